@@ -0,0 +1,148 @@
+#pragma once
+#include "../../ORNG-Core/headers/EngineAPI.h"
+
+namespace ORNG {
+	/*
+		Times and checks AssetManager's bookkeeping with a large number of registered assets, writes the results to a JSON file, then closes the application.
+		Adds m_num_assets textures and materials (every material using two of the textures) under a generated project directory, then times lookups by uuid and filepath, GetView and a linear filepath scan like the one lookups used to do.
+		Then checks filepath lookups stay valid after textures are respecced onto new paths, after the working directory changes and after the project directory changes.
+		Finally times deleting textures that materials use, checking the materials no longer reference them, and deleting everything else.
+		Then checks AssetFileWatcher (inotify on Linux, polling elsewhere) batches edits to several files into one set of reimports and ignores saves that don't change a file, see RunFileWatcherCheck.
+		Over the following frames, checks AssetManager's hot reload swaps reimported textures and sounds into the existing assets while they're in use, see BeginHotReloadCheck.
+		The projects are empty directories in the temp directory, only the file watcher and hot reload checks write files there. The layer does no rendering.
+	*/
+	class AssetBenchLayer : public Layer {
+	public:
+		AssetBenchLayer(const std::string& output_path, unsigned num_assets, unsigned num_lookups) :
+			m_output_path(output_path), m_num_assets(num_assets), m_num_lookups(num_lookups) {};
+
+		void OnInit() override;
+		void Update() override;
+		void OnRender() override {};
+		void OnShutdown() override {};
+		void OnImGuiRender() override {};
+
+		// False until every check has run and passed, the timings aren't checked
+		bool Passed() const {
+			return m_index_result.passed && m_file_watcher_result.passed && m_hot_reload_result.passed;
+		}
+
+		// Out of every 10 assets, the rest are textures
+		static constexpr unsigned MATERIALS_PER_10_ASSETS = 4;
+		// Linear scans are slow enough that only this many are timed
+		static constexpr unsigned NUM_LINEAR_SCAN_LOOKUPS = 200;
+		// Textures moved to new filepaths with SetSpec, then deleted with their material users
+		static constexpr unsigned NUM_RESPECCED_TEXTURES = 1000;
+		// Edited together, so the watcher should report them in one batch
+		static constexpr unsigned NUM_WATCHED_FILES = 8;
+		// Hot reload sources are rewritten with twice the texture size and a different sound length
+		static constexpr unsigned HOT_RELOAD_TEXTURE_SIZE = 4;
+		static constexpr unsigned HOT_RELOAD_SOUND_MS = 1000;
+		static constexpr unsigned HOT_RELOAD_NEW_SOUND_MS = 1500;
+		// Reimports not swapped in by then fail the check
+		static constexpr float HOT_RELOAD_TIMEOUT_MS = 10'000.f;
+		// Frames the sources are updated for after the last swap before checking they're still playing
+		static constexpr unsigned HOT_RELOAD_PLAYBACK_FRAMES = 10;
+
+	private:
+		struct TimingResult {
+			unsigned num_textures = 0;
+			unsigned num_materials = 0;
+			float add_ms = 0.f;
+			// Mean per lookup
+			float uuid_lookup_ns = 0.f;
+			float filepath_lookup_ns = 0.f;
+			float linear_scan_lookup_ns = 0.f;
+			float texture_view_ms = 0.f;
+			float material_view_ms = 0.f;
+			// Mean per texture, each used by at least one material
+			float texture_delete_us = 0.f;
+			float clear_ms = 0.f;
+		};
+
+		struct IndexResult {
+			// Lookups by filepath that returned the wrong asset or nothing, over every phase of the check
+			unsigned failed_lookups = 0;
+			// Lookups of paths textures were moved away from that still found them
+			unsigned stale_lookups = 0;
+			// Materials still referencing a deleted texture
+			unsigned dangling_materials = 0;
+			bool passed = false;
+		};
+
+		struct FileWatcherResult {
+			bool using_notifications = false;
+			unsigned num_files = 0;
+			// Non-empty ConsumeChanges results after every file was edited, and how many files they held
+			unsigned num_batches = 0;
+			unsigned num_reported = 0;
+			// From the last edit until the batch could be consumed, includes AssetFileWatcher::DEBOUNCE_INTERVAL
+			float batch_latency_ms = 0.f;
+			// Files reported after being rewritten with the contents they already had
+			unsigned num_noop_reported = 0;
+			bool passed = false;
+		};
+
+		struct HotReloadResult {
+			// From rewriting the sources until each asset was swapped, includes AssetFileWatcher::DEBOUNCE_INTERVAL
+			float texture_reload_ms = 0.f;
+			float decoded_sound_reload_ms = 0.f;
+			float streamed_sound_reload_ms = 0.f;
+			// The texture has the new size and texture object, the sounds the new length
+			bool texture_swapped = false;
+			bool decoded_sound_swapped = false;
+			bool streamed_sound_swapped = false;
+			// Sources that were playing each sound are still playing the new one after the old one was released
+			bool decoded_source_playing = false;
+			bool streamed_source_playing = false;
+			bool passed = false;
+		};
+
+		// Everything the hot reload check keeps between frames
+		struct HotReloadState {
+			std::unique_ptr<Scene> p_scene;
+			Texture2D* p_texture = nullptr;
+			SoundAsset* p_decoded_sound = nullptr;
+			SoundAsset* p_streamed_sound = nullptr;
+			AudioComponent* p_decoded_source = nullptr;
+			AudioComponent* p_streamed_source = nullptr;
+			unsigned old_texture_handle = 0;
+			std::chrono::steady_clock::time_point start_time;
+			std::chrono::steady_clock::time_point rewrite_time;
+			bool rewritten = false;
+			unsigned frames_since_swapped = 0;
+		};
+
+		// Adds a texture and a decoded and a streamed sound from generated source files, plays both sounds on looping sources and enables hot reload
+		// UpdateHotReloadCheck then rewrites the sources once the watcher has its baseline and waits for the asset manager's update to swap the reimports in
+		// Passes if every asset is swapped within HOT_RELOAD_TIMEOUT_MS and both sources keep playing on the new sounds
+		void BeginHotReloadCheck();
+		// Returns true once the check has finished and cleaned up
+		bool UpdateHotReloadCheck();
+		void EndHotReloadCheck();
+
+		// Watches a directory of text files, edits all of them at once then rewrites them unchanged
+		// Passes if the edits are reported in a single batch no sooner than the debounce interval, holding every file, and the unchanged saves aren't reported at all
+		FileWatcherResult RunFileWatcherCheck();
+
+		// Adds the assets then runs the timings and index checks in the order described above, passes if no lookup fails or finds a moved texture and no material is left using a deleted one
+		void RunChecks();
+
+		// Number of textures that GetAsset<Texture2D>(paths[i]) doesn't return
+		static unsigned CountFailedLookups(const std::vector<Texture2D*>& textures, const std::vector<std::string>& paths);
+
+		void WriteResults();
+
+		std::string m_output_path;
+		unsigned m_num_assets;
+		unsigned m_num_lookups;
+
+		TimingResult m_timing_result;
+		IndexResult m_index_result;
+		FileWatcherResult m_file_watcher_result;
+		HotReloadResult m_hot_reload_result;
+
+		HotReloadState m_hot_reload;
+		bool m_ran_checks = false;
+	};
+}
@@ -0,0 +1,529 @@
+#include "AssetBenchLayer.h"
+#include <glfw/glfw3.h>
+#include <unordered_set>
+#include "assets/AssetManager.h"
+#include <fmod.hpp>
+#include "assets/AssetFileWatcher.h"
+#include "assets/SoundAsset.h"
+#include "rendering/Material.h"
+
+namespace ORNG {
+	static constexpr unsigned RNG_SEED = 11;
+	static constexpr unsigned SOUND_SAMPLE_RATE = 48'000;
+
+	static float MsSince(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// Square 24-bit BMP of a single colour
+	static void WriteTestImage(const std::filesystem::path& filepath, unsigned size, uint8_t shade) {
+		const uint32_t row_size = (size * 3 + 3) & ~3u;
+		const uint32_t data_size = row_size * size;
+
+		std::ofstream s{ filepath, std::ios::binary | std::ios::trunc };
+		auto write = [&s]<typename T>(T value) { s.write(reinterpret_cast<const char*>(&value), sizeof(T)); };
+
+		s.write("BM", 2);
+		write(uint32_t{ 54 + data_size });
+		write(uint32_t{ 0 });
+		write(uint32_t{ 54 });
+		write(uint32_t{ 40 });
+		write(static_cast<int32_t>(size));
+		write(static_cast<int32_t>(size));
+		write(uint16_t{ 1 });
+		write(uint16_t{ 24 });
+		write(uint32_t{ 0 }); // BI_RGB
+		write(data_size);
+		write(int32_t{ 2835 });
+		write(int32_t{ 2835 });
+		write(uint32_t{ 0 });
+		write(uint32_t{ 0 });
+
+		std::vector<uint8_t> row(row_size, 0);
+		std::fill_n(row.begin(), size * 3, shade);
+		for (unsigned y = 0; y < size; y++) {
+			s.write(reinterpret_cast<const char*>(row.data()), row_size);
+		}
+	}
+
+	// 16-bit mono WAV of silence
+	static void WriteTestSound(const std::filesystem::path& filepath, unsigned length_ms) {
+		const uint32_t data_size = SOUND_SAMPLE_RATE / 1000 * length_ms * sizeof(int16_t);
+
+		std::ofstream s{ filepath, std::ios::binary | std::ios::trunc };
+		auto write = [&s]<typename T>(T value) { s.write(reinterpret_cast<const char*>(&value), sizeof(T)); };
+
+		s.write("RIFF", 4);
+		write(uint32_t{ 36 + data_size });
+		s.write("WAVEfmt ", 8);
+		write(uint32_t{ 16 });
+		write(uint16_t{ 1 }); // PCM
+		write(uint16_t{ 1 });
+		write(uint32_t{ SOUND_SAMPLE_RATE });
+		write(static_cast<uint32_t>(SOUND_SAMPLE_RATE * sizeof(int16_t)));
+		write(static_cast<uint16_t>(sizeof(int16_t)));
+		write(uint16_t{ 16 });
+		s.write("data", 4);
+		write(data_size);
+
+		std::vector<char> samples(data_size, 0);
+		s.write(samples.data(), data_size);
+	}
+
+	static unsigned GetSoundLength(const SoundAsset* p_sound) {
+		unsigned length_ms = 0;
+		if (p_sound->p_sound)
+			p_sound->p_sound->getLength(&length_ms, FMOD_TIMEUNIT_MS);
+
+		return length_ms;
+	}
+
+	static std::filesystem::path GetHotReloadDir() {
+		return std::filesystem::temp_directory_path() / "orng-asset-bench" / "hot-reload";
+	}
+
+	void AssetBenchLayer::OnInit() {
+		ORNG_CORE_INFO("Asset bench: {0} assets, {1} lookups", m_num_assets, m_num_lookups);
+	}
+
+
+
+	void AssetBenchLayer::Update() {
+		// Hot reload swaps only happen in the asset manager's update, so that check is spread over the frames after the others
+		if (!m_ran_checks) {
+			RunChecks();
+			m_file_watcher_result = RunFileWatcherCheck();
+			BeginHotReloadCheck();
+			m_ran_checks = true;
+			return;
+		}
+
+		if (!UpdateHotReloadCheck())
+			return;
+
+		WriteResults();
+		glfwSetWindowShouldClose(Window::GetGLFWwindow(), true);
+	}
+
+
+
+	unsigned AssetBenchLayer::CountFailedLookups(const std::vector<Texture2D*>& textures, const std::vector<std::string>& paths) {
+		unsigned failed = 0;
+		for (size_t i = 0; i < textures.size(); i++) {
+			if (AssetManager::GetAsset<Texture2D>(paths[i]) != textures[i])
+				failed++;
+		}
+
+		return failed;
+	}
+
+
+
+	void AssetBenchLayer::RunChecks() {
+		auto& timing = m_timing_result;
+		auto& index = m_index_result;
+
+		// Neither directory is written to, they only have to exist to be made the working directory
+		const auto bench_dir = std::filesystem::temp_directory_path() / "orng-asset-bench";
+		const auto project_a = bench_dir / "project-a";
+		const auto project_b = bench_dir / "project-b";
+		std::filesystem::create_directories(project_a);
+		std::filesystem::create_directories(project_b);
+		const auto initial_cwd = std::filesystem::current_path();
+
+		AssetManager::SetProjectDirectory(project_a.string());
+
+		timing.num_materials = m_num_assets / 10 * MATERIALS_PER_10_ASSETS;
+		timing.num_textures = m_num_assets - timing.num_materials;
+
+		// Paths the editor would use (relative to the project) and the ones assets are created with
+		std::vector<std::string> relative_paths(timing.num_textures);
+		std::vector<std::string> absolute_paths(timing.num_textures);
+		for (unsigned i = 0; i < timing.num_textures; i++) {
+			relative_paths[i] = std::format("res\\textures\\tex{}.png", i);
+			absolute_paths[i] = (project_a / "res" / "textures" / std::format("tex{}.png", i)).string();
+		}
+
+		std::vector<Texture2D*> textures(timing.num_textures);
+		std::vector<Material*> materials(timing.num_materials);
+
+		auto start = std::chrono::steady_clock::now();
+		for (unsigned i = 0; i < timing.num_textures; i++) {
+			textures[i] = AssetManager::AddAsset(new Texture2D(absolute_paths[i]));
+		}
+		for (unsigned i = 0; i < timing.num_materials; i++) {
+			auto* p_material = new Material((project_a / "res" / "materials" / std::format("mat{}.omat", i)).string());
+			p_material->base_colour_texture = textures[(i * 2) % timing.num_textures];
+			p_material->normal_map_texture = textures[(i * 2 + 1) % timing.num_textures];
+			materials[i] = AssetManager::AddAsset(p_material);
+		}
+		timing.add_ms = MsSince(start);
+
+		// Lookups are made in a random order so they aren't helped by the caches more than a real frame would be
+		std::mt19937 rng{ RNG_SEED };
+		std::uniform_int_distribution<unsigned> texture_dist{ 0, timing.num_textures - 1 };
+		std::vector<unsigned> lookup_indices(m_num_lookups);
+		for (auto& i : lookup_indices) {
+			i = texture_dist(rng);
+		}
+
+		std::vector<uint64_t> uuids(timing.num_textures);
+		for (unsigned i = 0; i < timing.num_textures; i++) {
+			uuids[i] = textures[i]->uuid();
+		}
+
+		// Summed so the lookups can't be optimized out
+		uintptr_t sink = 0;
+
+		start = std::chrono::steady_clock::now();
+		for (auto i : lookup_indices) {
+			sink += reinterpret_cast<uintptr_t>(AssetManager::GetAsset<Texture2D>(uuids[i]));
+		}
+		timing.uuid_lookup_ns = MsSince(start) * 1e6f / m_num_lookups;
+
+		start = std::chrono::steady_clock::now();
+		for (auto i : lookup_indices) {
+			sink += reinterpret_cast<uintptr_t>(AssetManager::GetAsset<Texture2D>(relative_paths[i]));
+		}
+		timing.filepath_lookup_ns = MsSince(start) * 1e6f / m_num_lookups;
+
+		start = std::chrono::steady_clock::now();
+		for (unsigned i = 0; i < NUM_LINEAR_SCAN_LOOKUPS; i++) {
+			for (auto* p_tex : AssetManager::GetView<Texture2D>()) {
+				if (p_tex->PathEqualTo(absolute_paths[lookup_indices[i % m_num_lookups]])) {
+					sink += reinterpret_cast<uintptr_t>(p_tex);
+					break;
+				}
+			}
+		}
+		timing.linear_scan_lookup_ns = MsSince(start) * 1e6f / NUM_LINEAR_SCAN_LOOKUPS;
+
+		start = std::chrono::steady_clock::now();
+		sink += AssetManager::GetView<Texture2D>().size();
+		timing.texture_view_ms = MsSince(start);
+
+		start = std::chrono::steady_clock::now();
+		sink += AssetManager::GetView<Material>().size();
+		timing.material_view_ms = MsSince(start);
+
+		ORNG_CORE_TRACE("Asset bench lookup sink: {0}", sink);
+
+		index.failed_lookups += CountFailedLookups(textures, relative_paths);
+		index.failed_lookups += CountFailedLookups(textures, absolute_paths);
+
+		// Move some textures onto new paths through SetSpec, their old paths mustn't find them any more
+		const unsigned num_respecced = glm::min(NUM_RESPECCED_TEXTURES, timing.num_textures);
+		for (unsigned i = 0; i < num_respecced; i++) {
+			if (AssetManager::GetAsset<Texture2D>(relative_paths[i]) != textures[i])
+				continue;
+
+			Texture2DSpec spec = textures[i]->GetSpec();
+			spec.filepath = (project_a / "res" / "textures" / "moved" / std::format("tex{}.png", i)).string();
+			textures[i]->SetSpec(spec);
+
+			if (AssetManager::GetAsset<Texture2D>(relative_paths[i]) == textures[i])
+				index.stale_lookups++;
+
+			relative_paths[i] = std::format("res\\textures\\moved\\tex{}.png", i);
+			absolute_paths[i] = spec.filepath;
+		}
+
+		index.failed_lookups += CountFailedLookups(textures, relative_paths);
+
+		// Project loads change the working directory, lookups are keyed on the project directory so shouldn't notice
+		std::filesystem::current_path(project_b);
+		index.failed_lookups += CountFailedLookups(textures, relative_paths);
+		std::filesystem::current_path(initial_cwd);
+
+		// Under another project the paths are no longer inside it, only the full paths can find them
+		AssetManager::SetProjectDirectory(project_b.string());
+		index.failed_lookups += CountFailedLookups(textures, absolute_paths);
+		AssetManager::SetProjectDirectory(project_a.string());
+		index.failed_lookups += CountFailedLookups(textures, relative_paths);
+
+		// Every respecced texture is used by a material
+		std::unordered_set<const Texture2D*> deleted_textures;
+		start = std::chrono::steady_clock::now();
+		for (unsigned i = 0; i < num_respecced; i++) {
+			deleted_textures.insert(textures[i]);
+			AssetManager::DeleteAsset(textures[i]);
+		}
+		timing.texture_delete_us = MsSince(start) * 1000.f / glm::max(num_respecced, 1u);
+
+		for (auto* p_material : materials) {
+			if (std::ranges::any_of(p_material->GetTextures(), [&](const Texture2D* p_tex) { return deleted_textures.contains(p_tex); }))
+				index.dangling_materials++;
+		}
+
+		start = std::chrono::steady_clock::now();
+		AssetManager::ClearAll();
+		timing.clear_ms = MsSince(start);
+
+		index.passed = index.failed_lookups == 0 && index.stale_lookups == 0 && index.dangling_materials == 0;
+	}
+
+
+
+	AssetBenchLayer::FileWatcherResult AssetBenchLayer::RunFileWatcherCheck() {
+		FileWatcherResult result;
+		result.num_files = NUM_WATCHED_FILES;
+
+		// Separate from AssetManager's so nothing is reimported
+		AssetFileWatcher file_watcher;
+
+		const auto watched_dir = std::filesystem::temp_directory_path() / "orng-asset-bench" / "watched";
+		std::filesystem::remove_all(watched_dir);
+		std::filesystem::create_directories(watched_dir);
+
+		auto write_files = [&](const char* contents) {
+			for (unsigned i = 0; i < NUM_WATCHED_FILES; i++) {
+				std::ofstream{ watched_dir / std::format("asset{}.txt", i) } << contents << i;
+			}
+			// Not matching the watched extension, must never be reported
+			std::ofstream{ watched_dir / "ignored.bin" } << contents;
+		};
+
+		// Collects every batch released within a few polls of the debounce interval, anything later would be a second batch
+		auto collect_batches = [&](std::chrono::steady_clock::time_point last_write, std::vector<std::vector<std::string>>& batches) {
+			const auto deadline = last_write + AssetFileWatcher::DEBOUNCE_INTERVAL + AssetFileWatcher::POLL_INTERVAL * 4;
+			while (std::chrono::steady_clock::now() < deadline) {
+				if (auto changes = file_watcher.ConsumeChanges(); !changes.empty()) {
+					if (batches.empty())
+						result.batch_latency_ms = MsSince(last_write);
+
+					batches.push_back(std::move(changes));
+				}
+
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			}
+		};
+
+		write_files("original ");
+
+		file_watcher.WatchDirectory(watched_dir.string(), { ".txt" });
+		file_watcher.Start();
+		result.using_notifications = file_watcher.IsUsingNotifications();
+
+		// Let the first poll take its baseline of the files
+		std::this_thread::sleep_for(AssetFileWatcher::POLL_INTERVAL * 2);
+
+		std::vector<std::vector<std::string>> edit_batches;
+		write_files("edited ");
+		collect_batches(std::chrono::steady_clock::now(), edit_batches);
+
+		result.num_batches = static_cast<unsigned>(edit_batches.size());
+		for (auto& batch : edit_batches) {
+			result.num_reported += static_cast<unsigned>(batch.size());
+		}
+
+		// Same contents again, the write times change but the hashes don't
+		std::vector<std::vector<std::string>> noop_batches;
+		write_files("edited ");
+		collect_batches(std::chrono::steady_clock::now(), noop_batches);
+
+		for (auto& batch : noop_batches) {
+			result.num_noop_reported += static_cast<unsigned>(batch.size());
+		}
+
+		file_watcher.Stop();
+		std::filesystem::remove_all(watched_dir);
+
+		result.passed = result.num_batches == 1 && result.num_reported == NUM_WATCHED_FILES && result.num_noop_reported == 0 &&
+			result.batch_latency_ms >= static_cast<float>(AssetFileWatcher::DEBOUNCE_INTERVAL.count());
+
+		if (result.passed)
+			ORNG_CORE_INFO("File watcher check ({0}): {1} edits reported in one batch after {2}ms", result.using_notifications ? "inotify" : "polling", result.num_reported, result.batch_latency_ms);
+		else
+			ORNG_CORE_ERROR("File watcher check failed ({0}): {1} batches holding {2}/{3} files after {4}ms, {5} unchanged saves reported",
+				result.using_notifications ? "inotify" : "polling", result.num_batches, result.num_reported, NUM_WATCHED_FILES, result.batch_latency_ms, result.num_noop_reported);
+
+		return result;
+	}
+
+
+
+	void AssetBenchLayer::BeginHotReloadCheck() {
+		auto& state = m_hot_reload;
+		const auto dir = GetHotReloadDir();
+		std::filesystem::remove_all(dir);
+		std::filesystem::create_directories(dir);
+
+		WriteTestImage(dir / "texture.bmp", HOT_RELOAD_TEXTURE_SIZE, 64);
+		WriteTestSound(dir / "decoded.wav", HOT_RELOAD_SOUND_MS);
+		WriteTestSound(dir / "streamed.wav", HOT_RELOAD_SOUND_MS);
+
+		const std::string texture_path = (dir / "texture.bmp").string();
+		Texture2DSpec spec;
+		spec.filepath = texture_path;
+		spec.mag_filter = GL_NEAREST;
+		spec.min_filter = GL_NEAREST;
+		state.p_texture = new Texture2D(texture_path);
+		state.p_texture->SetSpec(spec);
+		state.p_texture->LoadFromFile();
+		state.p_texture = AssetManager::AddAsset(state.p_texture);
+		state.old_texture_handle = state.p_texture->GetTextureHandle();
+
+		auto add_sound = [&dir](const char* filename, SoundAsset::LoadMode mode) {
+			auto* p_sound = new SoundAsset("");
+			p_sound->source_filepath = (dir / filename).string();
+			p_sound->load_mode = mode;
+			p_sound->CreateSoundFromFile();
+			return AssetManager::AddAsset(p_sound);
+			};
+
+		state.p_decoded_sound = add_sound("decoded.wav", SoundAsset::LoadMode::DECODE);
+		state.p_streamed_sound = add_sound("streamed.wav", SoundAsset::LoadMode::STREAM);
+
+		state.p_scene = std::make_unique<Scene>();
+		state.p_scene->AddSystem(new AudioSystem{ &*state.p_scene });
+		state.p_scene->AddSystem(new TransformHierarchySystem{ &*state.p_scene });
+		state.p_scene->LoadScene();
+
+		auto add_source = [&state](SoundAsset* p_sound) {
+			auto* p_audio = state.p_scene->CreateEntity("Source").AddComponent<AudioComponent>();
+			p_audio->SetLooped(true);
+			p_audio->Play(p_sound->uuid());
+			return p_audio;
+			};
+
+		state.p_decoded_source = add_source(state.p_decoded_sound);
+		state.p_streamed_source = add_source(state.p_streamed_sound);
+
+		// Textures and sounds are watched by their own source paths, the directory only matters for scripts
+		AssetManager::EnableHotReload(dir.string());
+		state.start_time = std::chrono::steady_clock::now();
+	}
+
+
+
+	bool AssetBenchLayer::UpdateHotReloadCheck() {
+		auto& state = m_hot_reload;
+		auto& result = m_hot_reload_result;
+		state.p_scene->GetSystem<AudioSystem>().OnUpdate();
+
+		if (!state.rewritten) {
+			// Let the first poll take its baseline of the files
+			if (std::chrono::steady_clock::now() - state.start_time < AssetFileWatcher::POLL_INTERVAL * 2)
+				return false;
+
+			const auto dir = GetHotReloadDir();
+			WriteTestImage(dir / "texture.bmp", HOT_RELOAD_TEXTURE_SIZE * 2, 192);
+			WriteTestSound(dir / "decoded.wav", HOT_RELOAD_NEW_SOUND_MS);
+			WriteTestSound(dir / "streamed.wav", HOT_RELOAD_NEW_SOUND_MS);
+			state.rewrite_time = std::chrono::steady_clock::now();
+			state.rewritten = true;
+			return false;
+		}
+
+		auto check_swap = [&state](bool swapped_now, bool& swapped, float& reload_ms) {
+			if (swapped || !swapped_now)
+				return;
+
+			swapped = true;
+			reload_ms = MsSince(state.rewrite_time);
+			};
+
+		const auto& tex_spec = state.p_texture->GetSpec();
+		check_swap(tex_spec.width == HOT_RELOAD_TEXTURE_SIZE * 2 && state.p_texture->GetTextureHandle() != state.old_texture_handle,
+			result.texture_swapped, result.texture_reload_ms);
+		check_swap(GetSoundLength(state.p_decoded_sound) != HOT_RELOAD_SOUND_MS, result.decoded_sound_swapped, result.decoded_sound_reload_ms);
+		check_swap(GetSoundLength(state.p_streamed_sound) != HOT_RELOAD_SOUND_MS, result.streamed_sound_swapped, result.streamed_sound_reload_ms);
+
+		const bool all_swapped = result.texture_swapped && result.decoded_sound_swapped && result.streamed_sound_swapped;
+		if (all_swapped && ++state.frames_since_swapped < HOT_RELOAD_PLAYBACK_FRAMES)
+			return false;
+		else if (!all_swapped && MsSince(state.rewrite_time) < HOT_RELOAD_TIMEOUT_MS)
+			return false;
+
+		result.decoded_source_playing = state.p_decoded_source->IsPlaying();
+		result.streamed_source_playing = state.p_streamed_source->IsPlaying();
+		result.passed = all_swapped && result.decoded_source_playing && result.streamed_source_playing;
+
+		if (result.passed)
+			ORNG_CORE_INFO("Hot reload check: texture swapped after {0}ms, decoded and streamed sounds after {1}ms/{2}ms and still playing",
+				result.texture_reload_ms, result.decoded_sound_reload_ms, result.streamed_sound_reload_ms);
+		else
+			ORNG_CORE_ERROR("Hot reload check failed: texture/decoded/streamed swapped {0}/{1}/{2}, decoded/streamed sources playing {3}/{4}",
+				result.texture_swapped, result.decoded_sound_swapped, result.streamed_sound_swapped, result.decoded_source_playing, result.streamed_source_playing);
+
+		EndHotReloadCheck();
+		return true;
+	}
+
+
+
+	void AssetBenchLayer::EndHotReloadCheck() {
+		auto& state = m_hot_reload;
+		AssetManager::DisableHotReload();
+
+		state.p_scene.reset();
+		AssetManager::DeleteAsset(state.p_texture);
+		AssetManager::DeleteAsset(state.p_decoded_sound);
+		AssetManager::DeleteAsset(state.p_streamed_sound);
+		std::filesystem::remove_all(GetHotReloadDir());
+	}
+
+
+
+	void AssetBenchLayer::WriteResults() {
+		std::ofstream s{ m_output_path };
+		if (!s.is_open()) {
+			ORNG_CORE_ERROR("Asset bench failed to open '{0}' for writing", m_output_path);
+			return;
+		}
+
+		const auto& timing = m_timing_result;
+		const auto& index = m_index_result;
+
+		s << "{\n";
+		s << std::format("\t\"assets\": {},\n", m_num_assets);
+		s << std::format("\t\"lookups\": {},\n", m_num_lookups);
+
+		s << "\t\"timings\": {\n";
+		s << std::format("\t\t\"textures\": {},\n", timing.num_textures);
+		s << std::format("\t\t\"materials\": {},\n", timing.num_materials);
+		s << std::format("\t\t\"add_ms\": {},\n", timing.add_ms);
+		s << std::format("\t\t\"uuid_lookup_ns\": {},\n", timing.uuid_lookup_ns);
+		s << std::format("\t\t\"filepath_lookup_ns\": {},\n", timing.filepath_lookup_ns);
+		s << std::format("\t\t\"linear_scan_lookup_ns\": {},\n", timing.linear_scan_lookup_ns);
+		s << std::format("\t\t\"texture_view_ms\": {},\n", timing.texture_view_ms);
+		s << std::format("\t\t\"material_view_ms\": {},\n", timing.material_view_ms);
+		s << std::format("\t\t\"texture_delete_us\": {},\n", timing.texture_delete_us);
+		s << std::format("\t\t\"clear_ms\": {}\n", timing.clear_ms);
+		s << "\t},\n";
+
+		s << "\t\"filepath_index\": {\n";
+		s << std::format("\t\t\"passed\": {},\n", index.passed);
+		s << std::format("\t\t\"failed_lookups\": {},\n", index.failed_lookups);
+		s << std::format("\t\t\"stale_lookups\": {},\n", index.stale_lookups);
+		s << std::format("\t\t\"dangling_materials\": {}\n", index.dangling_materials);
+		s << "\t},\n";
+
+		const auto& watcher = m_file_watcher_result;
+		s << "\t\"file_watcher\": {\n";
+		s << std::format("\t\t\"passed\": {},\n", watcher.passed);
+		s << std::format("\t\t\"backend\": \"{}\",\n", watcher.using_notifications ? "inotify" : "polling");
+		s << std::format("\t\t\"files\": {},\n", watcher.num_files);
+		s << std::format("\t\t\"batches\": {},\n", watcher.num_batches);
+		s << std::format("\t\t\"reported\": {},\n", watcher.num_reported);
+		s << std::format("\t\t\"batch_latency_ms\": {},\n", watcher.batch_latency_ms);
+		s << std::format("\t\t\"noop_reported\": {}\n", watcher.num_noop_reported);
+		s << "\t},\n";
+
+		const auto& hot_reload = m_hot_reload_result;
+		s << "\t\"hot_reload\": {\n";
+		s << std::format("\t\t\"passed\": {},\n", hot_reload.passed);
+		s << std::format("\t\t\"texture_swapped\": {},\n", hot_reload.texture_swapped);
+		s << std::format("\t\t\"decoded_sound_swapped\": {},\n", hot_reload.decoded_sound_swapped);
+		s << std::format("\t\t\"streamed_sound_swapped\": {},\n", hot_reload.streamed_sound_swapped);
+		s << std::format("\t\t\"texture_reload_ms\": {},\n", hot_reload.texture_reload_ms);
+		s << std::format("\t\t\"decoded_sound_reload_ms\": {},\n", hot_reload.decoded_sound_reload_ms);
+		s << std::format("\t\t\"streamed_sound_reload_ms\": {},\n", hot_reload.streamed_sound_reload_ms);
+		s << std::format("\t\t\"decoded_source_playing\": {},\n", hot_reload.decoded_source_playing);
+		s << std::format("\t\t\"streamed_source_playing\": {}\n", hot_reload.streamed_source_playing);
+		s << "\t}\n";
+		s << "}\n";
+
+		ORNG_CORE_INFO("Asset bench results written to '{0}'", m_output_path);
+	}
+}
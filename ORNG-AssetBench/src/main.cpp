@@ -0,0 +1,14 @@
+#include "AssetBenchLayer.h"
+#include "BenchMain.h"
+
+// Usage: ORNG_ASSET_BENCH [output json path] [assets] [lookups]
+int main(int argc, char** argv) {
+	std::string output_path = argc > 1 ? argv[1] : "asset-bench.json";
+	unsigned num_assets = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 100'000;
+	unsigned num_lookups = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 100'000;
+
+	ORNG::AssetBenchLayer bench{ output_path, num_assets, num_lookups };
+
+	// The asset manager and audio are needed for the hot reload check, nothing is heard
+	return ORNG::RunBench(bench, "ORNG Asset Bench", static_cast<ORNG::ApplicationModulesFlags>(ORNG::SCENE_RENDERER | ORNG::PHYSICS | ORNG::INPUT), true);
+}
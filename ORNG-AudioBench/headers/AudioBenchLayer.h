@@ -0,0 +1,145 @@
+#pragma once
+#include "../../ORNG-Core/headers/EngineAPI.h"
+#include "components/ComponentSystems.h"
+
+namespace ORNG {
+	/*
+		Checks and times audio voice management headlessly (FMOD_OUTPUTTYPE_NOSOUND), writes the results to a JSON file, then closes the application.
+		First drives VoiceManager directly with simulated channels on a fixed timestep, then plays sounds through an AudioSystem in a scene and compares it against FMOD's own channel counts and playback positions.
+		Then stresses AudioSystem's per-frame attribute update with many sources moving every frame, checking the velocities it derives against the analytic ones.
+		Finally loads a long generated track decoded and streamed, from its source file and from .osound files, comparing load times and FMOD's memory use, and plays the streamed one from several sources at once.
+		The layer does no rendering.
+	*/
+	class AudioBenchLayer : public Layer {
+	public:
+		AudioBenchLayer(const std::string& output_path, unsigned num_sources, unsigned num_frames, unsigned num_moving_sources) :
+			m_output_path(output_path), m_num_sources(num_sources), m_num_frames(num_frames), m_num_moving_sources(num_moving_sources) {};
+
+		void OnInit() override;
+		void Update() override;
+		void OnRender() override {};
+		void OnShutdown() override {};
+		void OnImGuiRender() override {};
+
+		// False until every check has run and passed, the timings aren't checked
+		bool Passed() const {
+			return m_voice_manager_result.passed && m_audio_system_result.passed && m_moving_sources_result.passed && m_streaming_result.passed;
+		}
+
+		static constexpr unsigned MAX_REAL_VOICES = 48;
+		// Sources are spread over a square this wide, the listener circles inside it
+		static constexpr float SOURCE_AREA_WIDTH = 400.f;
+		static constexpr float SOURCE_MAX_RANGE = 60.f;
+
+		// A resumed voice may be off from where it would have been by about one FMOD mix block plus a frame
+		static constexpr float MAX_RESUME_DRIFT_MS = 50.f;
+		// Relative to the analytic speed, derived velocities are the chord over a frame and the frame times aren't exactly the ones positions were sampled at
+		static constexpr float MAX_VELOCITY_ERROR = 0.05f;
+
+		// Length of the generated track for the streaming check, 48kHz stereo PCM16 so around 11MB a minute
+		static constexpr unsigned STREAM_TRACK_LENGTH_MS = 120'000;
+		static constexpr unsigned NUM_STREAM_PLAYERS = 4;
+		// Streams start playing once their prebuffer is decoded, which can be a mix block or two behind the wall clock
+		static constexpr float MAX_STREAM_POSITION_ERROR_MS = 100.f;
+
+	private:
+		struct VoiceCounts {
+			unsigned min_real = std::numeric_limits<unsigned>::max();
+			unsigned max_real = 0;
+			float mean_real = 0.f;
+			float mean_virtual = 0.f;
+			unsigned total_virtualized = 0;
+			unsigned total_realized = 0;
+
+			void Add(const VoiceManager::Stats& stats, unsigned num_frames);
+		};
+
+		struct VoiceManagerResult {
+			VoiceCounts counts;
+			float mean_update_us = 0.f;
+			float max_update_us = 0.f;
+			// Frames where a real voice was quieter (after the real voice bias) than a virtual one, or an inaudible voice was real
+			unsigned ranking_violations = 0;
+			// Largest difference between a voice's tracked position and where it should be after the whole run
+			double max_position_drift_ms = 0.0;
+			bool passed = false;
+		};
+
+		struct AudioSystemResult {
+			VoiceCounts counts;
+			// Largest number of channels FMOD reported playing in any frame
+			int max_fmod_channels = 0;
+			float mean_update_us = 0.f;
+			unsigned num_resumes = 0;
+			// Difference between a resumed channel's position and the wall clock time since the sounds were started
+			float max_resume_drift_ms = 0.f;
+			float mean_resume_drift_ms = 0.f;
+			bool passed = false;
+		};
+
+		struct MovingSourcesResult {
+			float mean_update_us = 0.f;
+			float p95_update_us = 0.f;
+			float max_update_us = 0.f;
+			// Per frame, every transform event used to be a set3DAttributes call
+			float mean_transform_events = 0.f;
+			float mean_moved_sources = 0.f;
+			float mean_channel_updates = 0.f;
+			unsigned max_channel_updates = 0;
+			// Largest relative errors of the source velocities AudioSystem derived and of the listener velocity FMOD was given
+			float max_velocity_error = 0.f;
+			float max_listener_velocity_error = 0.f;
+			bool passed = false;
+		};
+
+		struct SoundLoadResult {
+			bool loaded = false;
+			// Mean over a few loads
+			float load_ms = 0.f;
+			// Bytes FMOD has allocated while the sound is loaded, on top of what it had before
+			int64_t fmod_memory_bytes = 0;
+		};
+
+		struct StreamingResult {
+			uint64_t track_bytes = 0;
+			SoundLoadResult decoded_file;
+			SoundLoadResult streamed_file;
+			SoundLoadResult decoded_osound;
+			SoundLoadResult streamed_osound;
+			// Extra FMOD memory for each source playing the streamed sound, each has its own stream
+			int64_t memory_per_player_bytes = 0;
+			int max_fmod_channels = 0;
+			// Largest difference between a player's position and the wall clock time since it started
+			float max_position_error_ms = 0.f;
+			bool passed = false;
+		};
+
+		// m_num_sources looping voices with simulated channels, passes if the budget and ranking hold every frame and every voice ends where it should
+		VoiceManagerResult RunVoiceManagerCheck();
+
+		// m_num_sources looping AudioComponents in a scene, passes if neither AudioSystem nor FMOD ever has more than MAX_REAL_VOICES channels and resumed voices are within MAX_RESUME_DRIFT_MS
+		AudioSystemResult RunAudioSystemCheck();
+
+		// m_num_moving_sources looping sources circling at different speeds, each moved and rotated every frame so it sends two transform events
+		// Passes if no more than one set3DAttributes call is made per real channel per frame and every source and listener velocity is within MAX_VELOCITY_ERROR
+		MovingSourcesResult RunMovingSourcesCheck();
+
+		// Passes if every load succeeds, streaming uses under a quarter of the memory decoding does and NUM_STREAM_PLAYERS sources can play the streamed .osound at once within MAX_STREAM_POSITION_ERROR_MS
+		StreamingResult RunStreamingCheck();
+
+		void WriteResults();
+
+		// Where the listener is after "time_ms", a circle through the sources so voices keep moving in and out of range
+		static glm::vec3 GetListenerPos(float time_ms);
+
+		std::string m_output_path;
+		unsigned m_num_sources;
+		unsigned m_num_frames;
+		unsigned m_num_moving_sources;
+
+		VoiceManagerResult m_voice_manager_result;
+		AudioSystemResult m_audio_system_result;
+		MovingSourcesResult m_moving_sources_result;
+		StreamingResult m_streaming_result;
+	};
+}
@@ -0,0 +1,608 @@
+#include "AudioBenchLayer.h"
+#include <glfw/glfw3.h>
+#include <fmod.hpp>
+#include <thread>
+#include <numeric>
+#include "assets/AssetManager.h"
+#include "assets/SoundAsset.h"
+#include "audio/AudioEngine.h"
+#include "core/FrameTiming.h"
+
+namespace ORNG {
+	// Every source plays the same silent looping sound, at different pitches so their positions drift apart
+	static constexpr unsigned SOUND_LENGTH_MS = 10'000;
+	static constexpr unsigned SOUND_SAMPLE_RATE = 48'000;
+	static constexpr float SOURCE_MIN_RANGE = 1.f;
+	static constexpr unsigned RNG_SEED = 7;
+
+	static constexpr unsigned STREAM_TRACK_CHANNELS = 2;
+	static constexpr unsigned NUM_LOAD_REPEATS = 3;
+	static constexpr unsigned STREAM_PLAYBACK_FRAMES = 120;
+
+	// Shortest distance between two positions in a looping sound
+	static double LoopedDistance(double a, double b, double length) {
+		double d = glm::abs(a - b);
+		return glm::min(d, length - d);
+	}
+
+	static int GetFMODMemory() {
+		int current = 0;
+		int max = 0;
+		FMOD::Memory_GetStats(&current, &max);
+		return current;
+	}
+
+	// 16-bit stereo WAV of a 440Hz tone, returns its size in bytes
+	static uint64_t WriteTestTrack(const std::string& filepath, unsigned length_ms) {
+		const uint32_t num_frames = SOUND_SAMPLE_RATE / 1000 * length_ms;
+		const uint32_t block_align = STREAM_TRACK_CHANNELS * sizeof(int16_t);
+		const uint32_t data_size = num_frames * block_align;
+
+		std::vector<int16_t> samples(num_frames * STREAM_TRACK_CHANNELS);
+		for (uint32_t i = 0; i < num_frames; i++) {
+			const double t = static_cast<double>(i) / SOUND_SAMPLE_RATE;
+			const auto sample = static_cast<int16_t>(std::sin(2.0 * glm::pi<double>() * 440.0 * t) * 8000.0);
+			for (unsigned c = 0; c < STREAM_TRACK_CHANNELS; c++) {
+				samples[i * STREAM_TRACK_CHANNELS + c] = sample;
+			}
+		}
+
+		std::ofstream s{ filepath, std::ios::binary | std::ios::trunc };
+		auto write = [&s]<typename T>(T value) { s.write(reinterpret_cast<const char*>(&value), sizeof(T)); };
+
+		s.write("RIFF", 4);
+		write(uint32_t{ 36 + data_size });
+		s.write("WAVEfmt ", 8);
+		write(uint32_t{ 16 });
+		write(uint16_t{ 1 }); // PCM
+		write(static_cast<uint16_t>(STREAM_TRACK_CHANNELS));
+		write(uint32_t{ SOUND_SAMPLE_RATE });
+		write(uint32_t{ SOUND_SAMPLE_RATE * block_align });
+		write(static_cast<uint16_t>(block_align));
+		write(uint16_t{ 16 });
+		s.write("data", 4);
+		write(data_size);
+		s.write(reinterpret_cast<const char*>(samples.data()), data_size);
+
+		return 44 + data_size;
+	}
+
+	// Scene with an AudioSystem and an active camera entity, "Listener", for it to follow
+	static std::unique_ptr<Scene> CreateAudioScene() {
+		auto p_scene = std::make_unique<Scene>();
+		p_scene->AddSystem(new CameraSystem{ &*p_scene });
+		p_scene->AddSystem(new AudioSystem{ &*p_scene });
+		p_scene->AddSystem(new TransformHierarchySystem{ &*p_scene });
+		p_scene->LoadScene();
+
+		p_scene->GetSystem<AudioSystem>().SetMaxRealVoices(AudioBenchLayer::MAX_REAL_VOICES);
+
+		auto& listener = p_scene->CreateEntity("Listener");
+		listener.AddComponent<CameraComponent>()->MakeActive();
+		return p_scene;
+	}
+
+	void AudioBenchLayer::OnInit() {
+		// The asset manager module is disabled, audio components fall back to the base sound so it has to exist
+		FMOD_CREATESOUNDEXINFO info{};
+		info.cbsize = sizeof(info);
+		info.numchannels = 1;
+		info.defaultfrequency = SOUND_SAMPLE_RATE;
+		info.format = FMOD_SOUND_FORMAT_PCM16;
+		info.length = SOUND_SAMPLE_RATE * sizeof(int16_t) * SOUND_LENGTH_MS / 1000;
+
+		auto* p_sound = new SoundAsset("BASE");
+		p_sound->uuid = UUID<uint64_t>(ORNG_BASE_SOUND_ID);
+		if (auto result = AudioEngine::GetSystem()->createSound(nullptr, FMOD_OPENUSER | FMOD_3D | FMOD_LOOP_NORMAL, &info, &p_sound->p_sound); result != FMOD_OK)
+			ORNG_CORE_ERROR("Audio bench failed creating its sound: '{0}'", FMOD_ErrorString(result));
+
+		AssetManager::AddAsset(p_sound);
+
+		ORNG_CORE_INFO("Audio bench: {0} sources, {1} frames, {2} real voices", m_num_sources, m_num_frames, MAX_REAL_VOICES);
+	}
+
+
+
+	void AudioBenchLayer::Update() {
+		m_voice_manager_result = RunVoiceManagerCheck();
+		m_audio_system_result = RunAudioSystemCheck();
+		m_moving_sources_result = RunMovingSourcesCheck();
+		m_streaming_result = RunStreamingCheck();
+		WriteResults();
+		glfwSetWindowShouldClose(Window::GetGLFWwindow(), true);
+	}
+
+
+
+	void AudioBenchLayer::VoiceCounts::Add(const VoiceManager::Stats& stats, unsigned num_frames) {
+		min_real = glm::min(min_real, stats.real_voices);
+		max_real = glm::max(max_real, stats.real_voices);
+		mean_real += static_cast<float>(stats.real_voices) / num_frames;
+		mean_virtual += static_cast<float>(stats.virtual_voices) / num_frames;
+		total_virtualized += stats.virtualized;
+		total_realized += stats.realized;
+	}
+
+	glm::vec3 AudioBenchLayer::GetListenerPos(float time_ms) {
+		// One lap every 20 seconds
+		const float angle = time_ms / 20'000.f * 2.f * glm::pi<float>();
+		return glm::vec3{ glm::cos(angle), 0.f, glm::sin(angle) } * SOURCE_AREA_WIDTH * 0.3f;
+	}
+
+
+
+	AudioBenchLayer::VoiceManagerResult AudioBenchLayer::RunVoiceManagerCheck() {
+		VoiceManagerResult result;
+		constexpr float dt_ms = 1000.f / 60.f;
+
+		std::mt19937 rng{ RNG_SEED };
+		std::uniform_real_distribution<float> pos_dist{ -0.5f * SOURCE_AREA_WIDTH, 0.5f * SOURCE_AREA_WIDTH };
+		std::uniform_real_distribution<float> pitch_dist{ 0.5f, 1.5f };
+		std::uniform_real_distribution<float> volume_dist{ 0.2f, 1.f };
+
+		std::vector<VoiceManager::Voice> voices(m_num_sources);
+		std::vector<VoiceManager::Voice*> voice_ptrs;
+		for (unsigned i = 0; i < m_num_sources; i++) {
+			auto& voice = voices[i];
+			voice.pos = { pos_dist(rng), 0.f, pos_dist(rng) };
+			voice.pitch = pitch_dist(rng);
+			voice.volume = volume_dist(rng);
+			voice.min_range = SOURCE_MIN_RANGE;
+			voice.max_range = SOURCE_MAX_RANGE;
+			// Some sources outrank louder ones
+			voice.priority = i % 10 == 0 ? 4.f : 1.f;
+			voice.looped = true;
+			voice.length_ms = SOUND_LENGTH_MS;
+			voice_ptrs.push_back(&voice);
+		}
+
+		// Stand-ins for FMOD channels, only advance while their voice is real
+		std::vector<double> channel_positions(m_num_sources, 0.0);
+
+		VoiceManager manager;
+		manager.SetMaxRealVoices(MAX_REAL_VOICES);
+
+		for (unsigned frame = 0; frame < m_num_frames; frame++) {
+			for (unsigned i = 0; i < m_num_sources; i++) {
+				if (!voices[i].is_virtual)
+					channel_positions[i] = glm::mod(channel_positions[i] + dt_ms * voices[i].pitch, static_cast<double>(SOUND_LENGTH_MS));
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			manager.Update(voice_ptrs, GetListenerPos(frame * dt_ms), dt_ms);
+			const float update_us = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+			result.mean_update_us += update_us / m_num_frames;
+			result.max_update_us = glm::max(result.max_update_us, update_us);
+
+			// Same transitions AudioSystem applies to its channels
+			for (uint32_t i : manager.GetVoicesToVirtualize()) {
+				voices[i].position_ms = channel_positions[i];
+			}
+
+			for (uint32_t i : manager.GetVoicesToRealize()) {
+				channel_positions[i] = voices[i].position_ms;
+			}
+
+			const auto& stats = manager.GetStats();
+			result.counts.Add(stats, m_num_frames);
+
+			float min_real_score = std::numeric_limits<float>::max();
+			float max_virtual_audibility = 0.f;
+			bool inaudible_real = false;
+			for (const auto& voice : voices) {
+				if (voice.is_virtual) {
+					max_virtual_audibility = glm::max(max_virtual_audibility, voice.audibility);
+				}
+				else {
+					min_real_score = glm::min(min_real_score, voice.audibility * VoiceManager::REAL_VOICE_BIAS);
+					inaudible_real |= voice.audibility < VoiceManager::MIN_AUDIBILITY;
+				}
+			}
+
+			const bool budget_left_for_audible = stats.real_voices < MAX_REAL_VOICES && max_virtual_audibility >= VoiceManager::MIN_AUDIBILITY;
+			if (inaudible_real || budget_left_for_audible || min_real_score < max_virtual_audibility)
+				result.ranking_violations++;
+		}
+
+		for (unsigned i = 0; i < m_num_sources; i++) {
+			const double expected = glm::mod(static_cast<double>(m_num_frames) * (dt_ms * voices[i].pitch), static_cast<double>(SOUND_LENGTH_MS));
+			const double actual = voices[i].is_virtual ? voices[i].position_ms : channel_positions[i];
+			result.max_position_drift_ms = glm::max(result.max_position_drift_ms, LoopedDistance(expected, actual, SOUND_LENGTH_MS));
+		}
+
+		result.passed = result.ranking_violations == 0 && result.counts.max_real <= MAX_REAL_VOICES && result.max_position_drift_ms < 1.0;
+		ORNG_CORE_INFO("Audio bench voice manager: {0:.1f} real, {1:.1f} virtual on average, {2:.2f}us mean update, {3} ranking violations, {4:.4f}ms max drift",
+			result.counts.mean_real, result.counts.mean_virtual, result.mean_update_us, result.ranking_violations, result.max_position_drift_ms);
+
+		return result;
+	}
+
+
+
+	AudioBenchLayer::AudioSystemResult AudioBenchLayer::RunAudioSystemCheck() {
+		AudioSystemResult result;
+
+		auto p_scene = CreateAudioScene();
+		auto& audio = p_scene->GetSystem<AudioSystem>();
+		auto* p_listener_transform = p_scene->GetActiveCamera()->GetEntity()->GetComponent<TransformComponent>();
+		p_listener_transform->SetAbsolutePosition(GetListenerPos(0.f));
+
+		std::mt19937 rng{ RNG_SEED };
+		std::uniform_real_distribution<float> pos_dist{ -0.5f * SOURCE_AREA_WIDTH, 0.5f * SOURCE_AREA_WIDTH };
+		std::uniform_real_distribution<float> pitch_dist{ 0.5f, 1.5f };
+		std::uniform_real_distribution<float> volume_dist{ 0.2f, 1.f };
+
+		std::vector<AudioComponent*> sources;
+		for (unsigned i = 0; i < m_num_sources; i++) {
+			auto& ent = p_scene->CreateEntity("Source");
+			ent.GetComponent<TransformComponent>()->SetAbsolutePosition({ pos_dist(rng), 0.f, pos_dist(rng) });
+
+			auto* p_audio = ent.AddComponent<AudioComponent>();
+			p_audio->SetPitch(pitch_dist(rng));
+			p_audio->SetVolume(volume_dist(rng));
+			p_audio->SetMinMaxRange(SOURCE_MIN_RANGE, SOURCE_MAX_RANGE);
+			p_audio->SetPriority(i % 10 == 0 ? 4.f : 1.f);
+			p_audio->SetLooped(true);
+			sources.push_back(p_audio);
+		}
+
+		for (auto* p_audio : sources) {
+			p_audio->Play();
+		}
+
+		// Timesteps are measured from here, the same point the sounds started
+		FrameTiming::Update();
+		const auto play_time = std::chrono::steady_clock::now();
+
+		std::vector<uint8_t> was_virtual(sources.size());
+		for (size_t i = 0; i < sources.size(); i++) {
+			was_virtual[i] = sources[i]->IsVirtual();
+		}
+
+		double total_resume_drift_ms = 0.0;
+		for (unsigned frame = 0; frame < m_num_frames; frame++) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(16));
+			FrameTiming::Update();
+
+			const float elapsed_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - play_time).count();
+			p_listener_transform->SetAbsolutePosition(GetListenerPos(elapsed_ms));
+
+			auto start = std::chrono::steady_clock::now();
+			audio.OnUpdate();
+			result.mean_update_us += std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count() / m_num_frames;
+
+			result.counts.Add(audio.GetVoiceStats(), m_num_frames);
+
+			int num_channels = 0;
+			int num_real_channels = 0;
+			AudioEngine::GetSystem()->getChannelsPlaying(&num_channels, &num_real_channels);
+			result.max_fmod_channels = glm::max(result.max_fmod_channels, num_channels);
+
+			for (size_t i = 0; i < sources.size(); i++) {
+				auto* p_audio = sources[i];
+				if (was_virtual[i] && !p_audio->IsVirtual()) {
+					const double expected = glm::mod(static_cast<double>(elapsed_ms) * p_audio->GetPitch(), static_cast<double>(SOUND_LENGTH_MS));
+					const float drift = static_cast<float>(LoopedDistance(expected, p_audio->GetPlaybackPosition(), SOUND_LENGTH_MS));
+					result.max_resume_drift_ms = glm::max(result.max_resume_drift_ms, drift);
+					total_resume_drift_ms += drift;
+					result.num_resumes++;
+				}
+
+				was_virtual[i] = p_audio->IsVirtual();
+			}
+		}
+
+		if (result.num_resumes > 0)
+			result.mean_resume_drift_ms = static_cast<float>(total_resume_drift_ms / result.num_resumes);
+
+		result.passed = result.counts.max_real <= MAX_REAL_VOICES && result.max_fmod_channels <= static_cast<int>(MAX_REAL_VOICES) &&
+			result.num_resumes > 0 && result.max_resume_drift_ms <= MAX_RESUME_DRIFT_MS;
+
+		ORNG_CORE_INFO("Audio bench audio system: {0:.1f} real, {1:.1f} virtual on average, {2} FMOD channels at most, {3} resumes with {4:.1f}ms max drift",
+			result.counts.mean_real, result.counts.mean_virtual, result.max_fmod_channels, result.num_resumes, result.max_resume_drift_ms);
+
+		return result;
+	}
+
+
+
+	AudioBenchLayer::MovingSourcesResult AudioBenchLayer::RunMovingSourcesCheck() {
+		MovingSourcesResult result;
+
+		auto p_scene = CreateAudioScene();
+		auto& audio = p_scene->GetSystem<AudioSystem>();
+		auto* p_listener_transform = p_scene->GetActiveCamera()->GetEntity()->GetComponent<TransformComponent>();
+		p_listener_transform->SetAbsolutePosition(GetListenerPos(0.f));
+
+		struct Orbit {
+			glm::vec3 center;
+			float radius;
+			// Radians per second
+			float angular_speed;
+
+			glm::vec3 GetPos(float t) const {
+				return center + glm::vec3{ glm::cos(angular_speed * t), 0.f, glm::sin(angular_speed * t) } * radius;
+			}
+
+			glm::vec3 GetVelocity(float t) const {
+				return glm::vec3{ -glm::sin(angular_speed * t), 0.f, glm::cos(angular_speed * t) } * radius * angular_speed;
+			}
+		};
+
+		std::mt19937 rng{ RNG_SEED };
+		std::uniform_real_distribution<float> center_dist{ -0.5f * SOURCE_AREA_WIDTH, 0.5f * SOURCE_AREA_WIDTH };
+		std::uniform_real_distribution<float> radius_dist{ 2.f, 20.f };
+		std::uniform_real_distribution<float> speed_dist{ 1.f, 40.f };
+
+		std::vector<Orbit> orbits;
+		std::vector<AudioComponent*> sources;
+		for (unsigned i = 0; i < m_num_moving_sources; i++) {
+			auto& orbit = orbits.emplace_back(Orbit{ { center_dist(rng), 0.f, center_dist(rng) }, radius_dist(rng) });
+			orbit.angular_speed = speed_dist(rng) / orbit.radius;
+
+			auto& ent = p_scene->CreateEntity("Source");
+			ent.GetComponent<TransformComponent>()->SetAbsolutePosition(orbit.GetPos(0.f));
+
+			auto* p_audio = ent.AddComponent<AudioComponent>();
+			p_audio->SetMinMaxRange(SOURCE_MIN_RANGE, SOURCE_MAX_RANGE);
+			p_audio->SetLooped(true);
+			p_audio->Play();
+			sources.push_back(p_audio);
+		}
+
+		// Sources and the listener are placed at their time 0 positions, timesteps and sample times are measured from here
+		FrameTiming::Update();
+		const float start_time_ms = FrameTiming::GetTotalElapsedTime();
+
+		auto relative_error = [](glm::vec3 v, glm::vec3 expected) {
+			return glm::length(v - expected) / glm::max(glm::length(expected), 1e-3f);
+			};
+
+		std::vector<float> update_times_us;
+		update_times_us.reserve(m_num_frames);
+		for (unsigned frame = 0; frame < m_num_frames; frame++) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(16));
+			FrameTiming::Update();
+			const float time_ms = FrameTiming::GetTotalElapsedTime() - start_time_ms;
+			const float t = time_ms / 1000.f;
+
+			p_listener_transform->SetAbsolutePosition(GetListenerPos(time_ms));
+			for (unsigned i = 0; i < m_num_moving_sources; i++) {
+				auto* p_transform = sources[i]->GetEntity()->GetComponent<TransformComponent>();
+				p_transform->SetAbsolutePosition(orbits[i].GetPos(t));
+				p_transform->SetOrientation(0.f, glm::degrees(orbits[i].angular_speed * t), 0.f);
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			audio.OnUpdate();
+			update_times_us.push_back(std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count());
+
+			const auto& stats = audio.GetAttributeStats();
+			result.mean_transform_events += static_cast<float>(stats.transform_events) / m_num_frames;
+			result.mean_moved_sources += static_cast<float>(stats.moved_sources) / m_num_frames;
+			result.mean_channel_updates += static_cast<float>(stats.channel_updates) / m_num_frames;
+			result.max_channel_updates = glm::max(result.max_channel_updates, stats.channel_updates);
+
+			for (unsigned i = 0; i < m_num_moving_sources; i++) {
+				result.max_velocity_error = glm::max(result.max_velocity_error, relative_error(sources[i]->GetVelocity(), orbits[i].GetVelocity(t)));
+			}
+
+			FMOD_VECTOR listener_vel;
+			AudioEngine::GetSystem()->get3DListenerAttributes(0, nullptr, &listener_vel, nullptr, nullptr);
+			// Derivative of GetListenerPos
+			const float angle = time_ms / 20'000.f * 2.f * glm::pi<float>();
+			const glm::vec3 expected_listener_vel = glm::vec3{ -glm::sin(angle), 0.f, glm::cos(angle) } * SOURCE_AREA_WIDTH * 0.3f * 2.f * glm::pi<float>() / 20.f;
+			result.max_listener_velocity_error = glm::max(result.max_listener_velocity_error, relative_error({ listener_vel.x, listener_vel.y, listener_vel.z }, expected_listener_vel));
+		}
+
+		std::ranges::sort(update_times_us);
+		if (!update_times_us.empty()) {
+			result.mean_update_us = std::accumulate(update_times_us.begin(), update_times_us.end(), 0.f) / update_times_us.size();
+			result.p95_update_us = update_times_us[static_cast<size_t>(0.95f * (update_times_us.size() - 1))];
+			result.max_update_us = update_times_us.back();
+		}
+
+		result.passed = result.max_channel_updates <= MAX_REAL_VOICES && result.max_velocity_error <= MAX_VELOCITY_ERROR && result.max_listener_velocity_error <= MAX_VELOCITY_ERROR;
+		ORNG_CORE_INFO("Audio bench moving sources: {0:.1f}us mean update, {1:.0f} transform events and {2:.1f} channel updates per frame, {3:.4f} max velocity error",
+			result.mean_update_us, result.mean_transform_events, result.mean_channel_updates, result.max_velocity_error);
+
+		return result;
+	}
+
+
+
+	AudioBenchLayer::StreamingResult AudioBenchLayer::RunStreamingCheck() {
+		StreamingResult result;
+
+		const auto temp_dir = std::filesystem::temp_directory_path();
+		const std::string track_path = (temp_dir / "orng-audio-bench-track.wav").string();
+		const std::string decoded_osound_path = (temp_dir / "orng-audio-bench-decoded.osound").string();
+		const std::string streamed_osound_path = (temp_dir / "orng-audio-bench-streamed.osound").string();
+
+		result.track_bytes = WriteTestTrack(track_path, STREAM_TRACK_LENGTH_MS);
+
+		// The load mode is stored in the .osound, so there's one file per mode
+		auto write_osound = [&track_path](const std::string& path, SoundAsset::LoadMode mode) {
+			SoundAsset sound{ path };
+			sound.source_filepath = track_path;
+			sound.load_mode = mode;
+			AssetManager::SerializeAssetToBinaryFile(sound, path);
+			};
+
+		write_osound(decoded_osound_path, SoundAsset::LoadMode::DECODE);
+		write_osound(streamed_osound_path, SoundAsset::LoadMode::STREAM);
+
+		auto measure_load = [](auto load) {
+			SoundLoadResult load_result;
+			load_result.loaded = true;
+			const int memory_before = GetFMODMemory();
+
+			for (unsigned i = 0; i < NUM_LOAD_REPEATS; i++) {
+				SoundAsset sound{ "" };
+				auto start = std::chrono::steady_clock::now();
+				load(sound);
+				load_result.load_ms += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() / NUM_LOAD_REPEATS;
+
+				load_result.loaded &= sound.p_sound != nullptr;
+				load_result.fmod_memory_bytes = GetFMODMemory() - memory_before;
+			}
+
+			return load_result;
+			};
+
+		auto load_file = [&track_path](SoundAsset::LoadMode mode) {
+			return [&track_path, mode](SoundAsset& sound) {
+				sound.source_filepath = track_path;
+				sound.load_mode = mode;
+				sound.CreateSoundFromFile();
+				};
+			};
+
+		result.decoded_file = measure_load(load_file(SoundAsset::LoadMode::DECODE));
+		result.streamed_file = measure_load(load_file(SoundAsset::LoadMode::STREAM));
+		result.decoded_osound = measure_load([&](SoundAsset& sound) { AssetManager::LoadSoundFromBinaryFile(sound, decoded_osound_path); });
+		result.streamed_osound = measure_load([&](SoundAsset& sound) { AssetManager::LoadSoundFromBinaryFile(sound, streamed_osound_path); });
+
+		// Several sources playing the streamed .osound, each opens its own stream of the same byte range
+		auto* p_asset = new SoundAsset(streamed_osound_path);
+		AssetManager::LoadSoundFromBinaryFile(*p_asset, streamed_osound_path);
+		AssetManager::AddAsset(p_asset);
+
+		auto p_scene = CreateAudioScene();
+		auto& audio = p_scene->GetSystem<AudioSystem>();
+
+		std::vector<AudioComponent*> players;
+		for (unsigned i = 0; i < NUM_STREAM_PLAYERS; i++) {
+			auto* p_audio = p_scene->CreateEntity("Player").AddComponent<AudioComponent>();
+			p_audio->SetLooped(true);
+			players.push_back(p_audio);
+		}
+
+		const int memory_before_play = GetFMODMemory();
+		for (auto* p_audio : players) {
+			p_audio->Play(p_asset->uuid());
+		}
+
+		FrameTiming::Update();
+		const auto play_time = std::chrono::steady_clock::now();
+
+		for (unsigned frame = 0; frame < STREAM_PLAYBACK_FRAMES; frame++) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(16));
+			FrameTiming::Update();
+			audio.OnUpdate();
+
+			int num_channels = 0;
+			int num_real_channels = 0;
+			AudioEngine::GetSystem()->getChannelsPlaying(&num_channels, &num_real_channels);
+			result.max_fmod_channels = glm::max(result.max_fmod_channels, num_channels);
+		}
+
+		result.memory_per_player_bytes = (GetFMODMemory() - memory_before_play) / static_cast<int>(NUM_STREAM_PLAYERS);
+
+		const float elapsed_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - play_time).count();
+		bool all_playing = true;
+		for (auto* p_audio : players) {
+			all_playing &= p_audio->IsPlaying() && !p_audio->IsVirtual();
+			result.max_position_error_ms = glm::max(result.max_position_error_ms, glm::abs(static_cast<float>(p_audio->GetPlaybackPosition()) - elapsed_ms));
+		}
+
+		p_scene.reset();
+		AssetManager::DeleteAsset(p_asset);
+		for (const auto& path : { track_path, decoded_osound_path, streamed_osound_path }) {
+			std::filesystem::remove(path);
+		}
+
+		const bool all_loaded = result.decoded_file.loaded && result.streamed_file.loaded && result.decoded_osound.loaded && result.streamed_osound.loaded;
+		result.passed = all_loaded && all_playing &&
+			result.streamed_file.fmod_memory_bytes * 4 < result.decoded_file.fmod_memory_bytes &&
+			result.streamed_osound.fmod_memory_bytes * 4 < result.decoded_osound.fmod_memory_bytes &&
+			result.max_fmod_channels == static_cast<int>(NUM_STREAM_PLAYERS) && result.max_position_error_ms <= MAX_STREAM_POSITION_ERROR_MS;
+
+		ORNG_CORE_INFO("Audio bench streaming: {0}MB track, .osound loads in {1:.1f}ms/{2:.1f}ms using {3}KB/{4}KB of FMOD memory decoded/streamed, {5:.1f}ms max player position error",
+			result.track_bytes / (1024 * 1024), result.decoded_osound.load_ms, result.streamed_osound.load_ms,
+			result.decoded_osound.fmod_memory_bytes / 1024, result.streamed_osound.fmod_memory_bytes / 1024, result.max_position_error_ms);
+
+		return result;
+	}
+
+
+
+	void AudioBenchLayer::WriteResults() {
+		std::ofstream s{ m_output_path };
+		if (!s.is_open()) {
+			ORNG_CORE_ERROR("Audio bench failed to open '{0}' for writing", m_output_path);
+			return;
+		}
+
+		auto write_counts = [&s](const VoiceCounts& counts) {
+			s << std::format("\t\t\"min_real_voices\": {},\n", counts.min_real);
+			s << std::format("\t\t\"max_real_voices\": {},\n", counts.max_real);
+			s << std::format("\t\t\"mean_real_voices\": {},\n", counts.mean_real);
+			s << std::format("\t\t\"mean_virtual_voices\": {},\n", counts.mean_virtual);
+			s << std::format("\t\t\"virtualized\": {},\n", counts.total_virtualized);
+			s << std::format("\t\t\"realized\": {},\n", counts.total_realized);
+			};
+
+		s << "{\n";
+		s << std::format("\t\"sources\": {},\n", m_num_sources);
+		s << std::format("\t\"frames\": {},\n", m_num_frames);
+		s << std::format("\t\"max_real_voices\": {},\n", MAX_REAL_VOICES);
+
+		const auto& manager = m_voice_manager_result;
+		s << "\t\"voice_manager\": {\n";
+		s << std::format("\t\t\"passed\": {},\n", manager.passed);
+		write_counts(manager.counts);
+		s << std::format("\t\t\"mean_update_us\": {},\n", manager.mean_update_us);
+		s << std::format("\t\t\"max_update_us\": {},\n", manager.max_update_us);
+		s << std::format("\t\t\"ranking_violations\": {},\n", manager.ranking_violations);
+		s << std::format("\t\t\"max_position_drift_ms\": {}\n", manager.max_position_drift_ms);
+		s << "\t},\n";
+
+		const auto& system = m_audio_system_result;
+		s << "\t\"audio_system\": {\n";
+		s << std::format("\t\t\"passed\": {},\n", system.passed);
+		write_counts(system.counts);
+		s << std::format("\t\t\"max_fmod_channels\": {},\n", system.max_fmod_channels);
+		s << std::format("\t\t\"mean_update_us\": {},\n", system.mean_update_us);
+		s << std::format("\t\t\"resumes\": {},\n", system.num_resumes);
+		s << std::format("\t\t\"max_resume_drift_ms\": {},\n", system.max_resume_drift_ms);
+		s << std::format("\t\t\"mean_resume_drift_ms\": {}\n", system.mean_resume_drift_ms);
+		s << "\t},\n";
+
+		const auto& moving = m_moving_sources_result;
+		s << "\t\"moving_sources\": {\n";
+		s << std::format("\t\t\"passed\": {},\n", moving.passed);
+		s << std::format("\t\t\"sources\": {},\n", m_num_moving_sources);
+		s << std::format("\t\t\"mean_update_us\": {},\n", moving.mean_update_us);
+		s << std::format("\t\t\"p95_update_us\": {},\n", moving.p95_update_us);
+		s << std::format("\t\t\"max_update_us\": {},\n", moving.max_update_us);
+		s << std::format("\t\t\"mean_transform_events\": {},\n", moving.mean_transform_events);
+		s << std::format("\t\t\"mean_moved_sources\": {},\n", moving.mean_moved_sources);
+		s << std::format("\t\t\"mean_channel_updates\": {},\n", moving.mean_channel_updates);
+		s << std::format("\t\t\"max_channel_updates\": {},\n", moving.max_channel_updates);
+		s << std::format("\t\t\"max_velocity_error\": {},\n", moving.max_velocity_error);
+		s << std::format("\t\t\"max_listener_velocity_error\": {}\n", moving.max_listener_velocity_error);
+		s << "\t},\n";
+
+		auto write_load = [&s](const char* name, const SoundLoadResult& load, bool last) {
+			s << std::format("\t\t\"{}\": {{ \"loaded\": {}, \"load_ms\": {}, \"fmod_memory_bytes\": {} }}{}\n", name, load.loaded, load.load_ms, load.fmod_memory_bytes, last ? "" : ",");
+			};
+
+		const auto& streaming = m_streaming_result;
+		s << "\t\"streaming\": {\n";
+		s << std::format("\t\t\"passed\": {},\n", streaming.passed);
+		s << std::format("\t\t\"track_bytes\": {},\n", streaming.track_bytes);
+		s << std::format("\t\t\"players\": {},\n", NUM_STREAM_PLAYERS);
+		s << std::format("\t\t\"memory_per_player_bytes\": {},\n", streaming.memory_per_player_bytes);
+		s << std::format("\t\t\"max_fmod_channels\": {},\n", streaming.max_fmod_channels);
+		s << std::format("\t\t\"max_position_error_ms\": {},\n", streaming.max_position_error_ms);
+		write_load("decoded_file", streaming.decoded_file, false);
+		write_load("streamed_file", streaming.streamed_file, false);
+		write_load("decoded_osound", streaming.decoded_osound, false);
+		write_load("streamed_osound", streaming.streamed_osound, true);
+		s << "\t}\n";
+		s << "}\n";
+
+		ORNG_CORE_INFO("Audio bench results written to '{0}'", m_output_path);
+	}
+}
@@ -0,0 +1,14 @@
+#include "AudioBenchLayer.h"
+#include "BenchMain.h"
+
+// Usage: ORNG_AUDIO_BENCH [output json path] [sources] [frames] [moving sources]
+int main(int argc, char** argv) {
+	std::string output_path = argc > 1 ? argv[1] : "audio-bench.json";
+	unsigned num_sources = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 1000;
+	unsigned num_frames = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 600;
+	unsigned num_moving_sources = argc > 4 ? static_cast<unsigned>(std::stoul(argv[4])) : 2000;
+
+	ORNG::AudioBenchLayer bench{ output_path, num_sources, num_frames, num_moving_sources };
+
+	return ORNG::RunBench(bench, "ORNG Audio Bench", static_cast<ORNG::ApplicationModulesFlags>(ORNG::SCENE_RENDERER | ORNG::PHYSICS | ORNG::INPUT | ORNG::ASSET_MANAGER), true);
+}
@@ -0,0 +1,41 @@
+# Headless bench executables, each one is ORNG_CORE plus its own sources
+# Usage: orng_add_bench(<target> <sources>...), "headers" in the calling directory is on the include path
+set(ORNG_BENCH_COMMON_DIR ${CMAKE_CURRENT_LIST_DIR})
+
+function(orng_add_bench target)
+    add_executable(${target} ${ARGN})
+
+    target_include_directories(${target} PUBLIC
+    ${CMAKE_CURRENT_SOURCE_DIR}/headers
+    ${ORNG_BENCH_COMMON_DIR}/headers
+    ${CMAKE_SOURCE_DIR}/ORNG-Core/headers
+    ${CMAKE_SOURCE_DIR}/ORNG-Core/extern/glew-cmake/include
+    "${CMAKE_SOURCE_DIR}/ORNG-Core/extern/spdlog/include"
+    "${CMAKE_SOURCE_DIR}/ORNG-Core/extern/assimp/include"
+    "${CMAKE_SOURCE_DIR}/ORNG-Core/extern/assimp/build/include"
+    "${CMAKE_SOURCE_DIR}/ORNG-Core/extern/glfw/include"
+    "${CMAKE_SOURCE_DIR}/ORNG-Core/extern/physx/physx/include"
+    "${CMAKE_SOURCE_DIR}/ORNG-Core/extern"
+    "${CMAKE_SOURCE_DIR}/ORNG-Core/extern/imgui"
+    "${CMAKE_SOURCE_DIR}/ORNG-Core/extern/fastnoise2/include"
+    "${CMAKE_SOURCE_DIR}/ORNG-Core/extern/yaml/include"
+    "${CMAKE_SOURCE_DIR}/ORNG-Core/extern/plog/include"
+    )
+
+    target_link_libraries(${target} PUBLIC 
+    ORNG_CORE
+    imgui
+    )
+
+    target_precompile_headers(${target} REUSE_FROM ORNG_CORE)
+
+
+    add_custom_command(TARGET ${target} POST_BUILD
+        COMMAND ${CMAKE_COMMAND} -E make_directory $<TARGET_FILE_DIR:${target}>)
+    foreach(core_binary IN LISTS ORNG_CORE_BINARIES)
+        add_custom_command(TARGET ${target} POST_BUILD
+            COMMAND ${CMAKE_COMMAND} -E copy_if_different
+            ${core_binary}
+            $<TARGET_FILE_DIR:${target}>)
+    endforeach()
+endfunction()
@@ -0,0 +1,22 @@
+#pragma once
+#include "EngineAPI.h"
+
+namespace ORNG {
+	// Runs "bench" headlessly in a small window until it closes the application, "bench" is a Layer with a Passed() that says whether all of its checks passed
+	// Returns the process exit code, 1 if any check failed so scripts running the benches can gate on it
+	template<typename T>
+	int RunBench(T& bench, const char* window_name, ApplicationModulesFlags disabled_modules, bool audio_no_output = false) {
+		Application app;
+
+		ApplicationData app_data{};
+		app_data.disabled_modules = disabled_modules;
+		app_data.audio_no_output = audio_no_output;
+		app_data.initial_window_dimensions = { 320, 180 };
+		app_data.window_name = window_name;
+
+		app.layer_stack.PushLayer(&bench);
+		app.Init(app_data);
+
+		return bench.Passed() ? 0 : 1;
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <unordered_set>
+
+namespace YAML {
+	class Node;
+}
+
+#define ORNG_ASSET_MANIFEST_FILEPATH ".\\res\\asset-manifest.yml"
+
+namespace ORNG {
+	enum class AssetType : uint8_t {
+		TEXTURE = 0,
+		MESH = 1,
+		SOUND = 2,
+		MATERIAL = 3,
+		PHYSX_MATERIAL = 4,
+		PREFAB = 5,
+	};
+
+	// One record per serialized asset in the project, written by the editor when the project is saved
+	struct AssetManifestEntry {
+		uint64_t uuid = 0;
+		AssetType type = AssetType::TEXTURE;
+
+		// Path of the serialized binary file (.otex, .omesh etc), relative to the project directory
+		std::string filepath;
+		uint64_t size_bytes = 0;
+
+		// Only used for meshes, components (vehicles, particle emitters) size their material arrays from this before the mesh data is loaded
+		uint8_t num_materials = 0;
+
+		// Assets this asset references directly, e.g material -> textures, prefab -> meshes/materials/sounds
+		std::vector<uint64_t> dependencies;
+
+		// Subset of "dependencies" that must be fully loaded before the dependant is used, e.g meshes cooked into physics colliders by a prefab
+		std::vector<uint64_t> blocking_dependencies;
+	};
+
+	/*
+		Built from the asset manifest and the YAML of a scene + prefabs.
+		Used by the runtime to only load assets that are actually reachable from the scene being played, instead of the whole res folder.
+	*/
+	class AssetDependencyGraph {
+	public:
+		// Writes a manifest describing every asset currently held by the AssetManager, called when the project is saved
+		static void WriteManifest(const std::string& output_filepath);
+
+		// Returns false if no manifest exists (e.g an older project), callers should fall back to loading everything
+		bool LoadManifest(const std::string& filepath);
+
+		// Collects the uuids of every asset the scene (and every prefab, as scripts can instantiate any of them) depends on, including indirect dependencies
+		// Meshes that need their CPU-side vertex data immediately (physics colliders, vehicles, mesh particles) are additionally written to "blocking_meshes"
+		void ResolveSceneClosure(const std::string& scene_filepath, std::unordered_set<uint64_t>& output, std::unordered_set<uint64_t>& blocking_meshes) const;
+
+		const AssetManifestEntry* GetEntry(uint64_t uuid) const {
+			auto it = m_entries.find(uuid);
+			return it == m_entries.end() ? nullptr : &it->second;
+		}
+
+		const std::unordered_map<uint64_t, AssetManifestEntry>& GetEntries() const {
+			return m_entries;
+		}
+
+		// Reads the asset uuids referenced by the components of a single serialized entity
+		static void CollectEntityDependencies(const YAML::Node& entity_node, std::vector<uint64_t>& output, std::vector<uint64_t>& blocking_meshes);
+
+	private:
+		static void CollectEntityArrayDependencies(const YAML::Node& entities, std::vector<uint64_t>& output, std::vector<uint64_t>& blocking_meshes);
+
+		std::unordered_map<uint64_t, AssetManifestEntry> m_entries;
+	};
+}
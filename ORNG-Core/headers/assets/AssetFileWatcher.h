@@ -0,0 +1,133 @@
+#pragma once
+#include <thread>
+#include <condition_variable>
+
+namespace ORNG {
+	/*
+		Watches files on a background thread and reports the ones whose content has changed.
+		On Linux the thread sleeps on inotify and only checks the files it's notified about, elsewhere (or if inotify can't be set up) every watched file is polled each POLL_INTERVAL.
+		Changes are debounced and released as a single batch once no file has been touched for DEBOUNCE_INTERVAL, so e.g a git checkout touching hundreds of files is handled in one go.
+		Files whose content hash is unchanged after a write (saving without edits, touching the file) are never reported.
+	*/
+	class AssetFileWatcher {
+	public:
+		AssetFileWatcher() = default;
+		~AssetFileWatcher() { Stop(); }
+
+		void Start();
+
+		// Blocks until the watcher thread has exited, watches are kept
+		void Stop();
+
+		bool IsRunning() const {
+			return m_running;
+		}
+
+		// True once started if changes are picked up through OS notifications rather than polling
+		bool IsUsingNotifications() const {
+			return m_using_notifications;
+		}
+
+		// Watches and unwatches take effect on the next poll, these can be called from any thread
+		void WatchFile(const std::string& filepath);
+		void UnwatchFile(const std::string& filepath);
+
+		// Watches every file (recursively) in "dir" ending with one of "extensions", including files created after this call
+		void WatchDirectory(const std::string& dir, const std::vector<std::string>& extensions);
+
+		void ClearWatches();
+
+		// Returns the filepaths in the last settled batch of changes, empty if there is none ready
+		std::vector<std::string> ConsumeChanges();
+
+		static constexpr std::chrono::milliseconds POLL_INTERVAL{ 250 };
+		static constexpr std::chrono::milliseconds DEBOUNCE_INTERVAL{ 400 };
+
+	private:
+		void PollLoop();
+		void Poll();
+		void ApplyWatchRequests();
+
+		// Wakes the watcher thread up early, e.g to apply watch requests or stop
+		void Wake();
+
+		// Hash of the file contents, 0 if the file couldn't be read
+		static uint64_t HashFileContents(const std::string& filepath);
+
+		struct FileState {
+			std::filesystem::file_time_type last_write_time;
+			uint64_t content_hash = 0;
+			bool hashed = false;
+
+			// Write time changed since the last reported batch, content is hashed once the batch settles
+			bool pending = false;
+
+			// Discovered through a directory watch rather than WatchFile, removed if the file disappears
+			bool from_directory = false;
+		};
+
+		struct DirectoryWatch {
+			std::string dir;
+			std::vector<std::string> extensions;
+		};
+
+		// Adds files in "watch" that aren't watched yet, with their current state as the baseline
+		void DiscoverDirectoryFiles(const DirectoryWatch& watch);
+
+		// Marks the file pending if its write time changed, returns false if it couldn't be read
+		bool CheckWriteTime(const std::string& path, FileState& state, std::chrono::steady_clock::time_point now);
+
+		// Only accessed by the watcher thread
+		std::unordered_map<std::string, FileState> m_files;
+		std::vector<DirectoryWatch> m_directories;
+		std::chrono::steady_clock::time_point m_last_change_time;
+		// Some file is pending, waiting for the batch to settle
+		bool m_changes_pending = false;
+
+		// Every file is checked on the next poll instead of only the ones notified about (always the case when polling)
+		bool m_rescan = true;
+
+#ifdef __linux__
+		// Sleeps until inotify or Wake() has something, or the pending batch settles
+		void WaitForNotifications();
+
+		// Notifies about changes to the files directly in "dir", and if "recursive" in every directory under it too, including ones created later
+		void AddNotifyWatch(const std::string& dir, bool recursive);
+		void ReadNotifications();
+		void CloseNotifications();
+
+		int m_inotify_fd = -1;
+		// Written by Wake() so the thread can wait on it alongside inotify
+		int m_wake_fd = -1;
+
+		struct NotifyWatch {
+			// As the paths of the files in it are keyed, empty for the working directory
+			std::string dir;
+			bool recursive = false;
+		};
+
+		// By watch descriptor, and descriptors by directory
+		std::unordered_map<int, NotifyWatch> m_notify_watches;
+		std::unordered_map<std::string, int> m_notify_watch_dirs;
+		// A watched directory didn't exist on the last rescan, rescans happen every POLL_INTERVAL until it does
+		bool m_missing_notify_dir = false;
+		// Paths inotify reported since the last poll
+		std::vector<std::string> m_notified_paths;
+#endif
+
+		// Guards everything below, main thread <-> watcher thread communication
+		std::mutex m_mutex;
+		std::condition_variable m_cv;
+
+		std::vector<std::string> m_files_to_watch;
+		std::vector<std::string> m_files_to_unwatch;
+		std::vector<DirectoryWatch> m_directories_to_watch;
+		bool m_clear_requested = false;
+
+		std::vector<std::string> m_ready_changes;
+
+		std::atomic<bool> m_running = false;
+		std::atomic<bool> m_using_notifications = false;
+		std::thread m_thread;
+	};
+}
@@ -5,6 +5,10 @@
 #include "rendering/MeshAsset.h"
 #include "assets/SoundAsset.h"
 #include "PhysXMaterialAsset.h"
+#include "assets/AssetDependencyGraph.h"
+#include "assets/AssetFileWatcher.h"
+#include "assets/DerivedDataCache.h"
+#include "util/TimeStep.h"
 #include <bitsery/bitsery.h>
 #include <bitsery/traits/vector.h>
 #include <bitsery/adapter/stream.h>
@@ -24,8 +28,6 @@
 
 
 struct GLFWwindow;
-enum aiTextureType;
-struct aiMaterial;
 
 
 
@@ -87,6 +89,7 @@ namespace bitsery {
 namespace ORNG {
 	class Texture2D;
 	class MeshAsset;
+	class Scene;
 	struct Texture2DSpec;
 
 	struct Prefab : public Asset {
@@ -122,12 +125,14 @@ namespace ORNG {
 		static void Init() { Get().I_Init(); }
 
 		// Asset's memory will be managed by asset manager, provide a ptr to a heap-allocated object that will not be destroyed
+		// T must be the concrete type of the asset, it's used as the key for typed lookups
 		template<std::derived_from<Asset> T>
 		static T* AddAsset(T* p_asset) {
 			uint64_t uuid = p_asset->uuid();
 			ASSERT(!Get().m_assets.contains(uuid));
+			DEBUG_ASSERT(typeid(*p_asset) == typeid(T));
 
-			Get().m_assets[uuid] = static_cast<Asset*>(p_asset);
+			Get().RegisterAsset(p_asset, type_id<T>);
 			HandleAssetAddition(p_asset);
 			return p_asset;
 		}
@@ -135,11 +140,13 @@ namespace ORNG {
 		template<std::derived_from<Asset> T>
 		static std::vector<T*> GetView() {
 			std::vector<T*> vec;
-			for (auto [uuid, p_asset] : Get().m_assets) {
-				if (T* p_typed_asset = dynamic_cast<T*>(p_asset); p_typed_asset &&
-					uuid >= ORNG_NUM_BASE_ASSETS
-					)
-					vec.push_back(p_typed_asset);
+			auto it = Get().m_typed_assets.find(type_id<T>);
+			if (it == Get().m_typed_assets.end())
+				return vec;
+
+			vec.reserve(it->second.assets.size());
+			for (auto* p_asset : it->second.assets) {
+				vec.push_back(static_cast<T*>(p_asset));
 			}
 
 			return vec;
@@ -148,31 +155,35 @@ namespace ORNG {
 		// Returns ptr to asset or nullptr if no valid asset was found
 		template<std::derived_from<Asset> T>
 		static T* GetAsset(uint64_t uuid) {
-			if (Get().m_assets.contains(uuid)) {
-				if (auto* p_asset = dynamic_cast<T*>(Get().m_assets[uuid]))
-					return p_asset;
-				else {
-					ORNG_CORE_TRACE("GetAsset failed, asset with uuid '{0}' doesn't match type provided", uuid);
-					return nullptr;
-				}
-			}
-			else {
+			auto& assets = Get().m_assets;
+
+			// Assets outside of the active scene's dependency closure are only loaded once something asks for them
+			if (!assets.contains(uuid) && Get().m_deferred_assets.contains(uuid))
+				Get().LoadDeferredAsset(uuid);
+
+			auto it = assets.find(uuid);
+			if (it == assets.end()) {
 				ORNG_CORE_TRACE("GetAsset failed, no asset with uuid '{0}' found", uuid);
 				return nullptr;
 			}
+
+			if (T* p_asset = CastAssetRecord<T>(it->second))
+				return p_asset;
+
+			ORNG_CORE_TRACE("GetAsset failed, asset with uuid '{0}' doesn't match type provided", uuid);
+			return nullptr;
 		}
 
 		// Returns ptr to asset or nullptr if no valid asset was found
 		template<std::derived_from<Asset> T>
 		static T* GetAsset(const std::string& filepath) {
-			for (auto& [uuid, p_asset] : Get().m_assets) {
-				if (p_asset->PathEqualTo(filepath)) {
-					if (auto* p_typed_asset = dynamic_cast<T*>(p_asset))
-						return p_typed_asset;
-					else {
-						ORNG_CORE_TRACE("GetAsset failed, asset with path '{0}' doesn't match type provided", filepath);
-					}
-				}
+			auto& instance = Get();
+			auto [begin, end] = instance.m_filepath_index.equal_range(NormalizeAssetPath(filepath));
+			for (auto it = begin; it != end; it++) {
+				if (T* p_asset = CastAssetRecord<T>(instance.m_assets[it->second]))
+					return p_asset;
+				else
+					ORNG_CORE_TRACE("GetAsset failed, asset with path '{0}' doesn't match type provided", filepath);
 			}
 
 			ORNG_CORE_TRACE("No valid asset with path '{0}' found", filepath);
@@ -180,10 +191,12 @@ namespace ORNG {
 		}
 
 		static bool DeleteAsset(uint64_t uuid) {
-			if (Get().m_assets.contains(uuid)) {
-				HandleAssetDeletion(Get().m_assets[uuid]);
-				delete Get().m_assets[uuid];
-				Get().m_assets.erase(uuid);
+			auto& instance = Get();
+			if (instance.m_assets.contains(uuid)) {
+				Asset* p_asset = instance.m_assets[uuid].p_asset;
+				HandleAssetDeletion(p_asset);
+				instance.UnregisterAsset(uuid);
+				delete p_asset;
 
 				return true;
 			}
@@ -195,18 +208,20 @@ namespace ORNG {
 
 		template <std::derived_from<Asset> T>
 		static bool DeleteAsset(T* p_asset) {
-			for (auto [key, val] : Get().m_assets) {
-				if (val == dynamic_cast<T*>(p_asset)) {
-					HandleAssetDeletion(val);
-					delete p_asset;
-					Get().m_assets.erase(key);
-					return true;
-				}
-			}
+			auto it = Get().m_assets.find(p_asset->uuid());
+			if (it == Get().m_assets.end() || it->second.p_asset != p_asset)
+				return false;
 
-			return false;
+			return DeleteAsset(p_asset->uuid());
 		}
 
+		// Use this instead of writing to Asset::filepath once an asset has been added, keeps lookups by filepath valid
+		static void SetAssetFilepath(Asset& asset, const std::string& filepath);
+
+		// Materials are indexed by the textures they use so texture deletion doesn't have to visit every material
+		// Call this after changing the texture slots of a material that has already been added
+		static void RefreshMaterialDependencies(Material* p_material);
+
 		// Clears all assets including base replacement ones
 		static void OnShutdown() {
 			Get().IOnShutdown();
@@ -218,12 +233,50 @@ namespace ORNG {
 
 		static void LoadMeshAsset(MeshAsset* p_asset);
 		static void LoadTexture2D(Texture2D* p_tex);
+		// Reads an .osound file into "sound", streaming it from the file if the sound's load mode and size call for it
+		static void LoadSoundFromBinaryFile(SoundAsset& sound, const std::string& filepath);
 
 		static void LoadAssetsFromProjectPath(const std::string& project_dir, bool precompiled_scripts);
 
+		// Filepath lookups are keyed relative to this directory rather than the working directory, re-keys every registered asset if it changes
+		// Called by the Load...FromProjectPath functions
+		static void SetProjectDirectory(const std::string& project_dir);
+
+		// Loads only the assets reachable from the scene at "scene_filepath", using the manifest written when the project was last saved
+		// Textures and meshes are registered as placeholders and streamed in over the following frames, everything outside the closure is loaded on demand by GetAsset
+		// Falls back to LoadAssetsFromProjectPath if the project has no manifest
+		static void LoadSceneAssetsFromProjectPath(const std::string& project_dir, const std::string& scene_filepath, bool precompiled_scripts);
+
+		// Reorders the streaming queue so assets closest to the active camera of "scene" load first, ties are broken by size (smallest first)
+		// Call once the scene has been deserialized so entity positions are known
+		static void PrioritiseStreaming(Scene& scene);
+
+		static bool IsStreaming() {
+			return !Get().m_streaming_queue.empty() || !Get().m_streams_in_flight.empty();
+		}
+
+		// Paths the asset binaries are written to by SerializeAssets
+		static std::string GetTextureBinaryPath(const Texture2D& tex);
+		static std::string GetSoundBinaryPath(const SoundAsset& sound);
+		static std::string GetMaterialBinaryPath(const Material& material);
+		static std::string GetPhysXMaterialBinaryPath(const PhysXMaterialAsset& material);
+
 		static void SerializeAssets() {
 			Get().ISerializeAssets();
 		}
+
+		// Starts watching texture/sound source files, shaders and the scripts in "project_dir" for changes
+		// Changed assets are reimported on a worker thread and swapped in place at the start of a frame, so existing pointers and uuids stay valid
+		static void EnableHotReload(const std::string& project_dir) { Get().IEnableHotReload(project_dir); }
+		static void DisableHotReload() { Get().IDisableHotReload(); }
+
+		static bool IsHotReloadEnabled() {
+			return Get().m_file_watcher.IsRunning();
+		}
+
+		// Imports/decodes every mesh and image source file at "path" (a file or directory, searched recursively) into the DerivedDataCache
+		// If "path" is empty the source files of all loaded textures are used, returns the number of files processed successfully
+		static unsigned WarmDerivedDataCache(const std::string& path);
 #
 		// Deletes all assets
 		inline static void ClearAll() { Get().IClearAll(); };
@@ -306,6 +359,11 @@ namespace ORNG {
 		void ICreateBinaryAssetPackage(const std::string& output_path);
 		void IDeserializeAssetsFromBinaryPackage(const std::string& package_filepath);
 
+		// Packages start with these, packages from before the header existed (or built with a different layout) are rejected rather than misread
+		static constexpr uint32_t PACKAGE_MAGIC = 0x4B50474E; // "NGPK"
+		// Bump whenever the package layout changes, 1 added the sound load mode after each sound's data
+		static constexpr uint32_t PACKAGE_VERSION = 1;
+
 		static bool TryFetchRawTextureData(Texture2D& tex, std::vector<std::byte>& output);
 		static bool TryFetchRawSoundData(SoundAsset& sound, std::vector<std::byte>& output);
 
@@ -328,6 +386,8 @@ namespace ORNG {
 			ser.object(sound.uuid);
 			ser.text1b(sound.filepath, ORNG_MAX_FILEPATH_SIZE);
 			ser.container1b(sound_data, UINT64_MAX);
+			// After the data so .osound files written before load modes existed still read
+			ser.value1b(static_cast<uint8_t>(sound.load_mode));
 		}
 
 		template<typename S>
@@ -343,6 +403,38 @@ namespace ORNG {
 			des.object(sound.uuid);
 			des.text1b(sound.filepath, ORNG_MAX_FILEPATH_SIZE);
 			des.container1b(raw_data, UINT64_MAX);
+			DeserializeSoundLoadMode(sound, des);
+		}
+
+		// Reads up to the sound's encoded data and returns its size, leaving "des" at the start of it so the data can be streamed from where it is instead of read
+		// The rest of the layout is read with DeserializeSoundLoadMode once the data has been skipped
+		template<typename S>
+		static uint64_t DeserializeSoundAssetHeader(SoundAsset& sound, S& des) {
+			des.object(sound.uuid);
+			des.text1b(sound.filepath, ORNG_MAX_FILEPATH_SIZE);
+
+			// The size prefix container1b writes, 1, 2 or 4 bytes depending on the size
+			uint8_t high_byte = 0;
+			des.value1b(high_byte);
+			if (high_byte < 0x80u)
+				return high_byte;
+
+			uint8_t low_byte = 0;
+			des.value1b(low_byte);
+			if (!(high_byte & 0x40u))
+				return ((high_byte & 0x7Fu) << 8) | low_byte;
+
+			uint16_t low_word = 0;
+			des.value2b(low_word);
+			return (static_cast<uint64_t>(((high_byte & 0x3Fu) << 8) | low_byte) << 16) | low_word;
+		}
+
+		template<typename S>
+		static void DeserializeSoundLoadMode(SoundAsset& sound, S& des) {
+			uint8_t load_mode = 0;
+			des.value1b(load_mode);
+			// Files from before load modes existed end at the data
+			sound.load_mode = des.adapter().error() == bitsery::ReaderError::NoError ? static_cast<SoundAsset::LoadMode>(load_mode) : SoundAsset::LoadMode::AUTO;
 		}
 
 		template<typename S>
@@ -413,19 +505,86 @@ namespace ORNG {
 			data.p_material->setRestitution(r);
 		}
 
+		struct AssetRecord {
+			Asset* p_asset = nullptr;
+			// type_id of the concrete asset type, lets typed lookups avoid a dynamic_cast
+			uint16_t type_id = 0;
+			// Key the asset is stored under in m_filepath_index, empty if it isn't
+			// Kept so the entry can be removed even if Asset::filepath was written directly or the project directory changed since
+			std::string path_key;
+			// Key the asset is stored under in m_source_path_index, empty unless hot reload is watching its source file
+			std::string source_key;
+		};
+
+		template<std::derived_from<Asset> T>
+		static T* CastAssetRecord(const AssetRecord& record) {
+			if (record.type_id == type_id<T>)
+				return static_cast<T*>(record.p_asset);
+
+			// Lookups through a base type (e.g TextureBase) still work, just slower
+			return dynamic_cast<T*>(record.p_asset);
+		}
+
+		// Strips separators, dots and the project directory (the working directory if no project is set) so paths compare the same way Asset::PathEqualTo does
+		static std::string NormalizeAssetPath(const std::string& filepath);
+
+		// Adds/removes the record's asset to/from m_filepath_index, keeping AssetRecord::path_key in sync
+		void IndexAssetPath(uint64_t uuid, AssetRecord& record);
+		void UnindexAssetPath(uint64_t uuid, AssetRecord& record);
+
+		// Watches the source file of the record's asset (see GetHotReloadSourcePath) and adds it to m_source_path_index, a file shared by several assets is unwatched with the last of them
+		void WatchAssetSource(uint64_t uuid, AssetRecord& record);
+		void UnwatchAssetSource(uint64_t uuid, AssetRecord& record);
+
+		void RegisterAsset(Asset* p_asset, uint16_t asset_type_id);
+
+		// Removes the asset from every lookup structure without deleting it or dispatching events
+		void UnregisterAsset(uint64_t uuid);
+
+		void RemoveMaterialDependencies(const Material* p_material);
+
+		// Creates, deserializes and registers an asset from its binary file, "read_path" is opened and the asset is given "asset_filepath"
+		// Returns nullptr if the file doesn't exist
+		static Asset* LoadAssetFromBinaryFile(AssetType type, const std::string& read_path, const std::string& asset_filepath);
+
+		static void LoadScriptAssets(const std::string& script_folder, bool precompiled_scripts);
+
+		// Registers an empty texture/mesh under the manifest entry's uuid so it can be referenced before its data is streamed in
+		void AddStreamingPlaceholder(const AssetManifestEntry& entry);
+
+		// Called each frame, starts file reads for the highest priority requests and uploads finished ones within the per-frame byte budget
+		void UpdateStreaming();
+
+		// Fills a placeholder with the data read from its binary file
+		void FinaliseStreamedAsset(Asset* p_asset, AssetType type, std::vector<std::byte>& file_data);
+
+		void LoadDeferredAsset(uint64_t uuid);
+
 		// Loads all base assets (assets the engine runtime requires) that require an external file, e.g the sphere mesh needs to be loaded from a binary file. These files are always present in the "res/core-res" folder of a project
 		void LoadExternalBaseAssets(const std::string& project_dir);
 
 		void IOnShutdown();
 		void ISerializeAssets();
 
+		void IEnableHotReload(const std::string& project_dir);
+		void IDisableHotReload();
+
+		// Called each frame, dispatches reimports for the latest batch of changed files and swaps in any that have finished
+		void UpdateHotReload();
+		void ReimportTexture(Texture2D* p_tex);
+		void ReimportSound(SoundAsset* p_sound);
+
+		// Source files are watched directly rather than the binaries in the project, as that is what gets edited
+		static const std::string& GetHotReloadSourcePath(const Asset* p_asset);
+
 		static void OnTextureDelete(Texture2D* p_tex);
 
 		// Intialize PxMaterial
 		static void InitPhysXMaterialAsset(PhysXMaterialAsset& asset);
 
 		static void LoadMeshAssetIntoGL(MeshAsset* asset);
-		static Texture2D* CreateMeshAssetTexture(const std::string& dir, const aiTextureType& type, const aiMaterial* p_material);
+		// Returns nullptr if "relative_path" is empty
+		static Texture2D* CreateMeshAssetTexture(const std::string& dir, const std::string& relative_path, bool srgb);
 		void IStallUntilMeshesLoaded();
 
 		static void DispatchAssetEvent(Events::AssetEventType type, uint8_t* data_payload);
@@ -452,7 +611,28 @@ namespace ORNG {
 		// Default-initialize audio components with this sound asset
 		std::unique_ptr<SoundAsset> mp_base_sound = nullptr;
 
-		std::unordered_map<uint64_t, Asset*> m_assets;
+		std::unordered_map<uint64_t, AssetRecord> m_assets;
+
+		struct TypedAssetStorage {
+			std::vector<Asset*> assets;
+			std::unordered_map<uint64_t, uint32_t> uuid_to_index;
+		};
+
+		// Dense per-type storage keyed by type_id, base assets are excluded as views never contain them
+		std::unordered_map<uint16_t, TypedAssetStorage> m_typed_assets;
+
+		// Normalized filepath -> uuid, multiple assets can share a path (e.g a mesh and a material generated from it)
+		std::unordered_multimap<std::string, uint64_t> m_filepath_index;
+		// Normalized like the keys of m_filepath_index
+		std::string m_project_dir_key;
+
+		// Normalized hot reload source filepath (a texture's image, a sound's source file) -> uuid, only filled while hot reload is enabled
+		// Asset::filepath is the serialized binary for these, so m_filepath_index can't map a changed source file to its assets
+		std::unordered_multimap<std::string, uint64_t> m_source_path_index;
+
+		// Texture -> materials using it, and material -> textures it was last indexed with so stale entries can be removed
+		std::unordered_map<const Texture2D*, std::vector<Material*>> m_texture_users;
+		std::unordered_map<const Material*, std::array<Texture2D*, 7>> m_material_textures;
 
 		// Update listener checks if futures in m_mesh_loading_queue are ready and handles them if they are
 		Events::EventListener<Events::EngineCoreEvent> m_update_listener;
@@ -461,5 +641,52 @@ namespace ORNG {
 
 		// Used for texture loading
 		GLFWwindow* mp_loading_context = nullptr;
+
+		// Only one thread can have the loading context current at a time
+		std::mutex m_loading_context_mutex;
+
+		AssetFileWatcher m_file_watcher;
+
+		// Reimports are tracked by uuid, the asset may be deleted before they finish
+		struct PendingTextureReload {
+			uint64_t uuid;
+			std::future<std::unique_ptr<Texture2D>> staging_texture;
+		};
+
+		struct PendingSoundReload {
+			uint64_t uuid;
+			std::future<std::unique_ptr<SoundAsset>> staging_sound;
+		};
+
+		std::vector<PendingTextureReload> m_pending_texture_reloads;
+		std::vector<PendingSoundReload> m_pending_sound_reloads;
+
+		struct StreamRequest {
+			Asset* p_asset = nullptr;
+			AssetType type = AssetType::TEXTURE;
+			uint64_t size_bytes = 0;
+			float camera_distance = std::numeric_limits<float>::max();
+		};
+
+		struct InFlightStreamRequest {
+			StreamRequest request;
+			std::future<std::vector<std::byte>> file_data;
+		};
+
+		// Sorted so the highest priority request is at the back
+		std::vector<StreamRequest> m_streaming_queue;
+		std::vector<InFlightStreamRequest> m_streams_in_flight;
+
+		// Manifest entries of assets outside the active scene's closure, loaded synchronously if they are requested
+		std::unordered_map<uint64_t, AssetManifestEntry> m_deferred_assets;
+
+		static constexpr unsigned MAX_STREAMS_IN_FLIGHT = 4;
+
+		// Streamed assets are decoded and uploaded on the main thread, cap how much of this is done each frame to avoid hitches
+		static constexpr uint64_t STREAMING_BYTE_BUDGET_PER_FRAME = 16'000'000;
+
+		TimeStep m_streaming_timer{ TimeStep::TimeUnits::MILLISECONDS };
+		uint64_t m_streamed_bytes = 0;
+		unsigned m_num_streamed_assets = 0;
 	};
 }
\ No newline at end of file
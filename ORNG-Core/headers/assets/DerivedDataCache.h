@@ -0,0 +1,77 @@
+#pragma once
+
+namespace ORNG {
+	/*
+		Local on-disk cache for data that is expensive to derive from a source file, e.g imported mesh data or decoded texture pixels.
+		Entries are keyed by a hash of the source bytes, the settings used to process them and the version of the output format, so changing any of these produces a new key and stale entries are never read.
+		The cache directory is shared between projects and can be copied between machines (e.g a CI job) to skip the work entirely.
+		Once the size limit is exceeded the least recently used entries are evicted. Thread-safe.
+	*/
+	class DerivedDataCache {
+	public:
+		struct Stats {
+			uint64_t hits = 0;
+			uint64_t misses = 0;
+			uint64_t writes = 0;
+			uint64_t evictions = 0;
+			uint64_t total_bytes = 0;
+			uint64_t num_entries = 0;
+		};
+
+		static DerivedDataCache& Get() {
+			static DerivedDataCache s_instance;
+			return s_instance;
+		}
+
+		// Scans "cache_dir" for existing entries, the cache does nothing until this is called
+		static void Init(const std::string& cache_dir, uint64_t max_size_bytes = DEFAULT_MAX_SIZE_BYTES) { Get().IInit(cache_dir, max_size_bytes); }
+
+		// Next to the executable, or the directory in the ORNG_DDC_DIR environment variable if it's set (e.g for a cache shared by CI jobs)
+		static std::string GetDefaultDirectory();
+
+		// Bump "format_version" whenever the layout of the derived data changes, "settings" should describe every option that affects the output
+		static uint64_t MakeKey(const std::vector<std::byte>& source_data, const std::string& settings, uint32_t format_version);
+
+		// For sources that aren't a single file, "source_hash" should cover all of the source data (see HashBytes)
+		static uint64_t MakeKey(uint64_t source_hash, const std::string& settings, uint32_t format_version);
+
+		// Returns false on a miss, "output" is left untouched
+		static bool Load(uint64_t key, std::vector<std::byte>& output) { return Get().ILoad(key, output); }
+
+		static void Store(uint64_t key, const std::vector<std::byte>& data) { Get().IStore(key, data); }
+
+		// Evicts least recently used entries until the cache takes up at most "max_size_bytes"
+		static void Prune(uint64_t max_size_bytes) { Get().IPrune(max_size_bytes); }
+
+		static void Clear() { Get().IPrune(0); }
+
+		static void SetMaxSize(uint64_t max_size_bytes);
+
+		static Stats GetStats();
+
+		static constexpr uint64_t DEFAULT_MAX_SIZE_BYTES = 4'000'000'000;
+
+	private:
+		void IInit(const std::string& cache_dir, uint64_t max_size_bytes);
+		bool ILoad(uint64_t key, std::vector<std::byte>& output);
+		void IStore(uint64_t key, const std::vector<std::byte>& data);
+		void IPrune(uint64_t max_size_bytes);
+
+		// Expects m_mutex to be locked
+		void PruneUnlocked(uint64_t max_size_bytes);
+
+		std::string GetEntryPath(uint64_t key) const;
+
+		struct Entry {
+			uint64_t size_bytes = 0;
+			// Persisted as the file's last write time, which is bumped on every hit
+			std::filesystem::file_time_type last_access;
+		};
+
+		std::mutex m_mutex;
+		std::unordered_map<uint64_t, Entry> m_entries;
+		std::string m_directory;
+		uint64_t m_max_size_bytes = DEFAULT_MAX_SIZE_BYTES;
+		Stats m_stats;
+	};
+}
@@ -9,12 +9,54 @@ namespace ORNG {
 		SoundAsset(const std::string& t_filepath) : Asset(t_filepath) {};
 		~SoundAsset();
 
+		enum class LoadMode : uint8_t {
+			// Streams if the encoded data is at least STREAM_SIZE_THRESHOLD bytes, decodes otherwise
+			AUTO,
+			// Decoded into memory once on load, cheap to play many times at once
+			DECODE,
+			// Read from disk as it plays through a small buffer, for music and long ambience
+			STREAM,
+		};
+
+		// Where a streamed sound's encoded data lives, either a whole source file or a byte range of an .osound file or asset package
+		struct StreamSource {
+			std::string filepath;
+			uint64_t offset = 0;
+			uint64_t size = 0;
+		};
+
+		// A 1MB mp3 is around a minute of audio and over 10MB decoded
+		static constexpr uint64_t STREAM_SIZE_THRESHOLD = 1024 * 1024;
+		// Bytes each stream reads from disk at a time, the decoded prebuffer is FMOD's default
+		static constexpr unsigned STREAM_FILE_BUFFER_SIZE = 16 * 1024;
+
+		static bool ShouldStream(LoadMode mode, uint64_t encoded_size) {
+			return mode == LoadMode::STREAM || (mode == LoadMode::AUTO && encoded_size >= STREAM_SIZE_THRESHOLD);
+		}
+
+		// For streamed sounds this is only used to query the sound, each channel playing it opens its own stream with OpenStream
 		FMOD::Sound* p_sound = nullptr;
 
 		std::string source_filepath;
 
+		LoadMode load_mode = LoadMode::AUTO;
+
+		// Empty unless the sound is streamed
+		StreamSource stream_source;
+
+		bool IsStreamed() const {
+			return !stream_source.filepath.empty();
+		}
+
+		// Decodes or streams source_filepath depending on load_mode
 		void CreateSoundFromFile();
 		void CreateSoundFromBinary(const std::vector<std::byte>& data);
+		// Streams "size" bytes starting at "offset" in "filepath", which must stay on disk for as long as the sound is used
+		void CreateStreamFromFile(const std::string& filepath, uint64_t offset, uint64_t size);
+
+		// FMOD streams can only be played by one channel at a time, returns a new stream of stream_source that the caller releases
+		// Returns nullptr if the sound isn't streamed or the stream can't be opened
+		FMOD::Sound* OpenStream(bool looped) const;
 
 	};
-}
\ No newline at end of file
+}
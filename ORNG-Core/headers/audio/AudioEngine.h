@@ -20,7 +20,13 @@ namespace ORNG {
 			return Get().mp_system;
 		}
 
-		static void Init() { Get().I_Init(); }
+		// "no_output" mixes without an audio device (FMOD_OUTPUTTYPE_NOSOUND), for benches and headless machines
+		static void Init(bool no_output = false) { Get().I_Init(no_output); }
+
+		// Software channels FMOD mixes, an AudioSystem's default voice budget (VoiceManager::DEFAULT_MAX_REAL_VOICES) leaves room below this for other scenes
+		static constexpr int MAX_SOFTWARE_CHANNELS = 64;
+		// Channel handles FMOD can hand out, including ones it virtualizes itself
+		static constexpr int MAX_CHANNELS = 512;
 
 		~AudioEngine();
 
@@ -31,6 +37,6 @@ namespace ORNG {
 		}
 
 		FMOD::System* mp_system = nullptr;
-		void I_Init();
+		void I_Init(bool no_output);
 	};
 }
\ No newline at end of file
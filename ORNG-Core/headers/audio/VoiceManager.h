@@ -0,0 +1,95 @@
+#pragma once
+#include <span>
+
+namespace ORNG {
+	/*
+		Decides which playing sounds get a real FMOD channel. Every update each voice is scored by how loud it would be at the listener (volume, distance attenuation and priority) and only the highest scoring voices, up to the budget, stay real.
+		The rest are virtual: they have no channel, but their playback position keeps advancing so they resume where they would have been once they're audible again.
+		Knows nothing about FMOD, the owner applies the transitions it reports (see AudioSystem) so the scoring and virtualization can be driven without an audio device.
+	*/
+	class VoiceManager {
+	public:
+		struct Voice {
+			// Inputs, refreshed by the owner before every update
+			glm::vec3 pos{ 0, 0, 0 };
+			float volume = 1.f;
+			float pitch = 1.f;
+			// 0 is fully 2D, 1 fully attenuated by distance
+			float level_3d = 1.f;
+			float min_range = 0.1f;
+			float max_range = 10000.f;
+			// Multiplies the audibility score, a voice with priority 2 keeps its channel over one twice as loud with priority 1
+			float priority = 1.f;
+			bool is_2d = false;
+			bool looped = false;
+			bool paused = false;
+			// Length of the sound, 0 if unknown in which case the voice never finishes while virtual
+			unsigned length_ms = 0;
+
+			// Managed by VoiceManager
+			bool is_virtual = true;
+			double position_ms = 0.0;
+			float audibility = 0.f;
+		};
+
+		// Attenuation matches FMOD_3D_LINEARROLLOFF, which every AudioComponent uses
+		static float ScoreAudibility(const Voice& voice, glm::vec3 listener_pos);
+
+		// Scores "voices", picks which ones are real and advances virtual voices by "dt_ms"
+		// Indices of voices that changed state or finished are available through the getters below until the next update
+		// "voices" is expected to hold only playing voices, voices added since the last update should be virtual with their starting position set
+		void Update(std::span<Voice* const> voices, glm::vec3 listener_pos, float dt_ms);
+
+		// Were real, owner should store their channel's position in "position_ms" and release the channel
+		const std::vector<uint32_t>& GetVoicesToVirtualize() const {
+			return m_to_virtualize;
+		}
+
+		// Were virtual, owner should start a channel at "position_ms"
+		const std::vector<uint32_t>& GetVoicesToRealize() const {
+			return m_to_realize;
+		}
+
+		// Virtual voices that reached the end of their sound, owner should stop them
+		const std::vector<uint32_t>& GetFinishedVoices() const {
+			return m_finished;
+		}
+
+		void SetMaxRealVoices(unsigned max_real_voices) {
+			m_max_real_voices = max_real_voices;
+		}
+
+		unsigned GetMaxRealVoices() const {
+			return m_max_real_voices;
+		}
+
+		struct Stats {
+			unsigned real_voices = 0;
+			unsigned virtual_voices = 0;
+			// Transitions during the last update
+			unsigned virtualized = 0;
+			unsigned realized = 0;
+		};
+
+		const Stats& GetStats() const {
+			return m_stats;
+		}
+
+		// Voices quieter than this are virtual even when there's budget left for them
+		static constexpr float MIN_AUDIBILITY = 0.001f;
+		// Real voices score this much higher when ranked, so two voices of similar audibility near the budget cutoff don't swap channels every frame
+		static constexpr float REAL_VOICE_BIAS = 1.1f;
+		static constexpr unsigned DEFAULT_MAX_REAL_VOICES = 48;
+
+	private:
+		unsigned m_max_real_voices = DEFAULT_MAX_REAL_VOICES;
+
+		// Reused every update
+		std::vector<uint32_t> m_ranked;
+		std::vector<uint32_t> m_to_virtualize;
+		std::vector<uint32_t> m_to_realize;
+		std::vector<uint32_t> m_finished;
+
+		Stats m_stats;
+	};
+}
@@ -1,11 +1,12 @@
 #ifndef AUDIOCOMP_H
 #define AUDIOCOMP_H
 #include "Component.h"
+#include "audio/VoiceManager.h"
 
 namespace FMOD {
 	class Channel;
+	class Sound;
 }
-struct FMOD_VECTOR;
 
 namespace ORNG {
 	constexpr uint64_t INVALID_SOUND_UUID = 0;
@@ -51,15 +52,33 @@ namespace ORNG {
 		void SetPan(float pan);
 		void Set3DOcclusion(float occlusion);
 
+		// Scales how audible this sound is considered when the AudioSystem decides which sounds get real channels, see VoiceManager
+		void SetPriority(float priority) {
+			m_priority = priority;
+		}
+
+		float GetPriority() const {
+			return m_priority;
+		}
+
 		float GetVolume();
 		float GetPitch();
 		AudioRange GetMinMaxRange();
 		bool IsPlaying();
 		bool IsPaused();
+		// True if the sound is playing without a real channel because it's inaudible or outscored by other sounds, it resumes where it would have been once it gets one back
+		bool IsVirtual() const {
+			return m_is_playing && !mp_channel;
+		}
 		// Returns playback position in ms
 		unsigned int GetPlaybackPosition();
 		uint64_t GetAudioAssetUUID() { return m_sound_asset_uuid; }
 
+		// Derived by AudioSystem from how far the entity moved over the last frame, in units per second
+		glm::vec3 GetVelocity() const {
+			return m_velocity;
+		}
+
 		enum class AudioEventType {
 			PLAY,
 		};
@@ -67,6 +86,9 @@ namespace ORNG {
 	private:
 		void DispatchAudioEvent(std::any data, Events::ECS_EventType event_type, uint32_t sub_event_type);
 
+		// Stops the channel and releases the stream it was playing if the sound is streamed
+		void ReleaseChannel();
+
 		uint64_t m_sound_asset_uuid = INVALID_SOUND_UUID;
 		uint32_t mode;
 		// Have to store a copy of this state here because it's not retrievable in the channel if the channel isn't actively playing
@@ -75,16 +97,29 @@ namespace ORNG {
 		float m_level_3d = 1.f;
 		float m_occlusion = 0.f;
 		float m_pan = 0.f;
+		float m_priority = 1.f;
 
 		bool is_looped = false;
 		AudioRange m_range{ 0.1f, 10000.f };
 
 
-		// Memory managed by AudioSystem
-		FMOD_VECTOR* mp_fmod_pos = nullptr;
-		FMOD_VECTOR* mp_fmod_vel = nullptr;
+		// Set once per update by AudioSystem from the entity's transform, velocity is in units per second
+		// Passed to FMOD directly, FMOD_VECTOR has the same layout
+		glm::vec3 m_position{ 0, 0, 0 };
+		glm::vec3 m_velocity{ 0, 0, 0 };
+		// Queued in AudioSystem to have its attributes updated
+		bool m_attributes_dirty = false;
+		// AudioSystem update the source last moved in
+		uint64_t m_last_moved_update = 0;
 
+		// Null while the sound is stopped or virtual
 		FMOD::Channel* mp_channel = nullptr;
+		// The stream mp_channel plays if the sound asset is streamed, owned by this component as a stream can't be shared between channels
+		FMOD::Sound* mp_stream = nullptr;
+
+		bool m_is_playing = false;
+		// Scoring inputs are refreshed by AudioSystem every update, the virtual playback position is kept here while there's no channel
+		VoiceManager::Voice m_voice;
 	};
 }
 
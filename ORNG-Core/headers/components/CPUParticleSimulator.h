@@ -0,0 +1,99 @@
+#pragma once
+#include <span>
+
+namespace ORNG {
+	class ParticleEmitterComponent;
+	class InterpolatorV1;
+	class InterpolatorV3;
+
+	/*
+		Simulates one emitter's particles on the CPU, mirroring ParticleCS.glsl and InitializeParticle in ParticleBuffersINCL.glsl so both backends produce the same particles from the same state and timesteps.
+		Each particle attribute is its own array, updated in blocks of BLOCK_SIZE particles spread over worker threads. The per-attribute loops have no branches or calls so the compiler can vectorize them, respawning is the only scalar pass.
+		ParticleSystem uses one per emitter set to SimulationBackend::CPU and uploads its particles every frame, it can also be driven without a GPU for testing and benchmarking.
+	*/
+	class CPUParticleSimulator {
+	public:
+		// Emitter state the simulation reads, the same values ParticleSystem writes to the emitter SSBO
+		struct EmitterParams {
+			glm::vec3 pos{ 0, 0, 0 };
+			glm::mat3 rotation{ 1 };
+			glm::vec3 spawn_extents{ 0, 0, 0 };
+			glm::vec3 acceleration{ 0, 0, 0 };
+			float vel_scale_min = 0.f;
+			float vel_scale_max = 0.f;
+			// Radians
+			float spread = 0.f;
+			float lifespan_ms = 1000.f;
+			float spawn_delay_ms = 0.f;
+			// Index of the emitter's first particle in ParticleSystem's particle SSBO, particles are seeded with their index in it
+			unsigned start_index = 0;
+			bool active = true;
+
+			static EmitterParams FromEmitter(ParticleEmitterComponent& emitter);
+		};
+
+		// Matches the std140 layout of Particle in ParticleBuffersINCL.glsl
+		struct GPUParticle {
+			glm::vec4 pos;
+			glm::vec4 quat;
+			glm::vec4 scale;
+			glm::vec4 velocity_life;
+			uint32_t emitter_index;
+			uint32_t flags;
+			uint32_t padding[2];
+		};
+		static_assert(sizeof(GPUParticle) == 80);
+
+		struct Particles {
+			std::vector<float> pos_x, pos_y, pos_z;
+			std::vector<float> vel_x, vel_y, vel_z;
+			std::vector<float> life;
+			// 0 until the particle first spawns, 1 after
+			std::vector<float> scale;
+
+			// Interpolator values over life, sampled from the same lookup tables as the particle shaders
+			std::vector<float> colour_r, colour_g, colour_b;
+			std::vector<float> life_scale_x, life_scale_y, life_scale_z;
+			std::vector<float> alpha;
+
+			void Resize(unsigned num_particles);
+		};
+
+		static constexpr unsigned BLOCK_SIZE = 16 * 1024;
+
+		// Sets up "num_particles" particles the way ParticleInitializerCS.glsl does, "dt_ms" is the timestep their spawn positions are seeded with
+		void Init(const EmitterParams& params, unsigned num_particles, float dt_ms);
+
+		// Advances every particle by "dt_ms" like ParticleCS.glsl, then samples the interpolators' baked lookup tables at each particle's point in its life
+		void Update(const EmitterParams& params, float dt_ms, const InterpolatorV3& colour, const InterpolatorV3& scale, const InterpolatorV1& alpha);
+
+		// Replaces the simulated particles with ones read back from the GPU
+		void ReadGPUParticles(std::span<const GPUParticle> particles);
+
+		// Writes GetNbParticles() particles, "emitter_index" is the index of the emitter in the emitter SSBO
+		void WriteGPUParticles(std::span<GPUParticle> particles, unsigned emitter_index) const;
+
+		unsigned GetNbParticles() const {
+			return static_cast<unsigned>(m_particles.life.size());
+		}
+
+		const Particles& GetParticles() const {
+			return m_particles;
+		}
+
+		// Threads blocks are spread over, 0 uses one per hardware thread
+		void SetMaxWorkers(unsigned max_workers) {
+			m_max_workers = max_workers;
+		}
+
+	private:
+		void UpdateBlock(const EmitterParams& params, float dt_ms, unsigned begin, unsigned end, const InterpolatorV3& colour, const InterpolatorV3& scale, const InterpolatorV1& alpha);
+
+		// InitializeParticle in ParticleBuffersINCL.glsl
+		void Respawn(const EmitterParams& params, unsigned i, float dt_ms, bool first_initialization);
+
+		Particles m_particles;
+
+		unsigned m_max_workers = 0;
+	};
+}
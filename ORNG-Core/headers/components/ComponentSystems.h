@@ -5,10 +5,12 @@
 
 #include "physx/PxPhysicsAPI.h"
 #include "physx/vehicle2/PxVehicleAPI.h"
+#include "physics/Physics.h"
 
 #include "scripting/ScriptShared.h"
 #include "rendering/VAO.h"
 #include "components/ParticleBufferComponent.h"
+#include "components/CPUParticleSimulator.h"
 #include "scene/Scene.h"
 
 namespace physx {
@@ -42,6 +44,9 @@ namespace ORNG {
 
 		virtual void OnUpdate() {};
 
+		// Called once scripts have updated and queued entity deletions have been processed
+		virtual void OnPostUpdate() {};
+
 		virtual void OnLoad() {};
 
 		virtual void OnUnload() {};
@@ -59,18 +64,86 @@ namespace ORNG {
 		void OnLoad();
 		void OnUnload();
 		void OnUpdate();
+
+		// Real and virtual voice counts from the last update
+		const VoiceManager::Stats& GetVoiceStats() const {
+			return m_voice_manager.GetStats();
+		}
+
+		// Playing sounds beyond this are virtualized, quietest first
+		void SetMaxRealVoices(unsigned max_real_voices) {
+			m_voice_manager.SetMaxRealVoices(max_real_voices);
+		}
+
+		unsigned GetMaxRealVoices() const {
+			return m_voice_manager.GetMaxRealVoices();
+		}
+
+		struct AttributeStats {
+			// Transform changes seen on entities since the previous update, including ones without an AudioComponent
+			unsigned transform_events = 0;
+			// Sources whose position was re-read last update, however many times they moved
+			unsigned moved_sources = 0;
+			// set3DAttributes calls last update, only sources with a real channel need one
+			unsigned channel_updates = 0;
+		};
+
+		const AttributeStats& GetAttributeStats() const {
+			return m_attribute_stats;
+		}
+
+		// Faster than this (units per second) between two updates is treated as a teleport, and the velocity is zeroed so doppler doesn't shift the pitch to nothing
+		static constexpr float MAX_DOPPLER_SPEED = 200.f;
 	private:
+		// Reads the positions of sources that moved since the last update, derives their velocities and sets each one's channel attributes once
+		void UpdateSourceAttributes(float dt);
+
+		static glm::vec3 GetVelocity(glm::vec3 prev_pos, glm::vec3 pos, float dt);
+
+		// Scores every playing sound, then starts or stops channels for the voices VoiceManager moved between real and virtual
+		void UpdateVoices();
+
+		// Starts a channel for "asset" with the component's state, at its voice's playback position
+		bool StartChannel(AudioComponent& comp, SoundAsset& asset);
 
 		void OnAudioDeleteEvent(const Events::ECS_Event<AudioComponent>& e_event);
 		void OnAudioUpdateEvent(const Events::ECS_Event<AudioComponent>& e_event);
 		void OnAudioAddEvent(const Events::ECS_Event<AudioComponent>& e_event);
 		void OnTransformEvent(const Events::ECS_Event<TransformComponent>& e_event);
+		// Queues the transform's AudioComponent, if it has one, for UpdateSourceAttributes
+		void MarkSourceMoved(TransformComponent* p_transform);
+
+		// Restarts the channels playing "asset" on its new sound where they were, virtual voices just take the new length
+		void OnSoundReloaded(SoundAsset& asset);
 
 		Events::ECS_EventListener<AudioComponent> m_audio_listener;
 		Events::ECS_EventListener<TransformComponent> m_transform_listener;
+		Events::EventListener<Events::PhysicsMovedEvent> m_physics_listener;
+		Events::EventListener<Events::AssetEvent> m_asset_listener;
 
 		FMOD::ChannelGroup* mp_channel_group = nullptr;
 
+		VoiceManager m_voice_manager;
+		// Playing components and their voices in the same order, rebuilt every update
+		std::vector<AudioComponent*> m_playing_sources;
+		std::vector<VoiceManager::Voice*> m_voices;
+		glm::vec3 m_listener_pos{ 0, 0, 0 };
+		glm::vec3 m_listener_vel{ 0, 0, 0 };
+		// False until the first update with an active camera, so the listener doesn't start with a velocity from the origin
+		bool m_has_listener = false;
+
+		// Sources whose transform changed since the last update, each once (see AudioComponent::m_attributes_dirty)
+		// Held as entities since deleting any AudioComponent can move others in the registry's storage
+		std::vector<entt::entity> m_moved_sources;
+		// Sources with a non-zero velocity, zeroed once they stop moving
+		std::vector<entt::entity> m_moving_sources;
+		std::vector<entt::entity> m_next_moving_sources;
+		uint64_t m_update_index = 0;
+		unsigned m_num_transform_events = 0;
+		AttributeStats m_attribute_stats;
+		// Channels in use, counted by UpdateVoices and incremented by sounds started since, so sounds played within a frame stay within the budget
+		unsigned m_num_real_voices = 0;
+
 		// Points to memory in scene's "CameraSystem" to find active camera
 		entt::entity* mp_active_cam_id;
 	};
@@ -84,10 +157,12 @@ namespace ORNG {
 
 		void OnUnload() override {
 			Events::EventManager::DeregisterListener((entt::entity)m_transform_event_listener.GetRegisterID());
+			Events::EventManager::DeregisterListener(m_physics_listener.GetRegisterID());
 		}
 	private:
-		void UpdateChildTransforms(const Events::ECS_Event<TransformComponent>&);
+		void UpdateChildTransforms(TransformComponent* p_transform, TransformComponent::UpdateType type);
 		Events::ECS_EventListener<TransformComponent> m_transform_event_listener;
+		Events::EventListener<Events::PhysicsMovedEvent> m_physics_listener;
 	};
 
 
@@ -144,16 +219,104 @@ namespace ORNG {
 	class PhysicsSystem : public ComponentSystem {
 		friend class EditorLayer;
 	public:
-		PhysicsSystem(Scene* p_scene);
+		// Secondary scenes (previews, tools) should use PhysicsDispatcherPool::BACKGROUND so they don't compete with the main scene for workers
+		PhysicsSystem(Scene* p_scene, PhysicsDispatcherPool dispatcher_pool = PhysicsDispatcherPool::MAIN);
 		virtual ~PhysicsSystem() = default;
 
 		void OnUpdate() override;
+		void OnPostUpdate() override;
 		void OnUnload() override;
 		void OnLoad() override;
+		// Returns nullptr while the mesh is being loaded from the derived data cache or cooked in the background, while the mesh asset has no vertex data (e.g a streaming placeholder) and if cooking failed
+		// Components waiting on a triangle mesh have their bounding box stand-in disabled, so they neither collide nor show up in queries until it's ready
+		// Static/kinematic ones are level geometry, so steps wait for them rather than simulating without them, see PrepareLevelCollisionMeshes
 		physx::PxTriangleMesh* GetOrCreateTriangleMesh(const MeshAsset* p_mesh_data);
 
-		RaycastResults Raycast(glm::vec3 origin, glm::vec3 unit_dir, float max_distance);
-		OverlapQueryResults OverlapQuery(PxGeometry& geom, glm::vec3 pos, unsigned max_hits);
+		// Single convex hull around the mesh's vertices, usable by dynamic bodies unlike triangle meshes, same loading/caching behaviour as GetOrCreateTriangleMesh
+		physx::PxConvexMesh* GetOrCreateConvexMesh(const MeshAsset* p_mesh_data);
+
+		// Cooks a hull around "positions" (xyz triples) with the same settings as convex mesh colliders, bypassing the derived data cache
+		// For tools and checks, the caller owns the returned mesh, nullptr if cooking failed
+		static physx::PxConvexMesh* CookConvexHull(std::span<const float> positions);
+
+		// Static actors not owned by an entity (e.g terrain colliders), they collide on WORLD_ACTOR_LAYER and query hits against them have no entity
+		// The caller keeps ownership and must remove them before the scene is unloaded
+		void AddWorldActor(physx::PxRigidStatic* p_actor);
+		void RemoveWorldActor(physx::PxRigidStatic* p_actor);
+
+		static constexpr uint8_t WORLD_ACTOR_LAYER = 0;
+
+		// Blocks until every pending triangle/convex mesh job has finished and the colliders using them have been rebuilt
+		void WaitForCollisionMeshCooking() { ProcessCollisionMeshJobs(true, true); }
+
+		bool IsCookingCollisionMeshes() const { return !m_triangle_mesh_jobs.empty() || !m_convex_mesh_jobs.empty(); }
+
+		struct CollisionMeshCookingReport {
+			unsigned num_loaded = 0;
+			unsigned num_cooked = 0;
+			float total_load_ms = 0.f;
+			float total_cook_ms = 0.f;
+		};
+
+		const CollisionMeshCookingReport& GetCollisionMeshCookingReport() const { return m_collision_mesh_report; }
+
+		// Cumulative over the system's lifetime, how scale changes reached the shapes
+		struct ColliderScaleStats {
+			// Resized in place with setGeometry
+			unsigned shapes_rescaled = 0;
+			// Geometry type couldn't be rescaled (e.g a mesh stand-in being swapped), so the whole collider was rebuilt
+			unsigned shapes_rebuilt = 0;
+		};
+
+		const ColliderScaleStats& GetColliderScaleStats() const { return m_collider_scale_stats; }
+
+		// Summed over every step taken this frame, for comparing how many pairs the simulation generated against how many were actually reported
+		struct ContactStats {
+			// New broadphase pairs dropped by the filter shader (non-interacting layers, triggers with no listeners)
+			unsigned pairs_filtered = 0;
+			// Pairs that went through narrowphase, and how many of those are touching
+			unsigned contact_pairs = 0;
+			unsigned touching_pairs = 0;
+			// Pairs delivered to onContact/onTrigger
+			unsigned reported_contacts = 0;
+			unsigned reported_triggers = 0;
+		};
+
+		const ContactStats& GetContactStats() const { return m_contact_stats; }
+
+		struct ActorStats {
+			// Rigid dynamics (including kinematics, vehicles and character controllers) that were awake/asleep in the frame's last step
+			unsigned active = 0;
+			unsigned sleeping = 0;
+			// Kinematic physics components in the scene, and how many were given a new target this frame
+			unsigned kinematic = 0;
+			unsigned kinematic_targets_set = 0;
+			unsigned statics_moved = 0;
+		};
+
+		const ActorStats& GetActorStats() const { return m_actor_stats; }
+
+		// From the last time poses were written to transforms, including the PhysicsMovedEvent listeners
+		struct WriteBackStats {
+			unsigned transforms_written = 0;
+			float write_back_ms = 0.f;
+		};
+
+		const WriteBackStats& GetWriteBackStats() const { return m_write_back_stats; }
+
+		RaycastResults Raycast(glm::vec3 origin, glm::vec3 unit_dir, float max_distance, uint32_t layer_mask = ALL_PHYSICS_LAYERS);
+		OverlapQueryResults OverlapQuery(PxGeometry& geom, glm::vec3 pos, unsigned max_hits, uint32_t layer_mask = ALL_PHYSICS_LAYERS);
+
+		// Batches are split across the PhysX dispatcher's worker threads (and the calling thread), see SI for the span requirements
+		void RaycastBatch(std::span<const RaycastQuery> queries, std::span<RaycastResults> results);
+		void SweepBatch(std::span<const SweepQuery> queries, std::span<RaycastResults> results);
+		void OverlapBatch(std::span<const OverlapSphereQuery> queries, std::span<OverlapBatchResult> results, std::span<SceneEntity*> hits, unsigned max_hits_per_query);
+
+		// Batches smaller than this run on the calling thread only
+		static constexpr unsigned MIN_QUERIES_PER_TASK = 64;
+
+		// Vehicles are far more expensive to step than a query, so they're split into much smaller ranges
+		static constexpr unsigned MIN_VEHICLES_PER_TASK = 4;
 
 		enum class ActorType : uint8_t {
 			RIGID_BODY,
@@ -164,8 +327,70 @@ namespace ORNG {
 
 		bool InitVehicle(VehicleComponent* p_comp);
 
+		// Upper limit on simulation steps per frame, if a frame takes longer than this many steps can cover the excess time is dropped
+		void SetMaxSubsteps(unsigned max_substeps) { m_max_substeps = glm::max(max_substeps, 1u); }
+		unsigned GetMaxSubsteps() const { return m_max_substeps; }
+
+		// How far between the last two simulation steps the transforms written this frame are, 0-1
+		float GetInterpolationAlpha() const { return m_interpolation_alpha; }
+
+		static constexpr float GetStepSize() { return m_step_size; }
+
+		/*
+			Pipelined stepping kicks off the frame's final step at the end of the gameplay update (OnPostUpdate) and fetches it at the start of the next update, so PhysX runs in parallel with rendering.
+			Transforms lag one frame further behind. The step is only in flight between OnPostUpdate and the next OnUpdate, PhysX actors can't be written to in that window.
+			Transform changes made while it's in flight (e.g from the editor) are queued and applied once the step has been fetched, adding, removing, rebuilding or changing the material of physics components waits for the step to finish first.
+			Other direct actor writes (forces, velocities) have to be made during the update, as scripts are.
+		*/
+		void SetPipelinedStepping(bool enabled) { if (!enabled) FetchInFlightStep(); m_pipelined_stepping = enabled; }
+		bool IsPipelinedStepping() const { return m_pipelined_stepping; }
+
+		// Vehicles are stepped across the dispatcher's workers before each simulation step, PhysX actor reads/writes for them stay on the stepping thread
+		void SetParallelVehicleStepping(bool enabled) { m_parallel_vehicle_stepping = enabled; }
+		bool IsParallelVehicleStepping() const { return m_parallel_vehicle_stepping; }
+
+		// Runs "num_steps" fixed steps right away regardless of frame time and writes the final poses, for tools and benchmarks that need deterministic stepping
+		void StepImmediate(unsigned num_steps);
+
+		// Runs the steps a frame of "frame_time_ms" covers the way a non-pipelined OnUpdate does (accumulator, substep limit, interpolated transforms), returns how many were run
+		// With pipelined stepping it does what OnUpdate and OnPostUpdate do, fetching the step the last call left in flight and leaving this frame's last step in flight, SetPipelinedStepping(false) fetches the final one
+		// For tools and benchmarks that supply their own frame times
+		unsigned StepFrame(float frame_time_ms);
+
+		PhysicsDispatcherPool GetDispatcherPool() const { return m_dispatcher_pool; }
+
 	private:
-		static void UpdateTransformCompFromGlobalPose(const PxTransform& pose, TransformComponent& transform, PhysicsSystem::ActorType type);
+		// Accumulates frame time and runs as many fixed steps as it covers (up to m_max_substeps), returns how many were started
+		unsigned RunSteps(float frame_time_ms, bool leave_last_in_flight);
+
+		// Called before a frame's first step, blocks until every static/kinematic triangle mesh that's cooking is ready
+		// Returns false if one is still waiting on its mesh asset's vertex data (e.g a streaming placeholder), in which case the step is held back
+		bool PrepareLevelCollisionMeshes();
+
+		// A step is split into kicking off the simulation and fetching it, which records the new poses of active actors
+		void BeginStep();
+		void EndStep();
+
+		// Blocks until a step left running by pipelined stepping has finished, no-op if there isn't one
+		void FetchInFlightStep();
+
+		// Writes transforms of moving actors, interpolated between their poses from the last two steps
+		void WriteInterpolatedPoses();
+
+		void RemoveInterpolatedPose(entt::entity entity);
+
+		// Calls "fn" with sub-ranges [begin, end) of [0, count) on this scene's dispatcher workers and the calling thread, returns once every range is done
+		void ParallelFor(unsigned count, const std::function<void(unsigned begin, unsigned end)>& fn, unsigned min_per_task = MIN_QUERIES_PER_TASK);
+
+		// Runs every vehicle's component sequence for one step, called before the scene is simulated
+		void StepVehicles();
+
+		// Writes the poses of static/kinematic actors whose transforms changed since the last call, each actor is written once however many transform events it had
+		// Called before each step and before scene queries so queries see moved statics
+		void FlushMovedActors();
+
+		// Fires queued OnCollision/OnTrigger script events and breaks joints flagged during the last steps
+		void ProcessEventQueues();
 
 		void InitComponent(PhysicsComponent* p_comp);
 		void InitComponent(CharacterControllerComponent* p_comp);
@@ -174,7 +399,23 @@ namespace ORNG {
 
 		void HandleComponentUpdate(const Events::ECS_Event<JointComponent>& t_event);
 		void UpdateComponentState(PhysicsComponent* p_comp);
+
+		// Rewrites the shape's filter data in place from its layer, collision mask and the PhysicsLayers matrix
+		void UpdateFilterData(PhysicsComponent* p_comp);
+		// Swaps the shape's material for the component's current one
+		void UpdateMaterial(PhysicsComponent* p_comp);
+		void UpdateFilterData(physx::PxRigidStatic* p_world_actor);
+
+		// Called when the PhysicsLayers matrix has changed
+		void RefreshFilterData();
+
+		// Rescales the existing shape's geometry to the entity's current scale, returns false if the shape needs rebuilding with UpdateComponentState instead
+		bool UpdateShapeScale(PhysicsComponent* p_comp);
 		void OnTransformEvent(const Events::ECS_Event<TransformComponent>& t_event);
+		// Writes an external transform change to the entity's actors, "update_type" is the TransformComponent::UpdateType of the event
+		void ApplyTransformChange(SceneEntity& entity, uint32_t update_type);
+		// Applies the transform changes queued while a step was in flight
+		void ApplyDeferredTransformChanges();
 
 		void RemoveComponent(PhysicsComponent* p_comp);
 		void RemoveComponent(CharacterControllerComponent* p_comp);
@@ -184,6 +425,28 @@ namespace ORNG {
 		void ConnectJoint(const JointComponent::ConnectionData& connection);
 		void BreakJoint(JointComponent::Joint* p_joint);
 
+		struct CookedCollisionMesh {
+			// Cooked PxTriangleMesh/PxConvexMesh stream, empty if cooking failed
+			std::vector<std::byte> data;
+			float time_ms = 0.f;
+			bool loaded_from_cache = false;
+		};
+
+		// Runs on a worker thread, loads the cooked stream from the derived data cache or cooks (and stores) it on a miss
+		static CookedCollisionMesh LoadOrCookTriangleMesh(uint64_t mesh_uuid, std::vector<float> positions, std::vector<unsigned> indices);
+		static CookedCollisionMesh LoadOrCookConvexMesh(uint64_t mesh_uuid, std::vector<float> positions);
+
+		// Hull cooking settings shared by LoadOrCookConvexMesh and CookConvexHull, "positions" has to outlive the desc
+		static physx::PxConvexMeshDesc GetConvexHullDesc(std::span<const float> positions);
+
+		// Creates meshes from finished jobs and rebuilds the components that were waiting on them
+		void ProcessCollisionMeshJobs(bool wait_for_triangle_meshes, bool wait_for_convex_meshes);
+
+		static bool HasCollisionVertexData(const MeshAsset* p_mesh_asset);
+
+		// Drops the cached collision meshes of a mesh asset that's been (re)loaded or deleted, rebuilding the components that use a loaded one
+		void OnMeshAssetChange(const MeshAsset* p_mesh_asset, bool loaded);
+
 
 		void InitVehicleSimulationContext();
 
@@ -199,6 +462,7 @@ namespace ORNG {
 		Events::ECS_EventListener<CharacterControllerComponent> m_character_controller_listener;
 		Events::ECS_EventListener<TransformComponent> m_transform_listener;
 		Events::ECS_EventListener<VehicleComponent> m_vehicle_listener;
+		Events::EventListener<Events::AssetEvent> m_asset_listener;
 
 
 		physx::PxBroadPhase* mp_broadphase = nullptr;
@@ -206,7 +470,53 @@ namespace ORNG {
 		physx::PxScene* mp_phys_scene = nullptr;
 		physx::PxControllerManager* mp_controller_manager = nullptr;
 
+		PhysicsDispatcherPool m_dispatcher_pool;
+		physx::PxCpuDispatcher* mp_dispatcher = nullptr;
+
 		std::unordered_map<const MeshAsset*, physx::PxTriangleMesh*> m_triangle_meshes;
+		std::unordered_map<const MeshAsset*, std::future<CookedCollisionMesh>> m_triangle_mesh_jobs;
+
+		std::unordered_map<const MeshAsset*, physx::PxConvexMesh*> m_convex_meshes;
+		std::unordered_map<const MeshAsset*, std::future<CookedCollisionMesh>> m_convex_mesh_jobs;
+
+		// Components using a bounding box in place of a triangle/convex mesh that's still being cooked
+		std::vector<entt::entity> m_entities_awaiting_collision_mesh;
+		// Static/kinematic triangle mesh components with a disabled stand-in, whether cooking or waiting on vertex data
+		std::vector<entt::entity> m_level_stand_ins;
+		// Steps are being held back for level geometry, only used to log when that starts and stops
+		bool m_holding_for_level_meshes = false;
+
+		CollisionMeshCookingReport m_collision_mesh_report;
+		ColliderScaleStats m_collider_scale_stats;
+
+		ContactStats m_contact_stats;
+		// Written by the filter shader, which can run on any PhysX worker thread
+		std::atomic<unsigned> m_pairs_filtered = 0;
+		// PhysicsLayers version the shapes' filter data was last built from
+		uint32_t m_layers_version = 0;
+
+		ActorStats m_actor_stats;
+		WriteBackStats m_write_back_stats;
+		unsigned m_num_kinematic_actors = 0;
+		// Counted by FlushMovedActors, added to m_actor_stats once the step they apply to has been fetched
+		unsigned m_kinematic_targets_set = 0;
+		unsigned m_statics_moved = 0;
+
+		// See AddWorldActor
+		std::vector<physx::PxRigidStatic*> m_world_actors;
+
+		// Entities with PhysicsComponent::m_pending_pose_write set, may contain entities that have since been destroyed
+		std::vector<entt::entity> m_moved_actors;
+
+		// Transform changes made while a pipelined step was in flight and their update types, may contain entities that have since been destroyed
+		std::vector<std::pair<entt::entity, uint32_t>> m_deferred_transform_changes;
+
+		// Bump when the cooking params/SDF settings in LoadOrCookTriangleMesh change in a way the cache key doesn't capture
+		static constexpr uint32_t TRIANGLE_MESH_CACHE_VERSION = 1;
+		static constexpr uint32_t CONVEX_MESH_CACHE_VERSION = 1;
+
+		// PhysX limit, hulls with more vertices are simplified down to this
+		static constexpr unsigned MAX_CONVEX_HULL_VERTICES = 255;
 
 		// Joints that have been broken during the simulation and logged with onConstraintBreak are stored here to disconnect them from entities after simulate() has finished
 		std::vector<JointComponent::Joint*> m_joints_to_break;
@@ -224,11 +534,37 @@ namespace ORNG {
 
 		std::vector<std::tuple<TriggerEvent, entt::entity, entt::entity>> m_trigger_event_queue;
 
-		// Transform that is currently being updated by the physics system, used to prevent needless physics component updates
-		TransformComponent* mp_currently_updating_transform = nullptr;
 
 		static constexpr float m_step_size = (1.f / 60.f);
+		// Milliseconds of frame time not yet simulated
 		float m_accumulator = 0.f;
+		unsigned m_max_substeps = 4;
+		float m_interpolation_alpha = 0.f;
+
+		bool m_pipelined_stepping = false;
+		bool m_step_in_flight = false;
+
+		bool m_parallel_vehicle_stepping = true;
+		// Scratch buffer for StepVehicles
+		std::vector<DirectDriveVehicle*> m_vehicles_to_step;
+
+		struct InterpolatedPose {
+			PxTransform previous;
+			PxTransform current;
+			entt::entity entity = entt::null;
+			ActorType type = ActorType::RIGID_BODY;
+			// Vehicle transforms follow their chassis shape rather than the actor
+			PxShape* p_vehicle_shape = nullptr;
+		};
+
+		// Actors that have moved in the last step, so their transforms are still being interpolated
+		// Kept contiguous so write-back is a linear pass, removal swaps with the last element
+		std::vector<InterpolatedPose> m_interpolated_poses;
+		std::unordered_map<entt::entity, unsigned> m_interpolated_pose_indices;
+
+		// Scratch buffers for WriteInterpolatedPoses, m_moved_transforms is the payload of the PhysicsMovedEvent
+		std::vector<TransformComponent*> m_moved_transforms;
+		std::vector<entt::entity> m_entities_at_rest;
 
 		class PhysCollisionCallback : public physx::PxSimulationEventCallback {
 		public:
@@ -273,6 +609,9 @@ namespace ORNG {
 		void OnMeshAssetDeletion(MeshAsset* p_asset);
 		void OnMaterialDeletion(Material* p_material);
 
+		// Flags the instance group transforms of any mesh/billboard on the entity for an update
+		void FlagInstanceTransformUpdate(SceneEntity* p_entity);
+
 		void SortBillboardIntoInstanceGroup(BillboardComponent* p_comp);
 		void OnBillboardAdd(BillboardComponent* p_comp);
 		void OnBillboardRemove(BillboardComponent* p_comp);
@@ -281,6 +620,7 @@ namespace ORNG {
 		Events::EventListener<Events::AssetEvent> m_asset_listener;
 
 		Events::ECS_EventListener<TransformComponent> m_transform_listener;
+		Events::EventListener<Events::PhysicsMovedEvent> m_physics_listener;
 		Events::ECS_EventListener<MeshComponent> m_mesh_listener;
 		std::vector<MeshInstanceGroup*> m_instance_groups;
 
@@ -303,6 +643,9 @@ namespace ORNG {
 		void OnLoad() override;
 		void OnUnload() override;
 		void OnUpdate() override;
+
+		// Copies the emitter's particles back from the GPU, blocks until every queued particle update has finished
+		void ReadEmitterParticles(ParticleEmitterComponent* p_comp, std::vector<CPUParticleSimulator::GPUParticle>& output);
 	private:
 		void InitEmitter(ParticleEmitterComponent* p_comp);
 		void OnEmitterUpdate(const Events::ECS_Event<ParticleEmitterComponent>& e_event);
@@ -318,11 +661,18 @@ namespace ORNG {
 		void OnEmitterVisualTypeChange(ParticleEmitterComponent* p_comp);
 
 		void UpdateEmitterBufferAtIndex(unsigned index);
+		// Uploads the emitter's baked interpolator LUTs, only needed when its interpolators change
+		void UpdateEmitterLUTsAtIndex(unsigned index);
+
+		// Steps emitters using SimulationBackend::CPU and uploads their particles
+		void UpdateCPUEmitters();
+		void UploadCPUParticles(ParticleEmitterComponent* p_comp);
 
 		Events::ECS_EventListener<ParticleEmitterComponent> m_particle_listener;
 		Events::ECS_EventListener<ParticleBufferComponent> m_particle_buffer_listener;
 
 		Events::ECS_EventListener<TransformComponent> m_transform_listener;
+		Events::EventListener<Events::PhysicsMovedEvent> m_physics_listener;
 
 		// Stored in order based on their m_particle_start_index
 		std::vector<entt::entity> m_emitter_entities;
@@ -330,11 +680,17 @@ namespace ORNG {
 		// Total particles belonging to emitters, does not include those belonging to ParticleBufferComponents which are stored separately
 		unsigned total_emitter_particles = 0;
 
+		std::unordered_map<entt::entity, CPUParticleSimulator> m_cpu_simulators;
+		// Reused for every upload
+		std::vector<CPUParticleSimulator::GPUParticle> m_cpu_upload_buffer;
+
 		unsigned* p_num_appended = nullptr;
 		std::byte* p_emitter_gpu_buffer = nullptr;
 
 		SSBO<float> m_particle_ssbo{ false, 0 };
 		SSBO<float> m_emitter_ssbo{ false, GL_DYNAMIC_STORAGE_BIT };
+		// One ParticleEmitterLUTs per emitter, same indices as m_emitter_ssbo
+		SSBO<float> m_emitter_lut_ssbo{ false, GL_DYNAMIC_STORAGE_BIT };
 		SSBO<float> m_particle_append_ssbo{ false, GL_MAP_WRITE_BIT | GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT };
 
 		SSBO<float> m_particle_copy_buffer{ false, 0 };
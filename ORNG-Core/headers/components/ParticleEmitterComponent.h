@@ -23,11 +23,19 @@ namespace ORNG {
 		friend class EditorLayer;
 		friend class SceneRenderer;
 		friend class SceneSerializer;
+		friend class CPUParticleSimulator;
 	public:
 		enum EmitterType : uint8_t {
 			BILLBOARD,
 			MESH
 		};
+
+		enum class SimulationBackend : uint8_t {
+			// Compute shaders, the default
+			GPU,
+			// CPUParticleSimulator, uploaded every frame, for machines with weak GPUs
+			CPU,
+		};
 		ParticleEmitterComponent(SceneEntity* p_entity) : Component(p_entity) { };
 
 		// Maximum of 100,000 particles per emitter
@@ -117,11 +125,22 @@ namespace ORNG {
 			DispatchUpdateEvent(VISUAL_TYPE_CHANGED);
 		}
 
+		SimulationBackend GetSimulationBackend() {
+			return m_simulation_backend;
+		}
+
+		// Particles are reinitialized when the backend changes
+		void SetSimulationBackend(SimulationBackend backend) {
+			m_simulation_backend = backend;
+			DispatchUpdateEvent(BACKEND_CHANGED, (int)0);
+		}
+
 		inline static const int BASE_NUM_PARTICLES = 64;
 
 	private:
 
 		EmitterType m_type = BILLBOARD;
+		SimulationBackend m_simulation_backend = SimulationBackend::GPU;
 
 		enum EmitterSubEvent : uint32_t {
 			DEFAULT= 0,
@@ -131,6 +150,7 @@ namespace ORNG {
 			VISUAL_TYPE_CHANGED = 16,
 			MODIFIERS_CHANGED = 32,
 			FULL_UPDATE = 64,
+			BACKEND_CHANGED = 128,
 		};
 
 		void DispatchUpdateEvent(EmitterSubEvent se = DEFAULT, std::any data_payload = 0.f);
@@ -6,6 +6,7 @@
 
 #include "scene/EntityNodeRef.h"
 #include "util/UUID.h"
+#include "physics/PhysicsLayers.h"
 
 namespace physx {
 	class PxRigidDynamic;
@@ -38,10 +39,14 @@ namespace ORNG {
 			BOX = 0,
 			SPHERE = 1,
 			TRIANGLE_MESH = 2,
+			// Convex hull of the entity's mesh, the only mesh collider dynamic bodies can use
+			CONVEX_MESH = 3,
 		};
 		enum RigidBodyType {
 			STATIC = 0,
 			DYNAMIC = 1,
+			// Moved only by its transform, which is applied as a kinematic target on the next simulation step
+			KINEMATIC = 2,
 		};
 
 		PhysicsComponent(SceneEntity* p_entity, bool is_trigger, GeometryType geom_type, RigidBodyType body_type, PhysXMaterialAsset* _material) : Component(p_entity), m_is_trigger(is_trigger),
@@ -59,19 +64,44 @@ namespace ORNG {
 		void SetMass(float mass);
 
 		void UpdateGeometry(GeometryType type);
+		// Dynamic bodies can't simulate triangle meshes, so they use the mesh's convex hull instead
+		GeometryType GetColliderGeometryType() const { return m_geometry_type == TRIANGLE_MESH && m_body_type == DYNAMIC ? CONVEX_MESH : m_geometry_type; }
 		void SetBodyType(RigidBodyType type);
 
 		void SetTrigger(bool is_trigger);
 		bool IsTrigger() { return m_is_trigger; }
 
+		// Layer in the range [0, MAX_LAYERS), scene queries select which layers they hit with a mask where bit N = layer N
+		// Which layers collide with each other is set project-wide in PhysicsLayers
+		void SetLayer(uint8_t layer);
+		uint8_t GetLayer() const { return m_layer; }
+
+		// Layers this body can collide with, on top of the PhysicsLayers matrix, bit N = layer N
+		void SetCollisionMask(uint32_t mask);
+		uint32_t GetCollisionMask() const { return m_collision_mask; }
+
+		// If false, no OnCollision/OnTrigger script events are generated for this body unless the other body in the pair wants them
+		// Off by default, the editor turns it on for entities with a ScriptComponent and scenes saved before it existed are migrated on load
+		void SetContactReportsEnabled(bool enabled);
+		bool GetContactReportsEnabled() const { return m_contact_reports_enabled; }
+
+		static constexpr uint8_t MAX_LAYERS = PhysicsLayers::MAX_LAYERS;
+
 		PhysXMaterialAsset* GetMaterial() {
 			return p_material;
 		}
 
 
 		physx::PxRigidActor* p_rigid_actor = nullptr;
+
+		// Sub event type of update events that only need the shape's simulation filter data refreshing, rather than a rebuild
+		static constexpr uint32_t FILTER_DATA_UPDATE = 1;
+		// Sub event type of update events that only need the shape's material swapping
+		static constexpr uint32_t MATERIAL_UPDATE = 2;
 	private:
 		void SendUpdateEvent();
+		void SendFilterUpdateEvent();
+		void SendMaterialUpdateEvent();
 
 		physx::PxShape* p_shape = nullptr;
 
@@ -79,6 +109,12 @@ namespace ORNG {
 		GeometryType m_geometry_type = BOX;
 		RigidBodyType m_body_type = STATIC;
 		bool m_is_trigger = false;
+		uint8_t m_layer = 0;
+		uint32_t m_collision_mask = UINT32_MAX;
+		bool m_contact_reports_enabled = false;
+
+		// Static/kinematic transform changed and the pose hasn't been written to the actor yet, see PhysicsSystem::FlushMovedActors
+		bool m_pending_pose_write = false;
 	};
 
 
@@ -52,6 +52,7 @@ namespace ORNG {
 		}
 
 		inline void SetAbsoluteOrientation(glm::vec3 orientation) {
+			ResolveOrientation();
 			SetOrientation(orientation - (m_abs_orientation - m_orientation));
 		}
 
@@ -81,6 +82,7 @@ namespace ORNG {
 		};
 
 		inline void SetOrientation(const glm::vec3 rot) {
+			m_orientation_stale = false;
 			m_orientation = rot;
 			RebuildMatrix(UpdateType::ORIENTATION);
 		};
@@ -95,6 +97,7 @@ namespace ORNG {
 		}
 
 		inline glm::vec3 GetAbsOrientation() {
+			ResolveOrientation();
 			return m_abs_orientation;
 		}
 
@@ -103,7 +106,7 @@ namespace ORNG {
 		}
 
 		// Returns inherited position([0]), scale([1]), rotation ([2]) including this components transforms.
-		std::tuple<glm::vec3, glm::vec3, glm::vec3> GetAbsoluteTransforms() { return std::make_tuple(m_abs_pos, m_abs_scale, m_abs_orientation); }
+		std::tuple<glm::vec3, glm::vec3, glm::vec3> GetAbsoluteTransforms() { ResolveOrientation(); return std::make_tuple(m_abs_pos, m_abs_scale, m_abs_orientation); }
 
 		TransformComponent* GetParent();
 
@@ -111,7 +114,7 @@ namespace ORNG {
 
 		glm::vec3 GetPosition() const { return m_pos; };
 		glm::vec3 GetScale() const { return m_scale; };
-		glm::vec3 GetOrientation() const { return m_orientation; };
+		glm::vec3 GetOrientation() const { ResolveOrientation(); return m_orientation; };
 
 
 		enum UpdateType : uint8_t {
@@ -128,6 +131,22 @@ namespace ORNG {
 
 		void RebuildMatrix(UpdateType type);
 	private:
+		// Rebuilds the matrix and absolute transforms without dispatching an update event
+		void BuildMatrix();
+
+		// Used by the PhysicsSystem for batched pose write-back, doesn't dispatch an update event, listeners are notified through a single Events::PhysicsMovedEvent instead
+		void SetPhysicsPose(const glm::vec3& abs_pos, const glm::quat& abs_orientation, bool set_orientation);
+
+		// SetPhysicsPose only keeps the quaternion, the euler angles are converted from it here when something reads them (editor, serializer, scripts, a matrix rebuild)
+		void ResolveOrientation() const {
+			if (!m_orientation_stale)
+				return;
+
+			m_orientation = glm::degrees(glm::eulerAngles(m_physics_orientation));
+			m_abs_orientation = m_orientation;
+			m_orientation_stale = false;
+		}
+
 		void UpdateAbsTransforms();
 
 		entt::entity m_parent_handle = entt::null;
@@ -137,13 +156,17 @@ namespace ORNG {
 		glm::mat4 m_transform = glm::mat4(1);
 
 		glm::vec3 m_scale = glm::vec3(1.0f, 1.0f, 1.0f);
-		glm::vec3 m_orientation = glm::vec3(0.0f, 0.0f, 0.0f);
+		mutable glm::vec3 m_orientation = glm::vec3(0.0f, 0.0f, 0.0f);
 		glm::vec3 m_pos = glm::vec3(0.0f, 0.0f, 0.0f);
 
 		glm::vec3 m_abs_scale = glm::vec3(1.0f, 1.0f, 1.0f);
-		glm::vec3 m_abs_orientation = glm::vec3(0.0f, 0.0f, 0.0f);
+		mutable glm::vec3 m_abs_orientation = glm::vec3(0.0f, 0.0f, 0.0f);
 		glm::vec3 m_abs_pos = glm::vec3(0.0f, 0.0f, 0.0f);
 
+		// Set by SetPhysicsPose, m_orientation and m_abs_orientation are out of date until ResolveOrientation
+		glm::quat m_physics_orientation = glm::quat(1.f, 0.f, 0.f, 0.f);
+		mutable bool m_orientation_stale = false;
+
 		glm::vec3 g_up = { 0.0, 1.0, 0.0 };
 
 	};
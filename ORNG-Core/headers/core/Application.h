@@ -19,6 +19,14 @@ namespace ORNG {
 		// Modules specified here will not be initialized with the application, this will make them unusable
 		ApplicationModulesFlags disabled_modules = MODULE_NONE;
 
+		// PhysX worker threads for the main scene, 0 uses every hardware thread except two (and the background threads)
+		unsigned physics_main_threads = 0;
+		// PhysX worker threads shared by secondary scenes, see PhysicsDispatcherPool
+		unsigned physics_background_threads = 1;
+
+		// Audio is mixed without an output device, see AudioEngine::Init
+		bool audio_no_output = false;
+
 		// Leave as -1 to prevent fullscreening
 		int initial_window_display_monitor_idx = -1;
 		glm::ivec2 initial_window_dimensions = { 2560, 1440 };
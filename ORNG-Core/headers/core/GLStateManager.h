@@ -132,6 +132,7 @@ namespace ORNG {
 			static const int PARTICLES = 6;
 			static const int PARTICLE_APPEND = 7;
 			static const int SECONDARY_PARTICLES = 8;
+			static const int PARTICLE_INTERPOLATOR_LUTS = 9;
 
 		};
 
@@ -163,6 +164,7 @@ namespace ORNG {
 			static const int EMISSIVE = GL_TEXTURE25;
 			static const int POINTLIGHT_DEPTH = GL_TEXTURE26;
 			static const int SCENE_VOXELIZATION = GL_TEXTURE27;
+			static const int TERRAIN_HEIGHTFIELD = GL_TEXTURE28;
 		};
 
 		struct TextureUnitIndexes {
@@ -183,6 +185,7 @@ namespace ORNG {
 			static const int DATA_3D = 15;
 			static const int ROUGHNESS_METALLIC_AO = 19;
 			static const int COLOUR_3 = 23;
+			static const int TERRAIN_HEIGHTFIELD = 28;
 		};
 
 	private:
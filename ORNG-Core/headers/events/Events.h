@@ -5,6 +5,7 @@
 
 namespace ORNG {
 	class SceneEntity;
+	class TransformComponent;
 
 	enum MouseButton {
 		LEFT_BUTTON = 0,
@@ -82,6 +83,11 @@ namespace ORNG::Events {
 		TEXTURE_DELETED,
 		TEXTURE_LOADED,
 		SCRIPT_DELETED,
+		// Dispatched when the source file of a script asset changes on disk, the payload is the ScriptAsset
+		SCRIPT_MODIFIED,
+		// Dispatched when a hot-reloaded sound asset has had its FMOD sound swapped for the reimported one, the payload is the SoundAsset
+		// The old sound is released once the event has been handled, so anything still playing it has to move to the new one
+		SOUND_RELOADED,
 	};
 
 	struct AssetEvent : public Event {
@@ -89,6 +95,12 @@ namespace ORNG::Events {
 		uint8_t* data_payload = nullptr; // Data payload will be a ptr to the asset being modified if it's an asset event
 	};
 
+	// Dispatched once per physics update with every transform the PhysicsSystem moved, these transforms don't dispatch individual ECS_Event's
+	struct PhysicsMovedEvent : public Event {
+		uint64_t scene_id = 0;
+		const std::vector<TransformComponent*>* p_transforms = nullptr;
+	};
+
 	enum class ECS_EventType {
 		COMP_ADDED,
 		COMP_UPDATED,
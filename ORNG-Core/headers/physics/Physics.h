@@ -36,10 +36,19 @@ namespace ORNG {
 		return { ConvertVec3<physx::PxVec3>(p), n_px_quat};
 	}
 
+	// Each PhysicsSystem (one per scene) submits its simulation work to one of these pools
+	enum class PhysicsDispatcherPool : uint8_t {
+		// Gets most of the worker threads, for the scene being played/edited
+		MAIN,
+		// Small separate pool for secondary scenes (previews, tools) so they never take workers away from the main scene
+		BACKGROUND
+	};
+
 	class Physics {
 	public:
-		static void Init() {
-			Get().I_Init();
+		// "num_main_threads" of 0 uses every hardware thread except two (and the background threads)
+		static void Init(unsigned num_main_threads = 0, unsigned num_background_threads = 1) {
+			Get().I_Init(num_main_threads, num_background_threads);
 		}
 
 		static void Shutdown() {
@@ -58,8 +67,8 @@ namespace ORNG {
 			return Get().mp_foundation;
 		}
 
-		static physx::PxCpuDispatcher* GetCPUDispatcher() {
-			return Get().mp_dispatcher;
+		static physx::PxCpuDispatcher* GetCPUDispatcher(PhysicsDispatcherPool pool = PhysicsDispatcherPool::MAIN) {
+			return pool == PhysicsDispatcherPool::MAIN ? Get().mp_dispatcher : Get().mp_background_dispatcher;
 		}
 
 		static float GetToleranceScale() {
@@ -68,7 +77,7 @@ namespace ORNG {
 
 
 	private:
-		void I_Init();
+		void I_Init(unsigned num_main_threads, unsigned num_background_threads);
 
 		void IShutdown();
 
@@ -83,6 +92,7 @@ namespace ORNG {
 		physx::PxFoundation* mp_foundation = nullptr;
 		physx::PxPhysics* mp_physics = nullptr;
 		physx::PxCpuDispatcher* mp_dispatcher = nullptr;
+		physx::PxCpuDispatcher* mp_background_dispatcher = nullptr;
 		physx::PxCudaContextManager* mp_cuda_context_manager = nullptr;
 
 		float m_tolerances_scale = 1.f;
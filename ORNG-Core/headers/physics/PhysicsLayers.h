@@ -0,0 +1,60 @@
+#pragma once
+
+#define ORNG_PHYSICS_LAYERS_FILEPATH ".\\res\\physics-layers.yml"
+
+namespace ORNG {
+	/*
+		Project-wide layer interaction matrix, two physics components only collide if their layers interact here and each layer is in the other's collision mask.
+		Pairs that don't interact are dropped in the filter shader before narrowphase.
+		Every layer interacts with every other layer by default.
+	*/
+	class PhysicsLayers {
+	public:
+		static constexpr uint8_t MAX_LAYERS = 32;
+
+		// Symmetric, setting (a, b) also sets (b, a)
+		static void SetLayersInteract(uint8_t a, uint8_t b, bool interact);
+
+		static bool DoLayersInteract(uint8_t a, uint8_t b) {
+			return Get().m_matrix[a] & (1u << b);
+		}
+
+		// Mask of every layer that interacts with "layer"
+		static uint32_t GetInteractionMask(uint8_t layer) {
+			return Get().m_matrix[layer];
+		}
+
+		static void SetLayerName(uint8_t layer, const std::string& name) {
+			Get().m_names[layer] = name;
+		}
+
+		static const std::string& GetLayerName(uint8_t layer) {
+			return Get().m_names[layer];
+		}
+
+		// Incremented on every change to the matrix, physics systems compare against this to know when filter data needs refreshing
+		static uint32_t GetVersion() {
+			return Get().m_version;
+		}
+
+		// Resets to defaults if the file doesn't exist, returns false if it exists but couldn't be parsed
+		static bool Load(const std::string& filepath);
+		static void Save(const std::string& filepath);
+
+		static void Reset() { Get().IReset(); }
+
+	private:
+		PhysicsLayers() { IReset(); }
+
+		void IReset();
+
+		static PhysicsLayers& Get() {
+			static PhysicsLayers s_instance;
+			return s_instance;
+		}
+
+		std::array<uint32_t, MAX_LAYERS> m_matrix;
+		std::array<std::string, MAX_LAYERS> m_names;
+		uint32_t m_version = 0;
+	};
+}
@@ -114,6 +114,19 @@ namespace ORNG {
 
 		void setUpActor(PxScene& scene, const PxTransform& pose, const char* vehicleName);
 
+		//If the component sequence was built without the PhysX begin/end components, these have to be called before/after step().
+		//Keeping them out of the sequence means step() never touches the PhysX actor, so many vehicles can be stepped concurrently
+		//while the actor reads and writes stay on one thread.
+		void stepPhysXActorBegin(const PxReal dt, const PxVehicleSimulationContext& context)
+		{
+			PxVehiclePhysXActorBeginComponent::update(dt, context);
+		}
+
+		void stepPhysXActorEnd(const PxReal dt, const PxVehicleSimulationContext& context)
+		{
+			PxVehiclePhysXActorEndComponent::update(dt, context);
+		}
+
 		virtual void getDataForPhysXActorBeginComponent(
 			const PxVehicleAxleDescription*& axleDescription,
 			const PxVehicleCommandState*& commands,
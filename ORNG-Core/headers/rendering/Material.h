@@ -107,6 +107,11 @@ namespace ORNG {
 			return flags;
 		}
 
+		// Every texture slot (some may be nullptr), used for dependency tracking
+		std::array<Texture2D*, 7> GetTextures() const {
+			return { base_colour_texture, normal_map_texture, metallic_texture, roughness_texture, ao_texture, displacement_texture, emissive_texture };
+		}
+
 		RenderGroup render_group = SOLID;
 
 		glm::vec4 base_colour = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
@@ -19,6 +19,43 @@ namespace ORNG {
 
 	class TransformComponent;
 
+	// Material properties read from the source file on import, these are turned into Material assets by the AssetManager once the mesh is loaded into GL
+	struct ImportedMaterial {
+		enum TextureSlot : uint8_t {
+			BASE_COLOUR = 0,
+			NORMAL,
+			ROUGHNESS,
+			METALLIC,
+			AO,
+			COUNT
+		};
+
+		enum PropertyFlags : uint8_t {
+			HAS_BASE_COLOUR = 1 << 0,
+			HAS_ROUGHNESS = 1 << 1,
+			HAS_METALLIC = 1 << 2,
+		};
+
+		// Paths as written in the source file, relative to the mesh's directory
+		std::array<std::string, TextureSlot::COUNT> texture_paths;
+
+		glm::vec3 base_colour{ 1, 1, 1 };
+		float roughness = 0.2f;
+		float metallic = 0.f;
+		uint8_t property_flags = 0;
+
+		template<typename S>
+		void serialize(S& s) {
+			for (auto& path : texture_paths) {
+				s.text1b(path, ORNG_MAX_FILEPATH_SIZE);
+			}
+			s.object(base_colour);
+			s.value4b(roughness);
+			s.value4b(metallic);
+			s.value1b(property_flags);
+		}
+	};
+
 	class MeshAsset : public Asset {
 	public:
 		friend class Renderer;
@@ -37,8 +74,12 @@ namespace ORNG {
 		MeshAsset(const MeshAsset& other) = default;
 		~MeshAsset() =default;
 
+		// Imports the source file, or reads the result of a previous import of identical source data (including referenced .mtl and .bin files) from the DerivedDataCache
 		bool LoadMeshData();
 
+		// Bump whenever the layout written by WriteImportCache changes
+		static constexpr uint32_t IMPORT_CACHE_VERSION = 1;
+
 		bool GetLoadStatus() const { return m_is_loaded; };
 
 		unsigned int GetIndicesCount() const { return num_indices; }
@@ -90,6 +131,11 @@ namespace ORNG {
 
 		void CountVerticesAndIndices(const aiScene* p_scene, unsigned int& num_verts, unsigned int& num_indices);
 
+		void ReadImportedMaterials(const aiScene* p_scene);
+
+		bool ReadImportCache(const std::vector<std::byte>& data);
+		void WriteImportCache(std::vector<std::byte>& output);
+
 		void PopulateBuffers();
 
 		MeshVAO m_vao;
@@ -105,6 +151,9 @@ namespace ORNG {
 
 		const aiScene* p_scene = nullptr;
 
+		// Filled on import, cleared once the AssetManager has created materials from it
+		std::vector<ImportedMaterial> m_imported_materials;
+
 
 #define INVALID_MATERIAL 0xFFFFFFFF
 
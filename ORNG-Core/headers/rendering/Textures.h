@@ -62,6 +62,19 @@ namespace ORNG {
 
 		bool ValidateBaseSpec(const TextureBaseSpec* spec, bool is_framebuffer_texture = false);
 
+		struct DecodedImage {
+			int width = 0;
+			int height = 0;
+			int channels = 0;
+			std::vector<std::byte> pixels;
+		};
+
+		// Decodes an 8-bit image file (flipped vertically, as textures are loaded), going through the DerivedDataCache so each image is only decoded once per machine
+		static bool DecodeImageFile(const std::string& filepath, DecodedImage& output);
+
+		// Bump whenever the layout of cached decoded images changes
+		static constexpr uint32_t DECODE_CACHE_VERSION = 1;
+
 		const std::string& GetName() {
 			return m_name;
 		}
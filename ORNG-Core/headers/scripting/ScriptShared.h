@@ -3,6 +3,7 @@
 #ifndef SCRIPT_SHARED_H
 #define SCRIPT_SHARED_H
 #include "entt/EnttSingleInclude.h"
+#include <span>
 
 class Instancer;
 namespace physx {
@@ -49,6 +50,7 @@ namespace ORNG {
 		glm::vec3 hit_pos{ 0, 0, 0 };
 		glm::vec3 hit_normal{ 0, 0, 0 };
 		float hit_dist = 0;
+		// Both null if a world actor such as a terrain collider was hit
 		PhysicsComponent* p_phys_comp = nullptr;
 		SceneEntity* p_entity = nullptr;
 	};
@@ -57,6 +59,37 @@ namespace ORNG {
 		std::vector<SceneEntity*> entities;
 	};
 
+	// Bit N selects PhysicsComponent layer N
+	static constexpr uint32_t ALL_PHYSICS_LAYERS = UINT32_MAX;
+
+	struct RaycastQuery {
+		glm::vec3 origin{ 0, 0, 0 };
+		glm::vec3 unit_dir{ 0, 0, -1 };
+		float max_distance = 0;
+		uint32_t layer_mask = ALL_PHYSICS_LAYERS;
+	};
+
+	// Sphere swept from "origin" along "unit_dir", results are written as RaycastResults
+	struct SweepQuery {
+		glm::vec3 origin{ 0, 0, 0 };
+		glm::vec3 unit_dir{ 0, 0, -1 };
+		float max_distance = 0;
+		float radius = 0.5f;
+		uint32_t layer_mask = ALL_PHYSICS_LAYERS;
+	};
+
+	struct OverlapSphereQuery {
+		glm::vec3 pos{ 0, 0, 0 };
+		float radius = 0.5f;
+		uint32_t layer_mask = ALL_PHYSICS_LAYERS;
+	};
+
+	// Range of the hit span passed to an overlap batch that belongs to one query
+	struct OverlapBatchResult {
+		unsigned first_hit = 0;
+		unsigned num_hits = 0;
+	};
+
 	typedef ScriptBase* (__cdecl* InstanceCreator)();
 	typedef void(__cdecl* InstanceDestroyer)(ScriptBase*);
 
@@ -75,6 +108,12 @@ namespace ORNG {
 		std::function<CameraComponent* ()> GetActiveCamera = nullptr;
 		std::function<OverlapQueryResults(physx::PxGeometry&, glm::vec3, unsigned)> OverlapQuery = nullptr;
 		std::function<ORNG::RaycastResults(glm::vec3 origin, glm::vec3 unit_dir, float max_distance)> Raycast = nullptr;
+
+		// Batched queries, executed in parallel. "results" must be at least as large as "queries", result i belongs to query i
+		std::function<void(std::span<const RaycastQuery> queries, std::span<RaycastResults> results)> RaycastBatch = nullptr;
+		std::function<void(std::span<const SweepQuery> queries, std::span<RaycastResults> results)> SweepBatch = nullptr;
+		// Hits are packed contiguously into "hits", "hits" must hold queries.size() * max_hits_per_query entities
+		std::function<void(std::span<const OverlapSphereQuery> queries, std::span<OverlapBatchResult> results, std::span<SceneEntity*> hits, unsigned max_hits_per_query)> OverlapBatch = nullptr;
 	};
 
 	typedef void(__cdecl* InputSetter)(void*);
@@ -47,6 +47,9 @@ namespace ORNG {
 
 		void ReloadShaders();
 
+		// Reloads only the shaders with a stage compiled from one of "filepaths", if any of them is an include file every shader is reloaded
+		void ReloadShadersUsingFiles(const std::vector<std::string>& filepaths);
+
 		inline static const uint64_t LIGHTING_SHADER_ID = 1;
 		inline static const uint64_t INVALID_SHADER_ID = 0; //useful for rendering things that should not have any shader applied to them (e.g skybox), only default gbuffer albedo
 	private:
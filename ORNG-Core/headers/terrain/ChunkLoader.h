@@ -1,20 +1,57 @@
 #pragma once
 #include "terrain/TerrainChunk.h"
+#include "terrain/ChunkStreamer.h"
 
 namespace ORNG {
 
+	/*
+		Streams TerrainChunk geometry in through a ChunkStreamer and uploads it to the GPU on the main thread.
+		Requests are reprioritized every ProcessChunkLoads by their screen-space error, so chunks in front of the camera with the coarsest stand-in load first.
+	*/
 	class ChunkLoader {
 	public:
-		static void RequestChunkLoad(TerrainChunk& chunk);
-		static void CancelChunkLoad(int key);
-		static void ProcessChunkLoads();
-		static void LoadChunk(TerrainChunk* chunk);
+		struct UploadStats {
+			unsigned uploads_last_frame = 0;
+			size_t bytes_uploaded_last_frame = 0;
+			// Generated chunks held back by the upload budget
+			unsigned waiting_for_upload = 0;
+		};
+
+		// "geometric_error" is the vertex spacing of the coarser chunk drawn in this one's place until it's loaded
+		static void RequestChunkLoad(TerrainChunk& chunk, float geometric_error);
+		static void CancelChunkLoad(uint64_t key);
+
+		// Reprioritizes queued requests around "camera_pos" and uploads finished chunks, stops once the upload budget is used up (always uploads at least one chunk so large chunks can't stall)
+		static void ProcessChunkLoads(glm::vec3 camera_pos);
+
+		static void SetUploadBudget(size_t bytes_per_frame) { m_upload_budget_bytes = bytes_per_frame; }
+
+		// For tools and benchmarks without a GL context, chunks are marked as ready to draw once their heightfield is moved in but no texture is created
+		static void SetGPUUploadsEnabled(bool enabled) { m_gpu_uploads_enabled = enabled; }
+
+		static ChunkStreamer::Metrics GetStreamingMetrics() { return GetStreamer().GetMetrics(); }
+		static UploadStats GetUploadStats() { return m_upload_stats; }
+
+		// Screen-space error of the chunk's stand-in, without the projection scale as it's the same for every chunk and only the ordering matters
+		static float CalculatePriority(glm::vec3 bot_left_coord, float width, float geometric_error, glm::vec3 camera_pos);
+
+		static constexpr size_t DEFAULT_UPLOAD_BUDGET_BYTES = 8'000'000;
 	private:
-		static [[nodiscard]] int CreateKey();
-		inline static int m_last_id = 0;
-		inline static std::map<int, TerrainChunk*> m_chunks_to_load;
-		inline static std::map<int, std::future<void>> m_futures;
-		inline static unsigned int m_active_processes = 0;
+		// Created on first use, workers are joined at exit
+		static ChunkStreamer& GetStreamer();
+
+		// Index into m_loading_chunks, -1 if not found
+		static int FindLoadingChunk(uint64_t key);
+
+		inline static std::unique_ptr<ChunkStreamer> mp_streamer = nullptr;
+		// Unordered, a vector rather than a map so requesting/cancelling loads doesn't allocate once it's grown, there are only tens of chunks loading at once
+		inline static std::vector<TerrainChunk*> m_loading_chunks;
+		// Highest priority first
+		inline static std::vector<ChunkStreamer::CompletedChunk> m_awaiting_upload;
+
+		inline static size_t m_upload_budget_bytes = DEFAULT_UPLOAD_BUDGET_BYTES;
+		inline static UploadStats m_upload_stats;
+		inline static bool m_gpu_uploads_enabled = true;
 	};
 
-}
\ No newline at end of file
+}
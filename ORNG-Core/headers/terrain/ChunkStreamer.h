@@ -0,0 +1,116 @@
+#pragma once
+#include <thread>
+#include <condition_variable>
+#include "terrain/TerrainGenerator.h"
+
+namespace ORNG {
+	/*
+		Generates terrain chunk heightfields on a fixed pool of worker threads, highest priority request first.
+		Idle workers always take the highest priority request left in the shared queue, priorities can be changed while requests are queued so the order follows the camera.
+		Doesn't touch any GL state or TerrainChunk, results are handed back through ConsumeCompleted, so it can be used without a GL context.
+	*/
+	class ChunkStreamer {
+	public:
+		struct ChunkParams {
+			unsigned seed = 0;
+			int width = 0;
+			unsigned resolution = 1;
+			float height_scale = 1.f;
+			glm::vec3 bot_left_coord{ 0, 0, 0 };
+		};
+
+		struct CompletedChunk {
+			uint64_t key = 0;
+			float priority = 0.f;
+			TerrainGenerator::Heightfield heightfield;
+			AABB bounding_box;
+			std::chrono::steady_clock::time_point request_time;
+			// Filled by the streamer's post-process step if it has one, e.g a cooked collider
+			std::vector<std::byte> payload;
+
+			size_t GetSizeBytes() const { return heightfield.GetSizeBytes() + payload.size(); }
+		};
+
+		struct Metrics {
+			// Requests waiting for a worker
+			unsigned queue_depth = 0;
+			unsigned in_flight = 0;
+			// Generated but not consumed yet
+			unsigned completed_waiting = 0;
+
+			uint64_t total_requested = 0;
+			uint64_t total_completed = 0;
+			uint64_t total_cancelled = 0;
+
+			// Over every completed request, queue latency is request -> generation start, total latency is request -> generation end
+			float mean_queue_latency_ms = 0.f;
+			float max_queue_latency_ms = 0.f;
+			float mean_generation_ms = 0.f;
+			float mean_total_latency_ms = 0.f;
+			float max_total_latency_ms = 0.f;
+		};
+
+		// Runs on the worker that generated the chunk, straight after generating it
+		using PostProcessFn = std::function<void(CompletedChunk&)>;
+
+		// 0 uses a quarter of the hardware threads, at least one
+		explicit ChunkStreamer(unsigned num_workers = 0, PostProcessFn post_process = nullptr);
+
+		// Queues are reserved for this many requests so a terrain quadtree's steady state doesn't allocate here
+		static constexpr size_t RESERVED_REQUESTS = 256;
+		~ChunkStreamer();
+
+		// Higher priority requests are generated first, returns a key used to refer to the request
+		uint64_t Request(const ChunkParams& params, float priority);
+
+		// Does nothing if the request has already started generating
+		void SetPriority(uint64_t key, float priority);
+
+		// Queued requests are dropped, requests being generated have their results discarded, safe to call with a key that's already completed or cancelled
+		void Cancel(uint64_t key);
+
+		// Returns every request generated since the last call, highest priority first
+		std::vector<CompletedChunk> ConsumeCompleted();
+
+		// Blocks until nothing is queued or being generated
+		void WaitForIdle();
+
+		Metrics GetMetrics();
+
+		unsigned GetNumWorkers() const {
+			return static_cast<unsigned>(m_workers.size());
+		}
+
+	private:
+		void WorkerLoop();
+
+		struct PendingRequest {
+			uint64_t key;
+			float priority;
+			ChunkParams params;
+			std::chrono::steady_clock::time_point request_time;
+		};
+
+		// Guards everything below
+		std::mutex m_mutex;
+		std::condition_variable m_work_cv;
+		std::condition_variable m_idle_cv;
+
+		// Unordered, workers scan for the highest priority as priorities change every frame and the queue only holds tens of requests
+		std::vector<PendingRequest> m_pending;
+		// At most one per worker
+		std::vector<uint64_t> m_in_flight;
+		std::vector<uint64_t> m_cancelled_in_flight;
+		std::vector<CompletedChunk> m_completed;
+
+		uint64_t m_next_key = 1;
+		Metrics m_metrics;
+		double m_total_queue_latency_ms = 0.0;
+		double m_total_generation_ms = 0.0;
+		double m_total_latency_ms = 0.0;
+
+		bool m_running = true;
+		PostProcessFn m_post_process;
+		std::vector<std::thread> m_workers;
+	};
+}
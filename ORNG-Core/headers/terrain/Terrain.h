@@ -1,5 +1,7 @@
 #pragma once
 #include "terrain/TerrainQuadtree.h"
+#include "terrain/TerrainColliders.h"
+#include "rendering/VAO.h"
 
 namespace ORNG {
 	class Material;
@@ -13,13 +15,41 @@ namespace ORNG {
 		void UpdateTerrainQuadtree(glm::vec3 player_pos);
 		void ResetTerrainQuadtree();
 
+		// Streams heightfield colliders around "focus_pos" into "physics", see TerrainColliders
+		void UpdateColliders(glm::vec3 focus_pos, PhysicsSystem& physics);
+
+		// Must be called before the PhysicsSystem given to UpdateColliders is unloaded
+		void ClearColliders();
+
+		// False until the terrain has been given a width
+		bool IsActive() const {
+			return m_quadtree != nullptr;
+		}
+
+		// Index buffer shared by every chunk with "side_length_steps" vertices per side, created on first use (see TerrainGenerator::GenHeightfieldIndices)
+		const MeshVAO& GetSharedIndices(unsigned side_length_steps);
+
+		struct MemoryStats {
+			unsigned num_chunks = 0;
+			size_t chunk_cpu_bytes = 0;
+			size_t chunk_gpu_bytes = 0;
+			size_t shared_index_bytes = 0;
+		};
+
+		// Over every loaded chunk in the quadtree
+		MemoryStats GetMemoryStats() const;
+
 	private:
 		std::unique_ptr<TerrainQuadtree> m_quadtree = nullptr;
-		Material* mp_material;
+		// Created with the quadtree, independent of its LOD
+		std::unique_ptr<TerrainColliders> mp_colliders = nullptr;
+		TerrainColliders::Settings m_collider_settings;
+		// Keyed by side length, skirts are always included
+		std::unordered_map<unsigned, std::unique_ptr<MeshVAO>> m_shared_indices;
+		Material* mp_material = nullptr;
 
 		glm::vec3 m_center_pos = glm::vec3(0.f, 0.f, 0.f);
 		unsigned int m_width = 0;
-		unsigned int m_resolution = 16;
 		unsigned int m_seed = 123;
 		float m_height_scale = 1.5f;
 	};
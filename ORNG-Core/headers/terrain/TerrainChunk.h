@@ -1,6 +1,6 @@
 #pragma once
 #include "TerrainGenerator.h"
-#include "rendering/VAO.h"
+#include "rendering/Textures.h"
 #include "components/BoundingVolume.h"
 
 namespace ORNG {
@@ -13,14 +13,40 @@ namespace ORNG {
 		TerrainChunk(glm::vec3 bot_left_coord, unsigned int resolution, unsigned int width, unsigned int seed, float height_scale) :
 			m_bot_left_coord(bot_left_coord), m_resolution(resolution), m_width(width), m_seed(seed), m_height_scale(height_scale) {};
 
+		// Uploads m_heightfield to an R16 texture, the CPU copy is kept
+		// The texture is reused if the chunk was loaded before with the same grid size
 		void LoadGLData();
+
+		// Reuses the chunk for a different area (see TerrainQuadtree's chunk pool), the heightfield's storage and the texture are kept for the next load
+		void Reset(glm::vec3 bot_left_coord, unsigned int resolution, unsigned int width);
+
+		bool IsReadyToDraw() const {
+			return m_is_initialized;
+		}
+
+		const TerrainGenerator::Heightfield& GetHeightfield() const {
+			return m_heightfield;
+		}
+
+		// Includes storage kept while the chunk is pooled
+		size_t GetCPUSizeBytes() const {
+			return m_heightfield.samples.capacity() * sizeof(uint16_t);
+		}
+
+		// Bytes held on the GPU by this chunk alone, the index buffer is shared between every chunk with the same side length (see Terrain::GetSharedIndices)
+		size_t GetGPUSizeBytes() const {
+			return mp_height_tex ? mp_height_tex->GetSpec().width * mp_height_tex->GetSpec().height * sizeof(uint16_t) : 0;
+		}
 	private:
 		/*Key for accessing chunk loader loading buffer, required for deletion if chunk not required anymore*/
-		unsigned int m_chunk_key=0;
+		uint64_t m_chunk_key=0;
+		// Vertex spacing of the chunk drawn in place of this one while it loads, see ChunkLoader::RequestChunkLoad
+		float m_geometric_error = 0.f;
 
 		AABB m_bounding_box;
-		MeshVAO m_vao;
-		TerrainGenerator::TerrainData data;
+		TerrainGenerator::Heightfield m_heightfield;
+		// Created on upload so chunks can be built and generated without a GL context
+		std::unique_ptr<Texture2D> mp_height_tex = nullptr;
 
 		glm::vec3 m_bot_left_coord;
 		unsigned int m_resolution;
@@ -29,6 +55,5 @@ namespace ORNG {
 		unsigned int m_seed;
 		bool m_is_initialized = false;
 		bool m_data_is_loaded = false;
-		bool is_loading = false;
 	};
-}
\ No newline at end of file
+}
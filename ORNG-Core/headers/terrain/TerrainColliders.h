@@ -0,0 +1,90 @@
+#pragma once
+#include "terrain/ChunkStreamer.h"
+
+namespace physx {
+	class PxRigidStatic;
+}
+
+namespace ORNG {
+	class PhysicsSystem;
+
+	/*
+		Static PxHeightField colliders for the terrain, in fixed size tiles around a focus point with the same sample spacing at every distance, so collision doesn't change with the render quadtree's LOD.
+		Tiles are generated and cooked on their own ChunkStreamer's workers, then created and added to a PhysicsSystem as world actors on the main thread.
+		Tiles that leave the load radius (plus half a tile, so a focus hovering on a tile edge doesn't thrash) are removed and released.
+	*/
+	class TerrainColliders {
+	public:
+		struct Settings {
+			// World units between height samples
+			unsigned sample_spacing = 2;
+			// World units per tile side, must be a multiple of sample_spacing
+			unsigned tile_width = 256;
+			// Tiles with any part of their footprint within this distance of the focus on the xz plane are loaded
+			float load_radius = 256.f;
+			unsigned num_workers = 1;
+		};
+
+		TerrainColliders(unsigned seed, float height_scale, const Settings& settings);
+		~TerrainColliders();
+
+		// Requests tiles that came into range, removes tiles that left it and adds cooked tiles to "physics"
+		// Must be given the same PhysicsSystem every time until Clear is called
+		void Update(glm::vec3 focus_pos, PhysicsSystem& physics);
+
+		// Blocks until every requested tile has been cooked and added, for tools and tests
+		void WaitForTiles(PhysicsSystem& physics);
+
+		// Removes every tile from the PhysicsSystem it was added to and cancels the rest, has to be called before that system is unloaded
+		void Clear();
+
+		struct Stats {
+			unsigned loaded_tiles = 0;
+			unsigned pending_tiles = 0;
+			// Cooked PxHeightField streams of the loaded tiles
+			size_t cooked_bytes = 0;
+			ChunkStreamer::Metrics streaming;
+		};
+
+		Stats GetStats();
+
+		const Settings& GetSettings() const {
+			return m_settings;
+		}
+
+		// Post-process step run on the streamer's workers, cooks the chunk's heightfield into its payload and frees the samples
+		static void CookHeightField(ChunkStreamer::CompletedChunk& chunk);
+
+	private:
+		struct Tile {
+			int x = 0;
+			int z = 0;
+			uint64_t key = 0;
+			// Null until cooked
+			physx::PxRigidStatic* p_actor = nullptr;
+			size_t cooked_bytes = 0;
+		};
+
+		// Adds finished tiles to "physics"
+		void ProcessCompleted(PhysicsSystem& physics);
+
+		void CreateActor(Tile& tile, ChunkStreamer::CompletedChunk& chunk, PhysicsSystem& physics);
+		void ReleaseTile(Tile& tile);
+
+		float FootprintDistance(int x, int z, glm::vec2 pos) const;
+
+		glm::vec3 GetTileBotLeft(int x, int z) const {
+			return glm::vec3{ static_cast<float>(x * static_cast<int>(m_settings.tile_width)), 0.f, static_cast<float>(z * static_cast<int>(m_settings.tile_width)) };
+		}
+
+		Settings m_settings;
+		unsigned m_seed;
+		float m_height_scale;
+
+		ChunkStreamer m_streamer;
+		// Unordered, only tens of tiles are loaded at once
+		std::vector<Tile> m_tiles;
+		// Set by Update, tiles are removed from this
+		PhysicsSystem* mp_physics = nullptr;
+	};
+}
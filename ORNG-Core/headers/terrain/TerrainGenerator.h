@@ -34,9 +34,43 @@ namespace ORNG {
 			glm::vec3 tangent_2 = glm::vec3(0);
 		};
 
+		// Compact chunk format, only heights are stored and positions, normals and tex coords are reconstructed from them in the vertex shader (TERRAIN_MODE in GBufferVS.glsl)
+		struct Heightfield {
+			// (side_length_steps + 2)^2 samples laid out x-major, with a one sample border so normals at the chunk's edges match its neighbours
+			// Normalized over [min_height, min_height + height_range]
+			std::vector<uint16_t> samples;
+			unsigned side_length_steps = 0;
+			float min_height = 0.f;
+			float height_range = 0.f;
+			// How far skirts hang below the chunk's edges to cover cracks against coarser neighbours
+			float skirt_depth = 0.f;
+
+			unsigned GetGridSize() const { return side_length_steps + 2; }
+
+			// Vertex coordinates, the border isn't included
+			float GetHeight(unsigned lx, unsigned lz) const;
+
+			size_t GetSizeBytes() const { return samples.size() * sizeof(uint16_t); }
+		};
+
 		// Resolution = width/height of grid, smaller = more detailed
 		static void GenNoiseChunk(unsigned int seed, int width, unsigned int resolution, float height_scale, glm::vec3 bot_left_coord, VertexData3D& output_data, AABB& output_bounding_box);
 
+		// Fills the chunk's whole heightfield (plus a one sample border) first, then derives normals/tangents from central differences over it in a separate pass
+		// Heights and layout match GenNoiseChunk, but there's exactly one normal/tangent/tex coord per vertex
+		static void GenNoiseChunkBatched(unsigned int seed, int width, unsigned int resolution, float height_scale, glm::vec3 bot_left_coord, VertexData3D& output_data, AABB& output_bounding_box);
+
+		// Same heights as GenNoiseChunkBatched, quantized to 16 bits over the chunk's height range
+		static void GenHeightfieldChunk(unsigned int seed, int width, unsigned int resolution, float height_scale, glm::vec3 bot_left_coord, Heightfield& output, AABB& output_bounding_box);
+
+		// Index buffer shared by every heightfield chunk with the same side length, vertex ids are grid coordinates (lx * side_length_steps + lz)
+		// With skirts, ids from side_length_steps^2 onwards are skirt vertices hanging below the edges, "side_length_steps" per edge in the order -x, +x, -z, +z
+		static void GenHeightfieldIndices(unsigned side_length_steps, bool with_skirts, std::vector<unsigned>& output);
+
+		// Unquantized height at a world position, matches the chunk functions' vertices there
+		// Creates the noise generators on every call, use the chunk functions to sample many points
+		static float GetHeight(unsigned int seed, float height_scale, float x, float z);
+
 	private:
 		static QuadVertices GenQuad(float size, glm::vec3 bot_left_vert_pos);
 	};
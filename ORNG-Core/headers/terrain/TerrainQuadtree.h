@@ -1,64 +1,127 @@
 #pragma once
+#include <limits>
 #include "TerrainGenerator.h"
 
 namespace ORNG {
-	class ChunkLoader;
 	class TerrainChunk;
 
+	/*
+		Chunked LOD over a square terrain. Every chunk has CHUNK_QUADS quads per side, so each level down halves the vertex spacing and every chunk shares one index buffer.
+		A node splits once the camera is within lod_distance_factor node widths of its footprint and merges once it's further than that plus the hysteresis margin, so the camera hovering around a boundary doesn't thrash.
+		Nodes and chunks come from pools that are only grown when the tree reaches a new peak size, updates reuse them and don't allocate.
+	*/
 	class TerrainQuadtree {
 	public:
 		friend class Terrain;
 		friend class EditorLayer;
 
-		/*This constructor only to be used for master quadtree*/
-		TerrainQuadtree(unsigned int width, float height_scale, unsigned int seed, glm::vec3 center_pos, unsigned int resolution);
-
-		void Update(glm::vec3 center_pos);
-		TerrainQuadtree* FindParentWithChunk();
-		TerrainQuadtree(glm::vec3 center_pos, TerrainQuadtree* parent);
+		// "width" is rounded up so every level's vertex spacing is a whole number
+		TerrainQuadtree(unsigned int width, float height_scale, unsigned int seed, glm::vec3 center_pos);
 		~TerrainQuadtree();
 
-		void Subdivide();
-		void Unsubdivide();
-		const TerrainChunk* GetChunk() const {
-			return m_chunk;
+		struct UpdateStats {
+			// Camera hadn't moved far enough since the last evaluation to change any split/merge decision, no nodes were visited
+			bool skipped = false;
+			unsigned nodes_evaluated = 0;
+			unsigned splits = 0;
+			unsigned merges = 0;
+			// Times the node or chunk pools had to grow, zero once the tree has reached its peak size
+			unsigned pool_allocations = 0;
+		};
+
+		// Returns true if any node split or merged
+		bool Update(glm::vec3 camera_pos);
+
+		const UpdateStats& GetLastUpdateStats() const {
+			return m_last_update_stats;
 		}
 
-		/* Look for nodes within radius "boundary" from center_pos, leaf node matches stored in chunk_array, inclusive
-		* Chunk pointers only guaranteed to be valid for one frame
-		*/
-		//void QueryChunks(std::vector<TerrainChunk*>& chunk_array, glm::vec3 center_pos, int boundary);
-		void QueryTree(std::vector<TerrainQuadtree*>& node_array, glm::vec3 center_pos, int boundary);
-		void QueryChunks(std::vector<TerrainQuadtree*>& node_array, glm::vec3 center_pos, int boundary);
+		// Loaded leaf chunks, with the closest loaded ancestor drawn instead wherever a node's children aren't all loaded yet
+		// Only rebuilt when the tree changed or chunks were still loading, valid until the next call
+		const std::vector<const TerrainChunk*>& GetDrawChunks();
+
+		// Multiplier of a node's width, a node splits when the camera is closer than this to its footprint and merges once it's further than this * (1 + merge_hysteresis)
+		void SetLODDistances(float lod_distance_factor, float merge_hysteresis);
+
+		// Adds every loaded chunk in the tree (parent nodes keep their chunks loaded as stand-ins) and the storage kept by pooled chunks
+		void AccumulateMemoryStats(unsigned& num_chunks, size_t& cpu_bytes, size_t& gpu_bytes) const;
 
-		bool CheckIntersection(glm::vec3 position) const;
+		unsigned GetNumActiveNodes() const {
+			return m_num_active_nodes;
+		}
 
-		TerrainQuadtree& GetParent() {
-			if (!m_is_root_node) return *m_parent;
-			return *this;
+		unsigned GetMaxDepth() const {
+			return m_max_depth;
 		}
 
+		static constexpr unsigned CHUNK_QUADS = 64;
+		// Leaf nodes are never narrower than this
+		static constexpr unsigned MIN_NODE_WIDTH = 128;
+		static constexpr float DEFAULT_LOD_DISTANCE_FACTOR = 1.f;
+		static constexpr float DEFAULT_MERGE_HYSTERESIS = 0.25f;
 
 	private:
+		static constexpr uint32_t INVALID_NODE = std::numeric_limits<uint32_t>::max();
+
+		struct Node {
+			// Bottom left corner on the xz plane
+			glm::vec2 min{ 0, 0 };
+			float width = 0.f;
+			uint32_t depth = 0;
+			// Children are allocated as a block of 4 consecutive nodes
+			uint32_t first_child = INVALID_NODE;
+			TerrainChunk* p_chunk = nullptr;
+		};
+
+		void Split(uint32_t node_index);
+		void Merge(uint32_t node_index);
+
+		uint32_t AllocateChildBlock();
+		TerrainChunk* AcquireChunk(const Node& node, float geometric_error);
+		void ReleaseChunk(TerrainChunk* p_chunk);
+
+		// Distance from the camera to the node's footprint on the xz plane, 0 if the camera is above it
+		static float FootprintDistance(const Node& node, glm::vec2 camera_pos);
+
+		float GetSplitDistance(const Node& node) const {
+			return node.width * m_lod_distance_factor;
+		}
+
+		unsigned GetResolution(const Node& node) const {
+			return static_cast<unsigned>(node.width) / CHUNK_QUADS;
+		}
+
+		// True if the node's chunk or all of its children can be drawn
+		bool IsReady(uint32_t node_index) const;
+		void CollectDrawChunks(uint32_t node_index);
+
+		static constexpr uint32_t ROOT_NODE = 0;
+
+		// Node 0 is the root, the rest are blocks of 4 siblings
+		std::vector<Node> m_nodes;
+		std::vector<uint32_t> m_free_child_blocks;
+		unsigned m_num_active_nodes = 0;
+
+		std::vector<std::unique_ptr<TerrainChunk>> m_chunk_storage;
+		std::vector<TerrainChunk*> m_free_chunks;
+
+		// Reused by Update
+		std::vector<uint32_t> m_eval_stack;
 
-		TerrainChunk* m_chunk = nullptr;
+		std::vector<const TerrainChunk*> m_draw_chunks;
+		bool m_draw_list_dirty = true;
 
-		/* Nodes */
-		std::vector<TerrainQuadtree> m_child_nodes;
+		// No split/merge decision can change until the camera is "m_decision_slack" away from "m_last_eval_pos", -1 forces an evaluation
+		glm::vec2 m_last_eval_pos{ 0, 0 };
+		float m_decision_slack = -1.f;
+		UpdateStats m_last_update_stats;
 
-		TerrainQuadtree* m_parent = nullptr;
-		int m_master_width;
-		bool m_is_root_node = false;
-		bool m_is_subdivided = false;
-		int m_subdivision_layer = 0;
-		int m_max_subdivision_layer;
-		int m_min_grid_width = 128;
+		float m_lod_distance_factor = DEFAULT_LOD_DISTANCE_FACTOR;
+		float m_merge_hysteresis = DEFAULT_MERGE_HYSTERESIS;
 
-		/*Data for building terrain*/
-		glm::vec3 m_center_pos = glm::vec3(0, 0, 0);
-		int m_width;
-		unsigned int m_seed;
+		unsigned m_max_depth = 0;
+		float m_base_height;
+		unsigned m_seed;
 		float m_height_scale;
-		unsigned int m_resolution;
 	};
-}
\ No newline at end of file
+}
@@ -38,6 +38,7 @@ namespace ORNG {
 			}
 
 			interpolator.scale = interpolator_node["Scale"].as<float>();
+			interpolator.BakeLUT();
 		}
 	};
 
@@ -7,6 +7,9 @@ namespace ORNG {
 		friend class InterpolatorSerializer;
 
 	public:
+		// Samples evenly spaced over x_min_max, including both ends
+		static constexpr unsigned LUT_SIZE = 64;
+
 		InterpolatorV1(glm::vec2 t_min_max_x, glm::vec2 t_min_max_y, float p1_val, float p2_val) : x_min_max(t_min_max_x), y_min_max(t_min_max_y) {
 			AddPoint(t_min_max_x.x, p1_val);
 			AddPoint(t_min_max_x.y, p2_val);
@@ -14,6 +17,15 @@ namespace ORNG {
 
 		float GetValue(float x);
 
+		// Same curve as GetValue (without scale) through the baked LUT, x is clamped to x_min_max
+		float SampleLUT(float x) const {
+			float coord = glm::clamp((x - x_min_max.x) / (x_min_max.y - x_min_max.x), 0.f, 1.f) * (LUT_SIZE - 1);
+			unsigned i = glm::min(static_cast<unsigned>(coord), LUT_SIZE - 2);
+			return glm::mix(m_lut[i], m_lut[i + 1], coord - static_cast<float>(i));
+		}
+
+		const std::array<float, LUT_SIZE>& GetLUT() const { return m_lut; }
+
 		void AddPoint(float x, float y);
 
 		void SetPoint(unsigned index, glm::vec2 v);
@@ -25,7 +37,12 @@ namespace ORNG {
 		glm::vec2 GetPoint(unsigned index);
 
 		void SortPoints() {
-			std::ranges::sort(points, [](const glm::vec2& point_left, const glm::vec2& point_right) {return point_left.x < point_right.x; });
+			auto comp = [](const glm::vec2& point_left, const glm::vec2& point_right) {return point_left.x < point_right.x; };
+			if (std::ranges::is_sorted(points, comp))
+				return;
+
+			std::ranges::sort(points, comp);
+			BakeLUT();
 		}
 
 		void ConvertSelfToBytes(std::byte*& p_byte);
@@ -36,7 +53,11 @@ namespace ORNG {
 		inline static const unsigned GPU_INTERPOLATOR_STRUCT_MAX_POINTS = 8;
 
 	private:
+		// Resamples the points into m_lut, called whenever the points change
+		void BakeLUT();
+
 		std::vector<glm::vec2> points;
+		std::array<float, LUT_SIZE> m_lut;
 
 		const glm::vec2 x_min_max = { 0, 1 };
 		const glm::vec2 y_min_max = { 0, 1 };
@@ -47,6 +68,9 @@ namespace ORNG {
 		friend class SceneSerializer;
 		friend class InterpolatorSerializer;
 	public:
+		// Samples evenly spaced over x_min_max, including both ends
+		static constexpr unsigned LUT_SIZE = 64;
+
 		InterpolatorV3(glm::vec2 t_min_max_x, glm::vec2 t_min_max_yzw, glm::vec3 p1_val, glm::vec3 p2_val) : x_min_max(t_min_max_x), yzw_min_max(t_min_max_yzw) {
 			AddPoint(x_min_max.x, p1_val);
 			AddPoint(x_min_max.y, p2_val);
@@ -54,6 +78,15 @@ namespace ORNG {
 
 		glm::vec3 GetValue(float x);
 
+		// Same curve as GetValue (without scale) through the baked LUT, x is clamped to x_min_max
+		glm::vec3 SampleLUT(float x) const {
+			float coord = glm::clamp((x - x_min_max.x) / (x_min_max.y - x_min_max.x), 0.f, 1.f) * (LUT_SIZE - 1);
+			unsigned i = glm::min(static_cast<unsigned>(coord), LUT_SIZE - 2);
+			return glm::mix(m_lut[i], m_lut[i + 1], coord - static_cast<float>(i));
+		}
+
+		const std::array<glm::vec3, LUT_SIZE>& GetLUT() const { return m_lut; }
+
 		void AddPoint(float x, glm::vec3 v);
 
 		void SetPoint(unsigned index, const glm::vec4& v);
@@ -65,7 +98,12 @@ namespace ORNG {
 		glm::vec4 GetPoint(unsigned index);
 
 		void SortPoints() {
-			std::ranges::sort(points, [](const glm::vec4& point_left, const glm::vec4& point_right) {return point_left.x < point_right.x; });
+			auto comp = [](const glm::vec4& point_left, const glm::vec4& point_right) {return point_left.x < point_right.x; };
+			if (std::ranges::is_sorted(points, comp))
+				return;
+
+			std::ranges::sort(points, comp);
+			BakeLUT();
 		}
 
 		void ConvertSelfToBytes(std::byte*& p_byte);
@@ -75,9 +113,12 @@ namespace ORNG {
 		inline static const unsigned GPU_STRUCT_SIZE_BYTES = sizeof(glm::vec4) * 8 + sizeof(unsigned);
 		inline static const unsigned GPU_INTERPOLATOR_STRUCT_MAX_POINTS = 8;
 	private:
+		// Resamples the points into m_lut, called whenever the points change
+		void BakeLUT();
 
 		const glm::vec2 x_min_max = { 0, 1 };
 		const glm::vec2 yzw_min_max = { 0, 1 };
 		std::vector<glm::vec4> points;
+		std::array<glm::vec3, LUT_SIZE> m_lut;
 	};
 }
\ No newline at end of file
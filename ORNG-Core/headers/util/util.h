@@ -138,6 +138,9 @@ namespace ORNG {
 	MISC UTILS
 	*/
 
+	// FNV-1a, pass the result of a previous call as "seed" to hash several buffers together
+	uint64_t HashBytes(const void* p_data, size_t size, uint64_t seed = 14695981039346656037ull);
+
 	template<Vec2Type T>
 	glm::vec2 xy(T vec) {
 		return { vec.x, vec.y };
@@ -140,7 +140,7 @@ vec4 CalculateAlbedoAndEmissive(vec2 tex_coord) {
 
 	float interpolation = 1.0 - clamp(PTCL.velocity_life.w, 0.0, EMITTER.lifespan) / EMITTER.lifespan;
 
-	albedo_col *= vec4(InterpolateV3(interpolation, EMITTER.colour_over_life), 1.0);
+	albedo_col *= vec4(SampleColourOverLife(PTCL.emitter_index, interpolation), 1.0);
 
 #endif
 	if (u_emissive_sampler_active) {
@@ -48,6 +48,39 @@ uniform vec3 u_aligned_camera_pos;
 
 uniform Material u_material;
 
+#ifdef TERRAIN_MODE
+// Chunks only store heights (see TerrainGenerator::Heightfield), positions, normals and tex coords are rebuilt from gl_VertexID
+layout(binding = 28) uniform sampler2D terrain_height_sampler;
+uniform vec3 u_chunk_origin;
+uniform float u_chunk_spacing;
+uniform uint u_chunk_steps;
+uniform float u_chunk_min_height;
+uniform float u_chunk_height_range;
+uniform float u_chunk_skirt_depth;
+
+// The heightfield has a one sample border and is laid out x-major, so rows are x and columns are z
+float TerrainHeight(ivec2 coord) {
+	return u_chunk_min_height + texelFetch(terrain_height_sampler, coord.yx + 1, 0).r * u_chunk_height_range;
+}
+
+// Grid coordinates of the vertex, ids past the grid are skirt vertices in the order -x, +x, -z, +z (see TerrainGenerator::GenHeightfieldIndices)
+ivec2 TerrainVertexCoord(int id, int steps, out bool is_skirt) {
+	is_skirt = id >= steps * steps;
+	if (!is_skirt)
+		return ivec2(id / steps, id % steps);
+
+	int skirt_id = id - steps * steps;
+	int edge = skirt_id / steps;
+	int i = skirt_id % steps;
+	int last = steps - 1;
+
+	if (edge == 0) return ivec2(0, i);
+	else if (edge == 1) return ivec2(last, i);
+	else if (edge == 2) return ivec2(i, 0);
+	else return ivec2(i, last);
+}
+#endif
+
 mat3 CalculateTbnMatrixTransform() {
 
 #ifdef PARTICLE
@@ -89,10 +122,19 @@ void main() {
 	vert_data.original_normal = vertex_normal;
 
 #ifdef TERRAIN_MODE
-
-		vert_data.tex_coord = tex_coord;
-		vert_data.normal = vertex_normal;
-		vert_data.position = vec4(position, 1.f);
+		int steps = int(u_chunk_steps);
+		bool is_skirt;
+		ivec2 coord = TerrainVertexCoord(gl_VertexID, steps, is_skirt);
+
+		float height = TerrainHeight(coord);
+		float dx = (TerrainHeight(coord + ivec2(1, 0)) - TerrainHeight(coord - ivec2(1, 0))) / (2.0 * u_chunk_spacing);
+		float dz = (TerrainHeight(coord + ivec2(0, 1)) - TerrainHeight(coord - ivec2(0, 1))) / (2.0 * u_chunk_spacing);
+
+		vert_data.tex_coord = vec2(coord) / float(steps);
+		vert_data.normal = normalize(vec3(-dx, 1.0, -dz));
+		vert_data.tangent = normalize(vec3(1.0, dx, 0.0));
+		vert_data.original_normal = vert_data.normal;
+		vert_data.position = vec4(u_chunk_origin.x + coord.x * u_chunk_spacing, height - (is_skirt ? u_chunk_skirt_depth : 0.0), u_chunk_origin.z + coord.y * u_chunk_spacing, 1.0);
 		gl_Position = PVMatrices.proj_view * vert_data.position;
 
 #elif defined SKYBOX_MODE
@@ -135,7 +177,7 @@ void main() {
 
 		#if defined PARTICLE && defined BILLBOARD
 			#ifndef PARTICLES_DETACHED
-				vec3 interpolated_scale = InterpolateV3(interpolation, EMITTER.scale_over_life);
+				vec3 interpolated_scale = SampleScaleOverLife(PTCL.emitter_index, interpolation);
 			#endif
 
 			#define TRANSFORM PARTICLE_SSBO.particles[vs_particle_index]
@@ -1,6 +1,8 @@
 ORNG_INCLUDE "UtilINCL.glsl"
 ORNG_INCLUDE "CommonINCL.glsl"
 #define VELOCITY_SCALE 35.0
+// InterpolatorV1/V3::LUT_SIZE
+#define INTERPOLATOR_LUT_SIZE 64
 
 // Emitters both manage the memory for particles as well as the update/render functionality
 // The update/render functionality can be overidden in a custom layer
@@ -19,17 +21,25 @@ struct ParticleEmitter {
     float lifespan;
     float spawn_cooldown;
     int is_active;
-    float pad1;
-
-    InterpolatorV3 colour_over_life;
-    InterpolatorV3 scale_over_life;
-    InterpolatorV1 alpha_over_life;
+    // Simulated by CPUParticleSimulator and uploaded every frame, ParticleCS leaves its particles alone
+    int is_cpu_simulated;
 
     vec4 acceleration;
 
 
 };
 
+// The emitter's interpolators baked on the CPU, sampled with the Sample...OverLife functions below
+// Only rewritten when the interpolators change, so it is kept apart from ParticleEmitter which is rewritten whenever the emitter moves
+struct ParticleEmitterLUTs {
+    vec4 colour_over_life[INTERPOLATOR_LUT_SIZE];
+    vec4 scale_over_life[INTERPOLATOR_LUT_SIZE];
+    // 4 samples per element
+    vec4 alpha_over_life[INTERPOLATOR_LUT_SIZE / 4];
+    // Colour, scale, alpha
+    vec4 scales;
+};
+
 struct ParticleBufferData {
     uint buffer_id;
 
@@ -54,6 +64,39 @@ layout(std140, binding = 5) buffer ParticleEmitters {
     ParticleEmitter emitters[];
 } ssbo_particle_emitters;
 
+layout(std140, binding = 9) readonly buffer ParticleEmitterInterpolatorLUTs {
+    ParticleEmitterLUTs luts[];
+} ssbo_particle_emitter_luts;
+
+#define EMITTER_LUTS ssbo_particle_emitter_luts.luts[emitter_index]
+
+// Same as SampleLUT in Interpolators.h, x is the particle's point in its life in [0, 1]
+void GetLUTSamplePos(float x, out uint i, out float f) {
+    float coord = clamp(x, 0.0, 1.0) * float(INTERPOLATOR_LUT_SIZE - 1);
+    i = min(uint(coord), uint(INTERPOLATOR_LUT_SIZE - 2));
+    f = coord - float(i);
+}
+
+vec3 SampleColourOverLife(uint emitter_index, float x) {
+    uint i; float f;
+    GetLUTSamplePos(x, i, f);
+    return mix(EMITTER_LUTS.colour_over_life[i].rgb, EMITTER_LUTS.colour_over_life[i + 1u].rgb, f) * EMITTER_LUTS.scales.x;
+}
+
+vec3 SampleScaleOverLife(uint emitter_index, float x) {
+    uint i; float f;
+    GetLUTSamplePos(x, i, f);
+    return mix(EMITTER_LUTS.scale_over_life[i].xyz, EMITTER_LUTS.scale_over_life[i + 1u].xyz, f) * EMITTER_LUTS.scales.y;
+}
+
+float SampleAlphaOverLife(uint emitter_index, float x) {
+    uint i; float f;
+    GetLUTSamplePos(x, i, f);
+    return mix(EMITTER_LUTS.alpha_over_life[i / 4u][i % 4u], EMITTER_LUTS.alpha_over_life[(i + 1u) / 4u][(i + 1u) % 4u], f) * EMITTER_LUTS.scales.z;
+}
+
+#undef EMITTER_LUTS
+
 
 
 #ifndef PARTICLES_DETACHED
@@ -11,6 +11,9 @@ ORNG_INCLUDE "BuffersINCL.glsl"
 
     
 void main() {
+        if (bool(EMITTER.is_cpu_simulated))
+            return;
+
         ssbo_particles.particles[ gl_GlobalInvocationID.x].velocity_life.w -= ubo_common.delta_time;
 
         if (ssbo_particles.particles[ gl_GlobalInvocationID.x].velocity_life.w <= 0.0 && bool(ssbo_particle_emitters.emitters[ssbo_particles.particles[ gl_GlobalInvocationID.x].emitter_index].is_active)) {
@@ -71,7 +71,7 @@ vec4 sampled_albedo = texture(diffuse_sampler, tex_coord.xy);
 
 	float interpolation = 1.0 - (clamp(PTCL.velocity_life.w, 0.0, EMITTER.lifespan) / EMITTER.lifespan);
 
-	albedo_col *= vec4(InterpolateV3(interpolation, EMITTER.colour_over_life), InterpolateV1(interpolation, EMITTER.alpha_over_life));
+	albedo_col *= vec4(SampleColourOverLife(PTCL.emitter_index, interpolation), SampleAlphaOverLife(PTCL.emitter_index, interpolation));
 #endif
 
 	if (u_emissive_sampler_active) {
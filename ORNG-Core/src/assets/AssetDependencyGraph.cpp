@@ -0,0 +1,267 @@
+#include "pch/pch.h"
+#include "assets/AssetDependencyGraph.h"
+#include "assets/AssetManager.h"
+#include "yaml-cpp/yaml.h"
+
+
+namespace ORNG {
+	static void OutDependency(std::vector<uint64_t>& output, uint64_t uuid) {
+		// Base assets are always resident so never need tracking
+		if (uuid >= ORNG_NUM_BASE_ASSETS)
+			output.push_back(uuid);
+	}
+
+	static void OutDependencySeq(std::vector<uint64_t>& output, const YAML::Node& node) {
+		if (!node || !node.IsSequence())
+			return;
+
+		for (auto id : node) {
+			OutDependency(output, id.as<uint64_t>());
+		}
+	}
+
+	static void EmitEntry(YAML::Emitter& out, const AssetManifestEntry& entry) {
+		out << YAML::BeginMap;
+		out << YAML::Key << "UUID" << YAML::Value << entry.uuid;
+		out << YAML::Key << "Type" << YAML::Value << (unsigned)entry.type;
+		out << YAML::Key << "Path" << YAML::Value << entry.filepath;
+		out << YAML::Key << "Bytes" << YAML::Value << entry.size_bytes;
+
+		if (entry.type == AssetType::MESH)
+			out << YAML::Key << "NbMaterials" << YAML::Value << (unsigned)entry.num_materials;
+
+		out << YAML::Key << "Deps" << YAML::Value << YAML::Flow << YAML::BeginSeq;
+		for (auto dep : entry.dependencies) {
+			out << dep;
+		}
+		out << YAML::EndSeq;
+
+		if (!entry.blocking_dependencies.empty()) {
+			out << YAML::Key << "BlockingDeps" << YAML::Value << YAML::Flow << YAML::BeginSeq;
+			for (auto dep : entry.blocking_dependencies) {
+				out << dep;
+			}
+			out << YAML::EndSeq;
+		}
+
+		out << YAML::EndMap;
+	}
+
+	// Paths of meshes/prefabs may be absolute if they were created this session, strip them down to ".\\res\\..." so the manifest stays valid in builds
+	static std::string MakeProjectRelative(const std::string& path, const std::string& res_folder) {
+		auto pos = path.rfind(res_folder);
+		return pos == std::string::npos ? path : ".\\" + path.substr(pos);
+	}
+
+	static uint64_t GetFileSizeOrZero(const std::string& filepath) {
+		try {
+			return FileExists(filepath) ? std::filesystem::file_size(filepath) : 0;
+		}
+		catch (std::exception& e) {
+			ORNG_CORE_ERROR("Asset manifest error: Failed reading file size of '{0}', '{1}'", filepath, e.what());
+			return 0;
+		}
+	}
+
+	void AssetDependencyGraph::WriteManifest(const std::string& output_filepath) {
+		std::vector<AssetManifestEntry> entries;
+
+		for (auto* p_tex : AssetManager::GetView<Texture2D>()) {
+			auto& entry = entries.emplace_back();
+			entry.uuid = p_tex->uuid();
+			entry.type = AssetType::TEXTURE;
+			entry.filepath = AssetManager::GetTextureBinaryPath(*p_tex);
+		}
+
+		for (auto* p_mesh : AssetManager::GetView<MeshAsset>()) {
+			auto& entry = entries.emplace_back();
+			entry.uuid = p_mesh->uuid();
+			entry.type = AssetType::MESH;
+			entry.filepath = MakeProjectRelative(p_mesh->filepath, "res\\meshes");
+			entry.num_materials = p_mesh->GetNbMaterials();
+		}
+
+		for (auto* p_sound : AssetManager::GetView<SoundAsset>()) {
+			auto& entry = entries.emplace_back();
+			entry.uuid = p_sound->uuid();
+			entry.type = AssetType::SOUND;
+			entry.filepath = AssetManager::GetSoundBinaryPath(*p_sound);
+		}
+
+		for (auto* p_mat : AssetManager::GetView<Material>()) {
+			auto& entry = entries.emplace_back();
+			entry.uuid = p_mat->uuid();
+			entry.type = AssetType::MATERIAL;
+			entry.filepath = AssetManager::GetMaterialBinaryPath(*p_mat);
+
+			for (auto* p_tex : p_mat->GetTextures()) {
+				if (p_tex)
+					OutDependency(entry.dependencies, p_tex->uuid());
+			}
+		}
+
+		for (auto* p_mat : AssetManager::GetView<PhysXMaterialAsset>()) {
+			auto& entry = entries.emplace_back();
+			entry.uuid = p_mat->uuid();
+			entry.type = AssetType::PHYSX_MATERIAL;
+			entry.filepath = AssetManager::GetPhysXMaterialBinaryPath(*p_mat);
+		}
+
+		for (auto* p_prefab : AssetManager::GetView<Prefab>()) {
+			auto& entry = entries.emplace_back();
+			entry.uuid = p_prefab->uuid();
+			entry.type = AssetType::PREFAB;
+			entry.filepath = MakeProjectRelative(p_prefab->filepath, "res\\prefabs");
+
+			YAML::Node node = p_prefab->serialized_content.empty() ? p_prefab->node : YAML::Load(p_prefab->serialized_content);
+			CollectEntityArrayDependencies(node["Entities"], entry.dependencies, entry.blocking_dependencies);
+		}
+
+		YAML::Emitter out;
+		out << YAML::BeginMap;
+		out << YAML::Key << "Assets" << YAML::Value << YAML::BeginSeq;
+		for (auto& entry : entries) {
+			entry.size_bytes = GetFileSizeOrZero(entry.filepath);
+			EmitEntry(out, entry);
+		}
+		out << YAML::EndSeq;
+		out << YAML::EndMap;
+
+		std::ofstream fout{ output_filepath };
+		if (!fout.is_open()) {
+			ORNG_CORE_ERROR("Asset manifest error: Cannot open {0} for writing", output_filepath);
+			return;
+		}
+
+		fout << out.c_str();
+	}
+
+	bool AssetDependencyGraph::LoadManifest(const std::string& filepath) {
+		m_entries.clear();
+
+		if (!FileExists(filepath))
+			return false;
+
+		YAML::Node data;
+		try {
+			data = YAML::LoadFile(filepath);
+		}
+		catch (std::exception& e) {
+			ORNG_CORE_ERROR("Asset manifest error: Failed parsing '{0}', '{1}'", filepath, e.what());
+			return false;
+		}
+
+		if (!data["Assets"])
+			return false;
+
+		for (auto node : data["Assets"]) {
+			AssetManifestEntry entry;
+			entry.uuid = node["UUID"].as<uint64_t>();
+			entry.type = static_cast<AssetType>(node["Type"].as<unsigned>());
+			entry.filepath = node["Path"].as<std::string>();
+			entry.size_bytes = node["Bytes"].as<uint64_t>();
+			if (node["NbMaterials"])
+				entry.num_materials = static_cast<uint8_t>(node["NbMaterials"].as<unsigned>());
+
+			entry.dependencies = node["Deps"].as<std::vector<uint64_t>>();
+			if (node["BlockingDeps"])
+				entry.blocking_dependencies = node["BlockingDeps"].as<std::vector<uint64_t>>();
+
+			m_entries[entry.uuid] = std::move(entry);
+		}
+
+		return true;
+	}
+
+	void AssetDependencyGraph::CollectEntityDependencies(const YAML::Node& entity_node, std::vector<uint64_t>& output, std::vector<uint64_t>& blocking_meshes) {
+		if (auto mesh_comp = entity_node["MeshComp"]) {
+			uint64_t mesh_id = mesh_comp["MeshAssetID"].as<uint64_t>();
+			OutDependency(output, mesh_id);
+			OutDependencySeq(output, mesh_comp["Materials"]);
+
+			// Triangle mesh colliders are cooked from the CPU-side vertex data as the scene is deserialized
+			if (entity_node["PhysicsComp"])
+				OutDependency(blocking_meshes, mesh_id);
+		}
+
+		if (auto physics_comp = entity_node["PhysicsComp"]) {
+			OutDependency(output, physics_comp["MaterialUUID"].as<uint64_t>());
+		}
+
+		if (auto audio_comp = entity_node["AudioComp"]) {
+			OutDependency(output, audio_comp["AudioUUID"].as<uint64_t>());
+		}
+
+		if (auto vehicle_comp = entity_node["VehicleComp"]) {
+			for (auto* key : { "BodyMesh", "WheelMesh" }) {
+				uint64_t mesh_id = vehicle_comp[key].as<uint64_t>();
+				OutDependency(output, mesh_id);
+				OutDependency(blocking_meshes, mesh_id);
+			}
+
+			OutDependencySeq(output, vehicle_comp["BodyMaterials"]);
+			OutDependencySeq(output, vehicle_comp["WheelMaterials"]);
+		}
+
+		if (auto emitter_comp = entity_node["ParticleEmitterComp"]) {
+			if (emitter_comp["MaterialUUID"]) {
+				OutDependency(output, emitter_comp["MaterialUUID"].as<uint64_t>());
+			}
+			else if (emitter_comp["MeshUUID"]) {
+				uint64_t mesh_id = emitter_comp["MeshUUID"].as<uint64_t>();
+				OutDependency(output, mesh_id);
+				OutDependency(blocking_meshes, mesh_id);
+				OutDependencySeq(output, emitter_comp["Materials"]);
+			}
+		}
+	}
+
+	void AssetDependencyGraph::CollectEntityArrayDependencies(const YAML::Node& entities, std::vector<uint64_t>& output, std::vector<uint64_t>& blocking_meshes) {
+		if (!entities || !entities.IsSequence())
+			return;
+
+		for (auto entity_node : entities) {
+			CollectEntityDependencies(entity_node, output, blocking_meshes);
+		}
+	}
+
+	void AssetDependencyGraph::ResolveSceneClosure(const std::string& scene_filepath, std::unordered_set<uint64_t>& output, std::unordered_set<uint64_t>& blocking_meshes) const {
+		std::vector<uint64_t> to_visit;
+		std::vector<uint64_t> blocking;
+
+		try {
+			YAML::Node scene = YAML::LoadFile(scene_filepath);
+			CollectEntityArrayDependencies(scene["Entities"], to_visit, blocking);
+		}
+		catch (std::exception& e) {
+			ORNG_CORE_ERROR("Asset dependency graph error: Failed parsing scene '{0}', '{1}'", scene_filepath, e.what());
+		}
+
+		// Scripts can instantiate any prefab by uuid, which can't be seen from here, so every prefab is treated as a root
+		for (auto& [uuid, entry] : m_entries) {
+			if (entry.type == AssetType::PREFAB)
+				to_visit.push_back(uuid);
+		}
+
+		while (!to_visit.empty()) {
+			uint64_t uuid = to_visit.back();
+			to_visit.pop_back();
+
+			if (output.contains(uuid))
+				continue;
+
+			output.insert(uuid);
+
+			if (auto* p_entry = GetEntry(uuid)) {
+				for (auto dep : p_entry->dependencies) {
+					if (!output.contains(dep))
+						to_visit.push_back(dep);
+				}
+
+				blocking.insert(blocking.end(), p_entry->blocking_dependencies.begin(), p_entry->blocking_dependencies.end());
+			}
+		}
+
+		blocking_meshes.insert(blocking.begin(), blocking.end());
+	}
+}
@@ -0,0 +1,497 @@
+#include "pch/pch.h"
+#include "assets/AssetFileWatcher.h"
+#include "util/Log.h"
+#include "util/util.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+
+namespace ORNG {
+	static bool HasExtension(const std::string& path, const std::vector<std::string>& extensions) {
+		return std::ranges::any_of(extensions, [&](const std::string& ext) { return path.ends_with(ext); });
+	}
+
+	void AssetFileWatcher::Start() {
+		if (m_running)
+			return;
+
+#ifdef __linux__
+		m_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		m_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+		if (m_inotify_fd == -1 || m_wake_fd == -1) {
+			ORNG_CORE_WARN("Asset file watcher couldn't set up inotify ({0}), falling back to polling", std::strerror(errno));
+			CloseNotifications();
+
+			if (m_wake_fd != -1) {
+				close(m_wake_fd);
+				m_wake_fd = -1;
+			}
+		}
+
+		m_using_notifications = m_inotify_fd != -1;
+#endif
+
+		// Catches anything that changed while stopped, and sets up notifications for watches kept from before
+		m_rescan = true;
+		m_running = true;
+		m_thread = std::thread([this] { PollLoop(); });
+	}
+
+	void AssetFileWatcher::Stop() {
+		if (!m_running)
+			return;
+
+		{
+			std::scoped_lock lock{ m_mutex };
+			m_running = false;
+		}
+
+		Wake();
+		m_thread.join();
+
+#ifdef __linux__
+		CloseNotifications();
+
+		if (m_wake_fd != -1) {
+			close(m_wake_fd);
+			m_wake_fd = -1;
+		}
+#endif
+	}
+
+	void AssetFileWatcher::Wake() {
+		m_cv.notify_all();
+
+#ifdef __linux__
+		if (m_wake_fd != -1) {
+			uint64_t one = 1;
+			// Can only fail if the counter would overflow, in which case the thread is woken anyway
+			[[maybe_unused]] auto written = write(m_wake_fd, &one, sizeof(one));
+		}
+#endif
+	}
+
+	void AssetFileWatcher::WatchFile(const std::string& filepath) {
+		if (filepath.empty())
+			return;
+
+		{
+			std::scoped_lock lock{ m_mutex };
+			m_files_to_watch.push_back(filepath);
+		}
+
+		Wake();
+	}
+
+	void AssetFileWatcher::UnwatchFile(const std::string& filepath) {
+		if (filepath.empty())
+			return;
+
+		{
+			std::scoped_lock lock{ m_mutex };
+			m_files_to_unwatch.push_back(filepath);
+		}
+
+		Wake();
+	}
+
+	void AssetFileWatcher::WatchDirectory(const std::string& dir, const std::vector<std::string>& extensions) {
+		{
+			std::scoped_lock lock{ m_mutex };
+			m_directories_to_watch.push_back(DirectoryWatch{ dir, extensions });
+		}
+
+		Wake();
+	}
+
+	void AssetFileWatcher::ClearWatches() {
+		{
+			std::scoped_lock lock{ m_mutex };
+			m_files_to_watch.clear();
+			m_files_to_unwatch.clear();
+			m_directories_to_watch.clear();
+			m_ready_changes.clear();
+			m_clear_requested = true;
+		}
+
+		Wake();
+	}
+
+	std::vector<std::string> AssetFileWatcher::ConsumeChanges() {
+		std::scoped_lock lock{ m_mutex };
+		return std::move(m_ready_changes);
+	}
+
+	void AssetFileWatcher::PollLoop() {
+		while (m_running) {
+			Poll();
+
+#ifdef __linux__
+			if (m_inotify_fd != -1) {
+				WaitForNotifications();
+				continue;
+			}
+#endif
+
+			std::unique_lock lock{ m_mutex };
+			m_cv.wait_for(lock, POLL_INTERVAL, [this] { return !m_running; });
+		}
+	}
+
+	void AssetFileWatcher::ApplyWatchRequests() {
+		std::scoped_lock lock{ m_mutex };
+
+		if (m_clear_requested) {
+			m_files.clear();
+			m_directories.clear();
+			m_clear_requested = false;
+
+#ifdef __linux__
+			for (auto& [wd, watch] : m_notify_watches) {
+				inotify_rm_watch(m_inotify_fd, wd);
+			}
+
+			m_notify_watches.clear();
+			m_notify_watch_dirs.clear();
+			m_notified_paths.clear();
+			m_missing_notify_dir = false;
+#endif
+		}
+
+		for (auto& filepath : m_files_to_watch) {
+			std::error_code ec;
+			auto& state = m_files[filepath];
+			state.last_write_time = std::filesystem::last_write_time(filepath, ec);
+			state.from_directory = false;
+			state.hashed = false;
+
+#ifdef __linux__
+			AddNotifyWatch(std::filesystem::path(filepath).parent_path().string(), false);
+#endif
+		}
+
+		for (auto& filepath : m_files_to_unwatch) {
+			m_files.erase(filepath);
+		}
+
+		for (auto& dir : m_directories_to_watch) {
+			m_directories.push_back(std::move(dir));
+		}
+
+		// New directories have to be scanned for their files, the next notification could be a long way off
+		if (!m_directories_to_watch.empty())
+			m_rescan = true;
+
+		m_files_to_watch.clear();
+		m_files_to_unwatch.clear();
+		m_directories_to_watch.clear();
+	}
+
+	void AssetFileWatcher::DiscoverDirectoryFiles(const DirectoryWatch& watch) {
+		std::error_code ec;
+		for (auto it = std::filesystem::recursive_directory_iterator(watch.dir, ec); !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+			if (!it->is_regular_file(ec))
+				continue;
+
+			std::string path = it->path().string();
+			if (m_files.contains(path) || !HasExtension(path, watch.extensions))
+				continue;
+
+			// Newly discovered files (or every file on the first poll) only establish a baseline, they aren't assets yet so there's nothing to reimport
+			auto& state = m_files[path];
+			state.last_write_time = it->last_write_time(ec);
+			state.from_directory = true;
+		}
+	}
+
+	bool AssetFileWatcher::CheckWriteTime(const std::string& path, FileState& state, std::chrono::steady_clock::time_point now) {
+		std::error_code ec;
+		auto write_time = std::filesystem::last_write_time(path, ec);
+		if (ec)
+			return false;
+
+		if (write_time != state.last_write_time) {
+			state.last_write_time = write_time;
+			state.pending = true;
+			m_changes_pending = true;
+			m_last_change_time = now;
+		}
+
+		return true;
+	}
+
+	void AssetFileWatcher::Poll() {
+		ApplyWatchRequests();
+
+#ifdef __linux__
+		if (m_inotify_fd != -1)
+			ReadNotifications();
+#endif
+
+		auto now = std::chrono::steady_clock::now();
+
+		// With notifications only the files they name need checking, otherwise every file is checked every poll
+		const bool check_every_file = m_rescan || !m_using_notifications;
+
+		if (check_every_file) {
+#ifdef __linux__
+			if (m_inotify_fd != -1) {
+				m_missing_notify_dir = false;
+
+				for (auto& watch : m_directories) {
+					AddNotifyWatch(watch.dir, true);
+				}
+
+				for (auto& [path, state] : m_files) {
+					AddNotifyWatch(std::filesystem::path(path).parent_path().string(), false);
+				}
+			}
+#endif
+
+			for (auto& watch : m_directories) {
+				DiscoverDirectoryFiles(watch);
+			}
+		}
+#ifdef __linux__
+		else {
+			// Files created in watched directories since the last poll, same as the directory scan would find them
+			for (auto& path : m_notified_paths) {
+				if (m_files.contains(path))
+					continue;
+
+				auto it = std::ranges::find_if(m_directories, [&](const DirectoryWatch& watch) { return path.starts_with(watch.dir) && HasExtension(path, watch.extensions); });
+				std::error_code ec;
+				if (it == m_directories.end() || !std::filesystem::is_regular_file(path, ec))
+					continue;
+
+				auto& state = m_files[path];
+				state.last_write_time = std::filesystem::last_write_time(path, ec);
+				state.from_directory = true;
+			}
+		}
+#endif
+
+		// Hash new files here rather than in WatchFile so the caller never blocks on file reads
+		for (auto& [path, state] : m_files) {
+			if (!state.hashed) {
+				state.content_hash = HashFileContents(path);
+				state.hashed = true;
+			}
+		}
+
+		std::vector<std::string> removed_files;
+		auto check_file = [&](const std::string& path, FileState& state) {
+			// File may be mid-save or deleted, directory watches rediscover it if it comes back
+			if (!CheckWriteTime(path, state, now) && state.from_directory)
+				removed_files.push_back(path);
+			};
+
+		if (check_every_file) {
+			for (auto& [path, state] : m_files) {
+				check_file(path, state);
+			}
+		}
+#ifdef __linux__
+		else {
+			for (auto& path : m_notified_paths) {
+				if (auto it = m_files.find(path); it != m_files.end())
+					check_file(it->first, it->second);
+			}
+		}
+
+		m_notified_paths.clear();
+#endif
+
+		m_rescan = false;
+
+		for (auto& path : removed_files) {
+			m_files.erase(path);
+		}
+
+		// Wait until writes have stopped for a while before hashing, so the whole batch is reported together and half-written files aren't picked up
+		if (!m_changes_pending || now - m_last_change_time < DEBOUNCE_INTERVAL)
+			return;
+
+		m_changes_pending = false;
+
+		std::vector<std::string> changed_files;
+		for (auto& [path, state] : m_files) {
+			if (!state.pending)
+				continue;
+
+			state.pending = false;
+
+			if (uint64_t hash = HashFileContents(path); hash != state.content_hash) {
+				state.content_hash = hash;
+				changed_files.push_back(path);
+			}
+		}
+
+		if (changed_files.empty())
+			return;
+
+		ORNG_CORE_TRACE("Asset file watcher: {0} files changed", changed_files.size());
+
+		std::scoped_lock lock{ m_mutex };
+		m_ready_changes.insert(m_ready_changes.end(), changed_files.begin(), changed_files.end());
+	}
+
+#ifdef __linux__
+	void AssetFileWatcher::WaitForNotifications() {
+		int timeout_ms = -1;
+
+		// Wake up again once the pending batch has settled
+		if (m_changes_pending) {
+			auto remaining = DEBOUNCE_INTERVAL - (std::chrono::steady_clock::now() - m_last_change_time);
+			timeout_ms = glm::max(static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(remaining).count()), 0);
+		}
+
+		if (m_missing_notify_dir)
+			timeout_ms = timeout_ms == -1 ? static_cast<int>(POLL_INTERVAL.count()) : glm::min(timeout_ms, static_cast<int>(POLL_INTERVAL.count()));
+
+		std::array<pollfd, 2> fds{ { { m_inotify_fd, POLLIN, 0 }, { m_wake_fd, POLLIN, 0 } } };
+		int num_ready = poll(fds.data(), fds.size(), timeout_ms);
+
+		if (fds[1].revents & POLLIN) {
+			uint64_t count;
+			[[maybe_unused]] auto read_bytes = read(m_wake_fd, &count, sizeof(count));
+		}
+
+		if (num_ready == 0 && m_missing_notify_dir)
+			m_rescan = true;
+	}
+
+	void AssetFileWatcher::AddNotifyWatch(const std::string& dir, bool recursive) {
+		if (m_inotify_fd == -1)
+			return;
+
+		if (auto it = m_notify_watch_dirs.find(dir); it != m_notify_watch_dirs.end()) {
+			auto& watch = m_notify_watches[it->second];
+			// Subdirectories are already watched if it was watched recursively before
+			if (watch.recursive || !recursive)
+				return;
+
+			watch.recursive = true;
+		}
+		else {
+			// Files are often saved by writing a temporary file and renaming it over the original, so moves are watched as well as writes
+			int wd = inotify_add_watch(m_inotify_fd, dir.empty() ? "." : dir.c_str(), IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+
+			if (wd == -1) {
+				if (errno == ENOENT || errno == ENOTDIR) {
+					m_missing_notify_dir = true;
+				}
+				else {
+					// Most likely the per-user watch limit, polling has no limit
+					ORNG_CORE_WARN("Asset file watcher couldn't watch '{0}' ({1}), falling back to polling", dir, std::strerror(errno));
+					CloseNotifications();
+				}
+
+				return;
+			}
+
+			m_notify_watches[wd] = NotifyWatch{ dir, recursive };
+			m_notify_watch_dirs[dir] = wd;
+		}
+
+		if (!recursive)
+			return;
+
+		std::error_code ec;
+		for (auto it = std::filesystem::directory_iterator(dir, ec); !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+			if (it->is_directory(ec) && !it->is_symlink(ec))
+				AddNotifyWatch(it->path().string(), true);
+		}
+	}
+
+	void AssetFileWatcher::ReadNotifications() {
+		alignas(inotify_event) std::array<char, 16 * 1024> buffer;
+
+		while (m_inotify_fd != -1) {
+			// Non-blocking, fails with EAGAIN once every queued event has been read
+			ssize_t len = read(m_inotify_fd, buffer.data(), buffer.size());
+			if (len <= 0)
+				return;
+
+			for (char* p = buffer.data(); p < buffer.data() + len;) {
+				auto* p_event = reinterpret_cast<const inotify_event*>(p);
+				p += sizeof(inotify_event) + p_event->len;
+
+				// Events were dropped, so every file has to be checked
+				if (p_event->mask & IN_Q_OVERFLOW) {
+					m_rescan = true;
+					continue;
+				}
+
+				auto it = m_notify_watches.find(p_event->wd);
+				if (it == m_notify_watches.end())
+					continue;
+
+				// The directory was deleted or unmounted, it's watched again by the rescan that follows if its parent is watched and it's recreated
+				if (p_event->mask & IN_IGNORED) {
+					m_notify_watch_dirs.erase(it->second.dir);
+					m_notify_watches.erase(it);
+					continue;
+				}
+
+				if (p_event->len == 0)
+					continue;
+
+				// Copied as watching a new directory can rehash m_notify_watches
+				const NotifyWatch watch = it->second;
+				std::string path = watch.dir.empty() ? std::string(p_event->name) : (std::filesystem::path(watch.dir) / p_event->name).string();
+
+				if (p_event->mask & IN_ISDIR) {
+					// Files can be created in a new directory before it's watched, the rescan finds them
+					if (watch.recursive && (p_event->mask & (IN_CREATE | IN_MOVED_TO))) {
+						AddNotifyWatch(path, true);
+						m_rescan = true;
+					}
+
+					continue;
+				}
+
+				m_notified_paths.push_back(std::move(path));
+			}
+		}
+	}
+
+	void AssetFileWatcher::CloseNotifications() {
+		if (m_inotify_fd != -1) {
+			// Closing the descriptor removes every watch on it
+			close(m_inotify_fd);
+			m_inotify_fd = -1;
+		}
+
+		m_notify_watches.clear();
+		m_notify_watch_dirs.clear();
+		m_notified_paths.clear();
+		m_missing_notify_dir = false;
+		m_using_notifications = false;
+		m_rescan = true;
+	}
+#endif
+
+	uint64_t AssetFileWatcher::HashFileContents(const std::string& filepath) {
+		std::ifstream s{ filepath, std::ios::binary };
+		if (!s.is_open())
+			return 0;
+
+		uint64_t hash = HashBytes(nullptr, 0);
+		std::array<char, 64 * 1024> buffer;
+
+		while (s) {
+			s.read(buffer.data(), buffer.size());
+			hash = HashBytes(buffer.data(), s.gcount(), hash);
+		}
+
+		return hash;
+	}
+}
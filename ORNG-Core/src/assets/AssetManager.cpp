@@ -9,6 +9,10 @@
 #include "physics/Physics.h" // for material initialization
 #include "yaml-cpp/yaml.h"
 #include "rendering/EnvMapLoader.h"
+#include "util/Timers.h"
+#include "scene/Scene.h"
+#include "scene/SceneEntity.h"
+#include "rendering/Renderer.h"
 
 // For glfwmakecontextcurrent
 #include <GLFW/glfw3.h>
@@ -20,10 +24,17 @@ namespace ORNG {
 	void AssetManager::I_Init() {
 		glfwWindowHint(GLFW_VISIBLE, 0);
 		mp_loading_context = glfwCreateWindow(100, 100, "ASSET_LOADING_CONTEXT", nullptr, Window::GetGLFWwindow());
+		DerivedDataCache::Init(DerivedDataCache::GetDefaultDirectory());
 		InitBaseAssets();
 
 		// Each frame, check if any meshes have finished loading vertex data and load them into GPU if they have
 		m_update_listener.OnEvent = [this](const Events::EngineCoreEvent& t_event) {
+			if (t_event.event_type == Events::EngineCoreEvent::EventType::ENGINE_UPDATE && IsStreaming())
+				UpdateStreaming();
+
+			if (t_event.event_type == Events::EngineCoreEvent::EventType::ENGINE_UPDATE && (m_file_watcher.IsRunning() || !m_pending_texture_reloads.empty() || !m_pending_sound_reloads.empty()))
+				UpdateHotReload();
+
 			if (t_event.event_type == Events::EngineCoreEvent::EventType::ENGINE_UPDATE && !m_mesh_loading_queue.empty()) {
 				for (int i = 0; i < m_mesh_loading_queue.size(); i++) {
 					[[unlikely]] if (m_mesh_loading_queue[i].wait_for(std::chrono::nanoseconds(1)) == std::future_status::ready) {
@@ -78,16 +89,21 @@ namespace ORNG {
 	}
 
 	void AssetManager::IClearAll() {
-		auto it = m_assets.begin();
-		while (it != m_assets.end()) {
-			if (it->first < ORNG_NUM_BASE_ASSETS) {
-				it++;
-				continue;
-			}
+		// Placeholders are about to be deleted, in-flight reads are waited on when their futures are destroyed
+		m_streaming_queue.clear();
+		m_streams_in_flight.clear();
+		m_deferred_assets.clear();
+		m_pending_texture_reloads.clear();
+		m_pending_sound_reloads.clear();
+
+		std::vector<uint64_t> uuids_to_delete;
+		for (auto& [uuid, record] : m_assets) {
+			if (uuid >= ORNG_NUM_BASE_ASSETS)
+				uuids_to_delete.push_back(uuid);
+		}
 
-			HandleAssetDeletion(it->second);
-			delete it->second;
-			it = m_assets.erase(it);
+		for (auto uuid : uuids_to_delete) {
+			DeleteAsset(uuid);
 		}
 	}
 
@@ -99,6 +115,12 @@ namespace ORNG {
 			SoundAsset dummy{ "" };
 			DeserializeAssetBinary(sound.filepath, dummy, &output);
 		}
+		else if (sound.IsStreamed() && FileExists(sound.stream_source.filepath)) { // Sound was streamed from a range of a package
+			std::ifstream s{ sound.stream_source.filepath, std::ios::binary };
+			output.resize(sound.stream_source.size);
+			s.seekg(sound.stream_source.offset);
+			s.read(reinterpret_cast<char*>(output.data()), output.size());
+		}
 
 		return false;
 	}
@@ -118,17 +140,22 @@ namespace ORNG {
 	}
 
 	void AssetManager::IDeserializeAssetsFromBinaryPackage(const std::string& package_filepath) {
-		std::ifstream s{ package_filepath, std::ios::binary | std::ios::ate };
+		std::ifstream s{ package_filepath, std::ios::binary };
 		if (!s.is_open()) {
 			ORNG_CORE_ERROR("Package file deserialization error: Cannot open {0} for reading", package_filepath);
 			return;
 		}
 
-		std::vector<std::byte> file_data;
+		// Read through the file rather than a copy of it in memory, so the data of streamed sounds is skipped over and never loaded
+		bitsery::Deserializer<bitsery::InputStreamAdapter> des{ s };
 
-		ReadBinaryFile(package_filepath, file_data);
-
-		BufferDeserializer des{ file_data.begin(), file_data.end()};
+		uint32_t magic = 0, version = 0;
+		des.value4b(magic);
+		des.value4b(version);
+		if (magic != PACKAGE_MAGIC || version != PACKAGE_VERSION) {
+			ORNG_CORE_ERROR("Package file deserialization error: {0} is not a version {1} asset package (magic {2:#x}, version {3}), it has to be rebuilt", package_filepath, PACKAGE_VERSION, magic, version);
+			return;
+		}
 
 		uint32_t num_textures, num_meshes, num_sounds, num_prefabs, num_materials, num_phys_materials;
 		des.value4b(num_textures);
@@ -161,8 +188,25 @@ namespace ORNG {
 		for (uint32_t i = 0; i < num_sounds; i++) {
 			SoundAsset* p_sound = new SoundAsset("");
 
-			DeserializeSoundAsset(*p_sound, bin_data, des);
-			p_sound->CreateSoundFromBinary(bin_data);
+			// The stream adapter reads straight from the file buffer, so the file's own position can be used to find and skip the data
+			// Streamed sounds read their range of the package from disk as they play
+			uint64_t data_size = DeserializeSoundAssetHeader(*p_sound, des);
+			std::streamoff data_offset = s.tellg();
+			s.seekg(data_offset + static_cast<std::streamoff>(data_size));
+			DeserializeSoundLoadMode(*p_sound, des);
+
+			if (SoundAsset::ShouldStream(p_sound->load_mode, data_size)) {
+				p_sound->CreateStreamFromFile(package_filepath, data_offset, data_size);
+			}
+			else {
+				std::streamoff next_asset_offset = s.tellg();
+				bin_data.resize(data_size);
+				s.seekg(data_offset);
+				s.read(reinterpret_cast<char*>(bin_data.data()), data_size);
+				s.seekg(next_asset_offset);
+				p_sound->CreateSoundFromBinary(bin_data);
+			}
+
 			AddAsset(p_sound);
 			bin_data.clear();
 		}
@@ -195,32 +239,17 @@ namespace ORNG {
 		std::vector<std::byte> ser_buffer;
 		BufferSerializer ser{ ser_buffer };
 
-		auto texture_view = std::vector<Texture2D*>();
-		auto mesh_view = std::vector<MeshAsset*>();
-		auto sound_view = std::vector<SoundAsset*>();
-		auto prefab_view = std::vector<Prefab*>();
-		auto mat_view = std::vector<Material*>();
-		auto phys_mat_view = std::vector<PhysXMaterialAsset*>();
+		auto texture_view = GetView<Texture2D>();
+		auto mesh_view = GetView<MeshAsset>();
+		auto sound_view = GetView<SoundAsset>();
+		auto prefab_view = GetView<Prefab>();
+		auto mat_view = GetView<Material>();
+		auto phys_mat_view = GetView<PhysXMaterialAsset>();
 
-		for (auto& [uuid, p_asset] : m_assets) {
-			if (p_asset->uuid() < ORNG_NUM_BASE_ASSETS)
-				continue;
+		ser.value4b(PACKAGE_MAGIC);
+		ser.value4b(PACKAGE_VERSION);
 
-			if (auto* p_casted = dynamic_cast<Texture2D*>(p_asset))
-				texture_view.push_back(p_casted);
-			else if (auto* p_casted = dynamic_cast<MeshAsset*>(p_asset))
-				mesh_view.push_back(p_casted);
-			else if (auto* p_casted = dynamic_cast<SoundAsset*>(p_asset))
-				sound_view.push_back(p_casted);
-			else if (auto* p_casted = dynamic_cast<Prefab*>(p_asset))
-				prefab_view.push_back(p_casted);
-			else if (auto* p_casted = dynamic_cast<Material*>(p_asset))
-				mat_view.push_back(p_casted);
-			else if (auto* p_casted = dynamic_cast<PhysXMaterialAsset*>(p_asset))
-				phys_mat_view.push_back(p_casted);
-		}
-		
-		// Begin layout with number of assets
+		// Then the number of assets
 		ser.value4b(static_cast<uint32_t>(texture_view.size()));
 		ser.value4b(static_cast<uint32_t>(mesh_view.size()));
 		ser.value4b(static_cast<uint32_t>(sound_view.size()));
@@ -233,7 +262,7 @@ namespace ORNG {
 			SerializeTexture2D(*p_texture, ser);
 		}
 		for (auto* p_mesh : mesh_view) {
-			p_mesh->filepath = "";
+			SetAssetFilepath(*p_mesh, "");
 			ser.object(*p_mesh);
 		}
 		for (auto* p_sound : sound_view) {
@@ -241,15 +270,15 @@ namespace ORNG {
 			SerializeSoundAsset(*p_sound, ser);
 		}
 		for (auto* p_prefab : prefab_view) {
-			p_prefab->filepath = "";
+			SetAssetFilepath(*p_prefab, "");
 			ser.object(*p_prefab);
 		}
 		for (auto* p_mat : mat_view) {
-			p_mat->filepath = "";
+			SetAssetFilepath(*p_mat, "");
 			ser.object(*p_mat);
 		}
 		for (auto* p_mat : phys_mat_view) {
-			p_mat->filepath = "";
+			SetAssetFilepath(*p_mat, "");
 			ser.object(*p_mat);
 		}
 
@@ -265,36 +294,474 @@ namespace ORNG {
 
 
 	void AssetManager::LoadTexture2D(Texture2D* p_tex) {
-		static std::mutex m;
 		Get().m_texture_futures.push_back(std::async(std::launch::async, [p_tex] {
-			m.lock();
+			std::scoped_lock lock{ Get().m_loading_context_mutex };
 			glfwMakeContextCurrent(Get().mp_loading_context);
 			p_tex->LoadFromFile();
 			DispatchAssetEvent(Events::AssetEventType::TEXTURE_LOADED, reinterpret_cast<uint8_t*>(p_tex));
 			glfwMakeContextCurrent(nullptr);
-			m.unlock();
 			}));
 	}
 
+	void AssetManager::LoadSoundFromBinaryFile(SoundAsset& sound, const std::string& filepath) {
+		std::ifstream s{ filepath, std::ios::binary };
+		if (!s.is_open()) {
+			ORNG_CORE_ERROR("Deserialization error: Cannot open {0} for reading", filepath);
+			return;
+		}
+
+		// The stream adapter reads straight from the file buffer, so the file's own position can be used to find and skip the data
+		bitsery::Deserializer<bitsery::InputStreamAdapter> des{ s };
+		uint64_t data_size = DeserializeSoundAssetHeader(sound, des);
+		std::streamoff data_offset = s.tellg();
+
+		s.seekg(data_offset + static_cast<std::streamoff>(data_size));
+		DeserializeSoundLoadMode(sound, des);
+
+		if (SoundAsset::ShouldStream(sound.load_mode, data_size)) {
+			sound.CreateStreamFromFile(filepath, data_offset, data_size);
+			return;
+		}
+
+		std::vector<std::byte> raw_sound_data(data_size);
+		s.clear();
+		s.seekg(data_offset);
+		s.read(reinterpret_cast<char*>(raw_sound_data.data()), data_size);
+		sound.CreateSoundFromBinary(raw_sound_data);
+	}
+
+
+
+	unsigned AssetManager::WarmDerivedDataCache(const std::string& path) {
+		static constexpr std::array<const char*, 4> mesh_extensions = { ".obj", ".fbx", ".glb", ".gltf" };
+		static constexpr std::array<const char*, 5> image_extensions = { ".png", ".jpg", ".jpeg", ".tga", ".bmp" };
+
+		std::vector<std::string> filepaths;
+		if (path.empty()) {
+			for (auto* p_tex : GetView<Texture2D>()) {
+				if (FileExists(p_tex->m_spec.filepath) && p_tex->m_spec.storage_type != GL_FLOAT)
+					filepaths.push_back(p_tex->m_spec.filepath);
+			}
+		}
+		else if (std::filesystem::is_directory(path)) {
+			for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
+				if (entry.is_regular_file())
+					filepaths.push_back(entry.path().string());
+			}
+		}
+		else {
+			filepaths.push_back(path);
+		}
+
+		auto has_extension = [](const std::string& filepath, const auto& extensions) {
+			std::string extension = std::filesystem::path(filepath).extension().string();
+			std::ranges::transform(extension, extension.begin(), [](char c) { return (char)std::tolower(c); });
+			return std::ranges::any_of(extensions, [&](const char* ext) { return extension == ext; });
+			};
+
+		std::vector<std::function<bool()>> jobs;
+		for (auto& filepath : filepaths) {
+			if (has_extension(filepath, mesh_extensions)) {
+				jobs.push_back([filepath] {
+					MeshAsset mesh{ filepath };
+					return mesh.LoadMeshData();
+					});
+			}
+			else if (has_extension(filepath, image_extensions)) {
+				jobs.push_back([filepath] {
+					TextureBase::DecodedImage image;
+					return TextureBase::DecodeImageFile(filepath, image);
+					});
+			}
+		}
+
+		// Run in batches to avoid spawning a thread per file for large directories
+		unsigned num_succeeded = 0;
+		unsigned batch_size = std::max(std::thread::hardware_concurrency(), 1u);
+		for (size_t i = 0; i < jobs.size(); i += batch_size) {
+			std::vector<std::future<bool>> futures;
+			for (size_t j = i; j < std::min(i + batch_size, jobs.size()); j++) {
+				futures.push_back(std::async(std::launch::async, jobs[j]));
+			}
+
+			for (auto& future : futures) {
+				num_succeeded += future.get();
+			}
+		}
+
+		return num_succeeded;
+	}
+
+
+	void AssetManager::IEnableHotReload(const std::string& project_dir) {
+		IDisableHotReload();
+		m_file_watcher.ClearWatches();
+
+		for (auto& [uuid, record] : m_assets) {
+			if (uuid >= ORNG_NUM_BASE_ASSETS)
+				WatchAssetSource(uuid, record);
+		}
+
+		m_file_watcher.WatchDirectory(ORNG_CORE_MAIN_DIR "\\res\\shaders", { ".glsl" });
+		m_file_watcher.WatchDirectory(project_dir + "\\res\\scripts", { ".cpp" });
+		m_file_watcher.Start();
+	}
+
+
+	void AssetManager::IDisableHotReload() {
+		m_file_watcher.Stop();
+
+		m_source_path_index.clear();
+		for (auto& [uuid, record] : m_assets) {
+			record.source_key.clear();
+		}
+
+		// Futures block until their reimport finishes when destroyed, staging assets are then released here on the main thread
+		m_pending_texture_reloads.clear();
+		m_pending_sound_reloads.clear();
+	}
+
+
+	const std::string& AssetManager::GetHotReloadSourcePath(const Asset* p_asset) {
+		static const std::string no_source;
+
+		if (auto* p_tex = dynamic_cast<const Texture2D*>(p_asset))
+			return p_tex->m_spec.filepath;
+		else if (auto* p_sound = dynamic_cast<const SoundAsset*>(p_asset))
+			return p_sound->source_filepath;
+
+		return no_source;
+	}
+
+
+	void AssetManager::ReimportTexture(Texture2D* p_tex) {
+		Texture2DSpec spec = p_tex->m_spec;
+
+		// Loaded into a separate texture object so the current one can still be rendered with until the swap
+		auto future = std::async(std::launch::async, [this, spec] {
+			std::scoped_lock lock{ m_loading_context_mutex };
+			glfwMakeContextCurrent(mp_loading_context);
+
+			auto p_staging = std::make_unique<Texture2D>("");
+			p_staging->m_spec = spec;
+			if (!p_staging->LoadFromFile())
+				p_staging.reset();
+
+			// Upload must be complete before the texture object is used by the main context
+			glFinish();
+			glfwMakeContextCurrent(nullptr);
+			return p_staging;
+			});
+
+		m_pending_texture_reloads.push_back(PendingTextureReload{ p_tex->uuid(), std::move(future) });
+	}
+
+
+	void AssetManager::ReimportSound(SoundAsset* p_sound) {
+		auto future = std::async(std::launch::async, [source_filepath = p_sound->source_filepath, load_mode = p_sound->load_mode] {
+			auto p_staging = std::make_unique<SoundAsset>("");
+			p_staging->load_mode = load_mode;
+
+			std::error_code ec;
+			if (uint64_t size = std::filesystem::file_size(source_filepath, ec); !ec && SoundAsset::ShouldStream(load_mode, size)) {
+				p_staging->CreateStreamFromFile(source_filepath, 0, size);
+			}
+			else {
+				std::vector<std::byte> data;
+				if (!ReadBinaryFile(source_filepath, data))
+					return std::unique_ptr<SoundAsset>{};
+
+				p_staging->CreateSoundFromBinary(data);
+			}
+
+			return p_staging->p_sound ? std::move(p_staging) : std::unique_ptr<SoundAsset>{};
+			});
+
+		m_pending_sound_reloads.push_back(PendingSoundReload{ p_sound->uuid(), std::move(future) });
+	}
+
+
+	void AssetManager::UpdateHotReload() {
+		std::vector<std::string> changed_shader_files;
+
+		for (auto& path : m_file_watcher.ConsumeChanges()) {
+			if (path.ends_with(".glsl")) {
+				changed_shader_files.push_back(path);
+				continue;
+			}
+
+			if (path.ends_with(".cpp")) {
+				// Recompiling needs the scene's script components to be reconnected, which whoever owns the scene handles
+				if (auto* p_script = GetAsset<ScriptAsset>(path))
+					DispatchAssetEvent(Events::AssetEventType::SCRIPT_MODIFIED, reinterpret_cast<uint8_t*>(p_script));
+
+				continue;
+			}
+
+			auto [begin, end] = m_source_path_index.equal_range(NormalizeAssetPath(path));
+			for (auto it = begin; it != end; it++) {
+				auto& record = m_assets[it->second];
+				if (auto* p_tex = CastAssetRecord<Texture2D>(record))
+					ReimportTexture(p_tex);
+				else if (auto* p_sound = CastAssetRecord<SoundAsset>(record))
+					ReimportSound(p_sound);
+			}
+		}
+
+		if (!changed_shader_files.empty())
+			Renderer::GetShaderLibrary().ReloadShadersUsingFiles(changed_shader_files);
+
+		// Swap finished reimports into the existing assets, this runs before anything is rendered this frame so a half-updated asset is never used
+		for (int i = 0; i < m_pending_texture_reloads.size(); i++) {
+			auto& reload = m_pending_texture_reloads[i];
+			if (reload.staging_texture.wait_for(std::chrono::nanoseconds(1)) != std::future_status::ready)
+				continue;
+
+			auto p_staging = reload.staging_texture.get();
+			auto it = m_assets.find(reload.uuid);
+			if (auto* p_tex = it == m_assets.end() ? nullptr : CastAssetRecord<Texture2D>(it->second); p_tex && p_staging) {
+				std::swap(p_tex->m_texture_obj, p_staging->m_texture_obj);
+				p_tex->m_spec = p_staging->m_spec;
+				DispatchAssetEvent(Events::AssetEventType::TEXTURE_LOADED, reinterpret_cast<uint8_t*>(p_tex));
+				ORNG_CORE_INFO("Hot-reloaded texture '{0}'", p_tex->m_spec.filepath);
+			}
+
+			// Staging texture now owns the old texture object and deletes it
+			m_pending_texture_reloads.erase(m_pending_texture_reloads.begin() + i);
+			i--;
+		}
+
+		for (int i = 0; i < m_pending_sound_reloads.size(); i++) {
+			auto& reload = m_pending_sound_reloads[i];
+			if (reload.staging_sound.wait_for(std::chrono::nanoseconds(1)) != std::future_status::ready)
+				continue;
+
+			auto p_staging = reload.staging_sound.get();
+			auto it = m_assets.find(reload.uuid);
+			if (auto* p_sound = it == m_assets.end() ? nullptr : CastAssetRecord<SoundAsset>(it->second); p_sound && p_staging) {
+				std::swap(p_sound->p_sound, p_staging->p_sound);
+				std::swap(p_sound->stream_source, p_staging->stream_source);
+
+				// Audio systems move the channels playing the old sound onto the new one before the staging sound releases it
+				DispatchAssetEvent(Events::AssetEventType::SOUND_RELOADED, reinterpret_cast<uint8_t*>(p_sound));
+				ORNG_CORE_INFO("Hot-reloaded sound '{0}'", p_sound->source_filepath);
+			}
+
+			m_pending_sound_reloads.erase(m_pending_sound_reloads.begin() + i);
+			i--;
+		}
+	}
+
 
 
 	void AssetManager::OnTextureDelete(Texture2D* p_tex) {
+		auto& instance = Get();
+		auto it = instance.m_texture_users.find(p_tex);
+		if (it == instance.m_texture_users.end())
+			return;
+
 		// If any materials use this texture, remove it from them
-		for (auto& [key, p_asset] : Get().m_assets) {
-			auto* p_material = dynamic_cast<Material*>(p_asset);
-			if (!p_material)
-				continue;
+		auto users = std::move(it->second);
+		instance.m_texture_users.erase(it);
 
+		for (auto* p_material : users) {
 			p_material->base_colour_texture = p_material->base_colour_texture == p_tex ? nullptr : p_material->base_colour_texture;
 			p_material->normal_map_texture = p_material->normal_map_texture == p_tex ? nullptr : p_material->normal_map_texture;
 			p_material->emissive_texture = p_material->emissive_texture == p_tex ? nullptr : p_material->emissive_texture;
 			p_material->displacement_texture = p_material->displacement_texture == p_tex ? nullptr : p_material->displacement_texture;
 			p_material->metallic_texture = p_material->metallic_texture == p_tex ? nullptr : p_material->metallic_texture;
 			p_material->roughness_texture = p_material->roughness_texture == p_tex ? nullptr : p_material->roughness_texture;
+			p_material->ao_texture = p_material->ao_texture == p_tex ? nullptr : p_material->ao_texture;
+
+			instance.m_material_textures[p_material] = p_material->GetTextures();
+		}
+	}
+
+
+	void AssetManager::RefreshMaterialDependencies(Material* p_material) {
+		auto& instance = Get();
+		instance.RemoveMaterialDependencies(p_material);
+
+		auto textures = p_material->GetTextures();
+		for (auto* p_tex : textures) {
+			if (!p_tex)
+				continue;
+
+			auto& users = instance.m_texture_users[p_tex];
+			if (std::ranges::find(users, p_material) == users.end())
+				users.push_back(p_material);
+		}
+
+		instance.m_material_textures[p_material] = textures;
+	}
+
+
+	void AssetManager::RemoveMaterialDependencies(const Material* p_material) {
+		auto it = m_material_textures.find(p_material);
+		if (it == m_material_textures.end())
+			return;
+
+		for (auto* p_tex : it->second) {
+			auto users_it = m_texture_users.find(p_tex);
+			if (!p_tex || users_it == m_texture_users.end())
+				continue;
+
+			std::erase(users_it->second, p_material);
+			if (users_it->second.empty())
+				m_texture_users.erase(users_it);
+		}
+
+		m_material_textures.erase(it);
+	}
+
+
+	std::string AssetManager::NormalizeAssetPath(const std::string& filepath) {
+		std::string path = filepath;
+		path.erase(std::remove_if(path.begin(), path.end(), [](char c) { return c == '\\' || c == '/' || c == '.'; }), path.end());
+
+		std::string root = Get().m_project_dir_key;
+		if (root.empty()) {
+			root = std::filesystem::current_path().string();
+			root.erase(std::remove_if(root.begin(), root.end(), [](char c) { return c == '\\' || c == '/' || c == '.'; }), root.end());
+		}
+
+		if (!root.empty() && path.starts_with(root))
+			path = path.substr(root.size());
+
+		return path;
+	}
+
+
+	void AssetManager::SetProjectDirectory(const std::string& project_dir) {
+		auto& instance = Get();
+		std::string key = std::filesystem::absolute(project_dir).string();
+		key.erase(std::remove_if(key.begin(), key.end(), [](char c) { return c == '\\' || c == '/' || c == '.'; }), key.end());
+
+		if (key == instance.m_project_dir_key)
+			return;
+
+		// Base assets outlive projects, anything registered under the old directory has to be keyed again
+		for (auto& [uuid, record] : instance.m_assets) {
+			instance.UnindexAssetPath(uuid, record);
+		}
+
+		instance.m_project_dir_key = key;
+
+		for (auto& [uuid, record] : instance.m_assets) {
+			instance.IndexAssetPath(uuid, record);
+		}
+	}
+
+
+	void AssetManager::IndexAssetPath(uint64_t uuid, AssetRecord& record) {
+		if (record.p_asset->filepath.empty())
+			return;
+
+		record.path_key = NormalizeAssetPath(record.p_asset->filepath);
+		m_filepath_index.emplace(record.path_key, uuid);
+	}
+
+
+	void AssetManager::UnindexAssetPath(uint64_t uuid, AssetRecord& record) {
+		if (record.path_key.empty())
+			return;
+
+		auto [begin, end] = m_filepath_index.equal_range(record.path_key);
+		for (auto it = begin; it != end; it++) {
+			if (it->second == uuid) {
+				m_filepath_index.erase(it);
+				break;
+			}
+		}
+
+		record.path_key.clear();
+	}
+
+
+	void AssetManager::WatchAssetSource(uint64_t uuid, AssetRecord& record) {
+		const std::string& source_path = GetHotReloadSourcePath(record.p_asset);
+		if (source_path.empty() || !record.source_key.empty())
+			return;
+
+		record.source_key = NormalizeAssetPath(source_path);
+		m_source_path_index.emplace(record.source_key, uuid);
+		m_file_watcher.WatchFile(source_path);
+	}
+
+
+	void AssetManager::UnwatchAssetSource(uint64_t uuid, AssetRecord& record) {
+		if (record.source_key.empty())
+			return;
+
+		auto [begin, end] = m_source_path_index.equal_range(record.source_key);
+		for (auto it = begin; it != end; it++) {
+			if (it->second == uuid) {
+				m_source_path_index.erase(it);
+				break;
+			}
+		}
+
+		if (!m_source_path_index.contains(record.source_key))
+			m_file_watcher.UnwatchFile(GetHotReloadSourcePath(record.p_asset));
+
+		record.source_key.clear();
+	}
+
+
+	void AssetManager::RegisterAsset(Asset* p_asset, uint16_t asset_type_id) {
+		uint64_t uuid = p_asset->uuid();
+		auto& record = m_assets[uuid] = AssetRecord{ p_asset, asset_type_id };
+
+		if (uuid >= ORNG_NUM_BASE_ASSETS) {
+			auto& storage = m_typed_assets[asset_type_id];
+			storage.uuid_to_index[uuid] = static_cast<uint32_t>(storage.assets.size());
+			storage.assets.push_back(p_asset);
+		}
+
+		IndexAssetPath(uuid, record);
+	}
+
+
+	void AssetManager::UnregisterAsset(uint64_t uuid) {
+		auto it = m_assets.find(uuid);
+		if (it == m_assets.end())
+			return;
+
+		auto& [p_asset, asset_type_id, path_key, source_key] = it->second;
+
+		if (auto storage_it = m_typed_assets.find(asset_type_id); storage_it != m_typed_assets.end() && storage_it->second.uuid_to_index.contains(uuid)) {
+			// Swap-remove to keep storage dense
+			auto& storage = storage_it->second;
+			uint32_t index = storage.uuid_to_index[uuid];
+			Asset* p_last = storage.assets.back();
+
+			storage.assets[index] = p_last;
+			storage.uuid_to_index[p_last->uuid()] = index;
+			storage.assets.pop_back();
+			storage.uuid_to_index.erase(uuid);
 		}
+
+		UnindexAssetPath(uuid, it->second);
+		UnwatchAssetSource(uuid, it->second);
+		m_assets.erase(it);
 	}
 
 
+	void AssetManager::SetAssetFilepath(Asset& asset, const std::string& filepath) {
+		auto& instance = Get();
+		uint64_t uuid = asset.uuid();
+
+		auto it = instance.m_assets.find(uuid);
+		if (it == instance.m_assets.end() || it->second.p_asset != &asset) {
+			asset.filepath = filepath;
+			return;
+		}
+
+		instance.UnindexAssetPath(uuid, it->second);
+		asset.filepath = filepath;
+		instance.IndexAssetPath(uuid, it->second);
+	}
+
 
 
 
@@ -320,45 +787,42 @@ namespace ORNG {
 			dir = asset->filepath.substr(0, slash_index);
 		}
 
-		// p_scene will be nullptr if the mesh was loaded from a binary file, then default materials will be provided
-		if (asset->p_scene) {
-			for (unsigned int i = 0; i < asset->p_scene->mNumMaterials; i++) {
-				asset->num_materials++;
-				const aiMaterial* p_material = asset->p_scene->mMaterials[i];
-				Material* p_new_material = Get().AddAsset(new Material());
-
-				// Load material textures
-				p_new_material->base_colour_texture = CreateMeshAssetTexture(dir, aiTextureType_BASE_COLOR, p_material);
-				p_new_material->normal_map_texture = CreateMeshAssetTexture(dir, aiTextureType_NORMALS, p_material);
-				p_new_material->roughness_texture = CreateMeshAssetTexture(dir, aiTextureType_DIFFUSE_ROUGHNESS, p_material);
-				p_new_material->metallic_texture = CreateMeshAssetTexture(dir, aiTextureType_METALNESS, p_material);
-				p_new_material->ao_texture = CreateMeshAssetTexture(dir, aiTextureType_AMBIENT_OCCLUSION, p_material);
-
-				// Load material properties
-				aiColor3D base_color(0.0f, 0.0f, 0.0f);
-				if (p_material->Get(AI_MATKEY_BASE_COLOR, base_color) == aiReturn_SUCCESS) {
-					p_new_material->base_colour.r = base_color.r;
-					p_new_material->base_colour.g = base_color.g;
-					p_new_material->base_colour.b = base_color.b;
-				}
+		// Imported materials will be empty if the mesh was loaded from a binary file, then default materials will be provided
+		for (auto& imported : asset->m_imported_materials) {
+			asset->num_materials++;
+			Material* p_new_material = Get().AddAsset(new Material());
+
+			// Load material textures
+			p_new_material->base_colour_texture = CreateMeshAssetTexture(dir, imported.texture_paths[ImportedMaterial::BASE_COLOUR], true);
+			p_new_material->normal_map_texture = CreateMeshAssetTexture(dir, imported.texture_paths[ImportedMaterial::NORMAL], false);
+			p_new_material->roughness_texture = CreateMeshAssetTexture(dir, imported.texture_paths[ImportedMaterial::ROUGHNESS], false);
+			p_new_material->metallic_texture = CreateMeshAssetTexture(dir, imported.texture_paths[ImportedMaterial::METALLIC], false);
+			p_new_material->ao_texture = CreateMeshAssetTexture(dir, imported.texture_paths[ImportedMaterial::AO], false);
+
+			// Load material properties
+			if (imported.property_flags & ImportedMaterial::HAS_BASE_COLOUR) {
+				p_new_material->base_colour.r = imported.base_colour.r;
+				p_new_material->base_colour.g = imported.base_colour.g;
+				p_new_material->base_colour.b = imported.base_colour.b;
+			}
 
-				float roughness;
-				float metallic;
+			if (imported.property_flags & ImportedMaterial::HAS_ROUGHNESS)
+				p_new_material->roughness = imported.roughness;
 
-				if (p_material->Get(AI_MATKEY_ROUGHNESS_FACTOR, roughness) == aiReturn_SUCCESS)
-					p_new_material->roughness = roughness;
+			if (imported.property_flags & ImportedMaterial::HAS_METALLIC)
+				p_new_material->metallic = imported.metallic;
 
-				if (p_material->Get(AI_MATKEY_METALLIC_FACTOR, metallic) == aiReturn_SUCCESS)
-					p_new_material->metallic = metallic;
+			RefreshMaterialDependencies(p_new_material);
 
-				// Check if the material has had any properties actually set - if not then use the default material instead of creating a new one.
-				if (!p_new_material->base_colour_texture && !p_new_material->normal_map_texture && !p_new_material->roughness_texture
-					&& !p_new_material->metallic_texture && !p_new_material->ao_texture && p_new_material->roughness == 0.2f && p_new_material->metallic == 0.0f) {
-					DeleteAsset(p_new_material);
-				}
+			// Check if the material has had any properties actually set - if not then use the default material instead of creating a new one.
+			if (!p_new_material->base_colour_texture && !p_new_material->normal_map_texture && !p_new_material->roughness_texture
+				&& !p_new_material->metallic_texture && !p_new_material->ao_texture && p_new_material->roughness == 0.2f && p_new_material->metallic == 0.0f) {
+				DeleteAsset(p_new_material);
 			}
 		}
 
+		asset->m_imported_materials.clear();
+
 		asset->OnLoadIntoGL();
 
 		asset->m_is_loaded = true;
@@ -373,47 +837,46 @@ namespace ORNG {
 
 
 
-	Texture2D* AssetManager::CreateMeshAssetTexture(const std::string& dir, const aiTextureType& type, const aiMaterial* p_material) {
-		Texture2D* p_tex = nullptr;
-
-
-		if (p_material->GetTextureCount(type) > 0) {
-			aiString path;
+	Texture2D* AssetManager::CreateMeshAssetTexture(const std::string& dir, const std::string& relative_path, bool srgb) {
+		if (relative_path.empty())
+			return nullptr;
 
-			if (p_material->GetTexture(type, 0, &path, NULL, NULL, NULL, NULL, NULL) == aiReturn_SUCCESS) {
-				std::string p(path.data);
-				std::string full_path;
+		std::string p = relative_path;
+		if (p.starts_with(".\\"))
+			p = p.substr(2, p.size() - 2);
 
-				if (p.starts_with(".\\"))
-					p = p.substr(2, p.size() - 2);
+		std::string full_path = dir + "\\" + p;
 
-				full_path = dir + "\\" + p;
+		Texture2DSpec base_spec;
+		base_spec.generate_mipmaps = true;
+		base_spec.mag_filter = GL_LINEAR;
+		base_spec.min_filter = GL_LINEAR_MIPMAP_LINEAR;
+		base_spec.filepath = full_path;
+		base_spec.srgb_space = srgb;
 
-				Texture2DSpec base_spec;
-				base_spec.generate_mipmaps = true;
-				base_spec.mag_filter = GL_LINEAR;
-				base_spec.min_filter = GL_LINEAR_MIPMAP_LINEAR;
-				base_spec.filepath = full_path;
-				base_spec.srgb_space = type == aiTextureType_BASE_COLOR ? true : false;
-
-				p_tex = new Texture2D(full_path);
-				p_tex->SetSpec(base_spec);
-				p_tex = AddAsset(p_tex);
-				Get().LoadTexture2D(p_tex);
-			}
-		}
+		Texture2D* p_tex = new Texture2D(full_path);
+		p_tex->SetSpec(base_spec);
+		p_tex = AddAsset(p_tex);
+		Get().LoadTexture2D(p_tex);
 
 		return p_tex;
 	}
 
 
 	void AssetManager::HandleAssetAddition(Asset* p_asset) {
+		if (auto& instance = Get(); instance.m_file_watcher.IsRunning()) {
+			if (auto it = instance.m_assets.find(p_asset->uuid()); it != instance.m_assets.end())
+				instance.WatchAssetSource(it->first, it->second);
+		}
+
 		if (auto* p_material = dynamic_cast<Material*>(p_asset)) {
+			RefreshMaterialDependencies(p_material);
 			DispatchAssetEvent(Events::AssetEventType::MATERIAL_LOADED, reinterpret_cast<uint8_t*>(p_material));
 		}
 	}
 
 	void AssetManager::HandleAssetDeletion(Asset* p_asset) {
+		// Its source file is unwatched by UnregisterAsset
 		if (auto* p_tex = dynamic_cast<Texture2D*>(p_asset)) {
 			OnTextureDelete(p_tex);
 			DispatchAssetEvent(Events::AssetEventType::TEXTURE_DELETED, reinterpret_cast<uint8_t*>(p_tex));
@@ -422,6 +885,7 @@ namespace ORNG {
 			DispatchAssetEvent(Events::AssetEventType::MESH_DELETED, reinterpret_cast<uint8_t*>(p_mesh));
 		}
 		if (auto* p_material = dynamic_cast<Material*>(p_asset)) {
+			Get().RemoveMaterialDependencies(p_material);
 			DispatchAssetEvent(Events::AssetEventType::MATERIAL_DELETED, reinterpret_cast<uint8_t*>(p_material));
 		}
 		else if (auto* p_script = dynamic_cast<ScriptAsset*>(p_asset)) {
@@ -431,14 +895,14 @@ namespace ORNG {
 	}
 
 	void AssetManager::LoadExternalBaseAssets(const std::string& project_dir) {
-		m_assets.erase(ORNG_BASE_SOUND_ID);
+		UnregisterAsset(ORNG_BASE_SOUND_ID);
 		mp_base_sound = std::make_unique<SoundAsset>(project_dir + "res\\core-res\\audio\\mouse-click.mp3");
 		mp_base_sound->uuid = UUID<uint64_t>(ORNG_BASE_SOUND_ID);
 		mp_base_sound->source_filepath = project_dir + "res\\core-res\\audio\\mouse-click.mp3";
 		mp_base_sound->CreateSoundFromFile();
 		AddAsset(&*mp_base_sound);
 
-		m_assets.erase(ORNG_BASE_SPHERE_ID);
+		UnregisterAsset(ORNG_BASE_SPHERE_ID);
 		mp_base_sphere.release();
 		mp_base_sphere = std::make_unique<MeshAsset>("res/meshes/Sphere.obj");
 		DeserializeAssetBinary("res/core-res/meshes/Sphere.obj.bin", *mp_base_sphere);
@@ -450,7 +914,78 @@ namespace ORNG {
 
 
 
+	Asset* AssetManager::LoadAssetFromBinaryFile(AssetType type, const std::string& read_path, const std::string& asset_filepath) {
+		if (!FileExists(read_path)) {
+			ORNG_CORE_ERROR("Failed loading asset binary '{0}', file doesn't exist", read_path);
+			return nullptr;
+		}
+
+		switch (type) {
+		case AssetType::TEXTURE:
+		{
+			auto* p_tex = new Texture2D(read_path);
+			std::vector<std::byte> binary_data;
+
+			DeserializeAssetBinary(read_path, *p_tex, &binary_data);
+			SetAssetFilepath(*p_tex, asset_filepath);
+			AddAsset(p_tex);
+			p_tex->LoadFromBinary(binary_data);
+			DispatchAssetEvent(Events::AssetEventType::TEXTURE_LOADED, reinterpret_cast<uint8_t*>(p_tex));
+			return p_tex;
+		}
+		case AssetType::MESH:
+		{
+			auto* p_mesh = new MeshAsset(asset_filepath);
+			DeserializeAssetBinary(read_path, *p_mesh);
+			SetAssetFilepath(*p_mesh, asset_filepath);
+			AddAsset(p_mesh);
+			LoadMeshAssetIntoGL(p_mesh);
+			return p_mesh;
+		}
+		case AssetType::SOUND:
+		{
+			auto* p_sound = new SoundAsset(read_path);
+			LoadSoundFromBinaryFile(*p_sound, read_path);
+			SetAssetFilepath(*p_sound, asset_filepath);
+			AddAsset(p_sound);
+			return p_sound;
+		}
+		case AssetType::MATERIAL:
+		{
+			auto* p_mat = new Material(asset_filepath);
+			SetAssetFilepath(*p_mat, asset_filepath);
+			DeserializeAssetBinary(read_path, *p_mat);
+			AddAsset(p_mat);
+			return p_mat;
+		}
+		case AssetType::PREFAB:
+		{
+			auto* p_prefab = new Prefab(asset_filepath);
+			DeserializeAssetBinary(read_path, *p_prefab);
+			SetAssetFilepath(*p_prefab, asset_filepath);
+			AddAsset(p_prefab);
+			p_prefab->node = YAML::Load(p_prefab->serialized_content);
+#ifndef ORNG_EDITOR_LAYER 
+			p_prefab->serialized_content.clear();
+#endif
+			return p_prefab;
+		}
+		case AssetType::PHYSX_MATERIAL:
+		{
+			auto* p_mat = new PhysXMaterialAsset(asset_filepath);
+			InitPhysXMaterialAsset(*p_mat);
+			DeserializeAssetBinary(read_path, *p_mat);
+			AddAsset(p_mat);
+			return p_mat;
+		}
+		}
+
+		return nullptr;
+	}
+
+
 	void AssetManager::LoadAssetsFromProjectPath(const std::string& project_dir, bool precompiled_scripts) {
+		SetProjectDirectory(project_dir);
 		std::string texture_folder = project_dir + "\\res\\textures\\";
 		std::string mesh_folder = project_dir + "\\res\\meshes\\";
 		std::string audio_folder = project_dir + "\\res\\audio\\";
@@ -459,13 +994,6 @@ namespace ORNG {
 		std::string script_folder = project_dir + "\\res\\scripts\\";
 		std::string physx_mat_folder = project_dir + "\\res\\physx-materials\\";
 
-
-		Texture2DSpec default_spec;
-		default_spec.min_filter = GL_LINEAR_MIPMAP_LINEAR;
-		default_spec.mag_filter = GL_LINEAR;
-		default_spec.generate_mipmaps = true;
-		default_spec.storage_type = GL_UNSIGNED_BYTE;
-
 		for (const auto& entry : std::filesystem::recursive_directory_iterator(texture_folder)) {
 			std::string path = entry.path().string();
 
@@ -473,16 +1001,7 @@ namespace ORNG {
 				continue;
 
 			auto rel_path = path.substr(path.rfind("\\res\\") + 1);
-			default_spec.filepath = rel_path;
-			auto* p_tex = new Texture2D(path);
-			std::vector<std::byte> binary_data;
-			auto& spec = p_tex->GetSpec();
-
-			DeserializeAssetBinary(path, *p_tex, &binary_data);
-			p_tex->filepath = rel_path;
-			AddAsset(p_tex);
-			p_tex->LoadFromBinary(binary_data);
-			DispatchAssetEvent(Events::AssetEventType::TEXTURE_LOADED, reinterpret_cast<uint8_t*>(p_tex));
+			LoadAssetFromBinaryFile(AssetType::TEXTURE, path, rel_path);
 		}
 
 		for (const auto& entry : std::filesystem::recursive_directory_iterator(mesh_folder)) {
@@ -491,11 +1010,7 @@ namespace ORNG {
 
 			std::string str_path = entry.path().string();
 			std::string rel_path = ".\\" + str_path.substr(str_path.rfind("res\\meshes"));
-			auto* p_mesh = new MeshAsset(rel_path);
-			DeserializeAssetBinary(rel_path, *p_mesh);
-			p_mesh->filepath = rel_path;
-			AddAsset(p_mesh);
-			LoadMeshAssetIntoGL(p_mesh);
+			LoadAssetFromBinaryFile(AssetType::MESH, rel_path, rel_path);
 		}
 
 
@@ -505,12 +1020,7 @@ namespace ORNG {
 				continue;
 			else {
 				std::string rel_path = ".\\" + path.substr(path.rfind("res\\audio"));
-				auto* p_sound = new SoundAsset(path);
-				std::vector<std::byte> raw_sound_data;
-				DeserializeAssetBinary(path, *p_sound, &raw_sound_data);
-				p_sound->filepath = rel_path;
-				p_sound->CreateSoundFromBinary(raw_sound_data);
-				AddAsset(p_sound);
+				LoadAssetFromBinaryFile(AssetType::SOUND, path, rel_path);
 			}
 		}
 
@@ -520,10 +1030,7 @@ namespace ORNG {
 				continue;
 			else {
 				std::string rel_path = ".\\" + entry.path().string().substr(path.string().rfind("res\\materials"));
-				auto* p_mat = new Material(rel_path);
-				p_mat->filepath = rel_path;
-				DeserializeAssetBinary(rel_path, *p_mat);
-				AddAsset(p_mat);
+				LoadAssetFromBinaryFile(AssetType::MATERIAL, rel_path, rel_path);
 			}
 		}
 
@@ -533,17 +1040,25 @@ namespace ORNG {
 				continue;
 			else {
 				std::string rel_path = ".\\" + path.string().substr(path.string().rfind("res\\prefabs"));
-				auto* p_prefab = new Prefab(rel_path);
-				DeserializeAssetBinary(rel_path, *p_prefab);
-				p_prefab->filepath = rel_path;
-				AddAsset(p_prefab);
-				p_prefab->node = YAML::Load(p_prefab->serialized_content);
-#ifndef ORNG_EDITOR_LAYER 
-				p_prefab->serialized_content.clear();
-#endif
+				LoadAssetFromBinaryFile(AssetType::PREFAB, rel_path, rel_path);
 			}
 		}
 
+		LoadScriptAssets(script_folder, precompiled_scripts);
+
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(physx_mat_folder)) {
+			auto path = entry.path();
+			if (entry.is_directory() || path.extension() != ".opmat")
+				continue;
+			else {
+				std::string rel_path = ".\\" + path.string().substr(path.string().rfind("res\\physx-materials"));
+				LoadAssetFromBinaryFile(AssetType::PHYSX_MATERIAL, rel_path, rel_path);
+			}
+		}
+	}
+
+
+	void AssetManager::LoadScriptAssets(const std::string& script_folder, bool precompiled_scripts) {
 		for (const auto& entry : std::filesystem::recursive_directory_iterator(script_folder)) {
 			auto path = entry.path();
 			std::string path_string = path.string();
@@ -572,20 +1087,243 @@ namespace ORNG {
 				}
 			}
 		}
+	}
 
 
-		for (const auto& entry : std::filesystem::recursive_directory_iterator(physx_mat_folder)) {
-			auto path = entry.path();
-			if (entry.is_directory() || path.extension() != ".opmat")
-				continue;
-			else {
-				std::string rel_path = ".\\" + path.string().substr(path.string().rfind("res\\physx-materials"));
-				auto* p_mat = new PhysXMaterialAsset(rel_path);
-				InitPhysXMaterialAsset(*p_mat);
-				DeserializeAssetBinary(rel_path, *p_mat);
-				AddAsset(p_mat);
+	void AssetManager::LoadSceneAssetsFromProjectPath(const std::string& project_dir, const std::string& scene_filepath, bool precompiled_scripts) {
+		TimeStep time{ TimeStep::TimeUnits::MILLISECONDS };
+		SetProjectDirectory(project_dir);
+
+		AssetDependencyGraph graph;
+		if (!graph.LoadManifest(ORNG_ASSET_MANIFEST_FILEPATH)) {
+			ORNG_CORE_WARN("No asset manifest found for project '{0}', loading all assets. Save the project in the editor to generate one", project_dir);
+			LoadAssetsFromProjectPath(project_dir, precompiled_scripts);
+			return;
+		}
+
+		std::unordered_set<uint64_t> closure;
+		std::unordered_set<uint64_t> blocking_meshes;
+		graph.ResolveSceneClosure(scene_filepath, closure, blocking_meshes);
+
+		auto& instance = Get();
+		uint64_t total_bytes = 0, loaded_bytes = 0, queued_bytes = 0;
+		unsigned num_loaded = 0, num_queued = 0;
+
+		// Textures must at least exist as placeholders before materials are deserialized so the material can resolve them
+		constexpr std::array<AssetType, 6> load_order = { AssetType::TEXTURE, AssetType::MESH, AssetType::SOUND, AssetType::PHYSX_MATERIAL, AssetType::MATERIAL, AssetType::PREFAB };
+		for (auto type : load_order) {
+			for (auto& [uuid, entry] : graph.GetEntries()) {
+				if (entry.type != type)
+					continue;
+
+				total_bytes += entry.size_bytes;
+
+				// PhysX materials are tiny and can be referenced by scripts, so always load them
+				if (!closure.contains(uuid) && type != AssetType::PHYSX_MATERIAL) {
+					instance.m_deferred_assets[uuid] = entry;
+					continue;
+				}
+
+				if (type == AssetType::TEXTURE || (type == AssetType::MESH && !blocking_meshes.contains(uuid))) {
+					instance.AddStreamingPlaceholder(entry);
+					queued_bytes += entry.size_bytes;
+					num_queued++;
+				}
+				else if (LoadAssetFromBinaryFile(type, entry.filepath, entry.filepath)) {
+					loaded_bytes += entry.size_bytes;
+					num_loaded++;
+				}
+			}
+		}
+
+		LoadScriptAssets(project_dir + "\\res\\scripts\\", precompiled_scripts);
+
+		ORNG_CORE_INFO("Scene assets loaded in {0}ms: {1} assets ({2} bytes) loaded, {3} assets ({4} bytes) queued for streaming, {5} assets deferred",
+			time.GetTimeInterval(), num_loaded, loaded_bytes, num_queued, queued_bytes, instance.m_deferred_assets.size());
+		ORNG_CORE_INFO("Loading the full project would have loaded {0} assets ({1} bytes) at startup", graph.GetEntries().size(), total_bytes);
+	}
+
+
+	void AssetManager::AddStreamingPlaceholder(const AssetManifestEntry& entry) {
+		StreamRequest request;
+		request.type = entry.type;
+		request.size_bytes = entry.size_bytes;
+
+		if (entry.type == AssetType::TEXTURE) {
+			auto* p_tex = new Texture2D(entry.filepath, entry.uuid);
+
+			// 1x1 white pixel until the real data arrives, same as the base texture
+			GL_StateManager::BindTexture(GL_TEXTURE_2D, p_tex->GetTextureHandle(), GL_TEXTURE0);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			unsigned char white_pixel[] = { 255, 255, 255, 255 };
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, white_pixel);
+
+			request.p_asset = AddAsset(p_tex);
+		}
+		else {
+			// Renders nothing until loaded as it has no submeshes, material count is needed up front as components size their material arrays with it
+			auto* p_mesh = new MeshAsset(entry.filepath, entry.uuid);
+			p_mesh->num_materials = entry.num_materials;
+			request.p_asset = AddAsset(p_mesh);
+		}
+
+		if (m_streaming_queue.empty() && m_streams_in_flight.empty()) {
+			m_streaming_timer.UpdateLastTime();
+			m_streamed_bytes = 0;
+			m_num_streamed_assets = 0;
+		}
+
+		m_streaming_queue.push_back(request);
+	}
+
+
+	void AssetManager::PrioritiseStreaming(Scene& scene) {
+		auto& instance = Get();
+		if (instance.m_streaming_queue.empty())
+			return;
+
+		glm::vec3 cam_pos{ 0, 0, 0 };
+		if (auto* p_cam = scene.GetActiveCamera())
+			cam_pos = p_cam->GetEntity()->GetComponent<TransformComponent>()->GetAbsPosition();
+
+		// Closest distance from the camera to any entity using the asset
+		std::unordered_map<uint64_t, float> distances;
+		auto update_distance = [&](const Asset* p_asset, float dist) {
+			if (!p_asset)
+				return;
+
+			auto [it, inserted] = distances.try_emplace(p_asset->uuid(), dist);
+			it->second = glm::min(it->second, dist);
+			};
+
+		for (auto [entity, mesh] : scene.GetRegistry().view<MeshComponent>().each()) {
+			float dist = glm::length(mesh.GetEntity()->GetComponent<TransformComponent>()->GetAbsPosition() - cam_pos);
+			update_distance(mesh.GetMeshData(), dist);
+
+			for (auto* p_mat : mesh.GetMaterials()) {
+				for (auto* p_tex : p_mat->GetTextures()) {
+					update_distance(p_tex, dist);
+				}
 			}
 		}
+
+		for (auto& request : instance.m_streaming_queue) {
+			auto it = distances.find(request.p_asset->uuid());
+			request.camera_distance = it == distances.end() ? std::numeric_limits<float>::max() : it->second;
+		}
+
+		// Lowest priority at the front, requests are popped from the back
+		std::ranges::sort(instance.m_streaming_queue, [](const StreamRequest& a, const StreamRequest& b) {
+			if (a.camera_distance != b.camera_distance)
+				return a.camera_distance > b.camera_distance;
+
+			return a.size_bytes > b.size_bytes;
+			});
+	}
+
+
+	void AssetManager::UpdateStreaming() {
+		ORNG_PROFILE_FUNC();
+
+		while (m_streams_in_flight.size() < MAX_STREAMS_IN_FLIGHT && !m_streaming_queue.empty()) {
+			auto& in_flight = m_streams_in_flight.emplace_back();
+			in_flight.request = m_streaming_queue.back();
+			m_streaming_queue.pop_back();
+
+			in_flight.file_data = std::async(std::launch::async, [filepath = in_flight.request.p_asset->filepath] {
+				std::vector<std::byte> data;
+				ReadBinaryFile(filepath, data);
+				return data;
+				});
+		}
+
+		uint64_t bytes_this_frame = 0;
+		for (int i = 0; i < m_streams_in_flight.size() && bytes_this_frame < STREAMING_BYTE_BUDGET_PER_FRAME; i++) {
+			auto& in_flight = m_streams_in_flight[i];
+			if (in_flight.file_data.wait_for(std::chrono::nanoseconds(1)) != std::future_status::ready)
+				continue;
+
+			std::vector<std::byte> file_data = in_flight.file_data.get();
+			bytes_this_frame += file_data.size();
+			m_streamed_bytes += file_data.size();
+			m_num_streamed_assets++;
+
+			FinaliseStreamedAsset(in_flight.request.p_asset, in_flight.request.type, file_data);
+
+			m_streams_in_flight.erase(m_streams_in_flight.begin() + i);
+			i--;
+		}
+
+		if (!IsStreaming())
+			ORNG_CORE_INFO("Asset streaming finished in {0}ms: {1} assets ({2} bytes)", m_streaming_timer.GetTimeInterval(), m_num_streamed_assets, m_streamed_bytes);
+	}
+
+
+	void AssetManager::FinaliseStreamedAsset(Asset* p_asset, AssetType type, std::vector<std::byte>& file_data) {
+		if (file_data.empty()) {
+			ORNG_CORE_ERROR("Asset streaming error: Failed reading '{0}'", p_asset->filepath);
+			return;
+		}
+
+		BufferDeserializer des{ file_data.begin(), file_data.end() };
+		std::string filepath = p_asset->filepath;
+
+		if (type == AssetType::TEXTURE) {
+			auto* p_tex = static_cast<Texture2D*>(p_asset);
+			std::vector<std::byte> raw_data;
+			DeserializeTexture2D(*p_tex, raw_data, des);
+			SetAssetFilepath(*p_tex, filepath);
+
+			// Restores the sampler state from the spec, the placeholder used nearest filtering
+			// Not through SetSpec as that would overwrite the filepath and allocate storage LoadFromBinary replaces straight after
+			const auto& spec = p_tex->GetSpec();
+			GLenum wrap_mode = spec.wrap_params == GL_NONE ? GL_REPEAT : spec.wrap_params;
+			GL_StateManager::BindTexture(GL_TEXTURE_2D, p_tex->GetTextureHandle(), GL_TEXTURE0, true);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, spec.min_filter == GL_NONE ? GL_NEAREST : spec.min_filter);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, spec.mag_filter == GL_NONE ? GL_NEAREST : spec.mag_filter);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap_mode);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap_mode);
+			GL_StateManager::BindTexture(GL_TEXTURE_2D, 0, GL_TEXTURE0, true);
+
+			p_tex->LoadFromBinary(raw_data);
+			DispatchAssetEvent(Events::AssetEventType::TEXTURE_LOADED, reinterpret_cast<uint8_t*>(p_tex));
+		}
+		else if (type == AssetType::MESH) {
+			auto* p_mesh = static_cast<MeshAsset*>(p_asset);
+			DeserializeMeshAsset(*p_mesh, des);
+			SetAssetFilepath(*p_mesh, filepath);
+			LoadMeshAssetIntoGL(p_mesh);
+			DispatchAssetEvent(Events::AssetEventType::MESH_LOADED, reinterpret_cast<uint8_t*>(p_mesh));
+		}
+	}
+
+
+	void AssetManager::LoadDeferredAsset(uint64_t uuid) {
+		// Remove first, loading can recurse back into GetAsset (materials resolving their textures)
+		AssetManifestEntry entry = std::move(m_deferred_assets[uuid]);
+		m_deferred_assets.erase(uuid);
+
+		ORNG_CORE_TRACE("Loading deferred asset '{0}' on demand", entry.filepath);
+		LoadAssetFromBinaryFile(entry.type, entry.filepath, entry.filepath);
+	}
+
+
+	std::string AssetManager::GetTextureBinaryPath(const Texture2D& tex) {
+		return ".\\res\\textures\\" + tex.filepath.substr(tex.filepath.rfind("\\") + 1);
+	}
+
+	std::string AssetManager::GetSoundBinaryPath(const SoundAsset& sound) {
+		std::string fn = sound.filepath.substr(sound.filepath.rfind("\\") + 1);
+		return ".\\res\\audio\\" + ReplaceFileExtension(fn, ".osound");
+	}
+
+	std::string AssetManager::GetMaterialBinaryPath(const Material& material) {
+		return ".\\res\\materials\\" + std::format("{}", material.uuid()) + ".omat";
+	}
+
+	std::string AssetManager::GetPhysXMaterialBinaryPath(const PhysXMaterialAsset& material) {
+		return ".\\res\\physx-materials\\" + std::format("{}", material.uuid()) + ".opmat";
 	}
 
 
@@ -593,22 +1331,23 @@ namespace ORNG {
 		// Serialize all assets currently loaded into asset manager
 		// Meshes and prefabs are overlooked here as they are serialized automatically upon being loaded into the engine
 		for (auto* p_texture : GetView<Texture2D>()) {
-			SerializeAssetToBinaryFile(*p_texture, ".\\res\\textures\\" + p_texture->filepath.substr(p_texture->filepath.rfind("\\") + 1));
+			SerializeAssetToBinaryFile(*p_texture, GetTextureBinaryPath(*p_texture));
 		}
 
 		for (auto* p_mat : GetView<Material>()) {
-			SceneSerializer::SerializeBinary(".\\res\\materials\\" + std::format("{}", p_mat->uuid()) + ".omat", *p_mat);
+			SceneSerializer::SerializeBinary(GetMaterialBinaryPath(*p_mat), *p_mat);
 		}
 
 		for (auto* p_sound : GetView<SoundAsset>()) {
-			std::string fn = p_sound->filepath.substr(p_sound->filepath.rfind("\\") + 1);
-			fn = ".\\res\\audio\\" + ReplaceFileExtension(fn, ".osound");
-			SerializeAssetToBinaryFile(*p_sound, fn);
+			SerializeAssetToBinaryFile(*p_sound, GetSoundBinaryPath(*p_sound));
 		}
 
 		for (auto* p_mat : GetView<PhysXMaterialAsset>()) {
-			SceneSerializer::SerializeBinary(".\\res\\physx-materials\\" + std::format("{}", p_mat->uuid()) + ".opmat", *p_mat);
+			SceneSerializer::SerializeBinary(GetPhysXMaterialBinaryPath(*p_mat), *p_mat);
 		}
+
+		// Written last so the recorded file sizes are up to date, used by the runtime to only load what the scene needs
+		AssetDependencyGraph::WriteManifest(ORNG_ASSET_MANIFEST_FILEPATH);
 	}
 
 	void AssetManager::InitPhysXMaterialAsset(PhysXMaterialAsset& asset) {
@@ -655,6 +1394,7 @@ namespace ORNG {
 
 
 	void AssetManager::IOnShutdown() {
+		DisableHotReload();
 		ClearAll();
 		auto& instance = Get();
 
@@ -3,11 +3,65 @@
 #include "audio/AudioEngine.h"
 #include <fmod.hpp>
 #include <fmod_errors.h>
+#include <fstream>
 
 
 namespace ORNG {
+	// Handle given to FMOD for a streamed sound, reads are confined to the stream source's byte range so a sound inside an .osound or package sees only its own data
+	struct StreamFile {
+		std::ifstream stream;
+		uint64_t offset = 0;
+		unsigned size = 0;
+		unsigned pos = 0;
+	};
+
+	static FMOD_RESULT F_CALL StreamFileOpen(const char* name, unsigned int* filesize, void** handle, void* userdata) {
+		auto& source = *static_cast<const SoundAsset::StreamSource*>(userdata);
+		auto* p_file = new StreamFile{ std::ifstream{ name, std::ios::binary }, source.offset, static_cast<unsigned>(source.size) };
+
+		if (!p_file->stream.is_open() || !p_file->stream.seekg(source.offset)) {
+			delete p_file;
+			return FMOD_ERR_FILE_NOTFOUND;
+		}
+
+		*filesize = p_file->size;
+		*handle = p_file;
+		return FMOD_OK;
+	}
+
+	static FMOD_RESULT F_CALL StreamFileClose(void* handle, void* userdata) {
+		delete static_cast<StreamFile*>(handle);
+		return FMOD_OK;
+	}
+
+	static FMOD_RESULT F_CALL StreamFileRead(void* handle, void* buffer, unsigned int sizebytes, unsigned int* bytesread, void* userdata) {
+		auto& file = *static_cast<StreamFile*>(handle);
+		unsigned to_read = std::min(sizebytes, file.size - file.pos);
+
+		file.stream.read(static_cast<char*>(buffer), to_read);
+		*bytesread = static_cast<unsigned>(file.stream.gcount());
+		file.pos += *bytesread;
+
+		return *bytesread < sizebytes ? FMOD_ERR_FILE_EOF : FMOD_OK;
+	}
+
+	static FMOD_RESULT F_CALL StreamFileSeek(void* handle, unsigned int pos, void* userdata) {
+		auto& file = *static_cast<StreamFile*>(handle);
+		file.pos = std::min(pos, file.size);
+		file.stream.clear();
+
+		return file.stream.seekg(file.offset + file.pos) ? FMOD_OK : FMOD_ERR_FILE_COULDNOTSEEK;
+	}
+
 
 	void SoundAsset::CreateSoundFromFile() {
+		std::error_code ec;
+		uint64_t size = std::filesystem::file_size(source_filepath, ec);
+		if (!ec && ShouldStream(load_mode, size)) {
+			CreateStreamFromFile(source_filepath, 0, size);
+			return;
+		}
+
 		if (auto result = AudioEngine::GetSystem()->createSound(source_filepath.c_str(),  FMOD_3D | FMOD_LOOP_OFF, nullptr, &p_sound); result != FMOD_OK) {
 			ORNG_CORE_ERROR("Error loading sound: '{0}', '{1}'", source_filepath, FMOD_ErrorString(result));
 		}
@@ -25,9 +79,40 @@ namespace ORNG {
 		}
 	}
 
+	void SoundAsset::CreateStreamFromFile(const std::string& filepath, uint64_t offset, uint64_t size) {
+		stream_source = StreamSource{ filepath, offset, size };
+		p_sound = OpenStream(false);
+
+		if (!p_sound)
+			stream_source = StreamSource{};
+	}
+
+	FMOD::Sound* SoundAsset::OpenStream(bool looped) const {
+		if (!IsStreamed())
+			return nullptr;
+
+		FMOD_CREATESOUNDEXINFO info{};
+		info.cbsize = sizeof(info);
+		info.filebuffersize = STREAM_FILE_BUFFER_SIZE;
+		info.fileuseropen = StreamFileOpen;
+		info.fileuserclose = StreamFileClose;
+		info.fileuserread = StreamFileRead;
+		info.fileuserseek = StreamFileSeek;
+		// Only read in StreamFileOpen, which FMOD calls before createSound returns
+		info.fileuserdata = const_cast<StreamSource*>(&stream_source);
+
+		FMOD::Sound* p_stream = nullptr;
+		if (auto result = AudioEngine::GetSystem()->createSound(stream_source.filepath.c_str(), FMOD_CREATESTREAM | FMOD_3D | (looped ? FMOD_LOOP_NORMAL : FMOD_LOOP_OFF), &info, &p_stream); result != FMOD_OK) {
+			ORNG_CORE_ERROR("Error opening sound stream: '{0}', '{1}'", stream_source.filepath, FMOD_ErrorString(result));
+			return nullptr;
+		}
+
+		return p_stream;
+	}
+
 	SoundAsset::~SoundAsset() {
 		if (p_sound)
 			p_sound->release();
 	}
 
-}
\ No newline at end of file
+}
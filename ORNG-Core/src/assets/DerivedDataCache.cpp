@@ -0,0 +1,185 @@
+#include "pch/pch.h"
+#include "assets/DerivedDataCache.h"
+#include "util/util.h"
+#include "util/Log.h"
+#include <charconv>
+
+
+namespace ORNG {
+	static constexpr const char* DDC_ENTRY_EXTENSION = ".ddc";
+
+	std::string DerivedDataCache::GetDefaultDirectory() {
+		if (const char* p_dir = std::getenv("ORNG_DDC_DIR"); p_dir && *p_dir)
+			return p_dir;
+
+		return GetApplicationExecutableDirectory() + "\\ddc";
+	}
+
+	uint64_t DerivedDataCache::MakeKey(const std::vector<std::byte>& source_data, const std::string& settings, uint32_t format_version) {
+		return MakeKey(HashBytes(source_data.data(), source_data.size()), settings, format_version);
+	}
+
+	uint64_t DerivedDataCache::MakeKey(uint64_t source_hash, const std::string& settings, uint32_t format_version) {
+		uint64_t hash = HashBytes(settings.data(), settings.size(), source_hash);
+		return HashBytes(&format_version, sizeof(format_version), hash);
+	}
+
+	std::string DerivedDataCache::GetEntryPath(uint64_t key) const {
+		return std::format("{}\\{:016x}{}", m_directory, key, DDC_ENTRY_EXTENSION);
+	}
+
+	void DerivedDataCache::IInit(const std::string& cache_dir, uint64_t max_size_bytes) {
+		std::scoped_lock lock{ m_mutex };
+
+		m_directory = cache_dir;
+		m_max_size_bytes = max_size_bytes;
+		m_entries.clear();
+		m_stats = Stats{};
+
+		if (!FileExists(m_directory))
+			Create_Directory(m_directory);
+
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::directory_iterator(m_directory, ec)) {
+			if (!entry.is_regular_file(ec) || entry.path().extension() != DDC_ENTRY_EXTENSION)
+				continue;
+
+			uint64_t key = 0;
+			std::string stem = entry.path().stem().string();
+			if (std::from_chars(stem.data(), stem.data() + stem.size(), key, 16).ec != std::errc{})
+				continue;
+
+			m_entries[key] = Entry{ entry.file_size(ec), entry.last_write_time(ec) };
+			m_stats.total_bytes += m_entries[key].size_bytes;
+		}
+
+		m_stats.num_entries = m_entries.size();
+		ORNG_CORE_INFO("Derived data cache '{0}': {1} entries, {2}MB", m_directory, m_stats.num_entries, m_stats.total_bytes / 1'000'000);
+
+		PruneUnlocked(m_max_size_bytes);
+	}
+
+	bool DerivedDataCache::ILoad(uint64_t key, std::vector<std::byte>& output) {
+		std::string path;
+		{
+			std::scoped_lock lock{ m_mutex };
+			if (m_directory.empty() || !m_entries.contains(key)) {
+				m_stats.misses++;
+				return false;
+			}
+
+			path = GetEntryPath(key);
+		}
+
+		// Read outside of the lock so other threads can keep using the cache
+		std::vector<std::byte> data;
+		bool read = FileExists(path) && ReadBinaryFile(path, data);
+
+		std::scoped_lock lock{ m_mutex };
+		auto it = m_entries.find(key);
+
+		if (!read) {
+			if (it != m_entries.end()) {
+				m_stats.total_bytes -= it->second.size_bytes;
+				m_entries.erase(it);
+				m_stats.num_entries = m_entries.size();
+			}
+
+			m_stats.misses++;
+			return false;
+		}
+
+		// Entry may have been evicted while reading, the data read is still valid as entries are immutable
+		if (it != m_entries.end()) {
+			std::error_code ec;
+			it->second.last_access = std::filesystem::file_time_type::clock::now();
+			std::filesystem::last_write_time(path, it->second.last_access, ec);
+		}
+
+		m_stats.hits++;
+		output = std::move(data);
+		return true;
+	}
+
+	void DerivedDataCache::IStore(uint64_t key, const std::vector<std::byte>& data) {
+		std::string path;
+		{
+			std::scoped_lock lock{ m_mutex };
+			if (m_directory.empty() || m_entries.contains(key))
+				return;
+
+			path = GetEntryPath(key);
+		}
+
+		// Written to a temporary file first so a crash or another process never sees a partially written entry
+		std::string temp_path = std::format("{}.{}.TEMP", path, std::hash<std::thread::id>{}(std::this_thread::get_id()));
+		{
+			std::ofstream s{ temp_path, std::ios::binary | std::ios::trunc };
+			if (!s.is_open()) {
+				ORNG_CORE_ERROR("Derived data cache error: Cannot open '{0}' for writing", temp_path);
+				return;
+			}
+
+			s.write(reinterpret_cast<const char*>(data.data()), data.size());
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(temp_path, path, ec);
+		if (ec) {
+			// Another thread/process wrote the same entry first, which has identical contents
+			TryFileDelete(temp_path);
+		}
+
+		std::scoped_lock lock{ m_mutex };
+		if (m_entries.contains(key))
+			return;
+
+		m_entries[key] = Entry{ data.size(), std::filesystem::file_time_type::clock::now() };
+		m_stats.total_bytes += data.size();
+		m_stats.num_entries = m_entries.size();
+		m_stats.writes++;
+
+		if (m_stats.total_bytes > m_max_size_bytes) {
+			// Prune below the limit so a full cache doesn't evict on every single store
+			PruneUnlocked(m_max_size_bytes - m_max_size_bytes / 10);
+		}
+	}
+
+	void DerivedDataCache::IPrune(uint64_t max_size_bytes) {
+		std::scoped_lock lock{ m_mutex };
+		PruneUnlocked(max_size_bytes);
+	}
+
+	void DerivedDataCache::PruneUnlocked(uint64_t max_size_bytes) {
+		if (m_stats.total_bytes <= max_size_bytes)
+			return;
+
+		std::vector<std::pair<uint64_t, Entry>> entries{ m_entries.begin(), m_entries.end() };
+		std::ranges::sort(entries, [](const auto& a, const auto& b) { return a.second.last_access < b.second.last_access; });
+
+		for (auto& [key, entry] : entries) {
+			if (m_stats.total_bytes <= max_size_bytes)
+				break;
+
+			TryFileDelete(GetEntryPath(key));
+			m_entries.erase(key);
+			m_stats.total_bytes -= entry.size_bytes;
+			m_stats.evictions++;
+		}
+
+		m_stats.num_entries = m_entries.size();
+	}
+
+	void DerivedDataCache::SetMaxSize(uint64_t max_size_bytes) {
+		auto& instance = Get();
+		std::scoped_lock lock{ instance.m_mutex };
+		instance.m_max_size_bytes = max_size_bytes;
+		instance.PruneUnlocked(max_size_bytes);
+	}
+
+	DerivedDataCache::Stats DerivedDataCache::GetStats() {
+		auto& instance = Get();
+		std::scoped_lock lock{ instance.m_mutex };
+		return instance.m_stats;
+	}
+}
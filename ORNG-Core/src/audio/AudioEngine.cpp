@@ -1,12 +1,16 @@
 #include "pch/pch.h"
 #include <fmod.hpp>
+#ifdef _WIN32
 #include <combaseapi.h>
+#endif
 #include "audio/AudioEngine.h"
 
 namespace ORNG {
 
-	void AudioEngine::I_Init() {
+	void AudioEngine::I_Init(bool no_output) {
+#ifdef _WIN32
 		CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+#endif
 		FMOD_RESULT result;
 		result = FMOD::System_Create(&mp_system);
 
@@ -17,7 +21,12 @@ namespace ORNG {
 			exit(-1);
 		}
 
-		result = mp_system->init(512, FMOD_INIT_3D_RIGHTHANDED, 0);    // Initialize FMOD.
+		if (no_output)
+			ORNG_CALL_FMOD(mp_system->setOutput(FMOD_OUTPUTTYPE_NOSOUND));
+
+		ORNG_CALL_FMOD(mp_system->setSoftwareChannels(MAX_SOFTWARE_CHANNELS));
+
+		result = mp_system->init(MAX_CHANNELS, FMOD_INIT_3D_RIGHTHANDED, 0);    // Initialize FMOD.
 		if (result != FMOD_OK)
 		{
 			ORNG_CORE_ERROR("FMOD error! ({0}) {1}\n", result, FMOD_ErrorString(result));
@@ -4,8 +4,16 @@
 #include "audio/AudioEngine.h"
 #include "assets/AssetManager.h"
 #include "scene/SceneEntity.h"
+#include "core/FrameTiming.h"
 
 namespace ORNG {
+	// Positions and velocities are stored as glm::vec3 and passed straight to FMOD
+	static_assert(sizeof(FMOD_VECTOR) == sizeof(glm::vec3));
+
+	static const FMOD_VECTOR* ToFMOD(const glm::vec3& v) {
+		return reinterpret_cast<const FMOD_VECTOR*>(&v);
+	}
+
 	static void OnAudioComponentAdd(entt::registry& registry, entt::entity entity) {
 		ComponentSystem::DispatchComponentEvent<AudioComponent>(registry, entity, Events::ECS_EventType::COMP_ADDED);
 	}
@@ -36,8 +44,24 @@ namespace ORNG {
 			};
 
 
+		m_physics_listener.OnEvent = [this](const Events::PhysicsMovedEvent& e_event) {
+			if (e_event.scene_id != GetSceneUUID())
+				return;
+
+			for (auto* p_transform : *e_event.p_transforms) {
+				MarkSourceMoved(p_transform);
+			}
+			};
+
+		m_asset_listener.OnEvent = [this](const Events::AssetEvent& e_event) {
+			if (e_event.event_type == Events::AssetEventType::SOUND_RELOADED)
+				OnSoundReloaded(*reinterpret_cast<SoundAsset*>(e_event.data_payload));
+			};
+
 		Events::EventManager::RegisterListener(m_audio_listener);
 		Events::EventManager::RegisterListener(m_transform_listener);
+		Events::EventManager::RegisterListener(m_physics_listener);
+		Events::EventManager::RegisterListener(m_asset_listener);
 
 		auto& reg = mp_scene->GetRegistry();
 		reg.on_construct<AudioComponent>().connect<&OnAudioComponentAdd>();
@@ -46,61 +70,253 @@ namespace ORNG {
 
 
 	void AudioSystem::OnAudioDeleteEvent(const Events::ECS_Event<AudioComponent>& e_event) {
-		// Don't error check this as FMOD will clean this up if the channel is invalid.
-		e_event.affected_components[0]->mp_channel->stop();
+		auto* p_sound_comp = e_event.affected_components[0];
+		p_sound_comp->ReleaseChannel();
+
+		if (p_sound_comp->m_attributes_dirty)
+			std::erase(m_moved_sources, p_sound_comp->GetEnttHandle());
 
-		delete e_event.affected_components[0]->mp_fmod_pos;
-		delete e_event.affected_components[0]->mp_fmod_vel;
+		if (p_sound_comp->m_velocity != glm::vec3(0))
+			std::erase(m_moving_sources, p_sound_comp->GetEnttHandle());
 	}
 
 	void AudioSystem::OnUnload() {
 		mp_channel_group->release();
 		Events::EventManager::DeregisterListener(m_audio_listener.GetRegisterID());
 		Events::EventManager::DeregisterListener(m_transform_listener.GetRegisterID());
+		Events::EventManager::DeregisterListener(m_physics_listener.GetRegisterID());
+		Events::EventManager::DeregisterListener(m_asset_listener.GetRegisterID());
 	}
 
 
 
 	void AudioSystem::OnUpdate() {
-		auto& reg = mp_scene->GetRegistry();
+		const float dt = FrameTiming::GetTimeStep() / 1000.f;
 
 		if (auto* p_active_cam = mp_scene->GetActiveCamera()) {
 			auto& transform = *p_active_cam->GetEntity()->GetComponent<TransformComponent>();
-			auto pos = transform.GetAbsPosition();
-			static FMOD_VECTOR cam_pos;
-			cam_pos = { pos.x, pos.y, pos.z };
-			static FMOD_VECTOR cam_velocity;
-			static FMOD_VECTOR forward;
-			forward = { transform.forward.x, transform.forward.y, transform.forward.z };
-			static FMOD_VECTOR up;
-			up = { transform.up.x, transform.up.y, transform.up.z };
-			cam_velocity = { 0, 0, 0 };
-			ORNG_CALL_FMOD(AudioEngine::GetSystem()->set3DListenerAttributes(0, &cam_pos, &cam_velocity, &forward, &up));
+			glm::vec3 pos = transform.GetAbsPosition();
+			m_listener_vel = m_has_listener ? GetVelocity(m_listener_pos, pos, dt) : glm::vec3(0);
+			m_listener_pos = pos;
+			m_has_listener = true;
+
+			ORNG_CALL_FMOD(AudioEngine::GetSystem()->set3DListenerAttributes(0, ToFMOD(m_listener_pos), ToFMOD(m_listener_vel), ToFMOD(transform.forward), ToFMOD(transform.up)));
 		}
 
+		UpdateSourceAttributes(dt);
+		UpdateVoices();
 		ORNG_CALL_FMOD(AudioEngine::GetSystem()->update());
 	}
 
+	glm::vec3 AudioSystem::GetVelocity(glm::vec3 prev_pos, glm::vec3 pos, float dt) {
+		if (dt <= 0.f)
+			return glm::vec3(0);
+
+		glm::vec3 velocity = (pos - prev_pos) / dt;
+		// Treated as a teleport rather than something moving fast enough to pitch shift it to nothing
+		return glm::length(velocity) > MAX_DOPPLER_SPEED ? glm::vec3(0) : velocity;
+	}
+
+	void AudioSystem::UpdateSourceAttributes(float dt) {
+		ORNG_TRACY_PROFILE;
+		m_attribute_stats = AttributeStats{};
+		m_attribute_stats.transform_events = m_num_transform_events;
+		m_num_transform_events = 0;
+		m_attribute_stats.moved_sources = static_cast<unsigned>(m_moved_sources.size());
+		m_update_index++;
+
+		auto& reg = mp_scene->GetRegistry();
+		m_next_moving_sources.clear();
+		for (auto entity : m_moved_sources) {
+			// Removed since it was queued
+			auto* p_comp = reg.try_get<AudioComponent>(entity);
+			if (!p_comp)
+				continue;
+
+			glm::vec3 pos = p_comp->GetEntity()->GetComponent<TransformComponent>()->GetAbsPosition();
+			p_comp->m_velocity = GetVelocity(p_comp->m_position, pos, dt);
+			p_comp->m_position = pos;
+			p_comp->m_attributes_dirty = false;
+			p_comp->m_last_moved_update = m_update_index;
+
+			if (p_comp->m_velocity != glm::vec3(0))
+				m_next_moving_sources.push_back(entity);
+
+			if (p_comp->mp_channel) {
+				ORNG_CALL_FMOD(p_comp->mp_channel->set3DAttributes(ToFMOD(p_comp->m_position), ToFMOD(p_comp->m_velocity)));
+				m_attribute_stats.channel_updates++;
+			}
+		}
+
+		// Sources that moved last update but not this one have stopped
+		for (auto entity : m_moving_sources) {
+			auto* p_comp = reg.try_get<AudioComponent>(entity);
+			if (!p_comp || p_comp->m_last_moved_update == m_update_index)
+				continue;
+
+			p_comp->m_velocity = glm::vec3(0);
+			if (p_comp->mp_channel) {
+				ORNG_CALL_FMOD(p_comp->mp_channel->set3DAttributes(ToFMOD(p_comp->m_position), ToFMOD(p_comp->m_velocity)));
+				m_attribute_stats.channel_updates++;
+			}
+		}
+
+		m_moved_sources.clear();
+		std::swap(m_moving_sources, m_next_moving_sources);
+	}
+
+	void AudioSystem::UpdateVoices() {
+		ORNG_TRACY_PROFILE;
+		m_playing_sources.clear();
+		m_voices.clear();
+
+		for (auto [entity, comp] : mp_scene->GetRegistry().view<AudioComponent>().each()) {
+			if (!comp.m_is_playing)
+				continue;
+
+			if (comp.mp_channel) {
+				// The handle is invalid once a non-looping sound has ended, which leaves is_playing false
+				bool is_playing = false;
+				comp.mp_channel->isPlaying(&is_playing);
+				if (!is_playing) {
+					comp.ReleaseChannel();
+					comp.m_is_playing = false;
+					continue;
+				}
+			}
+
+			auto& voice = comp.m_voice;
+			voice.pos = comp.m_position;
+			voice.volume = comp.m_volume * (1.f - comp.m_occlusion);
+			voice.pitch = comp.m_pitch;
+			voice.level_3d = comp.m_level_3d;
+			voice.min_range = comp.m_range.min;
+			voice.max_range = comp.m_range.max;
+			voice.priority = comp.m_priority;
+			voice.is_2d = (comp.mode & FMOD_2D) != 0;
+			voice.looped = comp.is_looped;
+
+			m_playing_sources.push_back(&comp);
+			m_voices.push_back(&voice);
+		}
+
+		m_voice_manager.Update(m_voices, m_listener_pos, FrameTiming::GetTimeStep());
+
+		for (uint32_t i : m_voice_manager.GetVoicesToVirtualize()) {
+			auto& comp = *m_playing_sources[i];
+			unsigned position = 0;
+			ORNG_CALL_FMOD(comp.mp_channel->getPosition(&position, FMOD_TIMEUNIT_MS));
+			comp.m_voice.position_ms = position;
+			comp.ReleaseChannel();
+		}
+
+		for (uint32_t i : m_voice_manager.GetVoicesToRealize()) {
+			auto& comp = *m_playing_sources[i];
+			auto* p_asset = AssetManager::GetAsset<SoundAsset>(comp.m_sound_asset_uuid);
+
+			if (!p_asset || !StartChannel(comp, *p_asset)) {
+				comp.m_voice.is_virtual = true;
+				comp.m_is_playing = false;
+			}
+		}
+
+		for (uint32_t i : m_voice_manager.GetFinishedVoices()) {
+			m_playing_sources[i]->m_is_playing = false;
+		}
+
+		m_num_real_voices = m_voice_manager.GetStats().real_voices;
+	}
+
+	bool AudioSystem::StartChannel(AudioComponent& comp, SoundAsset& asset) {
+		FMOD::Sound* p_stream = nullptr;
+		if (asset.IsStreamed() && !(p_stream = asset.OpenStream(comp.is_looped)))
+			return false;
+
+		FMOD::Channel* p_channel = nullptr;
+		if (AudioEngine::GetSystem()->playSound(p_stream ? p_stream : asset.p_sound, mp_channel_group, true, &p_channel) != FMOD_OK) {
+			if (p_stream)
+				p_stream->release();
+
+			return false;
+		}
+
+		comp.mp_channel = p_channel;
+		comp.mp_stream = p_stream;
+		ORNG_CALL_FMOD(p_channel->setMode(comp.mode));
+		ORNG_CALL_FMOD(p_channel->setLoopCount(comp.is_looped ? -1 : 0));
+		ORNG_CALL_FMOD(p_channel->set3DAttributes(ToFMOD(comp.m_position), ToFMOD(comp.m_velocity)));
+		ORNG_CALL_FMOD(p_channel->setVolume(comp.m_volume));
+		ORNG_CALL_FMOD(p_channel->set3DMinMaxDistance(comp.m_range.min, comp.m_range.max));
+		ORNG_CALL_FMOD(p_channel->setPitch(comp.m_pitch));
+		ORNG_CALL_FMOD(p_channel->set3DLevel(comp.m_level_3d));
+		ORNG_CALL_FMOD(p_channel->setPan(comp.m_pan));
+		ORNG_CALL_FMOD(p_channel->set3DOcclusion(comp.m_occlusion, comp.m_occlusion));
+
+		// Resumes where the sound would have been if it had kept a channel while virtual
+		if (comp.m_voice.position_ms > 0.0)
+			ORNG_CALL_FMOD(p_channel->setPosition(static_cast<unsigned>(comp.m_voice.position_ms), FMOD_TIMEUNIT_MS));
+
+		ORNG_CALL_FMOD(p_channel->setPaused(comp.m_voice.paused));
+		return true;
+	}
+
+	void AudioSystem::OnSoundReloaded(SoundAsset& asset) {
+		unsigned length_ms = 0;
+		ORNG_CALL_FMOD(asset.p_sound->getLength(&length_ms, FMOD_TIMEUNIT_MS));
+
+		for (auto [entity, comp] : mp_scene->GetRegistry().view<AudioComponent>().each()) {
+			if (!comp.m_is_playing || comp.m_sound_asset_uuid != asset.uuid())
+				continue;
+
+			comp.m_voice.length_ms = length_ms;
+			if (!comp.mp_channel)
+				continue;
+
+			// Decoded channels play the old sound, which is about to be released, streamed ones read the source file that was just rewritten
+			unsigned position = 0;
+			comp.mp_channel->getPosition(&position, FMOD_TIMEUNIT_MS);
+			comp.ReleaseChannel();
+
+			// The new sound may be shorter
+			if (length_ms > 0 && position >= length_ms) {
+				if (!comp.is_looped) {
+					comp.m_is_playing = false;
+					continue;
+				}
+
+				position %= length_ms;
+			}
+
+			comp.m_voice.position_ms = position;
+			if (!StartChannel(comp, asset)) {
+				comp.m_voice.is_virtual = true;
+				comp.m_is_playing = false;
+			}
+		}
+	}
+
 	void AudioSystem::OnTransformEvent(const Events::ECS_Event<TransformComponent>& e_event) {
-		if (auto* p_sound_comp = e_event.affected_components[0]->GetEntity()->GetComponent<AudioComponent>()) {
-			auto pos = e_event.affected_components[0]->GetAbsPosition();
-			*p_sound_comp->mp_fmod_pos = { pos.x, pos.y, pos.z };
-			p_sound_comp->mp_channel->set3DAttributes(p_sound_comp->mp_fmod_pos, p_sound_comp->mp_fmod_vel);
+		MarkSourceMoved(e_event.affected_components[0]);
+	}
+
+	void AudioSystem::MarkSourceMoved(TransformComponent* p_transform) {
+		// A source can move several times a frame, its attributes are only read and sent to FMOD once in UpdateSourceAttributes
+		auto* p_sound_comp = p_transform->GetEntity()->GetComponent<AudioComponent>();
+		if (p_sound_comp && !p_sound_comp->m_attributes_dirty) {
+			p_sound_comp->m_attributes_dirty = true;
+			m_moved_sources.push_back(p_sound_comp->GetEnttHandle());
 		}
+
+		m_num_transform_events++;
 	}
 
 
 	void AudioSystem::OnAudioAddEvent(const Events::ECS_Event<AudioComponent>& e_event) {
-		auto pos = e_event.affected_components[0]->GetEntity()->GetComponent<TransformComponent>()->GetAbsPosition();
-		e_event.affected_components[0]->mp_fmod_pos = new FMOD_VECTOR{ pos.x, pos.y, pos.z };
-		e_event.affected_components[0]->mp_fmod_vel = new FMOD_VECTOR{ 0, 0, 0 };
+		// Starts at rest, velocities are only derived from movement after this
+		e_event.affected_components[0]->m_position = e_event.affected_components[0]->GetEntity()->GetComponent<TransformComponent>()->GetAbsPosition();
 
+		// No channel is taken until the sound is played, so idle components don't use up the voice budget
 		e_event.affected_components[0]->SetSoundAssetUUID(ORNG_BASE_SOUND_ID);
-
-		auto* p_asset = AssetManager::GetAsset<SoundAsset>(ORNG_BASE_SOUND_ID);
-
-		// Default initialize channel with the base sound
-		ORNG_CALL_FMOD(AudioEngine::GetSystem()->playSound(p_asset->p_sound, mp_channel_group, true, &e_event.affected_components[0]->mp_channel));
 	}
 
 	void AudioSystem::OnAudioUpdateEvent(const Events::ECS_Event<AudioComponent>& e_event) {
@@ -115,13 +331,22 @@ namespace ORNG {
 			if (!p_asset)
 				return;
 
-			ORNG_CALL_FMOD(AudioEngine::GetSystem()->playSound(p_asset->p_sound, mp_channel_group, true, &e_event.affected_components[0]->mp_channel));
-			ORNG_CALL_FMOD(p_sound_comp->mp_channel->set3DAttributes(p_sound_comp->mp_fmod_pos, p_sound_comp->mp_fmod_vel));
-			ORNG_CALL_FMOD(p_sound_comp->mp_channel->setVolume(p_sound_comp->m_volume));
-			ORNG_CALL_FMOD(p_sound_comp->mp_channel->set3DMinMaxDistance(p_sound_comp->m_range.min, p_sound_comp->m_range.max));
-			ORNG_CALL_FMOD(p_sound_comp->mp_channel->setPitch(p_sound_comp->m_pitch));
-			ORNG_CALL_FMOD(p_sound_comp->mp_channel->setMode(e_event.affected_components[0]->mode));
-			ORNG_CALL_FMOD(p_sound_comp->mp_channel->setPaused(false));
+			// Restarting reuses the component's voice
+			p_sound_comp->Stop();
+			p_sound_comp->m_is_playing = true;
+
+			auto& voice = p_sound_comp->m_voice;
+			voice.is_virtual = true;
+			voice.paused = false;
+			voice.position_ms = 0.0;
+			voice.length_ms = 0;
+			ORNG_CALL_FMOD(p_asset->p_sound->getLength(&voice.length_ms, FMOD_TIMEUNIT_MS));
+
+			// Starts real straight away if the budget allows it, otherwise the next update decides whether it's audible enough to take a channel from another sound
+			if (m_num_real_voices < m_voice_manager.GetMaxRealVoices() && StartChannel(*p_sound_comp, *p_asset)) {
+				voice.is_virtual = false;
+				m_num_real_voices++;
+			}
 
 			break;
 		}
@@ -0,0 +1,94 @@
+#include "pch/pch.h"
+#include "audio/VoiceManager.h"
+#include "util/util.h"
+
+namespace ORNG {
+	float VoiceManager::ScoreAudibility(const Voice& voice, glm::vec3 listener_pos) {
+		float attenuation = 1.f;
+
+		if (!voice.is_2d) {
+			const float distance = glm::length(voice.pos - listener_pos);
+			const float rolloff_width = voice.max_range - voice.min_range;
+			float distance_attenuation = 1.f;
+
+			if (distance > voice.min_range)
+				distance_attenuation = rolloff_width > 0.f ? glm::clamp(1.f - (distance - voice.min_range) / rolloff_width, 0.f, 1.f) : 0.f;
+
+			attenuation = glm::mix(1.f, distance_attenuation, voice.level_3d);
+		}
+
+		return voice.volume * attenuation * voice.priority;
+	}
+
+	void VoiceManager::Update(std::span<Voice* const> voices, glm::vec3 listener_pos, float dt_ms) {
+		ORNG_TRACY_PROFILE;
+		m_to_virtualize.clear();
+		m_to_realize.clear();
+		m_finished.clear();
+		m_ranked.clear();
+		m_stats = Stats{};
+
+		for (uint32_t i = 0; i < voices.size(); i++) {
+			Voice& voice = *voices[i];
+
+			if (voice.is_virtual && !voice.paused) {
+				voice.position_ms += dt_ms * voice.pitch;
+
+				if (voice.length_ms > 0 && voice.position_ms >= voice.length_ms) {
+					if (!voice.looped) {
+						m_finished.push_back(i);
+						continue;
+					}
+
+					voice.position_ms = glm::mod(voice.position_ms, static_cast<double>(voice.length_ms));
+				}
+			}
+
+			// Paused voices aren't heard, they keep their position while virtual
+			voice.audibility = voice.paused ? 0.f : ScoreAudibility(voice, listener_pos);
+			if (voice.audibility >= MIN_AUDIBILITY)
+				m_ranked.push_back(i);
+		}
+
+		auto rank_score = [&voices](uint32_t i) { return voices[i]->audibility * (voices[i]->is_virtual ? 1.f : REAL_VOICE_BIAS); };
+
+		if (m_ranked.size() > m_max_real_voices) {
+			std::ranges::nth_element(m_ranked, m_ranked.begin() + m_max_real_voices, std::greater{}, rank_score);
+			m_ranked.resize(m_max_real_voices);
+		}
+
+		// Sorted so the selection can be merged against voice indices below without a per-voice flag
+		std::ranges::sort(m_ranked);
+
+		auto selected_it = m_ranked.begin();
+		auto finished_it = m_finished.begin();
+		for (uint32_t i = 0; i < voices.size(); i++) {
+			if (finished_it != m_finished.end() && *finished_it == i) {
+				finished_it++;
+				continue;
+			}
+
+			Voice& voice = *voices[i];
+			const bool should_be_real = selected_it != m_ranked.end() && *selected_it == i;
+			if (should_be_real)
+				selected_it++;
+
+			if (should_be_real && voice.is_virtual) {
+				voice.is_virtual = false;
+				m_to_realize.push_back(i);
+			}
+			else if (!should_be_real && !voice.is_virtual) {
+				voice.is_virtual = true;
+				m_to_virtualize.push_back(i);
+			}
+
+			if (voice.is_virtual)
+				m_stats.virtual_voices++;
+			else
+				m_stats.real_voices++;
+		}
+
+		m_stats.virtualized = static_cast<unsigned>(m_to_virtualize.size());
+		m_stats.realized = static_cast<unsigned>(m_to_realize.size());
+	}
+}
@@ -11,22 +11,28 @@ namespace ORNG {
 
 	void AudioComponent::SetPitch(float p) {
 		m_pitch = p;
-		ORNG_CALL_FMOD(mp_channel->setPitch(p));
+		if (mp_channel)
+			ORNG_CALL_FMOD(mp_channel->setPitch(p));
 	}
 
 	void AudioComponent::SetVolume(float v) {
 		m_volume = v;
-		ORNG_CALL_FMOD(mp_channel->setVolume(v));
+		if (mp_channel)
+			ORNG_CALL_FMOD(mp_channel->setVolume(v));
 	}
 
 	void AudioComponent::SetMinMaxRange(float min, float max) {
 		m_range.min = min; 
 		m_range.max = max;
-		ORNG_CALL_FMOD(mp_channel->set3DMinMaxDistance(min, max));
+		if (mp_channel)
+			ORNG_CALL_FMOD(mp_channel->set3DMinMaxDistance(min, max));
 	}
 
 	void AudioComponent::SetPaused(bool b) {
-		ORNG_CALL_FMOD(mp_channel->setPaused(b));
+		// Stored on the voice so virtual sounds stop advancing too
+		m_voice.paused = b;
+		if (mp_channel)
+			ORNG_CALL_FMOD(mp_channel->setPaused(b));
 	}
 
 	void AudioComponent::Set2D(bool b) {
@@ -39,17 +45,30 @@ namespace ORNG {
 			mode = mode | FMOD_3D;
 		}
 
-		ORNG_CALL_FMOD(mp_channel->setMode(mode));
+		if (mp_channel)
+			ORNG_CALL_FMOD(mp_channel->setMode(mode));
 	}
 
 	bool AudioComponent::IsPlaying() {
-		bool b = false;
-		ORNG_CALL_FMOD(mp_channel->isPlaying(&b));
-		return b;
+		// Kept up to date by AudioSystem, which also tracks virtual sounds that have no channel to ask
+		return m_is_playing;
 	}
 
 	void AudioComponent::Stop() {
-		ORNG_CALL_FMOD(mp_channel->stop());
+		ReleaseChannel();
+		m_is_playing = false;
+	}
+
+	void AudioComponent::ReleaseChannel() {
+		// Don't error check this as the channel is invalid if the sound has already ended
+		if (mp_channel)
+			mp_channel->stop();
+
+		if (mp_stream)
+			ORNG_CALL_FMOD(mp_stream->release());
+
+		mp_channel = nullptr;
+		mp_stream = nullptr;
 	}
 
 	void AudioComponent::Play(uint64_t uuid) {
@@ -75,36 +94,50 @@ namespace ORNG {
 	}
 
 	bool AudioComponent::IsPaused() {
-		bool b;
-		mp_channel->getPaused(&b);
-		return b;
+		return m_voice.paused;
 	}
 
 	void AudioComponent::SetLooped(bool looped) {
 		is_looped = looped;
-		ORNG_CALL_FMOD(mp_channel->setLoopCount(looped ? -1 : 0));
 		mode = FMOD_DEFAULT | FMOD_3D | (looped ? FMOD_LOOP_NORMAL : FMOD_LOOP_OFF) | FMOD_3D_LINEARROLLOFF;
-		ORNG_CALL_FMOD(mp_channel->setMode(mode));
+
+		if (mp_channel) {
+			ORNG_CALL_FMOD(mp_channel->setLoopCount(looped ? -1 : 0));
+			ORNG_CALL_FMOD(mp_channel->setMode(mode));
+		}
 	}
 
 
 	void AudioComponent::Set3DLevel(float level) {
 		m_level_3d = level;
-		ORNG_CALL_FMOD(mp_channel->set3DLevel(level));
+		if (mp_channel)
+			ORNG_CALL_FMOD(mp_channel->set3DLevel(level));
 	}
 
 	void AudioComponent::SetPan(float pan) {
 		m_pan = pan;
-		ORNG_CALL_FMOD(mp_channel->setPan(pan));
+		if (mp_channel)
+			ORNG_CALL_FMOD(mp_channel->setPan(pan));
+	}
+
+	void AudioComponent::Set3DOcclusion(float occlusion) {
+		m_occlusion = occlusion;
+		if (mp_channel)
+			ORNG_CALL_FMOD(mp_channel->set3DOcclusion(occlusion, occlusion));
 	}
 
 
 	void AudioComponent::SetPlaybackPosition(unsigned time_in_ms) {
-		ORNG_CALL_FMOD(mp_channel->setPosition(time_in_ms, FMOD_TIMEUNIT_MS));
+		m_voice.position_ms = time_in_ms;
+		if (mp_channel)
+			ORNG_CALL_FMOD(mp_channel->setPosition(time_in_ms, FMOD_TIMEUNIT_MS));
 	}
 
 	unsigned int AudioComponent::GetPlaybackPosition() {
-		unsigned int pos;
+		if (!mp_channel)
+			return static_cast<unsigned>(m_voice.position_ms);
+
+		unsigned int pos = 0;
 		ORNG_CALL_FMOD(mp_channel->getPosition(&pos, FMOD_TIMEUNIT_MS));
 		return pos;
 	}
@@ -0,0 +1,201 @@
+#include "pch/pch.h"
+#include "components/CPUParticleSimulator.h"
+#include "components/ParticleEmitterComponent.h"
+#include "components/TransformComponent.h"
+#include "scene/SceneEntity.h"
+#include "util/ExtraMath.h"
+#include "util/Interpolators.h"
+#include "util/util.h"
+
+namespace ORNG {
+	// PI as defined in UtilINCL.glsl, not glm's, so seeds derived from it match
+	static constexpr float SHADER_PI = 3.14159265f;
+
+	// rnd() in UtilINCL.glsl
+	// The float to int conversion saturates like it does on the GPU, unsigned arithmetic wraps the same way the shader's int overflow does
+	static float Rnd(float x, float y) {
+		const float f = x * 40.f + y * 6400.f;
+		const int32_t n = f == f ? static_cast<int32_t>(glm::clamp(static_cast<double>(f), static_cast<double>(INT32_MIN), static_cast<double>(INT32_MAX))) : 0;
+
+		uint32_t u = static_cast<uint32_t>(n);
+		u = (u << 13) ^ u;
+		return 1.f - static_cast<float>((u * (u * u * 15731u + 789221u) + 1376312589u) & 0x7fffffffu) / 1073741824.f;
+	}
+
+	CPUParticleSimulator::EmitterParams CPUParticleSimulator::EmitterParams::FromEmitter(ParticleEmitterComponent& emitter) {
+		auto [pos, scale, rot] = emitter.GetEntity()->GetComponent<TransformComponent>()->GetAbsoluteTransforms();
+
+		EmitterParams params;
+		params.pos = pos;
+		params.rotation = ExtraMath::Init3DRotateTransform(rot.x, rot.y, rot.z);
+		params.spawn_extents = emitter.m_spawn_extents;
+		params.acceleration = emitter.acceleration;
+		params.vel_scale_min = emitter.m_velocity_min_max_scalar.x;
+		params.vel_scale_max = emitter.m_velocity_min_max_scalar.y;
+		params.spread = emitter.m_spread * 2.0f * glm::pi<float>();
+		params.lifespan_ms = emitter.m_particle_lifespan_ms;
+		params.spawn_delay_ms = emitter.m_particle_spawn_delay_ms;
+		params.start_index = emitter.m_particle_start_index;
+		params.active = emitter.m_active;
+
+		return params;
+	}
+
+	void CPUParticleSimulator::Particles::Resize(unsigned num_particles) {
+		for (auto* p_array : { &pos_x, &pos_y, &pos_z, &vel_x, &vel_y, &vel_z, &life, &scale, &colour_r, &colour_g, &colour_b, &life_scale_x, &life_scale_y, &life_scale_z, &alpha }) {
+			p_array->resize(num_particles);
+		}
+	}
+
+	void CPUParticleSimulator::Init(const EmitterParams& params, unsigned num_particles, float dt_ms) {
+		m_particles.Resize(0);
+		m_particles.Resize(num_particles);
+
+		for (unsigned i = 0; i < num_particles; i++) {
+			Respawn(params, i, dt_ms, true);
+		}
+	}
+
+	void CPUParticleSimulator::Respawn(const EmitterParams& params, unsigned i, float dt_ms, bool first_initialization) {
+		auto& p = m_particles;
+		const float index = static_cast<float>(params.start_index + i);
+
+		const float az = Rnd(index, Rnd(SHADER_PI, index)) * 2.0f * SHADER_PI;
+		const float pol = Rnd(SHADER_PI, Rnd(index, SHADER_PI)) * params.spread;
+
+		const float rnd_vel = Rnd(index, pol) * (params.vel_scale_max - params.vel_scale_min) + params.vel_scale_min;
+		const glm::vec3 vel = params.rotation * (glm::normalize(glm::vec3(glm::sin(pol) * glm::cos(az), glm::sin(pol) * glm::sin(az), glm::cos(pol))) * glm::abs(rnd_vel));
+
+		const glm::vec3 spawn_pos = params.pos + params.rotation * (glm::vec3(Rnd(index, dt_ms), Rnd(az, index), Rnd(p.pos_x[i], dt_ms)) * params.spawn_extents);
+
+		if (first_initialization) {
+			// Initial offset to life to factor in spawn delay
+			p.life[i] = static_cast<float>(i) * params.spawn_delay_ms;
+			p.scale[i] = 0.f;
+		}
+		else {
+			p.life[i] += params.lifespan_ms;
+			p.scale[i] = 1.f;
+		}
+
+		p.vel_x[i] = vel.x;
+		p.vel_y[i] = vel.y;
+		p.vel_z[i] = vel.z;
+		p.pos_x[i] = spawn_pos.x;
+		p.pos_y[i] = spawn_pos.y;
+		p.pos_z[i] = spawn_pos.z;
+	}
+
+	void CPUParticleSimulator::Update(const EmitterParams& params, float dt_ms, const InterpolatorV3& colour, const InterpolatorV3& scale, const InterpolatorV1& alpha) {
+		ORNG_TRACY_PROFILE;
+		const unsigned num_particles = GetNbParticles();
+		const unsigned num_blocks = (num_particles + BLOCK_SIZE - 1) / BLOCK_SIZE;
+		const unsigned max_workers = m_max_workers == 0 ? glm::max(std::thread::hardware_concurrency(), 1u) : m_max_workers;
+		const unsigned num_workers = glm::min(num_blocks, max_workers);
+
+		// Blocks touch disjoint ranges of every array so workers never share writes
+		std::atomic<unsigned> next_block = 0;
+		auto work = [&] {
+			for (unsigned block = next_block++; block < num_blocks; block = next_block++) {
+				const unsigned begin = block * BLOCK_SIZE;
+				UpdateBlock(params, dt_ms, begin, glm::min(begin + BLOCK_SIZE, num_particles), colour, scale, alpha);
+			}
+			};
+
+		// The calling thread takes blocks too
+		std::vector<std::future<void>> futures;
+		for (unsigned i = 1; i < num_workers; i++) {
+			futures.push_back(std::async(std::launch::async, work));
+		}
+
+		work();
+
+		for (auto& future : futures) {
+			future.get();
+		}
+	}
+
+	void CPUParticleSimulator::UpdateBlock(const EmitterParams& params, float dt_ms, unsigned begin, unsigned end, const InterpolatorV3& colour, const InterpolatorV3& scale, const InterpolatorV1& alpha) {
+		auto& p = m_particles;
+		float* p_life = p.life.data();
+		float* p_pos_x = p.pos_x.data();
+		float* p_pos_y = p.pos_y.data();
+		float* p_pos_z = p.pos_z.data();
+		float* p_vel_x = p.vel_x.data();
+		float* p_vel_y = p.vel_y.data();
+		float* p_vel_z = p.vel_z.data();
+
+		for (unsigned i = begin; i < end; i++) {
+			p_life[i] -= dt_ms;
+		}
+
+		if (params.active) {
+			for (unsigned i = begin; i < end; i++) {
+				if (p_life[i] <= 0.f)
+					Respawn(params, i, dt_ms, false);
+			}
+		}
+
+		// Same order of operations as the shader so results match to rounding
+		const glm::vec3 vel_step = params.acceleration * dt_ms * 0.001f;
+		for (unsigned i = begin; i < end; i++) {
+			p_vel_x[i] += vel_step.x;
+			p_vel_y[i] += vel_step.y;
+			p_vel_z[i] += vel_step.z;
+		}
+
+		for (unsigned i = begin; i < end; i++) {
+			p_pos_x[i] += p_vel_x[i] * dt_ms * 0.001f;
+			p_pos_y[i] += p_vel_y[i] * dt_ms * 0.001f;
+			p_pos_z[i] += p_vel_z[i] * dt_ms * 0.001f;
+		}
+
+		for (unsigned i = begin; i < end; i++) {
+			const float t = 1.f - glm::clamp(p_life[i], 0.f, params.lifespan_ms) / params.lifespan_ms;
+
+			const glm::vec3 c = colour.SampleLUT(t) * colour.scale;
+			p.colour_r[i] = c.r;
+			p.colour_g[i] = c.g;
+			p.colour_b[i] = c.b;
+
+			const glm::vec3 s = scale.SampleLUT(t) * scale.scale;
+			p.life_scale_x[i] = s.x;
+			p.life_scale_y[i] = s.y;
+			p.life_scale_z[i] = s.z;
+
+			p.alpha[i] = alpha.SampleLUT(t) * alpha.scale;
+		}
+	}
+
+	void CPUParticleSimulator::ReadGPUParticles(std::span<const GPUParticle> particles) {
+		auto& p = m_particles;
+		p.Resize(static_cast<unsigned>(particles.size()));
+
+		for (size_t i = 0; i < particles.size(); i++) {
+			const auto& particle = particles[i];
+			p.pos_x[i] = particle.pos.x;
+			p.pos_y[i] = particle.pos.y;
+			p.pos_z[i] = particle.pos.z;
+			p.vel_x[i] = particle.velocity_life.x;
+			p.vel_y[i] = particle.velocity_life.y;
+			p.vel_z[i] = particle.velocity_life.z;
+			p.life[i] = particle.velocity_life.w;
+			p.scale[i] = particle.scale.x;
+		}
+	}
+
+	void CPUParticleSimulator::WriteGPUParticles(std::span<GPUParticle> particles, unsigned emitter_index) const {
+		ASSERT(particles.size() >= GetNbParticles());
+		const auto& p = m_particles;
+
+		for (unsigned i = 0; i < GetNbParticles(); i++) {
+			auto& particle = particles[i];
+			particle.pos = { p.pos_x[i], p.pos_y[i], p.pos_z[i], 0.f };
+			particle.quat = { 0.f, 0.f, 0.f, 1.f };
+			particle.scale = glm::vec4(p.scale[i]);
+			particle.velocity_life = { p.vel_x[i], p.vel_y[i], p.vel_z[i], p.life[i] };
+			particle.emitter_index = emitter_index;
+			particle.flags = 0;
+		}
+	}
+}
@@ -23,6 +23,22 @@ namespace ORNG {
 		SendUpdateEvent(); // Shape needs recreating
 	}
 
+	void PhysicsComponent::SetLayer(uint8_t layer) {
+		m_layer = glm::min(layer, static_cast<uint8_t>(MAX_LAYERS - 1));
+		// Filter data can be changed on the existing shape, no need to rebuild
+		SendFilterUpdateEvent();
+	}
+
+	void PhysicsComponent::SetCollisionMask(uint32_t mask) {
+		m_collision_mask = mask;
+		SendFilterUpdateEvent();
+	}
+
+	void PhysicsComponent::SetContactReportsEnabled(bool enabled) {
+		m_contact_reports_enabled = enabled;
+		SendFilterUpdateEvent();
+	}
+
 
 
 	void PhysicsComponent::AddForce(glm::vec3 force) {
@@ -68,7 +84,9 @@ namespace ORNG {
 		p_material->p_material->release();
 		p_material = &material;
 		material.p_material->acquireReference();
-		SendUpdateEvent();
+
+		// Materials can be swapped on the existing shape, no need to rebuild
+		SendMaterialUpdateEvent();
 	}
 
 	glm::vec3 PhysicsComponent::GetVelocity() const {
@@ -86,6 +104,16 @@ namespace ORNG {
 		Events::EventManager::DispatchEvent(phys_event);
 	}
 
+	void PhysicsComponent::SendFilterUpdateEvent() {
+		Events::ECS_Event<PhysicsComponent> phys_event{ Events::ECS_EventType::COMP_UPDATED, this, FILTER_DATA_UPDATE };
+		Events::EventManager::DispatchEvent(phys_event);
+	}
+
+	void PhysicsComponent::SendMaterialUpdateEvent() {
+		Events::ECS_Event<PhysicsComponent> phys_event{ Events::ECS_EventType::COMP_UPDATED, this, MATERIAL_UPDATE };
+		Events::EventManager::DispatchEvent(phys_event);
+	}
+
 
 
 	void CharacterControllerComponent::Move(glm::vec3 disp, float minDist, float elapsedTime) {
@@ -4,8 +4,8 @@
 
 namespace ORNG {
 
-	void TransformHierarchySystem::UpdateChildTransforms(const Events::ECS_Event<TransformComponent>& t_event) {
-		auto* p_relationship_comp = t_event.affected_components[0]->GetEntity()->GetComponent<RelationshipComponent>();
+	void TransformHierarchySystem::UpdateChildTransforms(TransformComponent* p_transform, TransformComponent::UpdateType type) {
+		auto* p_relationship_comp = p_transform->GetEntity()->GetComponent<RelationshipComponent>();
 		entt::entity current_entity = p_relationship_comp->first;
 
 		auto& reg = mp_scene->GetRegistry();
@@ -16,7 +16,7 @@ namespace ORNG {
 			if (transform.m_is_absolute)
 				continue;
 
-			transform.RebuildMatrix(static_cast<TransformComponent::UpdateType>(t_event.sub_event_type));
+			transform.RebuildMatrix(type);
 			current_entity = reg.get<RelationshipComponent>(current_entity).next;
 		}
 	}
@@ -25,11 +25,21 @@ namespace ORNG {
 		// On transform update event, update all child transforms
 		m_transform_event_listener.OnEvent = [this](const Events::ECS_Event<TransformComponent>& t_event) {
 			[[likely]] if (t_event.event_type == Events::ECS_EventType::COMP_UPDATED) {
-				UpdateChildTransforms(t_event);
+				UpdateChildTransforms(t_event.affected_components[0], static_cast<TransformComponent::UpdateType>(t_event.sub_event_type));
+			}
+		};
+
+		m_physics_listener.OnEvent = [this](const Events::PhysicsMovedEvent& t_event) {
+			if (t_event.scene_id != GetSceneUUID())
+				return;
+
+			for (auto* p_transform : *t_event.p_transforms) {
+				UpdateChildTransforms(p_transform, TransformComponent::ALL);
 			}
 		};
 
 		m_transform_event_listener.scene_id = GetSceneUUID();
 		Events::EventManager::RegisterListener(m_transform_event_listener);
+		Events::EventManager::RegisterListener(m_physics_listener);
 	}
 }
\ No newline at end of file
@@ -43,7 +43,7 @@ namespace ORNG {
 			return;
 
 		while (p_parent_transform) {
-			m_abs_orientation += p_parent_transform->m_orientation;
+			m_abs_orientation += p_parent_transform->GetOrientation();
 			m_abs_scale *= p_parent_transform->m_scale;
 
 			p_parent_transform = p_parent_transform->GetParent();
@@ -62,7 +62,17 @@ namespace ORNG {
 	}
 
 	void TransformComponent::RebuildMatrix(UpdateType type) {
+		BuildMatrix();
+
+		if (GetEntity()) {
+			Events::ECS_Event<TransformComponent> e_event{ Events::ECS_EventType::COMP_UPDATED, this, type };
+			Events::EventManager::DispatchEvent(e_event);
+		}
+	}
+
+	void TransformComponent::BuildMatrix() {
 		//ORNG_TRACY_PROFILE;
+		ResolveOrientation();
 
 		auto* p_parent = GetParent();
 		if (m_is_absolute || !p_parent) {
@@ -117,10 +127,40 @@ namespace ORNG {
 		up = glm::normalize(glm::cross(right, forward));
 
 		UpdateAbsTransforms();
+	}
 
-		if (GetEntity()) {
-			Events::ECS_Event<TransformComponent> e_event{ Events::ECS_EventType::COMP_UPDATED, this, type };
-			Events::EventManager::DispatchEvent(e_event);
+	void TransformComponent::SetPhysicsPose(const glm::vec3& abs_pos, const glm::quat& abs_orientation, bool set_orientation) {
+		if (!m_is_absolute && GetParent()) {
+			// Bodies parented to another entity are rare, take the regular path through the parent's inverse
+			ResolveOrientation();
+			if (set_orientation)
+				m_orientation = glm::degrees(glm::eulerAngles(abs_orientation)) - (m_abs_orientation - m_orientation);
+
+			m_pos = glm::inverse(GetParent()->GetMatrix()) * glm::vec4(abs_pos, 1.0);
+			BuildMatrix();
+			return;
+		}
+
+		if (set_orientation) {
+			// Euler angles are only kept for editing/serialization and converted when they're read, the matrix is built straight from the quaternion
+			m_physics_orientation = abs_orientation;
+			m_orientation_stale = true;
+			glm::mat3 rot = glm::mat3_cast(abs_orientation);
+
+			m_transform[0] = glm::vec4(rot[0] * m_scale.x, 0.f);
+			m_transform[1] = glm::vec4(rot[1] * m_scale.y, 0.f);
+			m_transform[2] = glm::vec4(rot[2] * m_scale.z, 0.f);
+
+			forward = -rot[2];
+			right = glm::normalize(glm::cross(forward, g_up));
+			up = glm::normalize(glm::cross(right, forward));
 		}
+
+		m_transform[3] = glm::vec4(abs_pos, 1.f);
+		m_pos = abs_pos;
+
+		m_abs_pos = abs_pos;
+		m_abs_orientation = m_orientation;
+		m_abs_scale = m_scale;
 	}
 }
\ No newline at end of file
@@ -139,7 +139,17 @@ namespace ORNG {
 
 		Events::EventManager::RegisterListener(m_mesh_listener);
 		Events::EventManager::RegisterListener(m_asset_listener);
+		m_physics_listener.OnEvent = [this, p_scene](const Events::PhysicsMovedEvent& t_event) {
+			if (t_event.scene_id != p_scene->uuid())
+				return;
+
+			for (auto* p_transform : *t_event.p_transforms) {
+				FlagInstanceTransformUpdate(p_transform->GetEntity());
+			}
+			};
+
 		Events::EventManager::RegisterListener(m_transform_listener);
+		Events::EventManager::RegisterListener(m_physics_listener);
 		Events::EventManager::RegisterListener(m_billboard_listener);
 	};
 
@@ -174,19 +184,20 @@ namespace ORNG {
 
 	void MeshInstancingSystem::OnTransformEvent(const Events::ECS_Event<TransformComponent>& t_event) {
 		// Whenever a transform component changes, check if it has a mesh, if so then update the transform buffer of the instance group holding it.
-		auto* p_entity = t_event.affected_components[0]->GetEntity();
-		if (t_event.event_type == Events::ECS_EventType::COMP_UPDATED) {
+		if (t_event.event_type == Events::ECS_EventType::COMP_UPDATED)
+			FlagInstanceTransformUpdate(t_event.affected_components[0]->GetEntity());
+	}
 
-			if (auto* meshc = p_entity->GetComponent<MeshComponent>()) {
-				meshc->mp_instance_group->FlagInstanceTransformUpdate(meshc->GetEntity());
-			}
 
-			if (auto* p_billboard = p_entity->GetComponent<BillboardComponent>()) {
-				p_billboard->mp_instance_group->FlagInstanceTransformUpdate(p_entity);
-			}
-		} 
 
-	
+	void MeshInstancingSystem::FlagInstanceTransformUpdate(SceneEntity* p_entity) {
+		if (auto* meshc = p_entity->GetComponent<MeshComponent>()) {
+			meshc->mp_instance_group->FlagInstanceTransformUpdate(meshc->GetEntity());
+		}
+
+		if (auto* p_billboard = p_entity->GetComponent<BillboardComponent>()) {
+			p_billboard->mp_instance_group->FlagInstanceTransformUpdate(p_entity);
+		}
 	}
 
 
@@ -207,6 +218,7 @@ namespace ORNG {
 
 	void MeshInstancingSystem::OnUnload() {
 		Events::EventManager::DeregisterListener(m_transform_listener.GetRegisterID());
+		Events::EventManager::DeregisterListener(m_physics_listener.GetRegisterID());
 		Events::EventManager::DeregisterListener(m_mesh_listener.GetRegisterID());
 
 		for (auto* group : m_instance_groups) {
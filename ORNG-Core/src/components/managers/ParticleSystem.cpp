@@ -7,6 +7,7 @@
 #include "util/TimeStep.h"
 #include "components/ParticleBufferComponent.h"
 #include "util/Timers.h"
+#include "core/FrameTiming.h"
 
 
 
@@ -14,8 +15,12 @@
 namespace ORNG {
 
 	constexpr unsigned particle_struct_size = sizeof(float) * 4 + sizeof(glm::vec4) * 4;
-	constexpr unsigned emitter_struct_size = sizeof(float) * 36 + InterpolatorV3::GPU_STRUCT_SIZE_BYTES * 2 + sizeof(float) * 6 + InterpolatorV1::GPU_STRUCT_SIZE_BYTES + sizeof(float) * 3;
+	constexpr unsigned emitter_struct_size = sizeof(float) * 36;
+	// ParticleEmitterLUTs in ParticleBuffersINCL.glsl, alpha is packed 4 floats to a vec4
+	constexpr unsigned emitter_lut_struct_size = sizeof(glm::vec4) * (InterpolatorV3::LUT_SIZE * 2 + InterpolatorV1::LUT_SIZE / 4 + 1);
+	static_assert(InterpolatorV3::LUT_SIZE == InterpolatorV1::LUT_SIZE && InterpolatorV1::LUT_SIZE % 4 == 0);
 	constexpr unsigned particle_transform_size = sizeof(float) * 12;
+	static_assert(particle_struct_size == sizeof(CPUParticleSimulator::GPUParticle));
 
 	inline static void OnParticleEmitterAdd(entt::registry& registry, entt::entity entity) {
 		ComponentSystem::DispatchComponentEvent<ParticleEmitterComponent>(registry, entity, Events::ECS_EventType::COMP_ADDED);
@@ -69,6 +74,7 @@ namespace ORNG {
 		if (!m_particle_ssbo.IsInitialized()) {
 			m_particle_ssbo.Init();
 			m_emitter_ssbo.Init();
+			m_emitter_lut_ssbo.Init();
 			m_particle_append_ssbo.Init();
 			m_particle_append_ssbo.Resize(sizeof(uint32_t) + particle_struct_size * 100'000);
 			p_num_appended = static_cast<unsigned*>(glMapNamedBufferRange(m_particle_append_ssbo.GetHandle(), 0, sizeof(unsigned), GL_MAP_WRITE_BIT | GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT));
@@ -79,8 +85,10 @@ namespace ORNG {
 		m_particle_append_ssbo.draw_type = GL_DYNAMIC_DRAW;
 		m_particle_ssbo.draw_type = GL_DYNAMIC_DRAW;
 		m_emitter_ssbo.draw_type = GL_DYNAMIC_DRAW;
+		m_emitter_lut_ssbo.draw_type = GL_DYNAMIC_DRAW;
 
 		GL_StateManager::BindSSBO(m_emitter_ssbo.GetHandle(), GL_StateManager::SSBO_BindingPoints::PARTICLE_EMITTERS);
+		GL_StateManager::BindSSBO(m_emitter_lut_ssbo.GetHandle(), GL_StateManager::SSBO_BindingPoints::PARTICLE_INTERPOLATOR_LUTS);
 		GL_StateManager::BindSSBO(m_particle_ssbo.GetHandle(), GL_StateManager::SSBO_BindingPoints::PARTICLES);
 		GL_StateManager::BindSSBO(m_particle_append_ssbo.GetHandle(), GL_StateManager::SSBO_BindingPoints::PARTICLE_APPEND);
 
@@ -130,8 +138,19 @@ namespace ORNG {
 		reg.on_destroy<ParticleBufferComponent>().connect<&OnParticleBufferDestroy>();
 		reg.on_construct<ParticleBufferComponent>().connect<&OnParticleBufferAdd>();
 
+		m_physics_listener.OnEvent = [this](const Events::PhysicsMovedEvent& e_event) {
+			if (e_event.scene_id != GetSceneUUID())
+				return;
+
+			for (auto* p_transform : *e_event.p_transforms) {
+				if (auto* p_emitter = p_transform->GetEntity()->GetComponent<ParticleEmitterComponent>())
+					OnEmitterUpdate(p_emitter);
+			}
+			};
+
 		Events::EventManager::RegisterListener(m_particle_listener);
 		Events::EventManager::RegisterListener(m_transform_listener);
+		Events::EventManager::RegisterListener(m_physics_listener);
 		Events::EventManager::RegisterListener(m_particle_buffer_listener);
 	}
 
@@ -187,15 +206,26 @@ namespace ORNG {
 		if (m_emitter_ssbo.GetGPU_BufferSize() < m_emitter_entities.size() * emitter_struct_size)
 			m_emitter_ssbo.Resize(glm::max((int)glm::ceil(m_emitter_entities.size() * 1.5f), 10) * emitter_struct_size);
 
+		if (m_emitter_lut_ssbo.GetGPU_BufferSize() < m_emitter_entities.size() * emitter_lut_struct_size)
+			m_emitter_lut_ssbo.Resize(glm::max((int)glm::ceil(m_emitter_entities.size() * 1.5f), 10) * emitter_lut_struct_size);
+
 
 		UpdateEmitterBufferAtIndex(p_comp->m_index);
+		UpdateEmitterLUTsAtIndex(p_comp->m_index);
 		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
 
 		// Initialize new particles in shader
 		GL_StateManager::BindSSBO(m_emitter_ssbo.GetHandle(), GL_StateManager::SSBO_BindingPoints::PARTICLE_EMITTERS);
+		GL_StateManager::BindSSBO(m_emitter_lut_ssbo.GetHandle(), GL_StateManager::SSBO_BindingPoints::PARTICLE_INTERPOLATOR_LUTS);
 		GL_StateManager::BindSSBO(m_particle_ssbo.GetHandle(), GL_StateManager::SSBO_BindingPoints::PARTICLES);
 
+		if (p_comp->m_simulation_backend == ParticleEmitterComponent::SimulationBackend::CPU) {
+			m_cpu_simulators[p_comp->GetEnttHandle()].Init(CPUParticleSimulator::EmitterParams::FromEmitter(*p_comp), p_comp->m_num_particles, FrameTiming::GetTimeStep());
+			UploadCPUParticles(p_comp);
+			return;
+		}
+
 		mp_particle_initializer_cs->Activate(ParticleCSVariants::DEFAULT);
 		mp_particle_initializer_cs->SetUniform("u_start_index", p_comp->m_particle_start_index);
 		mp_particle_initializer_cs->SetUniform<unsigned>("u_emitter_index", m_emitter_entities.size() - 1);
@@ -208,32 +238,26 @@ namespace ORNG {
 
 	void ParticleSystem::UpdateEmitterBufferAtIndex(unsigned index) {
 		auto& comp = mp_scene->GetRegistry().get<ParticleEmitterComponent>(m_emitter_entities[index]);
-		auto* p_transform = comp.GetEntity()->GetComponent<TransformComponent>();
-		auto [pos, scale, rot] = p_transform->GetAbsoluteTransforms();
-		glm::vec3 forward = p_transform->forward;
+		// Shared with the CPU backend so both simulate from the same values
+		auto params = CPUParticleSimulator::EmitterParams::FromEmitter(comp);
 
 		std::array<std::byte, emitter_struct_size> emitter_data;
 		std::byte* p_byte = &emitter_data[0];
 
 		ConvertToBytes(p_byte,
-			pos, 0.0f,
-			comp.m_particle_start_index, 
+			params.pos, 0.0f,
+			params.start_index, 
 			comp.m_num_particles, 
-			comp.m_spread * 2.0f * glm::pi<float>(),
-			comp.m_velocity_min_max_scalar.x,
-			glm::mat4(ExtraMath::Init3DRotateTransform(rot.x, rot.y, rot.z)),
-			comp.m_spawn_extents,
-			comp.m_velocity_min_max_scalar.y,
-			comp.m_particle_lifespan_ms, 
-			comp.m_particle_spawn_delay_ms, 
-			static_cast<int>(comp.m_active), 0.0f,
-			comp.m_life_colour_interpolator,
-			0.0f, 0.0f,
-			comp.m_life_scale_interpolator,
-			0.0f, 0.0f,
-			comp.m_life_alpha_interpolator,
-			0.0f, 0.0f,
-			comp.acceleration,
+			params.spread,
+			params.vel_scale_min,
+			glm::mat4(params.rotation),
+			params.spawn_extents,
+			params.vel_scale_max,
+			params.lifespan_ms, 
+			params.spawn_delay_ms, 
+			static_cast<int>(params.active), 
+			static_cast<int>(comp.m_simulation_backend == ParticleEmitterComponent::SimulationBackend::CPU),
+			params.acceleration,
 			0.f
 			);
 
@@ -242,6 +266,31 @@ namespace ORNG {
 
 	}
 
+	void ParticleSystem::UpdateEmitterLUTsAtIndex(unsigned index) {
+		auto& comp = mp_scene->GetRegistry().get<ParticleEmitterComponent>(m_emitter_entities[index]);
+		auto& colour_lut = comp.m_life_colour_interpolator.GetLUT();
+		auto& scale_lut = comp.m_life_scale_interpolator.GetLUT();
+		auto& alpha_lut = comp.m_life_alpha_interpolator.GetLUT();
+
+		std::array<glm::vec4, emitter_lut_struct_size / sizeof(glm::vec4)> lut_data;
+		glm::vec4* p_colour = &lut_data[0];
+		glm::vec4* p_scale = p_colour + InterpolatorV3::LUT_SIZE;
+		glm::vec4* p_alpha = p_scale + InterpolatorV3::LUT_SIZE;
+
+		for (unsigned i = 0; i < InterpolatorV3::LUT_SIZE; i++) {
+			p_colour[i] = glm::vec4(colour_lut[i], 0.f);
+			p_scale[i] = glm::vec4(scale_lut[i], 0.f);
+		}
+
+		for (unsigned i = 0; i < InterpolatorV1::LUT_SIZE / 4; i++) {
+			p_alpha[i] = { alpha_lut[i * 4], alpha_lut[i * 4 + 1], alpha_lut[i * 4 + 2], alpha_lut[i * 4 + 3] };
+		}
+
+		lut_data[lut_data.size() - 1] = { comp.m_life_colour_interpolator.scale, comp.m_life_scale_interpolator.scale, comp.m_life_alpha_interpolator.scale, 0.f };
+
+		glNamedBufferSubData(m_emitter_lut_ssbo.GetHandle(), index * emitter_lut_struct_size, emitter_lut_struct_size, &lut_data[0]);
+	}
+
 
 	void ParticleSystem::OnEmitterUpdate(ParticleEmitterComponent* p_comp) {
 		UpdateEmitterBufferAtIndex(p_comp->m_index);
@@ -265,13 +314,16 @@ namespace ORNG {
 	void ParticleSystem::OnEmitterUpdate(const Events::ECS_Event<ParticleEmitterComponent>& e_event) {
 		auto* p_comp = e_event.affected_components[0];
 
-		if (e_event.sub_event_type & (ParticleEmitterComponent::FULL_UPDATE | ParticleEmitterComponent::NB_PARTICLES_CHANGED | ParticleEmitterComponent::LIFESPAN_CHANGED | ParticleEmitterComponent::SPAWN_DELAY_CHANGED)) {
+		if (e_event.sub_event_type & (ParticleEmitterComponent::FULL_UPDATE | ParticleEmitterComponent::NB_PARTICLES_CHANGED | ParticleEmitterComponent::LIFESPAN_CHANGED | ParticleEmitterComponent::SPAWN_DELAY_CHANGED | ParticleEmitterComponent::BACKEND_CHANGED)) {
 			OnEmitterDestroy(p_comp, std::any_cast<int>(e_event.data_payload));
 			InitEmitter(p_comp);
 		}
 		else if (e_event.sub_event_type & ParticleEmitterComponent::VISUAL_TYPE_CHANGED) {
 			OnEmitterVisualTypeChange(e_event.affected_components[0]);
 		}
+		else if (e_event.sub_event_type & ParticleEmitterComponent::MODIFIERS_CHANGED) {
+			UpdateEmitterLUTsAtIndex(e_event.affected_components[0]->m_index);
+		}
 		else {
 			UpdateEmitterBufferAtIndex(e_event.affected_components[0]->m_index);
 		}
@@ -311,17 +363,21 @@ namespace ORNG {
 		}
 
 		m_emitter_entities.erase(it);
+		m_cpu_simulators.erase(p_comp->GetEnttHandle());
 		total_emitter_particles -= old_nb_particles;
 
 		m_emitter_ssbo.Erase(p_comp->m_index * emitter_struct_size, emitter_struct_size);
+		m_emitter_lut_ssbo.Erase(p_comp->m_index * emitter_lut_struct_size, emitter_lut_struct_size);
 		m_particle_ssbo.Erase(p_comp->m_particle_start_index * particle_struct_size, old_nb_particles * particle_struct_size);
 
 		GL_StateManager::BindSSBO(m_emitter_ssbo.GetHandle(), GL_StateManager::SSBO_BindingPoints::PARTICLE_EMITTERS);
+		GL_StateManager::BindSSBO(m_emitter_lut_ssbo.GetHandle(), GL_StateManager::SSBO_BindingPoints::PARTICLE_INTERPOLATOR_LUTS);
 		GL_StateManager::BindSSBO(m_particle_ssbo.GetHandle(), GL_StateManager::SSBO_BindingPoints::PARTICLES);
 	}
 
 	void ParticleSystem::OnUnload() {
 		Events::EventManager::DeregisterListener(m_transform_listener.GetRegisterID());
+		Events::EventManager::DeregisterListener(m_physics_listener.GetRegisterID());
 		Events::EventManager::DeregisterListener(m_particle_listener.GetRegisterID());
 		Events::EventManager::DeregisterListener(m_particle_buffer_listener.GetRegisterID());
 	}
@@ -363,7 +419,34 @@ namespace ORNG {
 
 	}
 
+	void ParticleSystem::UploadCPUParticles(ParticleEmitterComponent* p_comp) {
+		auto& simulator = m_cpu_simulators[p_comp->GetEnttHandle()];
+		m_cpu_upload_buffer.resize(simulator.GetNbParticles());
+		simulator.WriteGPUParticles(m_cpu_upload_buffer, p_comp->m_index);
+
+		glNamedBufferSubData(m_particle_ssbo.GetHandle(), p_comp->m_particle_start_index * particle_struct_size, m_cpu_upload_buffer.size() * particle_struct_size, m_cpu_upload_buffer.data());
+	}
+
+	void ParticleSystem::UpdateCPUEmitters() {
+		const float dt = FrameTiming::GetTimeStep();
+
+		for (auto& [entity, simulator] : m_cpu_simulators) {
+			auto& comp = mp_scene->GetRegistry().get<ParticleEmitterComponent>(entity);
+			simulator.Update(CPUParticleSimulator::EmitterParams::FromEmitter(comp), dt, comp.m_life_colour_interpolator, comp.m_life_scale_interpolator, comp.m_life_alpha_interpolator);
+			UploadCPUParticles(&comp);
+		}
+	}
+
+	void ParticleSystem::ReadEmitterParticles(ParticleEmitterComponent* p_comp, std::vector<CPUParticleSimulator::GPUParticle>& output) {
+		output.resize(p_comp->m_num_particles);
+		glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+		glGetNamedBufferSubData(m_particle_ssbo.GetHandle(), p_comp->m_particle_start_index * particle_struct_size, output.size() * particle_struct_size, output.data());
+	}
+
 	void ParticleSystem::OnUpdate() {
+		// Emitters on the CPU backend are skipped by ParticleCS
+		UpdateCPUEmitters();
+
 		mp_particle_cs->ActivateProgram();
 		GL_StateManager::BindSSBO(m_particle_ssbo.GetHandle(), GL_StateManager::SSBO_BindingPoints::PARTICLES);
 
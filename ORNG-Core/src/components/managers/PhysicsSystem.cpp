@@ -11,6 +11,9 @@
 #include "assets/AssetManager.h"
 #include "physx/extensions/PxParticleExt.h"
 #include "core/FrameTiming.h"
+#include "assets/DerivedDataCache.h"
+#include "physics/PhysicsLayers.h"
+#include <condition_variable>
 
 
 namespace ORNG {
@@ -50,25 +53,61 @@ namespace ORNG {
 		ComponentSystem::DispatchComponentEvent<JointComponent>(registry, entity, Events::ECS_EventType::COMP_DELETED);
 	}
 
-	PhysicsSystem::PhysicsSystem(Scene* p_scene) : ComponentSystem(p_scene) {
+	PhysicsSystem::PhysicsSystem(Scene* p_scene, PhysicsDispatcherPool dispatcher_pool) : ComponentSystem(p_scene), m_dispatcher_pool(dispatcher_pool) {
 	};
 
+	static bool IsKinematicActor(PxRigidActor* p_actor) {
+		auto* p_dynamic = p_actor->is<PxRigidDynamic>();
+		return p_dynamic && p_dynamic->getRigidBodyFlags().isSet(PxRigidBodyFlag::eKINEMATIC);
+	}
+
+
+
+	// Simulation filter data layout for physics component shapes:
+	// word0 = layer bit, word1 = layers it collides with (PhysicsLayers matrix & collision mask), word2 = flags
+	// Shapes with no filter data (character controllers, vehicles) collide with everything and always report
+	static constexpr PxU32 FILTER_FLAG_REPORT_CONTACTS = 1 << 0;
+
+	// Copied into the scene by PhysX, so the counter it points to is shared by every invocation of the shader
+	struct FilterShaderData {
+		std::atomic<unsigned>* p_pairs_filtered = nullptr;
+	};
+
+	static PxFilterData GetSimulationFilterData(const PhysicsComponent& comp) {
+		uint32_t layer = comp.GetLayer();
+		return PxFilterData(1u << layer, PhysicsLayers::GetInteractionMask(layer) & comp.GetCollisionMask(), comp.GetContactReportsEnabled() ? FILTER_FLAG_REPORT_CONTACTS : 0, 0);
+	}
+
 	PxFilterFlags FilterShader(
 		PxFilterObjectAttributes attributes0, PxFilterData filterData0,
 		PxFilterObjectAttributes attributes1, PxFilterData filterData1,
 		PxPairFlags& pairFlags, const void* constantBlock, PxU32 constantBlockSize)
 	{
-		// let triggers through
+		// Non-interacting layers are dropped here so the pair never reaches narrowphase
+		const bool layered = filterData0.word0 && filterData1.word0;
+		if (layered && !((filterData0.word0 & filterData1.word1) && (filterData1.word0 & filterData0.word1))) {
+			static_cast<const FilterShaderData*>(constantBlock)->p_pairs_filtered->fetch_add(1, std::memory_order_relaxed);
+			return PxFilterFlag::eKILL;
+		}
+
+		const bool report = !filterData0.word0 || !filterData1.word0 || ((filterData0.word2 | filterData1.word2) & FILTER_FLAG_REPORT_CONTACTS);
+
 		if (PxFilterObjectIsTrigger(attributes0) || PxFilterObjectIsTrigger(attributes1))
 		{
+			// Triggers have no effect on the simulation, so a trigger pair nobody listens to can be dropped entirely
+			if (!report) {
+				static_cast<const FilterShaderData*>(constantBlock)->p_pairs_filtered->fetch_add(1, std::memory_order_relaxed);
+				return PxFilterFlag::eKILL;
+			}
+
 			pairFlags = PxPairFlag::eTRIGGER_DEFAULT;
 			return PxFilterFlag::eDEFAULT;
 		}
-		// generate contacts for all that were not filtered above
+
 		pairFlags = PxPairFlag::eCONTACT_DEFAULT;
 
-		// trigger the contact callback for pairs (A,B) where
-		// the filtermask of A contains the ID of B and vice versa.
+		// Only generate contact notifications that a script will consume
+		if (report)
 			pairFlags |= PxPairFlag::eNOTIFY_TOUCH_FOUND;
 
 		return PxFilterFlag::eDEFAULT;
@@ -83,8 +122,12 @@ namespace ORNG {
 		PxTolerancesScale scale(1.f);
 		PxSceneDesc scene_desc{ scale };
 		scene_desc.filterShader = FilterShader;
+		FilterShaderData filter_shader_data{ &m_pairs_filtered };
+		scene_desc.filterShaderData = &filter_shader_data;
+		scene_desc.filterShaderDataSize = sizeof(FilterShaderData);
 		scene_desc.gravity = PxVec3(0.f, -9.81f, 0.f);
-		scene_desc.cpuDispatcher = Physics::GetCPUDispatcher();
+		mp_dispatcher = Physics::GetCPUDispatcher(m_dispatcher_pool);
+		scene_desc.cpuDispatcher = mp_dispatcher;
 		scene_desc.cudaContextManager = Physics::GetCudaContextManager();
 		scene_desc.flags |= PxSceneFlag::eENABLE_PCM;
 		scene_desc.flags |= PxSceneFlag::eENABLE_ACTIVE_ACTORS;
@@ -107,6 +150,8 @@ namespace ORNG {
 
 		InitListeners();
 
+		m_layers_version = PhysicsLayers::GetVersion();
+
 		auto& reg = mp_scene->GetRegistry();
 		reg.on_construct<PhysicsComponent>().connect<&OnPhysComponentAdd>();
 		reg.on_destroy<PhysicsComponent>().connect<&OnPhysComponentDestroy>();
@@ -148,13 +193,19 @@ namespace ORNG {
 		// Physics listener
 		m_phys_listener.scene_id = GetSceneUUID();
 		m_phys_listener.OnEvent = [this](const Events::ECS_Event<PhysicsComponent>& t_event) {
+			FetchInFlightStep();
 			switch (t_event.event_type) {
 				using enum Events::ECS_EventType;
 			case COMP_ADDED: // Only doing index 0 because these events will only ever affect a single component currently
 				InitComponent(t_event.affected_components[0]);
 				break;
 			case COMP_UPDATED:
-				UpdateComponentState(t_event.affected_components[0]);
+				if (t_event.sub_event_type == PhysicsComponent::FILTER_DATA_UPDATE)
+					UpdateFilterData(t_event.affected_components[0]);
+				else if (t_event.sub_event_type == PhysicsComponent::MATERIAL_UPDATE)
+					UpdateMaterial(t_event.affected_components[0]);
+				else
+					UpdateComponentState(t_event.affected_components[0]);
 				break;
 			case COMP_DELETED:
 				RemoveComponent(t_event.affected_components[0]);
@@ -167,6 +218,7 @@ namespace ORNG {
 		// Joint listener
 		m_joint_listener.scene_id = GetSceneUUID();
 		m_joint_listener.OnEvent = [this](const Events::ECS_Event<JointComponent>& t_event) {
+			FetchInFlightStep();
 			switch (t_event.event_type) {
 				using enum Events::ECS_EventType;
 			case COMP_ADDED:
@@ -183,6 +235,7 @@ namespace ORNG {
 
 		m_vehicle_listener.scene_id = GetSceneUUID();
 		m_vehicle_listener.OnEvent = [this](const Events::ECS_Event<VehicleComponent>& t_event) {
+			FetchInFlightStep();
 			switch (t_event.event_type) {
 				using enum Events::ECS_EventType; 
 			case COMP_ADDED:
@@ -200,6 +253,7 @@ namespace ORNG {
 		// Character controller listener
 		m_character_controller_listener.scene_id = GetSceneUUID();
 		m_character_controller_listener.OnEvent = [this](const Events::ECS_Event<CharacterControllerComponent>& t_event) {
+			FetchInFlightStep();
 			using enum Events::ECS_EventType;
 			switch (t_event.event_type) {
 			case COMP_ADDED: // Only doing index 0 because these events will only ever affect a single component currently
@@ -218,11 +272,18 @@ namespace ORNG {
 			OnTransformEvent(t_event);
 			};
 
+		// Collision meshes are cached per mesh asset, they go stale when it's (re)loaded or deleted
+		m_asset_listener.OnEvent = [this](const Events::AssetEvent& t_event) {
+			if (t_event.event_type == Events::AssetEventType::MESH_LOADED || t_event.event_type == Events::AssetEventType::MESH_DELETED)
+				OnMeshAssetChange(reinterpret_cast<MeshAsset*>(t_event.data_payload), t_event.event_type == Events::AssetEventType::MESH_LOADED);
+			};
+
 		Events::EventManager::RegisterListener(m_phys_listener);
 		Events::EventManager::RegisterListener(m_joint_listener);
 		Events::EventManager::RegisterListener(m_character_controller_listener);
 		Events::EventManager::RegisterListener(m_transform_listener);
 		Events::EventManager::RegisterListener(m_vehicle_listener);
+		Events::EventManager::RegisterListener(m_asset_listener);
 	}
 
 	bool PhysicsSystem::InitVehicle(VehicleComponent* p_comp) {
@@ -241,7 +302,8 @@ namespace ORNG {
 		//setPhysXIntegrationParams(vehicle.mBaseParams.axleDescription, &f1, 1, 0.5, vehicle.mPhysXParams);
 		vehicle.mPhysXParams.create(vehicle.mBaseParams.axleDescription, PxQueryFilterData(), nullptr, &f1, 1, 0.5, PxTransform({ 0.0, 0.0, 0.5 }), half_extents, PxTransform(PxIdentity));
 
-		bool result = vehicle.initialize(*Physics::GetPhysics(), params, *p_base_material, true);
+		// PhysX begin/end components are run separately in StepVehicles so the rest of the sequence can be stepped in parallel
+		bool result = vehicle.initialize(*Physics::GetPhysics(), params, *p_base_material, false);
 		vehicle.setUpActor(*mp_phys_scene, PxTransform(PxIdentity), "Test vehicle");
 		PxShape* shapes[5];
 
@@ -252,7 +314,9 @@ namespace ORNG {
 			// TODO: Have actual parameters for changing shapes and debug visuals for it
 			shapes[i]->setFlag(PxShapeFlag::eSIMULATION_SHAPE, true);
 		}
+		vehicle.stepPhysXActorBegin(FLT_MIN, m_vehicle_context);
 		vehicle.step(FLT_MIN, m_vehicle_context);
+		vehicle.stepPhysXActorEnd(FLT_MIN, m_vehicle_context);
 
 		vehicle.mPhysXState.physxActor.rigidBody->userData = p_comp->GetEntity();
 
@@ -507,11 +571,16 @@ namespace ORNG {
 
 
 	void PhysicsSystem::RemoveComponent(VehicleComponent* p_comp) {
+		RemoveInterpolatedPose(p_comp->GetEntity()->GetEnttHandle());
 		p_comp->m_vehicle.destroy();
 	}
 
 
 	void PhysicsSystem::RemoveComponent(PhysicsComponent* p_comp) {
+		RemoveInterpolatedPose(p_comp->GetEntity()->GetEnttHandle());
+		if (IsKinematicActor(p_comp->p_rigid_actor))
+			m_num_kinematic_actors--;
+
 		mp_phys_scene->removeActor(*p_comp->p_rigid_actor);
 		p_comp->p_rigid_actor->release();
 
@@ -522,6 +591,31 @@ namespace ORNG {
 
 
 	void PhysicsSystem::OnUnload() {
+		FetchInFlightStep();
+
+		for (auto& [p_mesh_asset, job] : m_triangle_mesh_jobs) {
+			job.wait();
+		}
+		for (auto& [p_mesh_asset, job] : m_convex_mesh_jobs) {
+			job.wait();
+		}
+		m_triangle_mesh_jobs.clear();
+		m_convex_mesh_jobs.clear();
+		m_entities_awaiting_collision_mesh.clear();
+		m_level_stand_ins.clear();
+		m_holding_for_level_meshes = false;
+		m_interpolated_poses.clear();
+		m_interpolated_pose_indices.clear();
+		m_moved_actors.clear();
+		m_deferred_transform_changes.clear();
+		m_num_kinematic_actors = 0;
+		m_accumulator = 0.f;
+
+		if (!m_world_actors.empty()) {
+			ORNG_CORE_ERROR("PhysicsSystem unloaded with {0} world actors still added", m_world_actors.size());
+			m_world_actors.clear();
+		}
+
 		PxVehicleUnitCylinderSweepMeshDestroy(mp_sweep_mesh);
 		DeinitListeners();
 
@@ -537,38 +631,125 @@ namespace ORNG {
 		Events::EventManager::DeregisterListener(m_transform_listener.GetRegisterID());
 		Events::EventManager::DeregisterListener(m_joint_listener.GetRegisterID());
 		Events::EventManager::DeregisterListener(m_vehicle_listener.GetRegisterID());
+		Events::EventManager::DeregisterListener(m_asset_listener.GetRegisterID());
 	}
 
 
 	void PhysicsSystem::OnTransformEvent(const Events::ECS_Event<TransformComponent>& t_event) {
 		if (t_event.event_type == Events::ECS_EventType::COMP_UPDATED) {
-			auto* p_transform = t_event.affected_components[0];
+			// Transforms written by the physics system don't dispatch events, so this is always an external change
+			auto* p_ent = t_event.affected_components[0]->GetEntity();
+
+			// Actors can't be written to while they're being simulated, the step is fetched before the next update so this only stalls if something needs the result sooner
+			if (m_step_in_flight)
+				m_deferred_transform_changes.emplace_back(p_ent->GetEnttHandle(), t_event.sub_event_type);
+			else
+				ApplyTransformChange(*p_ent, t_event.sub_event_type);
+		}
+	}
 
-			if (p_transform == mp_currently_updating_transform) // Ignore transform event if it was updated by the physics engine, as the states are already synced
-				return;
 
-			// Check for both types of physics component
-			auto* p_ent = t_event.affected_components[0]->GetEntity();
-			auto* p_phys_comp = p_ent->GetComponent<PhysicsComponent>();
 
-			if (auto* p_vehicle_comp = p_ent->GetComponent<VehicleComponent>()) {
-				p_vehicle_comp->m_vehicle.mPhysXState.physxActor.rigidBody->setGlobalPose(TransformComponentToPxTransform(*p_transform));
-			}
+	void PhysicsSystem::ApplyTransformChange(SceneEntity& entity, uint32_t update_type) {
+		auto* p_transform = entity.GetComponent<TransformComponent>();
 
-			if (auto* p_controller_comp = p_ent->GetComponent<CharacterControllerComponent>()) {
-				glm::vec3 pos = p_transform->GetAbsPosition();
-				p_controller_comp->p_controller->setPosition({ pos.x, pos.y, pos.z });
-			}
+		// Teleported, don't blend from the old pose
+		RemoveInterpolatedPose(entity.GetEnttHandle());
+
+		// Check for both types of physics component
+		auto* p_phys_comp = entity.GetComponent<PhysicsComponent>();
+
+		if (auto* p_vehicle_comp = entity.GetComponent<VehicleComponent>()) {
+			p_vehicle_comp->m_vehicle.mPhysXState.physxActor.rigidBody->setGlobalPose(TransformComponentToPxTransform(*p_transform));
+		}
 
-			if (p_phys_comp) {
-				if (t_event.sub_event_type == TransformComponent::UpdateType::SCALE || t_event.sub_event_type == TransformComponent::UpdateType::ALL) { // Whole shape needs to be rebuilt
+		if (auto* p_controller_comp = entity.GetComponent<CharacterControllerComponent>()) {
+			glm::vec3 pos = p_transform->GetAbsPosition();
+			p_controller_comp->p_controller->setPosition({ pos.x, pos.y, pos.z });
+		}
+
+		if (p_phys_comp) {
+			if (update_type == TransformComponent::UpdateType::SCALE || update_type == TransformComponent::UpdateType::ALL) {
+				// Shape is only rebuilt if its geometry can't be rescaled in place
+				if (!UpdateShapeScale(p_phys_comp)) {
+					m_collider_scale_stats.shapes_rebuilt++;
 					UpdateComponentState(p_phys_comp);
 					return;
 				}
 
-				p_phys_comp->p_rigid_actor->setGlobalPose(TransformComponentToPxTransform(*p_transform));
+				m_collider_scale_stats.shapes_rescaled++;
+			}
+
+			if (p_phys_comp->m_body_type == PhysicsComponent::DYNAMIC) {
+				// Writing an unchanged pose would wake the actor up
+				PxTransform pose = TransformComponentToPxTransform(*p_transform);
+				if (!(p_phys_comp->p_rigid_actor->getGlobalPose() == pose))
+					p_phys_comp->p_rigid_actor->setGlobalPose(pose);
+			}
+			else if (!p_phys_comp->m_pending_pose_write) {
+				p_phys_comp->m_pending_pose_write = true;
+				m_moved_actors.push_back(entity.GetEnttHandle());
+			}
+		}
+	}
+
+
+
+	void PhysicsSystem::ApplyDeferredTransformChanges() {
+		if (m_deferred_transform_changes.empty())
+			return;
+
+		ORNG_TRACY_PROFILE;
+		auto& reg = mp_scene->GetRegistry();
+
+		// Later changes to the same entity rewrite the same poses, they're cheap as unchanged poses aren't written
+		auto changes = std::move(m_deferred_transform_changes);
+		m_deferred_transform_changes.clear();
+
+		for (auto [entity, update_type] : changes) {
+			if (auto* p_transform = reg.valid(entity) ? reg.try_get<TransformComponent>(entity) : nullptr)
+				ApplyTransformChange(*p_transform->GetEntity(), update_type);
+		}
+	}
+
+
+
+	void PhysicsSystem::FlushMovedActors() {
+		if (m_moved_actors.empty())
+			return;
+
+		ORNG_TRACY_PROFILE;
+		auto& reg = mp_scene->GetRegistry();
+
+		for (auto entity : m_moved_actors) {
+			auto* p_comp = reg.valid(entity) ? reg.try_get<PhysicsComponent>(entity) : nullptr;
+			if (!p_comp || !p_comp->m_pending_pose_write || !p_comp->p_rigid_actor)
+				continue;
+
+			p_comp->m_pending_pose_write = false;
+			PxTransform pose = TransformComponentToPxTransform(reg.get<TransformComponent>(entity));
+
+			if (p_comp->m_body_type == PhysicsComponent::KINEMATIC && IsKinematicActor(p_comp->p_rigid_actor)) {
+				auto* p_dynamic = static_cast<PxRigidDynamic*>(p_comp->p_rigid_actor);
+
+				PxTransform target;
+				if (!p_dynamic->getKinematicTarget(target))
+					target = p_dynamic->getGlobalPose();
+
+				// Transform may have been changed and then set back within the frame
+				if (target == pose)
+					continue;
+
+				p_dynamic->setKinematicTarget(pose);
+				m_kinematic_targets_set++;
+			}
+			else if (!(p_comp->p_rigid_actor->getGlobalPose() == pose)) {
+				p_comp->p_rigid_actor->setGlobalPose(pose);
+				m_statics_moved++;
 			}
 		}
+
+		m_moved_actors.clear();
 	}
 
 
@@ -578,9 +759,164 @@ namespace ORNG {
 		if (m_triangle_meshes.contains(p_mesh_asset))
 			return m_triangle_meshes[p_mesh_asset];
 
+		if (m_triangle_mesh_jobs.contains(p_mesh_asset))
+			return nullptr;
 
-		PxTolerancesScale scale(1.f);
+		// Not cached, streaming placeholders have no vertex data until they're loaded, see OnMeshAssetChange
+		if (!HasCollisionVertexData(p_mesh_asset)) {
+			ORNG_CORE_TRACE("No triangle mesh collider for mesh '{0}' yet, no vertex data", p_mesh_asset->filepath);
+			return nullptr;
+		}
+
+		const MeshVAO& vao = p_mesh_asset->GetVAO();
+
+		// Vertex data is copied as the mesh asset can be modified/deleted on the main thread while the job runs
+		m_triangle_mesh_jobs[p_mesh_asset] = std::async(std::launch::async, &PhysicsSystem::LoadOrCookTriangleMesh, 
+			static_cast<uint64_t>(p_mesh_asset->uuid()), vao.vertex_data.positions, vao.vertex_data.indices);
+
+		return nullptr;
+	}
+
+
+
+	PxConvexMesh* PhysicsSystem::GetOrCreateConvexMesh(const MeshAsset* p_mesh_asset) {
+		if (m_convex_meshes.contains(p_mesh_asset))
+			return m_convex_meshes[p_mesh_asset];
+
+		if (m_convex_mesh_jobs.contains(p_mesh_asset))
+			return nullptr;
+
+		if (!HasCollisionVertexData(p_mesh_asset)) {
+			ORNG_CORE_TRACE("No convex mesh collider for mesh '{0}' yet, no vertex data", p_mesh_asset->filepath);
+			return nullptr;
+		}
+
+		const MeshVAO& vao = p_mesh_asset->GetVAO();
+		if (vao.vertex_data.positions.size() < 12) {
+			ORNG_CORE_ERROR("Cannot create convex mesh collider for mesh '{0}', not enough vertex data", p_mesh_asset->filepath);
+			m_convex_meshes[p_mesh_asset] = nullptr;
+			return nullptr;
+		}
+
+		m_convex_mesh_jobs[p_mesh_asset] = std::async(std::launch::async, &PhysicsSystem::LoadOrCookConvexMesh,
+			static_cast<uint64_t>(p_mesh_asset->uuid()), vao.vertex_data.positions);
+
+		return nullptr;
+	}
+
+
+
+	bool PhysicsSystem::HasCollisionVertexData(const MeshAsset* p_mesh_asset) {
 		const MeshVAO& vao = p_mesh_asset->GetVAO();
+		return !vao.vertex_data.positions.empty() && !vao.vertex_data.indices.empty();
+	}
+
+
+
+	void PhysicsSystem::OnMeshAssetChange(const MeshAsset* p_mesh_asset, bool loaded) {
+		// Shapes hold their own references, so these are only released once nothing uses them
+		if (auto it = m_triangle_meshes.find(p_mesh_asset); it != m_triangle_meshes.end()) {
+			if (it->second)
+				it->second->release();
+
+			m_triangle_meshes.erase(it);
+		}
+
+		if (auto it = m_convex_meshes.find(p_mesh_asset); it != m_convex_meshes.end()) {
+			if (it->second)
+				it->second->release();
+
+			m_convex_meshes.erase(it);
+		}
+
+		// Components of a deleted mesh keep the shapes they have, the cache entry only has to go so a new asset at the same address isn't given them
+		if (!loaded)
+			return;
+
+		// Vertex data is only guaranteed to be on the CPU during this event, components are rebuilt now so any cooking is started with it
+		auto& reg = mp_scene->GetRegistry();
+		for (auto [entity, comp, mesh_comp] : reg.view<PhysicsComponent, MeshComponent>().each()) {
+			const auto geometry = comp.GetColliderGeometryType();
+			if (mesh_comp.GetMeshData() == p_mesh_asset && comp.p_shape && (geometry == PhysicsComponent::TRIANGLE_MESH || geometry == PhysicsComponent::CONVEX_MESH))
+				UpdateComponentState(&comp);
+		}
+	}
+
+
+
+	PxConvexMeshDesc PhysicsSystem::GetConvexHullDesc(std::span<const float> positions) {
+		PxConvexMeshDesc desc;
+		desc.points.count = static_cast<PxU32>(positions.size() / 3);
+		desc.points.stride = sizeof(float) * 3;
+		desc.points.data = positions.data();
+		// Shifting the vertices to be around the origin before computing the hull avoids precision issues with meshes far from their origin
+		// Dense meshes are quantized first so the hull computation doesn't scale with the full vertex count
+		desc.flags = PxConvexFlag::eCOMPUTE_CONVEX | PxConvexFlag::eSHIFT_VERTICES | PxConvexFlag::eQUANTIZE_INPUT;
+		desc.quantizedCount = 1024;
+		desc.vertexLimit = MAX_CONVEX_HULL_VERTICES;
+		return desc;
+	}
+
+
+
+	PxConvexMesh* PhysicsSystem::CookConvexHull(std::span<const float> positions) {
+		PxCookingParams params(PxTolerancesScale(1.f));
+		PxConvexMeshDesc desc = GetConvexHullDesc(positions);
+
+		PxDefaultMemoryOutputStream stream;
+		if (!PxCookConvexMesh(params, desc, stream))
+			return nullptr;
+
+		PxDefaultMemoryInputData input{ stream.getData(), stream.getSize() };
+		return Physics::GetPhysics()->createConvexMesh(input);
+	}
+
+
+
+	PhysicsSystem::CookedCollisionMesh PhysicsSystem::LoadOrCookConvexMesh(uint64_t mesh_uuid, std::vector<float> positions) {
+		ORNG_TRACY_PROFILE;
+		TimeStep timer{ TimeStep::TimeUnits::MICROSECONDS };
+		CookedCollisionMesh output;
+
+		PxTolerancesScale scale(1.f);
+		PxCookingParams params(scale);
+		PxConvexMeshDesc desc = GetConvexHullDesc(positions);
+
+		uint64_t vertex_hash = HashBytes(positions.data(), positions.size() * sizeof(float));
+		std::string settings = std::format("uuid={};flags={};quantized={};limit={};physx={}", mesh_uuid, static_cast<uint32_t>(desc.flags),
+			desc.quantizedCount, desc.vertexLimit, PX_PHYSICS_VERSION);
+
+		uint64_t key = DerivedDataCache::MakeKey(vertex_hash, settings, CONVEX_MESH_CACHE_VERSION);
+
+		if (DerivedDataCache::Load(key, output.data)) {
+			output.loaded_from_cache = true;
+			output.time_ms = timer.GetTimeInterval() / 1000.f;
+			return output;
+		}
+
+		PxDefaultMemoryOutputStream stream;
+		PxConvexMeshCookingResult::Enum result;
+		if (!PxCookConvexMesh(params, desc, stream, &result)) {
+			ORNG_CORE_ERROR("Failed cooking convex mesh for mesh asset '{0}', cooking result: {1}", mesh_uuid, static_cast<int>(result));
+			return output;
+		}
+
+		output.data.resize(stream.getSize());
+		std::memcpy(output.data.data(), stream.getData(), stream.getSize());
+		output.time_ms = timer.GetTimeInterval() / 1000.f;
+
+		DerivedDataCache::Store(key, output.data);
+		return output;
+	}
+
+
+
+	PhysicsSystem::CookedCollisionMesh PhysicsSystem::LoadOrCookTriangleMesh(uint64_t mesh_uuid, std::vector<float> positions, std::vector<unsigned> indices) {
+		ORNG_TRACY_PROFILE;
+		TimeStep timer{ TimeStep::TimeUnits::MICROSECONDS };
+		CookedCollisionMesh output;
+
+		PxTolerancesScale scale(1.f);
 		PxCookingParams params(scale);
 		//params.buildGPUData = true;
 		// disable mesh cleaning - perform mesh validation on development configurations
@@ -594,14 +930,29 @@ namespace ORNG {
 
 		desc.subgridSize = 4;
 		desc.spacing = 5;
+
+		uint64_t vertex_hash = HashBytes(positions.data(), positions.size() * sizeof(float));
+		vertex_hash = HashBytes(indices.data(), indices.size() * sizeof(unsigned), vertex_hash);
+
+		std::string settings = std::format("uuid={};sdf={},{};preprocess={};hint={};physx={}", mesh_uuid, desc.subgridSize, desc.spacing,
+			static_cast<uint32_t>(params.meshPreprocessParams), static_cast<uint32_t>(params.meshCookingHint), PX_PHYSICS_VERSION);
+
+		uint64_t key = DerivedDataCache::MakeKey(vertex_hash, settings, TRIANGLE_MESH_CACHE_VERSION);
+
+		if (DerivedDataCache::Load(key, output.data)) {
+			output.loaded_from_cache = true;
+			output.time_ms = timer.GetTimeInterval() / 1000.f;
+			return output;
+		}
+
 		PxTriangleMeshDesc meshDesc;
-		meshDesc.points.count = vao.vertex_data.positions.size() / 3;
+		meshDesc.points.count = positions.size() / 3;
 		meshDesc.points.stride = sizeof(float) * 3;
-		meshDesc.points.data = (void*)&vao.vertex_data.positions[0];
+		meshDesc.points.data = positions.data();
 
-		meshDesc.triangles.count = vao.vertex_data.indices.size() / 3;
+		meshDesc.triangles.count = indices.size() / 3;
 		meshDesc.triangles.stride = 3 * sizeof(unsigned int);
-		meshDesc.triangles.data = (void*)&vao.vertex_data.indices[0];
+		meshDesc.triangles.data = indices.data();
 		meshDesc.sdfDesc = &desc;
 #ifdef _DEBUG
 		// mesh should be validated before cooked without the mesh cleaning
@@ -609,27 +960,186 @@ namespace ORNG {
 		PX_ASSERT(res);
 #endif
 
-		PxTriangleMesh* aTriangleMesh = PxCreateTriangleMesh(params, meshDesc, Physics::GetPhysics()->getPhysicsInsertionCallback());
-		m_triangle_meshes[p_mesh_asset] = aTriangleMesh;
-		return aTriangleMesh;
+		PxDefaultMemoryOutputStream stream;
+		if (!PxCookTriangleMesh(params, meshDesc, stream)) {
+			ORNG_CORE_ERROR("Failed cooking triangle mesh for mesh asset '{0}'", mesh_uuid);
+			return output;
+		}
+
+		output.data.resize(stream.getSize());
+		std::memcpy(output.data.data(), stream.getData(), stream.getSize());
+		output.time_ms = timer.GetTimeInterval() / 1000.f;
+
+		DerivedDataCache::Store(key, output.data);
+		return output;
+	}
+
+
+
+	void PhysicsSystem::ProcessCollisionMeshJobs(bool wait_for_triangle_meshes, bool wait_for_convex_meshes) {
+		if (m_triangle_mesh_jobs.empty() && m_convex_mesh_jobs.empty())
+			return;
+
+		ORNG_TRACY_PROFILE;
+		bool any_finished = false;
+
+		// Same for both mesh types, "create" turns the cooked stream into the PhysX mesh
+		auto process_jobs = [&](auto& jobs, auto& meshes, bool wait, auto create) {
+			for (auto it = jobs.begin(); it != jobs.end();) {
+				if (!wait && it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+					++it;
+					continue;
+				}
+
+				CookedCollisionMesh cooked = it->second.get();
+				TimeStep timer{ TimeStep::TimeUnits::MICROSECONDS };
+
+				typename std::remove_reference_t<decltype(meshes)>::mapped_type p_mesh = nullptr;
+				if (!cooked.data.empty()) {
+					PxDefaultMemoryInputData input{ reinterpret_cast<PxU8*>(cooked.data.data()), static_cast<PxU32>(cooked.data.size()) };
+					p_mesh = create(input);
+				}
+
+				float total_ms = cooked.time_ms + timer.GetTimeInterval() / 1000.f;
+				if (cooked.loaded_from_cache) {
+					m_collision_mesh_report.num_loaded++;
+					m_collision_mesh_report.total_load_ms += total_ms;
+				}
+				else {
+					m_collision_mesh_report.num_cooked++;
+					m_collision_mesh_report.total_cook_ms += total_ms;
+				}
+
+				if (!p_mesh)
+					ORNG_CORE_ERROR("Failed creating collision mesh for mesh asset '{0}', using bounding box collider", it->first->filepath);
+
+				meshes[it->first] = p_mesh;
+				it = jobs.erase(it);
+				any_finished = true;
+			}
+			};
+
+		process_jobs(m_triangle_mesh_jobs, m_triangle_meshes, wait_for_triangle_meshes, [](PxInputStream& input) { return Physics::GetPhysics()->createTriangleMesh(input); });
+		process_jobs(m_convex_mesh_jobs, m_convex_meshes, wait_for_convex_meshes, [](PxInputStream& input) { return Physics::GetPhysics()->createConvexMesh(input); });
+
+		if (!any_finished)
+			return;
+
+		auto& reg = mp_scene->GetRegistry();
+		auto awaiting = std::move(m_entities_awaiting_collision_mesh);
+		m_entities_awaiting_collision_mesh.clear();
+
+		for (auto entity : awaiting) {
+			auto* p_comp = reg.valid(entity) ? reg.try_get<PhysicsComponent>(entity) : nullptr;
+			auto* p_mesh_comp = reg.valid(entity) ? reg.try_get<MeshComponent>(entity) : nullptr;
+			if (!p_comp || !p_mesh_comp)
+				continue;
+
+			bool still_cooking;
+			if (p_comp->GetColliderGeometryType() == PhysicsComponent::TRIANGLE_MESH)
+				still_cooking = m_triangle_mesh_jobs.contains(p_mesh_comp->GetMeshData());
+			else if (p_comp->GetColliderGeometryType() == PhysicsComponent::CONVEX_MESH)
+				still_cooking = m_convex_mesh_jobs.contains(p_mesh_comp->GetMeshData());
+			else
+				continue;
+
+			if (still_cooking)
+				m_entities_awaiting_collision_mesh.push_back(entity);
+			else
+				UpdateComponentState(p_comp);
+		}
+
+		if (m_triangle_mesh_jobs.empty() && m_convex_mesh_jobs.empty()) {
+			auto& r = m_collision_mesh_report;
+			ORNG_CORE_INFO("Mesh colliders ready: {0} loaded from cache in {1}ms, {2} cooked in {3}ms",
+				r.num_loaded, r.total_load_ms, r.num_cooked, r.total_cook_ms);
+		}
+	}
+
+
+
+	bool PhysicsSystem::UpdateShapeScale(PhysicsComponent* p_comp) {
+		ORNG_TRACY_PROFILE;
+		if (!p_comp->p_shape)
+			return false;
+
+		FetchInFlightStep();
+
+		auto* p_mesh_comp = p_comp->GetEntity()->GetComponent<MeshComponent>();
+		// Mesh asset can be unset in scenes without a MeshInstancingSystem (e.g headless tools)
+		const AABB& aabb = p_mesh_comp && p_mesh_comp->GetMeshData() ? p_mesh_comp->GetMeshData()->GetAABB() : AABB(glm::vec3(0.5f));
+
+		glm::vec3 scale_factor = p_comp->GetEntity()->GetComponent<TransformComponent>()->GetAbsScale();
+		glm::vec3 scaled_extents = aabb.extents * scale_factor;
+
+		const PxGeometry& current_geom = p_comp->p_shape->getGeometry();
+
+		switch (current_geom.getType()) {
+		case PxGeometryType::eBOX:
+			// Also covers the bounding box stand-in for a triangle/convex mesh that's still cooking
+			if (p_comp->GetColliderGeometryType() == PhysicsComponent::SPHERE)
+				return false;
+
+			p_comp->p_shape->setGeometry(PxBoxGeometry(scaled_extents.x, scaled_extents.y, scaled_extents.z));
+			break;
+		case PxGeometryType::eSPHERE:
+			if (p_comp->GetColliderGeometryType() != PhysicsComponent::SPHERE)
+				return false;
+
+			p_comp->p_shape->setGeometry(PxSphereGeometry(glm::max(glm::max(scaled_extents.x, scaled_extents.y), scaled_extents.z)));
+			break;
+		case PxGeometryType::eTRIANGLEMESH: {
+			if (p_comp->GetColliderGeometryType() != PhysicsComponent::TRIANGLE_MESH)
+				return false;
+
+			PxTriangleMeshGeometry geom = static_cast<const PxTriangleMeshGeometry&>(current_geom);
+			geom.scale = PxMeshScale(PxVec3(scale_factor.x, scale_factor.y, scale_factor.z));
+			p_comp->p_shape->setGeometry(geom);
+			break;
+		}
+		case PxGeometryType::eCONVEXMESH: {
+			if (p_comp->GetColliderGeometryType() != PhysicsComponent::CONVEX_MESH)
+				return false;
+
+			PxConvexMeshGeometry geom = static_cast<const PxConvexMeshGeometry&>(current_geom);
+			geom.scale = PxMeshScale(PxVec3(scale_factor.x, scale_factor.y, scale_factor.z));
+			p_comp->p_shape->setGeometry(geom);
+			break;
+		}
+		default:
+			return false;
+		}
+
+		// Same density a rebuilt actor would get from PxCreateDynamic
+		if (p_comp->m_body_type == PhysicsComponent::DYNAMIC)
+			PxRigidBodyExt::updateMassAndInertia(*static_cast<PxRigidDynamic*>(p_comp->p_rigid_actor), 1.f);
+
+		return true;
 	}
 
 
 
 	void PhysicsSystem::UpdateComponentState(PhysicsComponent* p_comp) {
 		ORNG_TRACY_PROFILE;
+		// Shapes and actors can't be released mid-simulation
+		FetchInFlightStep();
 
 		auto* p_mesh_comp = p_comp->GetEntity()->GetComponent<MeshComponent>();
 		auto* p_transform = p_comp->GetEntity()->GetComponent<TransformComponent>();
-		const AABB& aabb = p_mesh_comp ? p_mesh_comp->GetMeshData()->GetAABB() : AABB(glm::vec3(0.5f));
+		const AABB& aabb = p_mesh_comp && p_mesh_comp->GetMeshData() ? p_mesh_comp->GetMeshData()->GetAABB() : AABB(glm::vec3(0.5f));
 
 		glm::vec3 scale_factor = p_comp->GetEntity()->GetComponent<TransformComponent>()->GetAbsScale();
 		glm::vec3 scaled_extents = aabb.extents * scale_factor;
 
 		const bool was_previously_initialized = static_cast<bool>(p_comp->p_shape);
+		// Set if the component's triangle mesh is still cooking or its mesh hasn't loaded
+		bool awaiting_triangle_mesh = false;
 		PxTransform current_transform = TransformComponentToPxTransform(*p_transform);
 
 		if (was_previously_initialized) {
+			if (IsKinematicActor(p_comp->p_rigid_actor))
+				m_num_kinematic_actors--;
+
 			p_comp->p_shape->release();
 			p_comp->p_rigid_actor->release();
 		}
@@ -639,21 +1149,45 @@ namespace ORNG {
 
 		{
 			ORNG_TRACY_PROFILEN("Physx create shape");
-			switch (p_comp->m_geometry_type) {
+			switch (p_comp->GetColliderGeometryType()) {
 			case PhysicsComponent::SPHERE:
-				p_comp->p_shape = Physics::GetPhysics()->createShape(PxSphereGeometry(glm::max(glm::max(scaled_extents.x, scaled_extents.y), scaled_extents.z)), *p_comp->p_material->p_material, p_comp->IsTrigger());
+				p_comp->p_shape = Physics::GetPhysics()->createShape(PxSphereGeometry(glm::max(glm::max(scaled_extents.x, scaled_extents.y), scaled_extents.z)), *p_comp->p_material->p_material, true);
 				break;
 			case PhysicsComponent::BOX:
-				p_comp->p_shape = Physics::GetPhysics()->createShape(PxBoxGeometry(scaled_extents.x, scaled_extents.y, scaled_extents.z), *p_comp->p_material->p_material, p_comp->IsTrigger());
+				p_comp->p_shape = Physics::GetPhysics()->createShape(PxBoxGeometry(scaled_extents.x, scaled_extents.y, scaled_extents.z), *p_comp->p_material->p_material, true);
 				break;
 			case PhysicsComponent::TRIANGLE_MESH:
-				if (!p_mesh_comp)
+				if (!p_mesh_comp || !p_mesh_comp->GetMeshData())
 					return;
 
-				PxTriangleMesh* aTriangleMesh = GetOrCreateTriangleMesh(p_mesh_comp->GetMeshData());
-				p_comp->p_shape = Physics::GetPhysics()->createShape(PxTriangleMeshGeometry(aTriangleMesh, PxMeshScale(PxVec3(scale_factor.x, scale_factor.y, scale_factor.z))), *p_comp->p_material->p_material, p_comp->IsTrigger());
+				if (PxTriangleMesh* p_triangle_mesh = GetOrCreateTriangleMesh(p_mesh_comp->GetMeshData())) {
+					p_comp->p_shape = Physics::GetPhysics()->createShape(PxTriangleMeshGeometry(p_triangle_mesh, PxMeshScale(PxVec3(scale_factor.x, scale_factor.y, scale_factor.z))), *p_comp->p_material->p_material, true);
+				}
+				else {
+					// Bounding box stands in until the cooked mesh is ready (or the mesh has loaded), it's only a proxy if cooking failed
+					if (m_triangle_mesh_jobs.contains(p_mesh_comp->GetMeshData()))
+						m_entities_awaiting_collision_mesh.push_back(p_comp->GetEntity()->GetEnttHandle());
+
+					awaiting_triangle_mesh = m_triangle_mesh_jobs.contains(p_mesh_comp->GetMeshData()) || !HasCollisionVertexData(p_mesh_comp->GetMeshData());
+					p_comp->p_shape = Physics::GetPhysics()->createShape(PxBoxGeometry(scaled_extents.x, scaled_extents.y, scaled_extents.z), *p_comp->p_material->p_material, true);
+				}
+				break;
+			case PhysicsComponent::CONVEX_MESH: {
+				PxConvexMesh* p_convex_mesh = p_mesh_comp && p_mesh_comp->GetMeshData() ? GetOrCreateConvexMesh(p_mesh_comp->GetMeshData()) : nullptr;
+
+				if (p_convex_mesh) {
+					p_comp->p_shape = Physics::GetPhysics()->createShape(PxConvexMeshGeometry(p_convex_mesh, PxMeshScale(PxVec3(scale_factor.x, scale_factor.y, scale_factor.z))), *p_comp->p_material->p_material, true);
+				}
+				else {
+					// Bounding box proxy until the hull is ready, the body keeps simulating with it in the meantime
+					if (p_mesh_comp && m_convex_mesh_jobs.contains(p_mesh_comp->GetMeshData()))
+						m_entities_awaiting_collision_mesh.push_back(p_comp->GetEntity()->GetEnttHandle());
+
+					p_comp->p_shape = Physics::GetPhysics()->createShape(PxBoxGeometry(scaled_extents.x, scaled_extents.y, scaled_extents.z), *p_comp->p_material->p_material, true);
+				}
 				break;
 			}
+			}
 		}
 
 
@@ -667,6 +1201,20 @@ namespace ORNG {
 
 		p_comp->p_shape->setFlag(PxShapeFlag::eSCENE_QUERY_SHAPE, true);
 
+		// Level geometry standing in as a box would be worse than none, nothing collides with or hits it until the real mesh replaces it
+		if (awaiting_triangle_mesh) {
+			p_comp->p_shape->setFlag(PxShapeFlag::eSIMULATION_SHAPE, false);
+			p_comp->p_shape->setFlag(PxShapeFlag::eTRIGGER_SHAPE, false);
+			p_comp->p_shape->setFlag(PxShapeFlag::eSCENE_QUERY_SHAPE, false);
+
+			const entt::entity entity = p_comp->GetEntity()->GetEnttHandle();
+			if (p_comp->m_body_type != PhysicsComponent::DYNAMIC && std::ranges::find(m_level_stand_ins, entity) == m_level_stand_ins.end())
+				m_level_stand_ins.push_back(entity);
+		}
+
+		p_comp->p_shape->setQueryFilterData(PxFilterData(1u << p_comp->m_layer, 0, 0, 0));
+		p_comp->p_shape->setSimulationFilterData(GetSimulationFilterData(*p_comp));
+
 		p_comp->p_shape->acquireReference();
 
 		{
@@ -678,6 +1226,13 @@ namespace ORNG {
 			else if (p_comp->m_body_type == PhysicsComponent::DYNAMIC) {
 				p_comp->p_rigid_actor = PxCreateDynamic(*Physics::GetPhysics(), current_transform, *p_comp->p_shape, 1.f);
 			}
+			else if (p_comp->m_body_type == PhysicsComponent::KINEMATIC) {
+				p_comp->p_rigid_actor = PxCreateKinematic(*Physics::GetPhysics(), current_transform, *p_comp->p_shape, 1.f);
+				m_num_kinematic_actors++;
+			}
+
+			// Actor starts at the current transform
+			p_comp->m_pending_pose_write = false;
 
 			p_comp->p_rigid_actor->userData = p_comp->GetEntity();
 
@@ -703,56 +1258,409 @@ namespace ORNG {
 
 
 
-	void PhysicsSystem::UpdateTransformCompFromGlobalPose(const PxTransform& pose, TransformComponent& transform, PhysicsSystem::ActorType type) {
-		PxVec3 phys_pos = pose.p;
-		PxQuatT phys_rot = pose.q;
+	void PhysicsSystem::UpdateFilterData(PhysicsComponent* p_comp) {
+		if (!p_comp->p_shape)
+			return;
+
+		p_comp->p_shape->setQueryFilterData(PxFilterData(1u << p_comp->m_layer, 0, 0, 0));
+		p_comp->p_shape->setSimulationFilterData(GetSimulationFilterData(*p_comp));
+
+		// Existing pairs keep their old filtering result until this is called
+		if (p_comp->p_rigid_actor->getScene())
+			mp_phys_scene->resetFiltering(*p_comp->p_rigid_actor);
+	}
+
 
-		glm::quat phys_quat = glm::quat(phys_rot.w, phys_rot.x, phys_rot.y, phys_rot.z);
-		glm::vec3 orientation = glm::degrees(glm::eulerAngles(phys_quat));
 
-		// Only set orientation from normal rigid bodies (character controllers causing bugs)
-		if (type == PhysicsSystem::ActorType::RIGID_BODY) [[likely]]
-			transform.m_orientation = orientation - (transform.m_abs_orientation - transform.m_orientation);
+	void PhysicsSystem::UpdateMaterial(PhysicsComponent* p_comp) {
+		if (!p_comp->p_shape)
+			return;
 
-		transform.SetAbsolutePosition(glm::vec3(phys_pos.x, phys_pos.y, phys_pos.z));
+		PxMaterial* p_px_material = p_comp->p_material->p_material;
+		p_comp->p_shape->setMaterials(&p_px_material, 1);
 	}
 
-	void PhysicsSystem::OnUpdate() {
-		ORNG_PROFILE_FUNC();
-		auto& reg = mp_scene->GetRegistry();
 
-		float ts = FrameTiming::GetTimeStep();
 
-		m_accumulator += ts;
+	void PhysicsSystem::UpdateFilterData(PxRigidStatic* p_world_actor) {
+		const uint32_t layer = WORLD_ACTOR_LAYER;
+		const PxFilterData simulation_filter_data{ 1u << layer, PhysicsLayers::GetInteractionMask(layer), 0, 0 };
+
+		std::array<PxShape*, 4> shapes;
+		PxU32 num_shapes = 0;
+		while (PxU32 num_read = p_world_actor->getShapes(shapes.data(), static_cast<PxU32>(shapes.size()), num_shapes)) {
+			for (PxU32 i = 0; i < num_read; i++) {
+				shapes[i]->setQueryFilterData(PxFilterData(1u << layer, 0, 0, 0));
+				shapes[i]->setSimulationFilterData(simulation_filter_data);
+			}
+			num_shapes += num_read;
+		}
+
+		if (p_world_actor->getScene())
+			mp_phys_scene->resetFiltering(*p_world_actor);
+	}
+
+	void PhysicsSystem::AddWorldActor(PxRigidStatic* p_actor) {
+		FetchInFlightStep();
+		p_actor->userData = nullptr;
+		UpdateFilterData(p_actor);
+		mp_phys_scene->addActor(*p_actor);
+		m_world_actors.push_back(p_actor);
+	}
+
+	void PhysicsSystem::RemoveWorldActor(PxRigidStatic* p_actor) {
+		FetchInFlightStep();
+		mp_phys_scene->removeActor(*p_actor);
+		std::erase(m_world_actors, p_actor);
+	}
+
+	void PhysicsSystem::RefreshFilterData() {
+		ORNG_TRACY_PROFILE;
+		FetchInFlightStep();
+
+		for (auto [entity, comp] : mp_scene->GetRegistry().view<PhysicsComponent>().each()) {
+			UpdateFilterData(&comp);
+		}
+
+		for (auto* p_actor : m_world_actors) {
+			UpdateFilterData(p_actor);
+		}
+
+		m_layers_version = PhysicsLayers::GetVersion();
+	}
 
-		if (m_accumulator < m_step_size * 1000.0)
-			return;
 
-		for (auto [entity, vehicle, transform] : reg.view<VehicleComponent, TransformComponent>().each()) {
-			vehicle.m_vehicle.step(m_step_size, m_vehicle_context);
-			PxShape* shape[1];
-			vehicle.m_vehicle.mPhysXState.physxActor.rigidBody->getShapes(&shape[0], 1);
 
-			mp_currently_updating_transform = &transform;
-			UpdateTransformCompFromGlobalPose(vehicle.m_vehicle.mPhysXState.physxActor.rigidBody->getGlobalPose() * shape[0]->getLocalPose(), transform, ActorType::VEHICLE);
-			mp_currently_updating_transform = nullptr;
+	void PhysicsSystem::BeginStep() {
+		ORNG_TRACY_PROFILE;
+		for (auto& pose : m_interpolated_poses) {
+			pose.previous = pose.current;
 		}
 
-		m_accumulator = 0;
+		FlushMovedActors();
+		StepVehicles();
+
 		mp_phys_scene->simulate(m_step_size);
+	}
+
+
+
+	void PhysicsSystem::StepVehicles() {
+		ORNG_TRACY_PROFILE;
+		m_vehicles_to_step.clear();
+
+		for (auto [entity, vehicle] : mp_scene->GetRegistry().view<VehicleComponent>().each()) {
+			m_vehicles_to_step.push_back(&vehicle.m_vehicle);
+		}
+
+		if (m_vehicles_to_step.empty())
+			return;
+
+		// Reads the actor state into each vehicle, PhysX writes aren't thread-safe so anything touching the actor stays on this thread
+		for (auto* p_vehicle : m_vehicles_to_step) {
+			p_vehicle->stepPhysXActorBegin(m_step_size, m_vehicle_context);
+		}
+
+		// The rest of the sequence only touches the vehicle's own state, apart from road geometry queries which are safe to run concurrently as nothing is writing to the scene
+		auto step_range = [this](unsigned begin, unsigned end) {
+			for (unsigned i = begin; i < end; i++) {
+				m_vehicles_to_step[i]->step(m_step_size, m_vehicle_context);
+			}
+			};
+
+		if (m_parallel_vehicle_stepping)
+			ParallelFor(m_vehicles_to_step.size(), step_range, MIN_VEHICLES_PER_TASK);
+		else
+			step_range(0, m_vehicles_to_step.size());
+
+		for (auto* p_vehicle : m_vehicles_to_step) {
+			p_vehicle->stepPhysXActorEnd(m_step_size, m_vehicle_context);
+		}
+	}
+
+
+
+	void PhysicsSystem::EndStep() {
+		ORNG_TRACY_PROFILE;
 		mp_phys_scene->fetchResults(true);
+
+		PxSimulationStatistics sim_stats;
+		mp_phys_scene->getSimulationStatistics(sim_stats);
+		m_contact_stats.pairs_filtered += m_pairs_filtered.exchange(0, std::memory_order_relaxed);
+		m_contact_stats.contact_pairs += sim_stats.nbDiscreteContactPairsTotal;
+		m_contact_stats.touching_pairs += sim_stats.nbDiscreteContactPairsWithContacts;
+
 		PxU32 num_active_actors;
 		PxActor** active_actors = mp_phys_scene->getActiveActors(num_active_actors);
-		ORNG_TRACY_PROFILE;
 
+		const unsigned num_dynamic_actors = mp_phys_scene->getNbActors(PxActorTypeFlag::eRIGID_DYNAMIC);
+		m_actor_stats.active = num_active_actors;
+		m_actor_stats.sleeping = num_dynamic_actors > num_active_actors ? num_dynamic_actors - num_active_actors : 0;
+		m_actor_stats.kinematic = m_num_kinematic_actors;
+		m_actor_stats.kinematic_targets_set += std::exchange(m_kinematic_targets_set, 0);
+		m_actor_stats.statics_moved += std::exchange(m_statics_moved, 0);
+
+		// Only awake actors are listed, sleeping actors cost nothing here or in WriteInterpolatedPoses
 		for (int i = 0; i < num_active_actors; i++) {
 			SceneEntity* p_ent = static_cast<SceneEntity*>(active_actors[i]->userData);
-			auto* p_transform = p_ent->GetComponent<TransformComponent>();
-			mp_currently_updating_transform = p_transform;
-			UpdateTransformCompFromGlobalPose(static_cast<PxRigidActor*>(active_actors[i])->getGlobalPose(), *p_transform, p_ent->HasComponent<CharacterControllerComponent>() ? ActorType::CHARACTER_CONTROLLER : ActorType::RIGID_BODY);
-			mp_currently_updating_transform = nullptr;
+			auto* p_actor = static_cast<PxRigidActor*>(active_actors[i]);
+
+			// Kinematic components follow their transform, writing the simulated pose back would only lag it
+			if (auto* p_phys_comp = p_ent->GetComponent<PhysicsComponent>(); p_phys_comp && p_phys_comp->p_rigid_actor == p_actor && p_phys_comp->m_body_type == PhysicsComponent::KINEMATIC)
+				continue;
+
+			auto [it, inserted] = m_interpolated_pose_indices.try_emplace(p_ent->GetEnttHandle(), static_cast<unsigned>(m_interpolated_poses.size()));
+			if (inserted) {
+				auto& pose = m_interpolated_poses.emplace_back();
+				pose.entity = p_ent->GetEnttHandle();
+				pose.previous = TransformComponentToPxTransform(*p_ent->GetComponent<TransformComponent>());
+
+				if (p_ent->HasComponent<VehicleComponent>()) {
+					p_actor->getShapes(&pose.p_vehicle_shape, 1);
+					pose.type = ActorType::VEHICLE;
+				}
+				else if (p_ent->HasComponent<CharacterControllerComponent>()) {
+					pose.type = ActorType::CHARACTER_CONTROLLER;
+				}
+			}
+
+			auto& pose = m_interpolated_poses[it->second];
+			pose.current = pose.p_vehicle_shape ? p_actor->getGlobalPose() * pose.p_vehicle_shape->getLocalPose() : p_actor->getGlobalPose();
+		}
+	}
+
+
+
+	void PhysicsSystem::RemoveInterpolatedPose(entt::entity entity) {
+		auto it = m_interpolated_pose_indices.find(entity);
+		if (it == m_interpolated_pose_indices.end())
+			return;
+
+		unsigned index = it->second;
+		m_interpolated_pose_indices.erase(it);
+
+		if (index != m_interpolated_poses.size() - 1) {
+			m_interpolated_poses[index] = m_interpolated_poses.back();
+			m_interpolated_pose_indices[m_interpolated_poses[index].entity] = index;
+		}
+
+		m_interpolated_poses.pop_back();
+	}
+
+
+
+	void PhysicsSystem::WriteInterpolatedPoses() {
+		ORNG_TRACY_PROFILE;
+		auto& reg = mp_scene->GetRegistry();
+		auto start = std::chrono::steady_clock::now();
+
+		m_moved_transforms.clear();
+		m_entities_at_rest.clear();
+
+		for (auto& pose : m_interpolated_poses) {
+			auto* p_transform = reg.valid(pose.entity) ? reg.try_get<TransformComponent>(pose.entity) : nullptr;
+			if (!p_transform) {
+				m_entities_at_rest.push_back(pose.entity);
+				continue;
+			}
+
+			PxVec3 pos = pose.previous.p + (pose.current.p - pose.previous.p) * m_interpolation_alpha;
+			glm::quat q0{ pose.previous.q.w, pose.previous.q.x, pose.previous.q.y, pose.previous.q.z };
+			glm::quat q1{ pose.current.q.w, pose.current.q.x, pose.current.q.y, pose.current.q.z };
+
+			// Only set orientation from normal rigid bodies/vehicles (character controllers causing bugs)
+			p_transform->SetPhysicsPose({ pos.x, pos.y, pos.z }, glm::slerp(q0, q1, m_interpolation_alpha), pose.type != ActorType::CHARACTER_CONTROLLER);
+			m_moved_transforms.push_back(p_transform);
+
+			// Actor didn't move in the last step so the final pose has been written, it's re-added when it becomes active again
+			if (pose.previous == pose.current)
+				m_entities_at_rest.push_back(pose.entity);
+		}
+
+		for (auto entity : m_entities_at_rest) {
+			RemoveInterpolatedPose(entity);
+		}
+
+		if (!m_moved_transforms.empty()) {
+			Events::PhysicsMovedEvent e_event;
+			e_event.scene_id = GetSceneUUID();
+			e_event.p_transforms = &m_moved_transforms;
+			Events::EventManager::DispatchEvent(e_event);
+		}
+
+		m_write_back_stats.transforms_written = static_cast<unsigned>(m_moved_transforms.size());
+		m_write_back_stats.write_back_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+
+
+	void PhysicsSystem::FetchInFlightStep() {
+		if (!m_step_in_flight)
+			return;
+
+		EndStep();
+		m_step_in_flight = false;
+		ApplyDeferredTransformChanges();
+	}
+
+
+
+	bool PhysicsSystem::PrepareLevelCollisionMeshes() {
+		if (m_level_stand_ins.empty())
+			return true;
+
+		auto& reg = mp_scene->GetRegistry();
+
+		// Stand-ins are the only shapes with queries disabled, rebuilt components that are still waiting are back in the list under the same entity
+		auto remove_resolved = [&] {
+			std::erase_if(m_level_stand_ins, [&](entt::entity entity) {
+				auto* p_comp = reg.valid(entity) ? reg.try_get<PhysicsComponent>(entity) : nullptr;
+				return !p_comp || !p_comp->p_shape || p_comp->GetColliderGeometryType() != PhysicsComponent::TRIANGLE_MESH ||
+					p_comp->m_body_type == PhysicsComponent::DYNAMIC || p_comp->p_shape->getFlags().isSet(PxShapeFlag::eSCENE_QUERY_SHAPE);
+				});
+			};
+
+		remove_resolved();
+
+		const bool any_cooking = std::ranges::any_of(m_level_stand_ins, [&](entt::entity entity) {
+			auto* p_mesh_comp = reg.try_get<MeshComponent>(entity);
+			return p_mesh_comp && m_triangle_mesh_jobs.contains(p_mesh_comp->GetMeshData());
+			});
+
+		if (any_cooking) {
+			ORNG_CORE_INFO("Waiting for level collision meshes to cook before stepping");
+			ProcessCollisionMeshJobs(true, false);
+			remove_resolved();
 		}
 
+		const bool ready = m_level_stand_ins.empty();
+		if (ready && m_holding_for_level_meshes)
+			ORNG_CORE_INFO("Level collision meshes ready, resuming physics steps");
+		else if (!ready && !m_holding_for_level_meshes)
+			ORNG_CORE_INFO("Holding physics steps until {0} level collision meshes have loaded", m_level_stand_ins.size());
+
+		m_holding_for_level_meshes = !ready;
+		return ready;
+	}
+
+
+
+	unsigned PhysicsSystem::RunSteps(float frame_time_ms, bool leave_last_in_flight) {
+		const float step_ms = m_step_size * 1000.f;
+
+		// Time isn't accumulated while held, so the scene doesn't try to catch up on the held steps once the level is in
+		if (m_accumulator + frame_time_ms >= step_ms && !PrepareLevelCollisionMeshes())
+			return 0;
+
+		m_accumulator += frame_time_ms;
+
+		unsigned num_steps = 0;
+		while (m_accumulator >= step_ms && num_steps < m_max_substeps) {
+			BeginStep();
+			m_accumulator -= step_ms;
+			num_steps++;
+
+			const bool last_step = m_accumulator < step_ms || num_steps == m_max_substeps;
+			if (leave_last_in_flight && last_step)
+				m_step_in_flight = true;
+			else
+				EndStep();
+		}
+
+		// Frame took longer than m_max_substeps steps can cover, drop the remaining time instead of trying to catch up (which would make the next frame even slower)
+		if (m_accumulator >= step_ms)
+			m_accumulator = std::fmod(m_accumulator, step_ms);
+
+		m_interpolation_alpha = m_accumulator / step_ms;
+		return num_steps;
+	}
+
+
+
+	void PhysicsSystem::StepImmediate(unsigned num_steps) {
+		ORNG_TRACY_PROFILE;
+		FetchInFlightStep();
+		ProcessCollisionMeshJobs(true, true);
+
+		if (m_layers_version != PhysicsLayers::GetVersion())
+			RefreshFilterData();
+
+		m_contact_stats = ContactStats{};
+		m_actor_stats = ActorStats{};
+
+		for (unsigned i = 0; i < num_steps; i++) {
+			BeginStep();
+			EndStep();
+		}
+
+		m_interpolation_alpha = 1.f;
+		WriteInterpolatedPoses();
+		ProcessEventQueues();
+	}
+
+
+
+	unsigned PhysicsSystem::StepFrame(float frame_time_ms) {
+		ORNG_TRACY_PROFILE;
+		ProcessCollisionMeshJobs(false, false);
+
+		if (m_layers_version != PhysicsLayers::GetVersion())
+			RefreshFilterData();
+
+		m_contact_stats = ContactStats{};
+		m_actor_stats = ActorStats{};
+
+		// Pipelined, this is the step the last call left in flight, otherwise there's only one if OnPostUpdate left it
+		FetchInFlightStep();
+
+		unsigned num_steps = m_pipelined_stepping ? 0 : RunSteps(frame_time_ms, false);
+		WriteInterpolatedPoses();
+		ProcessEventQueues();
+
+		// Left running while the caller does the rest of its frame, as OnPostUpdate leaves it running alongside rendering
+		if (m_pipelined_stepping)
+			num_steps = RunSteps(frame_time_ms, true);
+
+		return num_steps;
+	}
+
+
+
+	void PhysicsSystem::OnPostUpdate() {
+		if (m_pipelined_stepping)
+			RunSteps(FrameTiming::GetTimeStep(), true);
+	}
+
+
+
+	void PhysicsSystem::OnUpdate() {
+		ORNG_PROFILE_FUNC();
+
+		// Picks up meshes cooked since the last frame without blocking
+		ProcessCollisionMeshJobs(false, false);
+
+		if (m_layers_version != PhysicsLayers::GetVersion())
+			RefreshFilterData();
+
+		m_contact_stats = ContactStats{};
+		m_actor_stats = ActorStats{};
+
+		// In pipelined mode the steps were kicked off in OnPostUpdate last frame and have been running alongside rendering
+		if (m_pipelined_stepping)
+			FetchInFlightStep();
+		else
+			RunSteps(FrameTiming::GetTimeStep(), false);
+
+		// Transforms are written once per frame at a blend of the last two steps, rather than on every substep
+		WriteInterpolatedPoses();
+
+		ProcessEventQueues();
+	}
+
+
+
+	void PhysicsSystem::ProcessEventQueues() {
+		auto& reg = mp_scene->GetRegistry();
 
 		// Process OnCollision callbacks
 		for (auto& pair : m_entity_collision_queue) {
@@ -807,6 +1715,7 @@ namespace ORNG {
 
 
 	void PhysicsSystem::RemoveComponent(CharacterControllerComponent* p_comp) {
+		RemoveInterpolatedPose(p_comp->GetEntity()->GetEnttHandle());
 		p_comp->p_controller->release();
 	};
 
@@ -832,12 +1741,12 @@ namespace ORNG {
 		SceneEntity* p_first_ent = static_cast<SceneEntity*>(pairHeader.actors[0]->userData);
 		SceneEntity* p_second_ent = static_cast<SceneEntity*>(pairHeader.actors[1]->userData);
 
-		if (!p_first_ent || !p_second_ent) {
-			ORNG_CORE_ERROR("PhysCollisionCallback failed to find entities from collision event");
+		// World actors (see AddWorldActor) have no entity to send an event to
+		if (!p_first_ent || !p_second_ent)
 			return;
-		}
 
 		mp_system->m_entity_collision_queue.push_back(std::make_pair(p_first_ent->GetEnttHandle(), p_second_ent->GetEnttHandle()));
+		mp_system->m_contact_stats.reported_contacts += nbPairs;
 	}
 
 	void PhysicsSystem::PhysCollisionCallback::onConstraintBreak(PxConstraintInfo* constraints, PxU32 count) {
@@ -859,6 +1768,8 @@ namespace ORNG {
 			if (pairs[i].flags & (PxTriggerPairFlag::eREMOVED_SHAPE_TRIGGER | PxTriggerPairFlag::eREMOVED_SHAPE_OTHER))
 				continue;
 
+			mp_system->m_contact_stats.reported_triggers++;
+
 			auto* p_ent = static_cast<SceneEntity*>(pairs[i].otherActor->userData);
 			if (auto* p_trigger = static_cast<SceneEntity*>(pairs[i].triggerActor->userData); p_trigger && p_ent) {
 				if (auto* p_script = p_trigger->GetComponent<ScriptComponent>()) {
@@ -877,43 +1788,50 @@ namespace ORNG {
 
 
 
-	RaycastResults PhysicsSystem::Raycast(glm::vec3 origin, glm::vec3 unit_dir, float max_distance) {
-		PxRaycastBuffer ray_buffer;                 // [out] Raycast results
-		RaycastResults ret;
+	// All layers skips filtering entirely, so shapes without query filter data (character controllers, vehicles) are still hit
+	static PxQueryFilterData GetQueryFilterData(uint32_t layer_mask) {
+		if (layer_mask == ALL_PHYSICS_LAYERS)
+			return PxQueryFilterData{};
 
-		if (mp_phys_scene->raycast(ConvertVec3<PxVec3>(origin), ConvertVec3<PxVec3>(unit_dir), max_distance, ray_buffer)) {
-			PxRigidActor* p_closest_actor = ray_buffer.block.actor;
+		return PxQueryFilterData{ PxFilterData(layer_mask, 0, 0, 0), PxQueryFlag::eSTATIC | PxQueryFlag::eDYNAMIC };
+	}
 
-			ret.p_entity = static_cast<SceneEntity*>(p_closest_actor->userData);
-			if (!ret.p_entity) {
-				ORNG_CORE_ERROR("Failed to find entity from raycast results");
-				ret.p_entity = nullptr;
-				return ret;
-			}
+	// Works for both raycast and sweep hits, world actors (see PhysicsSystem::AddWorldActor) are hit without an entity
+	template<typename T>
+	static void ConvertQueryHit(const T& hit, RaycastResults& ret) {
+		ret.p_entity = static_cast<SceneEntity*>(hit.actor->userData);
+		if (ret.p_entity)
 			ret.p_phys_comp = ret.p_entity->GetComponent<PhysicsComponent>();
 
-			ret.hit = true;
-			ret.hit_pos = ConvertVec3<glm::vec3>(ray_buffer.block.position);
-			ret.hit_normal = ConvertVec3<glm::vec3>(ray_buffer.block.normal);
-			ret.hit_dist = ray_buffer.block.distance;
-		}
+		ret.hit = true;
+		ret.hit_pos = ConvertVec3<glm::vec3>(hit.position);
+		ret.hit_normal = ConvertVec3<glm::vec3>(hit.normal);
+		ret.hit_dist = hit.distance;
+	}
+
+	RaycastResults PhysicsSystem::Raycast(glm::vec3 origin, glm::vec3 unit_dir, float max_distance, uint32_t layer_mask) {
+		FlushMovedActors();
+		PxRaycastBuffer ray_buffer;                 // [out] Raycast results
+		RaycastResults ret;
+
+		if (mp_phys_scene->raycast(ConvertVec3<PxVec3>(origin), ConvertVec3<PxVec3>(unit_dir), max_distance, ray_buffer, PxHitFlag::eDEFAULT, GetQueryFilterData(layer_mask)))
+			ConvertQueryHit(ray_buffer.block, ret);
 
 		return ret;
 	};
 
-	OverlapQueryResults PhysicsSystem::OverlapQuery(PxGeometry& geom, glm::vec3 pos, unsigned max_hits) {
+	OverlapQueryResults PhysicsSystem::OverlapQuery(PxGeometry& geom, glm::vec3 pos, unsigned max_hits, uint32_t layer_mask) {
+		FlushMovedActors();
 		std::vector<PxOverlapHit> overlap_hits(max_hits);
 		PxOverlapBuffer overlap_buffer{ overlap_hits.data(), max_hits};
 		OverlapQueryResults ret;
 
-		if (mp_phys_scene->overlap(geom, PxTransform(ConvertVec3<PxVec3>(pos)), overlap_buffer)) {
+		if (mp_phys_scene->overlap(geom, PxTransform(ConvertVec3<PxVec3>(pos)), overlap_buffer, GetQueryFilterData(layer_mask))) {
 			for (int i = 0; i < overlap_buffer.getNbAnyHits(); i++) {
+				// World actors have no entity
 				auto* p_ent = static_cast<SceneEntity*>(overlap_hits[i].actor->userData);
-
-				if (!p_ent) {
-					ORNG_CORE_ERROR("Failed to find entity from overlap result");
+				if (!p_ent)
 					continue;
-				}
 
 				ret.entities.push_back(p_ent);
 
@@ -923,4 +1841,139 @@ namespace ORNG {
 		return ret;
 	}
 
+
+
+	// Owned by the thread calling ParallelFor, which can return and destroy it as soon as it sees remaining reach 0
+	// Workers only touch it while holding the mutex, so the last one is done with it by the time the caller can wake
+	struct ParallelForCompletion {
+		std::mutex mutex;
+		std::condition_variable cv;
+		unsigned remaining = 0;
+	};
+
+	// Runs one range of a ParallelFor on a PhysX dispatcher worker, the dispatcher calls release() once run() has returned
+	class ParallelForTask : public PxBaseTask {
+	public:
+		void run() override { (*p_fn)(begin, end); }
+		const char* getName() const override { return "ORNG ParallelForTask"; }
+
+		// Nothing owned by the caller, this task included, may be touched after the mutex is unlocked
+		void release() override {
+			auto* p = p_completion;
+			std::scoped_lock lock{ p->mutex };
+			if (--p->remaining == 0)
+				p->cv.notify_all();
+		}
+
+		// Tasks are owned by ParallelFor, no reference counting needed
+		void addReference() override {};
+		void removeReference() override {};
+		int32_t getReference() const override { return 1; }
+
+		const std::function<void(unsigned, unsigned)>* p_fn = nullptr;
+		ParallelForCompletion* p_completion = nullptr;
+		unsigned begin = 0;
+		unsigned end = 0;
+	};
+
+	void PhysicsSystem::ParallelFor(unsigned count, const std::function<void(unsigned begin, unsigned end)>& fn, unsigned min_per_task) {
+		auto* p_dispatcher = mp_dispatcher;
+		unsigned num_workers = p_dispatcher ? p_dispatcher->getWorkerCount() : 0;
+		unsigned num_ranges = glm::min(num_workers + 1, count / min_per_task);
+
+		if (num_ranges <= 1) {
+			fn(0, count);
+			return;
+		}
+
+		unsigned range_size = (count + num_ranges - 1) / num_ranges;
+		std::vector<ParallelForTask> tasks(num_ranges - 1);
+		ParallelForCompletion completion;
+		completion.remaining = num_ranges - 1;
+
+		// Range 0 is left for the calling thread
+		for (unsigned i = 0; i < tasks.size(); i++) {
+			auto& task = tasks[i];
+			task.p_fn = &fn;
+			task.p_completion = &completion;
+			task.begin = glm::min((i + 1) * range_size, count);
+			task.end = glm::min((i + 2) * range_size, count);
+			p_dispatcher->submitTask(task);
+		}
+
+		fn(0, glm::min(range_size, count));
+
+		std::unique_lock lock{ completion.mutex };
+		completion.cv.wait(lock, [&] { return completion.remaining == 0; });
+	}
+
+	void PhysicsSystem::RaycastBatch(std::span<const RaycastQuery> queries, std::span<RaycastResults> results) {
+		ORNG_TRACY_PROFILE;
+		ASSERT(results.size() >= queries.size());
+		FlushMovedActors();
+
+		ParallelFor(queries.size(), [&](unsigned begin, unsigned end) {
+			for (unsigned i = begin; i < end; i++) {
+				const auto& query = queries[i];
+				PxRaycastBuffer ray_buffer;
+				results[i] = RaycastResults{};
+
+				if (mp_phys_scene->raycast(ConvertVec3<PxVec3>(query.origin), ConvertVec3<PxVec3>(query.unit_dir), query.max_distance, ray_buffer, PxHitFlag::eDEFAULT, GetQueryFilterData(query.layer_mask)))
+					ConvertQueryHit(ray_buffer.block, results[i]);
+			}
+			});
+	}
+
+	void PhysicsSystem::SweepBatch(std::span<const SweepQuery> queries, std::span<RaycastResults> results) {
+		ORNG_TRACY_PROFILE;
+		ASSERT(results.size() >= queries.size());
+		FlushMovedActors();
+
+		ParallelFor(queries.size(), [&](unsigned begin, unsigned end) {
+			for (unsigned i = begin; i < end; i++) {
+				const auto& query = queries[i];
+				PxSweepBuffer sweep_buffer;
+				results[i] = RaycastResults{};
+
+				if (mp_phys_scene->sweep(PxSphereGeometry(query.radius), PxTransform(ConvertVec3<PxVec3>(query.origin)), ConvertVec3<PxVec3>(query.unit_dir), query.max_distance, sweep_buffer, PxHitFlag::eDEFAULT, GetQueryFilterData(query.layer_mask)))
+					ConvertQueryHit(sweep_buffer.block, results[i]);
+			}
+			});
+	}
+
+	void PhysicsSystem::OverlapBatch(std::span<const OverlapSphereQuery> queries, std::span<OverlapBatchResult> results, std::span<SceneEntity*> hits, unsigned max_hits_per_query) {
+		ORNG_TRACY_PROFILE;
+		ASSERT(results.size() >= queries.size() && hits.size() >= queries.size() * max_hits_per_query);
+		FlushMovedActors();
+
+		// Each query writes into its own window of "hits", windows are packed together afterwards
+		ParallelFor(queries.size(), [&](unsigned begin, unsigned end) {
+			std::vector<PxOverlapHit> overlap_hits(max_hits_per_query);
+
+			for (unsigned i = begin; i < end; i++) {
+				const auto& query = queries[i];
+				PxOverlapBuffer overlap_buffer{ overlap_hits.data(), max_hits_per_query };
+				results[i] = OverlapBatchResult{ i * max_hits_per_query, 0 };
+
+				if (!mp_phys_scene->overlap(PxSphereGeometry(query.radius), PxTransform(ConvertVec3<PxVec3>(query.pos)), overlap_buffer, GetQueryFilterData(query.layer_mask)))
+					continue;
+
+				for (unsigned j = 0; j < overlap_buffer.getNbAnyHits(); j++) {
+					if (auto* p_ent = static_cast<SceneEntity*>(overlap_hits[j].actor->userData))
+						hits[results[i].first_hit + results[i].num_hits++] = p_ent;
+				}
+			}
+			});
+
+		unsigned num_packed = 0;
+		for (unsigned i = 0; i < queries.size(); i++) {
+			auto& result = results[i];
+			if (result.first_hit != num_packed)
+				std::copy(hits.begin() + result.first_hit, hits.begin() + result.first_hit + result.num_hits, hits.begin() + num_packed);
+
+			result.first_hit = num_packed;
+			num_packed += result.num_hits;
+		}
+	}
+
 }
\ No newline at end of file
@@ -56,7 +56,7 @@ namespace ORNG {
 		GL_StateManager::InitGL();
 
 		if (!(data.disabled_modules & ApplicationModulesFlags::AUDIO))
-			AudioEngine::Init();
+			AudioEngine::Init(data.audio_no_output);
 
 		if (!(data.disabled_modules & ApplicationModulesFlags::INPUT))
 			Input::Init();
@@ -67,7 +67,7 @@ namespace ORNG {
 		Renderer::Init();
 
 		if (!(data.disabled_modules & ApplicationModulesFlags::PHYSICS))
-			Physics::Init();
+			Physics::Init(data.physics_main_threads, data.physics_background_threads);
 
 		if (!(data.disabled_modules & ApplicationModulesFlags::SCENE_RENDERER))
 			SceneRenderer::Init();
@@ -0,0 +1,83 @@
+#include "pch/pch.h"
+#include "physics/PhysicsLayers.h"
+#include "util/Log.h"
+#include "yaml-cpp/yaml.h"
+
+
+namespace ORNG {
+	void PhysicsLayers::SetLayersInteract(uint8_t a, uint8_t b, bool interact) {
+		auto& instance = Get();
+
+		if (interact) {
+			instance.m_matrix[a] |= (1u << b);
+			instance.m_matrix[b] |= (1u << a);
+		}
+		else {
+			instance.m_matrix[a] &= ~(1u << b);
+			instance.m_matrix[b] &= ~(1u << a);
+		}
+
+		instance.m_version++;
+	}
+
+	void PhysicsLayers::IReset() {
+		for (uint8_t i = 0; i < MAX_LAYERS; i++) {
+			m_matrix[i] = UINT32_MAX;
+			m_names[i] = i == 0 ? "Default" : std::format("Layer {}", i);
+		}
+
+		m_version++;
+	}
+
+	bool PhysicsLayers::Load(const std::string& filepath) {
+		Reset();
+
+		if (!std::filesystem::exists(filepath))
+			return true;
+
+		auto& instance = Get();
+
+		try {
+			YAML::Node root = YAML::LoadFile(filepath);
+
+			for (auto layer_node : root["Layers"]) {
+				auto index = layer_node["Index"].as<unsigned>();
+				if (index >= MAX_LAYERS)
+					continue;
+
+				instance.m_names[index] = layer_node["Name"].as<std::string>();
+				instance.m_matrix[index] = layer_node["Interacts"].as<uint32_t>();
+			}
+		}
+		catch (std::exception& e) {
+			ORNG_CORE_ERROR("Failed loading physics layers from '{0}': '{1}'", filepath, e.what());
+			Reset();
+			return false;
+		}
+
+		instance.m_version++;
+		return true;
+	}
+
+	void PhysicsLayers::Save(const std::string& filepath) {
+		auto& instance = Get();
+
+		YAML::Emitter out;
+		out << YAML::BeginMap;
+		out << YAML::Key << "Layers" << YAML::Value << YAML::BeginSeq;
+
+		for (uint8_t i = 0; i < MAX_LAYERS; i++) {
+			out << YAML::BeginMap;
+			out << YAML::Key << "Index" << YAML::Value << static_cast<unsigned>(i);
+			out << YAML::Key << "Name" << YAML::Value << instance.m_names[i];
+			out << YAML::Key << "Interacts" << YAML::Value << instance.m_matrix[i];
+			out << YAML::EndMap;
+		}
+
+		out << YAML::EndSeq;
+		out << YAML::EndMap;
+
+		std::ofstream fout{ filepath };
+		fout << out.c_str();
+	}
+}
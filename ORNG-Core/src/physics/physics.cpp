@@ -9,7 +9,7 @@ namespace ORNG {
 		//mp_foundation->release();
 	}
 
-	void Physics::I_Init() {
+	void Physics::I_Init(unsigned num_main_threads, unsigned num_background_threads) {
 		mp_foundation = PxCreateFoundation(PX_PHYSICS_VERSION, g_default_allocator_callback, g_default_error_callback);
 		if (!mp_foundation) {
 			ORNG_CORE_CRITICAL("PxCreateFoundation failed");
@@ -26,8 +26,13 @@ namespace ORNG {
 			BREAKPOINT;
 		}
 
-		const PxU32 num_threads = glm::max((int)std::thread::hardware_concurrency() - 2, 1);
-		mp_dispatcher = PxDefaultCpuDispatcherCreate(num_threads);
+		num_background_threads = glm::max(num_background_threads, 1u);
+		if (num_main_threads == 0)
+			num_main_threads = glm::max((int)std::thread::hardware_concurrency() - 2 - (int)num_background_threads, 1);
+
+		mp_dispatcher = PxDefaultCpuDispatcherCreate(num_main_threads);
+		mp_background_dispatcher = PxDefaultCpuDispatcherCreate(num_background_threads);
+		ORNG_CORE_INFO("PhysX dispatchers created, {0} main threads, {1} background threads", num_main_threads, num_background_threads);
 
 		if (!PxInitExtensions(*mp_physics, nullptr)) {
 			ORNG_CORE_CRITICAL("PxInitExtensions failed");
@@ -1,6 +1,8 @@
 #include "pch/pch.h"
 
 #include "rendering/MeshAsset.h"
+#include "assets/AssetManager.h"
+#include "assets/DerivedDataCache.h"
 #include "util/util.h"
 #include "util/Log.h"
 #include "util/TimeStep.h"
@@ -11,6 +13,69 @@
 namespace ORNG {
 
 
+	static constexpr unsigned MESH_IMPORT_FLAGS = aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices | aiProcess_CalcTangentSpace
+		| aiProcess_ImproveCacheLocality;
+
+	// Returns the value of the quoted string starting at or after "pos", and moves "pos" past it
+	static std::string_view ReadQuotedString(std::string_view text, size_t& pos) {
+		size_t begin = text.find('"', pos);
+		size_t end = begin == std::string_view::npos ? begin : text.find('"', begin + 1);
+		if (end == std::string_view::npos) {
+			pos = text.size();
+			return {};
+		}
+
+		pos = end + 1;
+		return text.substr(begin + 1, end - begin - 1);
+	}
+
+	// Files assimp reads besides "filepath" when importing it, an .obj's material libraries and a glTF's external buffers
+	// Found with a text scan of "source_data" so the cache can be checked without importing, textures aren't included as they're cached on their own
+	static std::vector<std::string> FindReferencedFiles(const std::string& filepath, const std::vector<std::byte>& source_data) {
+		std::vector<std::string> files;
+		std::string_view text{ reinterpret_cast<const char*>(source_data.data()), source_data.size() };
+		auto dir = std::filesystem::path(filepath).parent_path();
+
+		std::string extension = std::filesystem::path(filepath).extension().string();
+		std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+		if (extension == ".obj") {
+			for (size_t pos = text.find("mtllib"); pos != std::string_view::npos; pos = text.find("mtllib", pos)) {
+				const bool line_start = pos == 0 || text[pos - 1] == '\n';
+				pos += 6;
+				if (!line_start || pos >= text.size() || (text[pos] != ' ' && text[pos] != '\t'))
+					continue;
+
+				size_t end = text.find_first_of("\r\n", pos);
+				std::string_view name = text.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+				name.remove_prefix(glm::min(name.find_first_not_of(" \t"), name.size()));
+				name.remove_suffix(name.size() - glm::min(name.find_last_not_of(" \t") + 1, name.size()));
+				if (!name.empty())
+					files.push_back((dir / name).string());
+			}
+		}
+		else if (extension == ".gltf" || extension == ".glb") {
+			// A .glb's JSON chunk is plain text at the start of the file, its own binary chunk is part of source_data already
+			size_t pos = text.find("\"buffers\"");
+			size_t array_begin = pos == std::string_view::npos ? pos : text.find('[', pos);
+			if (array_begin == std::string_view::npos)
+				return files;
+
+			// Buffer objects only hold flat values, so the first ']' closes the array
+			size_t array_end = text.find(']', array_begin);
+			std::string_view buffers = text.substr(array_begin, array_end == std::string_view::npos ? std::string_view::npos : array_end - array_begin);
+
+			for (size_t uri_pos = buffers.find("\"uri\""); uri_pos != std::string_view::npos; uri_pos = buffers.find("\"uri\"", uri_pos)) {
+				uri_pos += 5;
+				std::string_view uri = ReadQuotedString(buffers, uri_pos);
+				if (!uri.empty() && !uri.starts_with("data:"))
+					files.push_back((dir / uri).string());
+			}
+		}
+
+		return files;
+	}
+
 	bool MeshAsset::LoadMeshData() {
 
 		if (m_is_loaded) {
@@ -19,12 +84,33 @@ namespace ORNG {
 		}
 
 		ORNG_CORE_INFO("Loading mesh: {0}", filepath);
+		TimeStep time = TimeStep(TimeStep::TimeUnits::MILLISECONDS);
+
+		// The main file and the files it references (.mtl, .bin) are hashed together, so editing any of them invalidates the cache entry
+		std::vector<std::byte> source_data;
+		uint64_t cache_key = 0;
+		if (FileExists(filepath) && ReadBinaryFile(filepath, source_data)) {
+			uint64_t source_hash = HashBytes(source_data.data(), source_data.size());
+			for (const auto& referenced_path : FindReferencedFiles(filepath, source_data)) {
+				// A missing file is hashed by name, so the entry is still invalidated once it appears
+				source_hash = HashBytes(referenced_path.data(), referenced_path.size(), source_hash);
+				if (std::vector<std::byte> referenced_data; FileExists(referenced_path) && ReadBinaryFile(referenced_path, referenced_data))
+					source_hash = HashBytes(referenced_data.data(), referenced_data.size(), source_hash);
+			}
+
+			cache_key = DerivedDataCache::MakeKey(source_hash, std::format("assimp:{}", MESH_IMPORT_FLAGS), IMPORT_CACHE_VERSION);
+			source_data.clear();
+
+			if (std::vector<std::byte> cached_data; DerivedDataCache::Load(cache_key, cached_data) && ReadImportCache(cached_data)) {
+				ORNG_CORE_INFO("Mesh loaded from derived data cache in {0}ms: {1}", time.GetTimeInterval(), filepath);
+				return true;
+			}
+		}
+
 		mp_importer = std::make_unique<Assimp::Importer>();
 
-		TimeStep time = TimeStep(TimeStep::TimeUnits::MILLISECONDS);
 		bool ret = false;
-		p_scene = mp_importer->ReadFile(filepath.c_str(), aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices | aiProcess_CalcTangentSpace
-			| aiProcess_ImproveCacheLocality);
+		p_scene = mp_importer->ReadFile(filepath.c_str(), MESH_IMPORT_FLAGS);
 
 		if (p_scene) {
 			ret = InitFromScene(p_scene);
@@ -34,11 +120,107 @@ namespace ORNG {
 			return false;
 		}
 
+		if (ret) {
+			ReadImportedMaterials(p_scene);
+
+			if (cache_key != 0) {
+				std::vector<std::byte> cache_data;
+				WriteImportCache(cache_data);
+				DerivedDataCache::Store(cache_key, cache_data);
+			}
+		}
+
 		ORNG_CORE_INFO("Mesh loaded in {0}ms: {1}", time.GetTimeInterval(), filepath);
 		return ret;
 	}
 
 
+	void MeshAsset::ReadImportedMaterials(const aiScene* p_scene) {
+		static constexpr std::array<aiTextureType, ImportedMaterial::COUNT> texture_types = {
+			aiTextureType_BASE_COLOR, aiTextureType_NORMALS, aiTextureType_DIFFUSE_ROUGHNESS, aiTextureType_METALNESS, aiTextureType_AMBIENT_OCCLUSION
+		};
+
+		m_imported_materials.resize(p_scene->mNumMaterials);
+
+		for (unsigned i = 0; i < p_scene->mNumMaterials; i++) {
+			const aiMaterial* p_material = p_scene->mMaterials[i];
+			auto& imported = m_imported_materials[i];
+
+			for (unsigned slot = 0; slot < ImportedMaterial::COUNT; slot++) {
+				aiString path;
+				if (p_material->GetTextureCount(texture_types[slot]) > 0 && p_material->GetTexture(texture_types[slot], 0, &path, NULL, NULL, NULL, NULL, NULL) == aiReturn_SUCCESS)
+					imported.texture_paths[slot] = path.data;
+			}
+
+			aiColor3D base_color(0.0f, 0.0f, 0.0f);
+			if (p_material->Get(AI_MATKEY_BASE_COLOR, base_color) == aiReturn_SUCCESS) {
+				imported.base_colour = { base_color.r, base_color.g, base_color.b };
+				imported.property_flags |= ImportedMaterial::HAS_BASE_COLOUR;
+			}
+
+			if (p_material->Get(AI_MATKEY_ROUGHNESS_FACTOR, imported.roughness) == aiReturn_SUCCESS)
+				imported.property_flags |= ImportedMaterial::HAS_ROUGHNESS;
+
+			if (p_material->Get(AI_MATKEY_METALLIC_FACTOR, imported.metallic) == aiReturn_SUCCESS)
+				imported.property_flags |= ImportedMaterial::HAS_METALLIC;
+		}
+	}
+
+
+	void MeshAsset::WriteImportCache(std::vector<std::byte>& output) {
+		BufferSerializer ser{ output };
+		ser.object(m_vao);
+		ser.object(m_aabb);
+		ser.value4b(num_indices);
+
+		ser.value4b(static_cast<uint32_t>(m_submeshes.size()));
+		for (auto& entry : m_submeshes) {
+			ser.object(entry);
+		}
+
+		ser.value4b(static_cast<uint32_t>(m_imported_materials.size()));
+		for (auto& material : m_imported_materials) {
+			ser.object(material);
+		}
+
+		ser.adapter().flush();
+		output.resize(ser.adapter().writtenBytesCount());
+	}
+
+
+	bool MeshAsset::ReadImportCache(const std::vector<std::byte>& data) {
+		BufferDeserializer des{ data.begin(), data.end() };
+		des.object(m_vao);
+		des.object(m_aabb);
+		des.value4b(num_indices);
+
+		uint32_t size;
+		des.value4b(size);
+		m_submeshes.resize(size);
+		for (auto& entry : m_submeshes) {
+			des.object(entry);
+		}
+
+		des.value4b(size);
+		m_imported_materials.resize(size);
+		for (auto& material : m_imported_materials) {
+			des.object(material);
+		}
+
+		if (des.adapter().error() != bitsery::ReaderError::NoError) {
+			ORNG_CORE_ERROR("Derived data cache entry for mesh '{0}' is corrupt, reimporting", filepath);
+			m_vao.vertex_data = {};
+			m_submeshes.clear();
+			m_imported_materials.clear();
+			m_aabb = {};
+			num_indices = 0;
+			return false;
+		}
+
+		return true;
+	}
+
+
 	bool MeshAsset::InitFromScene(const aiScene* p_scene) {
 		m_submeshes.resize(p_scene->mNumMeshes);
 
@@ -84,6 +84,11 @@ namespace ORNG {
 		};
 
 
+		std::vector<std::string> terrain_uniforms = gbuffer_uniforms;
+		for (const char* name : { "u_chunk_origin", "u_chunk_spacing", "u_chunk_steps", "u_chunk_min_height", "u_chunk_height_range", "u_chunk_skirt_depth" }) {
+			terrain_uniforms.push_back(name);
+		}
+
 		std::vector<std::string> ptcl_uniforms = gbuffer_uniforms;
 		ptcl_uniforms.push_back("u_transform_start_index");
 
@@ -100,7 +105,7 @@ namespace ORNG {
 		mp_gbuffer_shader_variants->SetPath(GL_FRAGMENT_SHADER, "res/core-res/shaders/GBufferFS.glsl");
 		{
 			using enum GBufferVariants;
-			mp_gbuffer_shader_variants->AddVariant((unsigned)TERRAIN, { "TERRAIN_MODE" }, gbuffer_uniforms);
+			mp_gbuffer_shader_variants->AddVariant((unsigned)TERRAIN, { "TERRAIN_MODE" }, terrain_uniforms);
 			mp_gbuffer_shader_variants->AddVariant((unsigned)MESH, {}, gbuffer_uniforms);
 			mp_gbuffer_shader_variants->AddVariant((unsigned)PARTICLE, { "PARTICLE" }, ptcl_uniforms);
 			mp_gbuffer_shader_variants->AddVariant((unsigned)SKYBOX, { "SKYBOX_MODE" }, {});
@@ -991,11 +996,12 @@ namespace ORNG {
 #endif	
 
 
-		/* uniforms */
-		//mp_gbuffer_shader_variants->Activate((unsigned)GBufferVariants::TERRAIN);
-		//SetGBufferMaterial(mp_gbuffer_shader_variants, mp_scene->terrain.mp_material);
-		//mp_gbuffer_shader_variants->SetUniform<unsigned int>("u_shader_id", ShaderLibrary::LIGHTING_SHADER_ID);
-		//DrawTerrain(p_cam);
+		if (mp_scene->terrain.IsActive() && mp_scene->terrain.mp_material) {
+			mp_gbuffer_shader_variants->Activate((unsigned)GBufferVariants::TERRAIN);
+			SetGBufferMaterial(mp_gbuffer_shader_variants, mp_scene->terrain.mp_material);
+			mp_gbuffer_shader_variants->SetUniform<unsigned int>("u_shader_id", ShaderLibrary::LIGHTING_SHADER_ID);
+			DrawTerrain(p_cam);
+		}
 
 		mp_gbuffer_shader_variants->Activate((unsigned)GBufferVariants::SKYBOX);
 		GL_StateManager::BindTexture(GL_TEXTURE_CUBE_MAP, mp_scene->skybox.GetSkyboxTexture().GetTextureHandle(), GL_StateManager::TextureUnits::COLOUR_CUBEMAP, false);
@@ -1210,14 +1216,20 @@ namespace ORNG {
 
 
 	void SceneRenderer::DrawTerrain(CameraComponent* p_cam) {
-		std::vector<TerrainQuadtree*> node_array;
+		for (const TerrainChunk* chunk : mp_scene->terrain.m_quadtree->GetDrawChunks()) {
+			if (!chunk->m_bounding_box.IsOnFrustum(p_cam->view_frustum))
+				continue;
 
-		mp_scene->terrain.m_quadtree->QueryChunks(node_array, p_cam->GetEntity()->GetComponent<TransformComponent>()->GetAbsPosition(), mp_scene->terrain.m_width);
-		for (auto& node : node_array) {
-			const TerrainChunk* chunk = node->GetChunk();
-			if (chunk->m_bounding_box.IsOnFrustum(p_cam->view_frustum)) {
-				Renderer::DrawVAO_Elements(GL_TRIANGLES, chunk->m_vao);
-			}
+			const auto& heightfield = chunk->m_heightfield;
+			mp_gbuffer_shader_variants->SetUniform("u_chunk_origin", chunk->m_bot_left_coord);
+			mp_gbuffer_shader_variants->SetUniform("u_chunk_spacing", static_cast<float>(chunk->m_resolution));
+			mp_gbuffer_shader_variants->SetUniform("u_chunk_steps", heightfield.side_length_steps);
+			mp_gbuffer_shader_variants->SetUniform("u_chunk_min_height", heightfield.min_height);
+			mp_gbuffer_shader_variants->SetUniform("u_chunk_height_range", heightfield.height_range);
+			mp_gbuffer_shader_variants->SetUniform("u_chunk_skirt_depth", heightfield.skirt_depth);
+			GL_StateManager::BindTexture(GL_TEXTURE_2D, chunk->mp_height_tex->GetTextureHandle(), GL_StateManager::TextureUnits::TERRAIN_HEIGHTFIELD);
+
+			Renderer::DrawVAO_Elements(GL_TRIANGLES, mp_scene->terrain.GetSharedIndices(heightfield.side_length_steps));
 		}
 	}
 
@@ -3,6 +3,8 @@
 #include "rendering/Textures.h"
 #include "util/Log.h"
 #include "core/GLStateManager.h"
+#include "assets/DerivedDataCache.h"
+#include "assets/AssetManager.h"
 
 namespace ORNG {
 
@@ -119,21 +121,58 @@ namespace ORNG {
 		return true;
 	}
 
-	bool TextureBase::LoadImageFile(const std::string& filepath, unsigned int  target, const TextureBaseSpec* base_spec, unsigned int layer) {
+	bool TextureBase::DecodeImageFile(const std::string& filepath, DecodedImage& output) {
+		std::vector<std::byte> source_data;
+		if (!FileExists(filepath) || !ReadBinaryFile(filepath, source_data))
+			return false;
+
+		uint64_t key = DerivedDataCache::MakeKey(source_data, "stbi:flip=1", DECODE_CACHE_VERSION);
+
+		// Cached layout: width, height, channels as int32, followed by the pixels
+		constexpr size_t header_size = sizeof(int32_t) * 3;
+		if (std::vector<std::byte> cached; DerivedDataCache::Load(key, cached) && cached.size() >= header_size) {
+			std::memcpy(&output.width, cached.data(), sizeof(int32_t));
+			std::memcpy(&output.height, cached.data() + sizeof(int32_t), sizeof(int32_t));
+			std::memcpy(&output.channels, cached.data() + sizeof(int32_t) * 2, sizeof(int32_t));
+
+			if (cached.size() == header_size + (size_t)output.width * output.height * output.channels) {
+				output.pixels.assign(cached.begin() + header_size, cached.end());
+				return true;
+			}
+		}
 
 		stbi_set_flip_vertically_on_load(1);
+		unsigned char* image_data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(source_data.data()), source_data.size(), &output.width, &output.height, &output.channels, 0);
 
-		int width = 0;
-		int	height = 0;
-		int	bpp = 0;
+		if (image_data == nullptr)
+			return false;
 
-		unsigned char* image_data = stbi_load(filepath.c_str(), &width, &height, &bpp, 0);
+		size_t num_bytes = (size_t)output.width * output.height * output.channels;
+		std::vector<std::byte> cache_data(header_size + num_bytes);
+		std::memcpy(cache_data.data(), &output.width, sizeof(int32_t));
+		std::memcpy(cache_data.data() + sizeof(int32_t), &output.height, sizeof(int32_t));
+		std::memcpy(cache_data.data() + sizeof(int32_t) * 2, &output.channels, sizeof(int32_t));
+		std::memcpy(cache_data.data() + header_size, image_data, num_bytes);
+		stbi_image_free(image_data);
 
-		if (image_data == nullptr) {
+		DerivedDataCache::Store(key, cache_data);
+		output.pixels.assign(cache_data.begin() + header_size, cache_data.end());
+
+		return true;
+	}
+
+	bool TextureBase::LoadImageFile(const std::string& filepath, unsigned int  target, const TextureBaseSpec* base_spec, unsigned int layer) {
+		DecodedImage image;
+
+		if (!DecodeImageFile(filepath, image)) {
 			ORNG_CORE_ERROR("Can't load texture from '{0}', - '{1}'", filepath.c_str(), stbi_failure_reason());
 			return  false;
 		}
 
+		int width = image.width;
+		int	height = image.height;
+		int	bpp = image.channels;
+
 		GLenum internal_format;
 		GLenum format;
 
@@ -164,20 +203,17 @@ namespace ORNG {
 			break;
 		default:
 			ORNG_CORE_ERROR("Failed loading texture from '{0}', unsupported number of channels", filepath);
-			stbi_image_free(image_data);
 			return false;
 		}
 
 		GL_StateManager::BindTexture(m_texture_target, m_texture_obj, GL_TEXTURE0, true);
 
-		glTexImage2D(target, 0, internal_format, width, height, 0, format, GL_UNSIGNED_BYTE, image_data);
+		glTexImage2D(target, 0, internal_format, width, height, 0, format, GL_UNSIGNED_BYTE, image.pixels.data());
 
 		if (base_spec->generate_mipmaps)
 			glGenerateMipmap(m_texture_target);
 		GL_StateManager::BindTexture(m_texture_target, 0, GL_TEXTURE0, true);
 
-		stbi_image_free(image_data);
-
 		return true;
 	}
 
@@ -391,7 +427,8 @@ namespace ORNG {
 				glGenerateMipmap(m_texture_target);
 
 			GL_StateManager::BindTexture(GL_TEXTURE_2D, 0, GL_TEXTURE0, true);
-			filepath = m_spec.filepath;
+			// Keeps AssetManager's filepath index valid if this texture is registered
+			AssetManager::SetAssetFilepath(*this, m_spec.filepath);
 			return true;
 		}
 		else {
@@ -70,6 +70,21 @@ namespace ORNG {
 				return GetSystem<PhysicsSystem>().Raycast(origin, unit_dir, max_distance);
 			};
 
+		m_si.RaycastBatch =
+			[this](std::span<const RaycastQuery> queries, std::span<RaycastResults> results) {
+				GetSystem<PhysicsSystem>().RaycastBatch(queries, results);
+			};
+
+		m_si.SweepBatch =
+			[this](std::span<const SweepQuery> queries, std::span<RaycastResults> results) {
+				GetSystem<PhysicsSystem>().SweepBatch(queries, results);
+			};
+
+		m_si.OverlapBatch =
+			[this](std::span<const OverlapSphereQuery> queries, std::span<OverlapBatchResult> results, std::span<SceneEntity*> hits, unsigned max_hits_per_query) {
+				GetSystem<PhysicsSystem>().OverlapBatch(queries, results, hits, max_hits_per_query);
+			};
+
 		m_si.GetEntityByUUID =
 			[this](uint64_t id) -> SceneEntity* {
 				return GetEntity(id);
@@ -122,8 +137,13 @@ namespace ORNG {
 		ORNG_PROFILE_FUNC();
 
 
-		//if (m_camera_system.GetActiveCamera())
-			//terrain.UpdateTerrainQuadtree(m_camera_system.GetActiveCamera()->GetEntity()->GetComponent<TransformComponent>()->GetPosition());
+		if (auto* p_cam = terrain.IsActive() ? GetActiveCamera() : nullptr) {
+			glm::vec3 cam_pos = p_cam->GetEntity()->GetComponent<TransformComponent>()->GetAbsPosition();
+			terrain.UpdateTerrainQuadtree(cam_pos);
+
+			if (HasSystem<PhysicsSystem>())
+				terrain.UpdateColliders(cam_pos, GetSystem<PhysicsSystem>());
+		}
 
 		for (auto* p_entity : m_entity_deletion_queue) {
 			DeleteEntity(p_entity);
@@ -131,6 +151,10 @@ namespace ORNG {
 
 
 		m_entity_deletion_queue.clear();
+
+		for (auto [id, p_system] : systems) {
+			p_system->OnPostUpdate();
+		}
 	}
 
 
@@ -486,6 +510,8 @@ namespace ORNG {
 		ORNG_CORE_INFO("Unloading scene...");
 		m_time_elapsed = 0.0;
 
+		terrain.ClearColliders();
+
 		for (auto [id, p_sys] : systems) {
 			p_sys->OnUnload();
 		}
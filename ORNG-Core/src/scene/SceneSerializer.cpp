@@ -302,6 +302,9 @@ namespace ORNG {
 			out << YAML::Key << "RigidBodyType" << YAML::Value << p_physics_comp->m_body_type;
 			out << YAML::Key << "GeometryType" << YAML::Value << p_physics_comp->m_geometry_type;
 			out << YAML::Key << "IsTrigger" << YAML::Value << p_physics_comp->IsTrigger();
+			out << YAML::Key << "Layer" << YAML::Value << static_cast<unsigned>(p_physics_comp->GetLayer());
+			out << YAML::Key << "CollisionMask" << YAML::Value << p_physics_comp->GetCollisionMask();
+			out << YAML::Key << "ContactReports" << YAML::Value << p_physics_comp->GetContactReportsEnabled();
 			Out(out, "MaterialUUID", p_physics_comp->p_material->uuid());
 			out << YAML::EndMap;
 		}
@@ -321,6 +324,7 @@ namespace ORNG {
 			out << YAML::Key << "AudioUUID" << YAML::Value << p_audio_comp->m_sound_asset_uuid;
 			out << YAML::Key << "MinRange" << YAML::Value << p_audio_comp->m_range.min;
 			out << YAML::Key << "MaxRange" << YAML::Value << p_audio_comp->m_range.max;
+			out << YAML::Key << "Priority" << YAML::Value << p_audio_comp->m_priority;
 			out << YAML::EndMap;
 		}
 
@@ -366,6 +370,7 @@ namespace ORNG {
 			Out(out, "Spawn delay", p_emitter->GetSpawnDelay());
 			Out(out, "Type", (unsigned)p_emitter->GetType());
 			Out(out, "Acceleration", p_emitter->GetAcceleration());
+			Out(out, "Simulation backend", (unsigned)p_emitter->GetSimulationBackend());
 
 			InterpolatorSerializer::SerializeInterpolator("Colour over time", out, p_emitter->m_life_colour_interpolator);
 			InterpolatorSerializer::SerializeInterpolator("Alpha over time", out, p_emitter->m_life_alpha_interpolator);
@@ -531,6 +536,9 @@ namespace ORNG {
 		p_audio->SetPitch(node["Pitch"].as<float>());
 		p_audio->SetSoundAssetUUID(node["AudioUUID"].as<uint64_t>());
 		p_audio->SetMinMaxRange(node["MinRange"].as<float>(), node["MaxRange"].as<float>());
+
+		if (node["Priority"])
+			p_audio->SetPriority(node["Priority"].as<float>());
 	}
 
 	void SceneSerializer::DeserializePhysicsComp(const YAML::Node& node, SceneEntity& entity) {
@@ -542,6 +550,15 @@ namespace ORNG {
 
 		auto* p_material = AssetManager::GetAsset<PhysXMaterialAsset>(node["MaterialUUID"].as<uint64_t>());
 		auto* p_physics_comp = entity.AddComponent<PhysicsComponent>(is_trigger, geometry_type, body_type, p_material);
+
+		if (node["Layer"])
+			p_physics_comp->SetLayer(static_cast<uint8_t>(node["Layer"].as<unsigned>()));
+
+		if (node["CollisionMask"])
+			p_physics_comp->SetCollisionMask(node["CollisionMask"].as<uint32_t>());
+
+		if (node["ContactReports"])
+			p_physics_comp->SetContactReportsEnabled(node["ContactReports"].as<bool>());
 	}
 
 	void SceneSerializer::DeserializeParticleEmitterComp(const YAML::Node& emitter_node, SceneEntity& entity) {
@@ -555,6 +572,9 @@ namespace ORNG {
 		p_emitter->m_type = static_cast<ParticleEmitterComponent::EmitterType>(emitter_node["Type"].as<unsigned>());
 		p_emitter->acceleration = emitter_node["Acceleration"].as<glm::vec3>();
 
+		if (emitter_node["Simulation backend"])
+			p_emitter->m_simulation_backend = static_cast<ParticleEmitterComponent::SimulationBackend>(emitter_node["Simulation backend"].as<unsigned>());
+
 		InterpolatorSerializer::DeserializeInterpolator(emitter_node["Alpha over time"], p_emitter->m_life_alpha_interpolator);
 		InterpolatorSerializer::DeserializeInterpolator(emitter_node["Colour over time"], p_emitter->m_life_colour_interpolator);
 		InterpolatorSerializer::DeserializeInterpolator(emitter_node["Scale over time"], p_emitter->m_life_scale_interpolator);
@@ -585,6 +605,7 @@ namespace ORNG {
 		auto* p_transform = entity.GetComponent<TransformComponent>();
 		p_transform->m_pos = node["Pos"].as<glm::vec3>();
 		p_transform->m_scale = node["Scale"].as<glm::vec3>();
+		p_transform->m_orientation_stale = false;
 		p_transform->m_orientation = node["Orientation"].as<glm::vec3>();
 		p_transform->m_is_absolute = node["Absolute"].as<bool>();
 		p_transform->RebuildMatrix(TransformComponent::UpdateType::ALL);
@@ -723,6 +744,11 @@ namespace ORNG {
 			std::string tag = (*it).first.as<std::string>();
 			deserializers[tag]();
 		}
+
+		// Scenes saved before contact reports were opt-in reported every contact, keep them on for bodies a script could be listening to
+		// Done once every component is loaded as the script component may come after the physics component
+		if (auto physics_node = entity_node["PhysicsComp"]; physics_node && !physics_node["ContactReports"] && entity.HasComponent<ScriptComponent>())
+			entity.GetComponent<PhysicsComponent>()->SetContactReportsEnabled(true);
 	}
 
 
@@ -247,6 +247,52 @@ namespace ORNG {
 		}
 	}
 
+	void ShaderLibrary::ReloadShadersUsingFiles(const std::vector<std::string>& filepaths) {
+		auto uses_file = [&](const Shader& shader) {
+			return std::ranges::any_of(shader.m_stages, [&](const auto& pair) {
+				auto stage_path = std::filesystem::path(pair.second.filepath).lexically_normal();
+				return std::ranges::any_of(filepaths, [&](const std::string& fp) { return std::filesystem::path(fp).lexically_normal() == stage_path; });
+				});
+			};
+
+		std::vector<Shader*> shaders_to_reload;
+		std::vector<std::string> matched_files;
+
+		auto check_shader = [&](Shader& shader) {
+			if (!uses_file(shader))
+				return;
+
+			shaders_to_reload.push_back(&shader);
+			for (auto& [type, stage] : shader.m_stages) {
+				matched_files.push_back(std::filesystem::path(stage.filepath).lexically_normal().string());
+			}
+			};
+
+		for (auto& [name, shader] : m_shaders) {
+			check_shader(shader);
+		}
+
+		for (auto& [name, sv] : m_shader_variants) {
+			for (auto& [id, shader] : sv.m_shaders) {
+				check_shader(shader);
+			}
+		}
+
+		// Include dependencies aren't tracked, so a changed file that isn't a stage of any shader means everything has to be reloaded
+		bool include_changed = std::ranges::any_of(filepaths, [&](const std::string& fp) {
+			return std::ranges::find(matched_files, std::filesystem::path(fp).lexically_normal().string()) == matched_files.end();
+			});
+
+		if (include_changed) {
+			ReloadShaders();
+			return;
+		}
+
+		for (auto* p_shader : shaders_to_reload) {
+			p_shader->Reload();
+		}
+	}
+
 	void ShaderLibrary::SetMatrixUBOs(const glm::mat4& proj, const glm::mat4& view) {
 		glm::mat4 proj_view = proj * view;
 		static std::vector<std::byte> matrices;
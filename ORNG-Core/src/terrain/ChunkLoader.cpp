@@ -1,56 +1,108 @@
 #include "pch/pch.h"
 
 #include "terrain/ChunkLoader.h"
+#include "util/util.h"
 
 namespace ORNG {
+	ChunkStreamer& ChunkLoader::GetStreamer() {
+		if (!mp_streamer) {
+			mp_streamer = std::make_unique<ChunkStreamer>();
+			m_loading_chunks.reserve(ChunkStreamer::RESERVED_REQUESTS);
+			m_awaiting_upload.reserve(ChunkStreamer::RESERVED_REQUESTS);
+		}
+
+		return *mp_streamer;
+	}
 
+	float ChunkLoader::CalculatePriority(glm::vec3 bot_left_coord, float width, float geometric_error, glm::vec3 camera_pos) {
+		// Distance to the chunk's footprint rather than its center, heights aren't known until it's generated
+		glm::vec2 min{ bot_left_coord.x, bot_left_coord.z };
+		glm::vec2 closest = glm::clamp(glm::vec2(camera_pos.x, camera_pos.z), min, min + glm::vec2(width));
+		float distance = glm::length(closest - glm::vec2(camera_pos.x, camera_pos.z));
 
-	int ChunkLoader::CreateKey() {
-		m_last_id++;
-		return m_last_id;
+		return geometric_error / glm::max(distance, 1.f);
 	}
 
-	void ChunkLoader::RequestChunkLoad(TerrainChunk& chunk) {
-		int key = CreateKey();
-		m_chunks_to_load[key] = &chunk;
-		chunk.m_chunk_key = key;
+	int ChunkLoader::FindLoadingChunk(uint64_t key) {
+		for (int i = 0; i < static_cast<int>(m_loading_chunks.size()); i++) {
+			if (m_loading_chunks[i]->m_chunk_key == key)
+				return i;
+		}
+
+		return -1;
 	}
 
-	void ChunkLoader::CancelChunkLoad(int key) {
-		m_chunks_to_load.erase(key);
-		m_futures.erase(key);
+	void ChunkLoader::RequestChunkLoad(TerrainChunk& chunk, float geometric_error) {
+		ChunkStreamer::ChunkParams params{ chunk.m_seed, static_cast<int>(chunk.m_width), chunk.m_resolution, chunk.m_height_scale, chunk.m_bot_left_coord };
+
+		// Camera position isn't known here, the priority is corrected on the next ProcessChunkLoads
+		chunk.m_chunk_key = GetStreamer().Request(params, geometric_error);
+		chunk.m_geometric_error = geometric_error;
+		m_loading_chunks.push_back(&chunk);
 	}
 
-	void ChunkLoader::LoadChunk(TerrainChunk* chunk) {
-		chunk->is_loading = true;
-		TerrainGenerator::GenNoiseChunk(chunk->m_seed, chunk->m_width, chunk->m_resolution, chunk->m_height_scale, chunk->m_bot_left_coord, chunk->m_vao.vertex_data, chunk->m_bounding_box);
-		chunk->m_data_is_loaded = true;
-		chunk->is_loading = false;
-		m_active_processes--;
+	void ChunkLoader::CancelChunkLoad(uint64_t key) {
+		int index = FindLoadingChunk(key);
+		if (index == -1)
+			return;
+
+		m_loading_chunks[index] = m_loading_chunks.back();
+		m_loading_chunks.pop_back();
+
+		GetStreamer().Cancel(key);
+		std::erase_if(m_awaiting_upload, [key](const ChunkStreamer::CompletedChunk& completed) { return completed.key == key; });
 	}
 
-	void ChunkLoader::ProcessChunkLoads() {
-		for (auto it = m_chunks_to_load.begin(); it != m_chunks_to_load.end();) {
-			TerrainChunk* chunk = it->second;
-
-			if (m_active_processes < 2 && !chunk->m_data_is_loaded && !chunk->is_loading) {
-				m_active_processes++;
-				m_futures[chunk->m_chunk_key] = (std::async(std::launch::async, [chunk] {LoadChunk(chunk); }));
-			}
-
-			if (chunk->m_data_is_loaded && !chunk->is_loading) {
-				chunk->LoadGLData();
-				m_futures.erase(chunk->m_chunk_key);
-				it = m_chunks_to_load.erase(it);
-			}
-			else {
-				it++;
-			}
+	void ChunkLoader::ProcessChunkLoads(glm::vec3 camera_pos) {
+		ORNG_TRACY_PROFILE;
+		auto& streamer = GetStreamer();
+
+		for (TerrainChunk* p_chunk : m_loading_chunks) {
+			streamer.SetPriority(p_chunk->m_chunk_key, CalculatePriority(p_chunk->m_bot_left_coord, static_cast<float>(p_chunk->m_width), p_chunk->m_geometric_error, camera_pos));
 		}
 
-	}
+		auto completed = streamer.ConsumeCompleted();
+		if (!completed.empty()) {
+			std::ranges::move(completed, std::back_inserter(m_awaiting_upload));
+		}
+
+		// Chunks generated in earlier frames may have moved closer or further away since
+		for (auto& waiting : m_awaiting_upload) {
+			const TerrainChunk* p_chunk = m_loading_chunks[FindLoadingChunk(waiting.key)];
+			waiting.priority = CalculatePriority(p_chunk->m_bot_left_coord, static_cast<float>(p_chunk->m_width), p_chunk->m_geometric_error, camera_pos);
+		}
+		std::ranges::sort(m_awaiting_upload, [](const auto& a, const auto& b) { return a.priority > b.priority; });
+
+		m_upload_stats.uploads_last_frame = 0;
+		m_upload_stats.bytes_uploaded_last_frame = 0;
 
+		size_t num_uploaded = 0;
+		for (auto& waiting : m_awaiting_upload) {
+			size_t size = waiting.GetSizeBytes();
+			if (num_uploaded > 0 && m_upload_stats.bytes_uploaded_last_frame + size > m_upload_budget_bytes)
+				break;
 
+			int index = FindLoadingChunk(waiting.key);
+			TerrainChunk* p_chunk = m_loading_chunks[index];
+			m_loading_chunks[index] = m_loading_chunks.back();
+			m_loading_chunks.pop_back();
 
+			// Swapped so the chunk's old buffer goes back to the streamer to be freed rather than reallocating one here
+			std::swap(p_chunk->m_heightfield, waiting.heightfield);
+			p_chunk->m_bounding_box = waiting.bounding_box;
+			p_chunk->m_data_is_loaded = true;
 
-}
\ No newline at end of file
+			if (m_gpu_uploads_enabled)
+				p_chunk->LoadGLData();
+			else
+				p_chunk->m_is_initialized = true;
+
+			m_upload_stats.bytes_uploaded_last_frame += size;
+			num_uploaded++;
+		}
+
+		m_awaiting_upload.erase(m_awaiting_upload.begin(), m_awaiting_upload.begin() + num_uploaded);
+		m_upload_stats.uploads_last_frame = static_cast<unsigned>(num_uploaded);
+		m_upload_stats.waiting_for_upload = static_cast<unsigned>(m_awaiting_upload.size());
+	}
+}
@@ -0,0 +1,165 @@
+#include "pch/pch.h"
+#include "terrain/ChunkStreamer.h"
+#include "util/util.h"
+
+
+namespace ORNG {
+	ChunkStreamer::ChunkStreamer(unsigned num_workers, PostProcessFn post_process) : m_post_process(std::move(post_process)) {
+		if (num_workers == 0)
+			num_workers = glm::max(std::thread::hardware_concurrency() / 4, 1u);
+
+		m_pending.reserve(RESERVED_REQUESTS);
+		m_in_flight.reserve(num_workers);
+		m_cancelled_in_flight.reserve(num_workers);
+
+		for (unsigned i = 0; i < num_workers; i++) {
+			m_workers.emplace_back([this] { WorkerLoop(); });
+		}
+	}
+
+	ChunkStreamer::~ChunkStreamer() {
+		{
+			std::scoped_lock lock{ m_mutex };
+			m_running = false;
+			m_pending.clear();
+		}
+
+		m_work_cv.notify_all();
+		for (auto& worker : m_workers) {
+			worker.join();
+		}
+	}
+
+	uint64_t ChunkStreamer::Request(const ChunkParams& params, float priority) {
+		uint64_t key;
+		{
+			std::scoped_lock lock{ m_mutex };
+			key = m_next_key++;
+			m_pending.push_back(PendingRequest{ key, priority, params, std::chrono::steady_clock::now() });
+			m_metrics.total_requested++;
+		}
+
+		m_work_cv.notify_one();
+		return key;
+	}
+
+	void ChunkStreamer::SetPriority(uint64_t key, float priority) {
+		std::scoped_lock lock{ m_mutex };
+		auto it = std::ranges::find_if(m_pending, [key](const PendingRequest& request) { return request.key == key; });
+		if (it != m_pending.end())
+			it->priority = priority;
+	}
+
+	void ChunkStreamer::Cancel(uint64_t key) {
+		std::scoped_lock lock{ m_mutex };
+
+		if (auto it = std::ranges::find_if(m_pending, [key](const PendingRequest& request) { return request.key == key; }); it != m_pending.end()) {
+			*it = m_pending.back();
+			m_pending.pop_back();
+			m_metrics.total_cancelled++;
+			m_idle_cv.notify_all();
+			return;
+		}
+
+		if (std::ranges::find(m_in_flight, key) != m_in_flight.end()) {
+			m_cancelled_in_flight.push_back(key);
+			return;
+		}
+
+		if (auto it = std::ranges::find_if(m_completed, [key](const CompletedChunk& chunk) { return chunk.key == key; }); it != m_completed.end()) {
+			m_completed.erase(it);
+			m_metrics.total_cancelled++;
+		}
+	}
+
+	std::vector<ChunkStreamer::CompletedChunk> ChunkStreamer::ConsumeCompleted() {
+		std::vector<CompletedChunk> completed;
+		{
+			std::scoped_lock lock{ m_mutex };
+			completed = std::move(m_completed);
+			m_completed.clear();
+		}
+
+		std::ranges::sort(completed, [](const CompletedChunk& a, const CompletedChunk& b) { return a.priority > b.priority; });
+		return completed;
+	}
+
+	void ChunkStreamer::WaitForIdle() {
+		std::unique_lock lock{ m_mutex };
+		m_idle_cv.wait(lock, [this] { return m_pending.empty() && m_in_flight.empty(); });
+	}
+
+	ChunkStreamer::Metrics ChunkStreamer::GetMetrics() {
+		std::scoped_lock lock{ m_mutex };
+		Metrics metrics = m_metrics;
+		metrics.queue_depth = static_cast<unsigned>(m_pending.size());
+		metrics.in_flight = static_cast<unsigned>(m_in_flight.size());
+		metrics.completed_waiting = static_cast<unsigned>(m_completed.size());
+
+		if (m_metrics.total_completed > 0) {
+			metrics.mean_queue_latency_ms = static_cast<float>(m_total_queue_latency_ms / m_metrics.total_completed);
+			metrics.mean_generation_ms = static_cast<float>(m_total_generation_ms / m_metrics.total_completed);
+			metrics.mean_total_latency_ms = static_cast<float>(m_total_latency_ms / m_metrics.total_completed);
+		}
+
+		return metrics;
+	}
+
+	void ChunkStreamer::WorkerLoop() {
+		while (true) {
+			PendingRequest request;
+			std::chrono::steady_clock::time_point start_time;
+			{
+				std::unique_lock lock{ m_mutex };
+				m_work_cv.wait(lock, [this] { return !m_running || !m_pending.empty(); });
+				if (!m_running)
+					return;
+
+				auto it = std::ranges::max_element(m_pending, {}, &PendingRequest::priority);
+				request = *it;
+				*it = m_pending.back();
+				m_pending.pop_back();
+				m_in_flight.push_back(request.key);
+				start_time = std::chrono::steady_clock::now();
+			}
+
+			CompletedChunk chunk;
+			chunk.key = request.key;
+			chunk.priority = request.priority;
+			chunk.request_time = request.request_time;
+			{
+				ORNG_TRACY_PROFILEN("Stream terrain chunk");
+				const auto& p = request.params;
+				TerrainGenerator::GenHeightfieldChunk(p.seed, p.width, p.resolution, p.height_scale, p.bot_left_coord, chunk.heightfield, chunk.bounding_box);
+
+				if (m_post_process)
+					m_post_process(chunk);
+			}
+
+			auto end_time = std::chrono::steady_clock::now();
+
+			std::scoped_lock lock{ m_mutex };
+			std::erase(m_in_flight, request.key);
+
+			if (std::erase(m_cancelled_in_flight, request.key)) {
+				m_metrics.total_cancelled++;
+			}
+			else {
+				const float queue_latency_ms = std::chrono::duration<float, std::milli>(start_time - request.request_time).count();
+				const float total_latency_ms = std::chrono::duration<float, std::milli>(end_time - request.request_time).count();
+
+				m_total_queue_latency_ms += queue_latency_ms;
+				m_total_generation_ms += std::chrono::duration<float, std::milli>(end_time - start_time).count();
+				m_total_latency_ms += total_latency_ms;
+				m_metrics.max_queue_latency_ms = glm::max(m_metrics.max_queue_latency_ms, queue_latency_ms);
+				m_metrics.max_total_latency_ms = glm::max(m_metrics.max_total_latency_ms, total_latency_ms);
+				m_metrics.total_completed++;
+
+				m_completed.push_back(std::move(chunk));
+			}
+
+			if (m_pending.empty() && m_in_flight.empty())
+				m_idle_cv.notify_all();
+		}
+	}
+}
@@ -8,17 +8,61 @@
 namespace ORNG {
 
 	void Terrain::UpdateTerrainQuadtree(glm::vec3 player_pos) {
+		if (!m_quadtree)
+			return;
+
 		m_quadtree->Update(player_pos);
-		ChunkLoader::ProcessChunkLoads();
+		ChunkLoader::ProcessChunkLoads(player_pos);
 	}
 
 	void Terrain::ResetTerrainQuadtree() {
-		m_quadtree = std::make_unique<TerrainQuadtree>(m_width, m_height_scale, m_seed, m_center_pos, m_resolution);
+		// Old chunks cancel their loads before the new tree requests any
+		m_quadtree = nullptr;
+		mp_colliders = nullptr;
+		if (m_width > 0) {
+			m_quadtree = std::make_unique<TerrainQuadtree>(m_width, m_height_scale, m_seed, m_center_pos);
+			mp_colliders = std::make_unique<TerrainColliders>(m_seed, m_height_scale, m_collider_settings);
+		}
+	}
+
+
+	void Terrain::UpdateColliders(glm::vec3 focus_pos, PhysicsSystem& physics) {
+		if (mp_colliders)
+			mp_colliders->Update(focus_pos, physics);
 	}
 
+	void Terrain::ClearColliders() {
+		if (mp_colliders)
+			mp_colliders->Clear();
+	}
+
+
+	const MeshVAO& Terrain::GetSharedIndices(unsigned side_length_steps) {
+		auto& p_vao = m_shared_indices[side_length_steps];
+		if (!p_vao) {
+			// Only the index buffer is filled, vertices are reconstructed from gl_VertexID
+			p_vao = std::make_unique<MeshVAO>();
+			TerrainGenerator::GenHeightfieldIndices(side_length_steps, true, p_vao->vertex_data.indices);
+			p_vao->FillBuffers();
+		}
+
+		return *p_vao;
+	}
+
+	Terrain::MemoryStats Terrain::GetMemoryStats() const {
+		MemoryStats stats;
+		if (m_quadtree)
+			m_quadtree->AccumulateMemoryStats(stats.num_chunks, stats.chunk_cpu_bytes, stats.chunk_gpu_bytes);
+
+		for (auto& [side_length_steps, p_vao] : m_shared_indices) {
+			stats.shared_index_bytes += p_vao->vertex_data.indices.size() * sizeof(unsigned);
+		}
+
+		return stats;
+	}
 
 	void Terrain::Init(Material* p_mat) {
 		mp_material = p_mat;
-		m_quadtree = std::make_unique<TerrainQuadtree>(m_width, m_height_scale, m_seed, m_center_pos, m_resolution);
+		ResetTerrainQuadtree();
 	}
 }
\ No newline at end of file
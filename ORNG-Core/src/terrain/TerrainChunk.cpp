@@ -5,7 +5,37 @@
 namespace ORNG {
 
 	void TerrainChunk::LoadGLData() {
-		m_vao.FillBuffers();
+		const unsigned grid_size = m_heightfield.GetGridSize();
+
+		Texture2DSpec spec;
+		spec.width = grid_size;
+		spec.height = grid_size;
+		spec.internal_format = GL_R16;
+		spec.format = GL_RED;
+		spec.storage_type = GL_UNSIGNED_SHORT;
+		spec.min_filter = GL_NEAREST;
+		spec.mag_filter = GL_NEAREST;
+		spec.wrap_params = GL_CLAMP_TO_EDGE;
+
+		if (!mp_height_tex || mp_height_tex->GetSpec().width != grid_size) {
+			mp_height_tex = std::make_unique<Texture2D>("Terrain chunk heights");
+			mp_height_tex->SetSpec(spec);
+		}
+
+		// Rows are 2 * grid_size bytes, which isn't always a multiple of the default alignment of 4
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+		glTextureSubImage2D(mp_height_tex->GetTextureHandle(), 0, 0, 0, grid_size, grid_size, GL_RED, GL_UNSIGNED_SHORT, m_heightfield.samples.data());
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
 		m_is_initialized = true;
 	}
-}
\ No newline at end of file
+
+	void TerrainChunk::Reset(glm::vec3 bot_left_coord, unsigned int resolution, unsigned int width) {
+		m_bot_left_coord = bot_left_coord;
+		m_resolution = resolution;
+		m_width = width;
+		m_chunk_key = 0;
+		m_is_initialized = false;
+		m_data_is_loaded = false;
+	}
+}
@@ -0,0 +1,196 @@
+#include "pch/pch.h"
+
+#include "terrain/TerrainColliders.h"
+#include "components/ComponentSystems.h"
+#include "physics/Physics.h"
+#include "assets/AssetManager.h"
+#include "assets/PhysXMaterialAsset.h"
+#include "util/util.h"
+
+namespace ORNG {
+	using namespace physx;
+
+	// Heightfield samples are unsigned, PxHeightField heights are signed
+	static constexpr int SAMPLE_OFFSET = 32768;
+
+	TerrainColliders::TerrainColliders(unsigned seed, float height_scale, const Settings& settings) :
+		m_settings(settings), m_seed(seed), m_height_scale(height_scale), m_streamer(settings.num_workers, &TerrainColliders::CookHeightField)
+	{
+		ASSERT(m_settings.tile_width % m_settings.sample_spacing == 0);
+	}
+
+	TerrainColliders::~TerrainColliders() {
+		Clear();
+	}
+
+	void TerrainColliders::CookHeightField(ChunkStreamer::CompletedChunk& chunk) {
+		ORNG_TRACY_PROFILE;
+		auto& heightfield = chunk.heightfield;
+		const unsigned steps = heightfield.side_length_steps;
+		const unsigned grid_size = heightfield.GetGridSize();
+
+		// Rows run along x and columns along z, the same as the heightfield's x-major layout without its border
+		std::vector<PxHeightFieldSample> samples(steps * steps);
+		for (unsigned lx = 0; lx < steps; lx++) {
+			for (unsigned lz = 0; lz < steps; lz++) {
+				auto& sample = samples[lx * steps + lz];
+				sample.height = static_cast<PxI16>(static_cast<int>(heightfield.samples[(lx + 1) * grid_size + lz + 1]) - SAMPLE_OFFSET);
+				sample.materialIndex0 = 0;
+				sample.materialIndex1 = 0;
+			}
+		}
+
+		PxHeightFieldDesc desc;
+		desc.format = PxHeightFieldFormat::eS16_TM;
+		desc.nbRows = steps;
+		desc.nbColumns = steps;
+		desc.samples.data = samples.data();
+		desc.samples.stride = sizeof(PxHeightFieldSample);
+
+		PxDefaultMemoryOutputStream stream;
+		if (PxCookHeightField(desc, stream)) {
+			chunk.payload.resize(stream.getSize());
+			std::memcpy(chunk.payload.data(), stream.getData(), stream.getSize());
+		}
+		else {
+			ORNG_CORE_ERROR("Failed cooking terrain heightfield collider at ({0}, {1})", chunk.bounding_box.center.x, chunk.bounding_box.center.z);
+		}
+
+		// Only the height range is needed to place the collider
+		heightfield.samples = {};
+	}
+
+	float TerrainColliders::FootprintDistance(int x, int z, glm::vec2 pos) const {
+		glm::vec3 bot_left = GetTileBotLeft(x, z);
+		glm::vec2 min{ bot_left.x, bot_left.z };
+		glm::vec2 closest = glm::clamp(pos, min, min + glm::vec2(static_cast<float>(m_settings.tile_width)));
+		return glm::length(closest - pos);
+	}
+
+	void TerrainColliders::Update(glm::vec3 focus_pos, PhysicsSystem& physics) {
+		ORNG_TRACY_PROFILE;
+		ASSERT(!mp_physics || mp_physics == &physics);
+		mp_physics = &physics;
+
+		const glm::vec2 focus{ focus_pos.x, focus_pos.z };
+		const float unload_radius = m_settings.load_radius + m_settings.tile_width * 0.5f;
+
+		for (size_t i = 0; i < m_tiles.size();) {
+			if (FootprintDistance(m_tiles[i].x, m_tiles[i].z, focus) > unload_radius) {
+				ReleaseTile(m_tiles[i]);
+				m_tiles[i] = m_tiles.back();
+				m_tiles.pop_back();
+			}
+			else {
+				i++;
+			}
+		}
+
+		const float tile_width = static_cast<float>(m_settings.tile_width);
+		const int min_x = static_cast<int>(glm::floor((focus.x - m_settings.load_radius) / tile_width));
+		const int max_x = static_cast<int>(glm::floor((focus.x + m_settings.load_radius) / tile_width));
+		const int min_z = static_cast<int>(glm::floor((focus.y - m_settings.load_radius) / tile_width));
+		const int max_z = static_cast<int>(glm::floor((focus.y + m_settings.load_radius) / tile_width));
+
+		for (int x = min_x; x <= max_x; x++) {
+			for (int z = min_z; z <= max_z; z++) {
+				const float distance = FootprintDistance(x, z, focus);
+				if (distance > m_settings.load_radius)
+					continue;
+
+				auto it = std::ranges::find_if(m_tiles, [x, z](const Tile& tile) { return tile.x == x && tile.z == z; });
+				if (it != m_tiles.end()) {
+					if (!it->p_actor)
+						m_streamer.SetPriority(it->key, -distance);
+
+					continue;
+				}
+
+				// One extra sample so the tile reaches its neighbours' edges
+				ChunkStreamer::ChunkParams params{ m_seed, static_cast<int>(m_settings.tile_width + m_settings.sample_spacing), m_settings.sample_spacing, m_height_scale, GetTileBotLeft(x, z) };
+				m_tiles.push_back(Tile{ x, z, m_streamer.Request(params, -distance) });
+			}
+		}
+
+		ProcessCompleted(physics);
+	}
+
+	void TerrainColliders::WaitForTiles(PhysicsSystem& physics) {
+		m_streamer.WaitForIdle();
+		ProcessCompleted(physics);
+	}
+
+	void TerrainColliders::ProcessCompleted(PhysicsSystem& physics) {
+		for (auto& chunk : m_streamer.ConsumeCompleted()) {
+			// Tiles that went out of range while cooking have already been removed
+			auto it = std::ranges::find_if(m_tiles, [&chunk](const Tile& tile) { return tile.key == chunk.key; });
+			if (it != m_tiles.end())
+				CreateActor(*it, chunk, physics);
+		}
+	}
+
+	void TerrainColliders::CreateActor(Tile& tile, ChunkStreamer::CompletedChunk& chunk, PhysicsSystem& physics) {
+		ORNG_TRACY_PROFILE;
+		if (chunk.payload.empty())
+			return;
+
+		PxDefaultMemoryInputData input{ reinterpret_cast<PxU8*>(chunk.payload.data()), static_cast<PxU32>(chunk.payload.size()) };
+		PxHeightField* p_height_field = Physics::GetPhysics()->createHeightField(input);
+		if (!p_height_field) {
+			ORNG_CORE_ERROR("Failed creating terrain heightfield collider for tile ({0}, {1})", tile.x, tile.z);
+			return;
+		}
+
+		// Samples are normalized over the tile's height range, PhysX can't take a zero height scale for a flat tile
+		const auto& heightfield = chunk.heightfield;
+		const float height_scale = glm::max(heightfield.height_range / std::numeric_limits<uint16_t>::max(), PX_MIN_HEIGHTFIELD_Y_SCALE);
+		const float spacing = static_cast<float>(m_settings.sample_spacing);
+		PxHeightFieldGeometry geometry{ p_height_field, PxMeshGeometryFlags(), height_scale, spacing, spacing };
+
+		const glm::vec3 bot_left = GetTileBotLeft(tile.x, tile.z);
+		PxTransform pose{ PxVec3(bot_left.x, heightfield.min_height + SAMPLE_OFFSET * height_scale, bot_left.z) };
+
+		auto* p_material = AssetManager::GetAsset<PhysXMaterialAsset>(ORNG_BASE_PHYSX_MATERIAL_ID)->p_material;
+		tile.p_actor = PxCreateStatic(*Physics::GetPhysics(), pose, geometry, *p_material);
+		// The shape holds its own reference
+		p_height_field->release();
+
+		tile.cooked_bytes = chunk.payload.size();
+		physics.AddWorldActor(tile.p_actor);
+	}
+
+	void TerrainColliders::ReleaseTile(Tile& tile) {
+		if (!tile.p_actor) {
+			m_streamer.Cancel(tile.key);
+			return;
+		}
+
+		mp_physics->RemoveWorldActor(tile.p_actor);
+		PX_RELEASE(tile.p_actor);
+	}
+
+	void TerrainColliders::Clear() {
+		for (auto& tile : m_tiles) {
+			ReleaseTile(tile);
+		}
+
+		m_tiles.clear();
+		mp_physics = nullptr;
+	}
+
+	TerrainColliders::Stats TerrainColliders::GetStats() {
+		Stats stats;
+		for (const auto& tile : m_tiles) {
+			if (tile.p_actor) {
+				stats.loaded_tiles++;
+				stats.cooked_bytes += tile.cooked_bytes;
+			}
+			else {
+				stats.pending_tiles++;
+			}
+		}
+
+		stats.streaming = m_streamer.GetMetrics();
+		return stats;
+	}
+}
@@ -4,36 +4,87 @@
 #include "../extern/fastnoiselite/FastNoiseLite.h"
 
 namespace ORNG {
-	void TerrainGenerator::GenNoiseChunk(unsigned int seed, int width, unsigned int resolution,
-		float height_scale, glm::vec3 bot_left_coord, VertexData3D& output_data, AABB& bounding_box)
-	{
-		const float height_exponent = 5.f;
-		/*Rounding will cause shelves*/
-		const float height_factor = glm::pow(height_scale, height_exponent);
+	// Both generation paths sum these cellular FBm layers, the weighted sum is scaled by height_scale^HEIGHT_EXPONENT
+	struct NoiseLayer {
+		float frequency;
+		int octaves;
+		float weight;
+		FastNoiseLite::CellularReturnType return_type;
+	};
+
+	static constexpr std::array<NoiseLayer, 2> NOISE_LAYERS = { {
+		{ 0.00125f, 3, 0.15f, FastNoiseLite::CellularReturnType_Distance2Div },
+		{ 0.001f, 5, 3.5f, FastNoiseLite::CellularReturnType_Distance2 },
+	} };
+
+	/*Rounding will cause shelves*/
+	static constexpr float HEIGHT_EXPONENT = 5.f;
+
+	using NoiseLayers = std::array<FastNoiseLite, NOISE_LAYERS.size()>;
+
+	// Created per call rather than shared so chunks can be generated on several threads at once
+	static NoiseLayers CreateNoiseLayers(unsigned seed) {
+		NoiseLayers noise_layers;
+		for (int i = 0; i < NOISE_LAYERS.size(); i++) {
+			auto& noise = noise_layers[i];
+			noise.SetSeed(seed);
+			noise.SetNoiseType(FastNoiseLite::NoiseType_Cellular);
+			noise.SetCellularReturnType(NOISE_LAYERS[i].return_type);
+			noise.SetFractalType(FastNoiseLite::FractalType_FBm);
+			noise.SetFractalOctaves(NOISE_LAYERS[i].octaves);
+			noise.SetFrequency(NOISE_LAYERS[i].frequency);
+		}
 
+		return noise_layers;
+	}
+
+	// Unscaled by the height factor
+	static float SampleHeight(NoiseLayers& noise_layers, float x, float z) {
+		float height = 0.f;
+		for (int i = 0; i < NOISE_LAYERS.size(); i++) {
+			height += noise_layers[i].GetNoise(x, z) * NOISE_LAYERS[i].weight;
+		}
+
+		return height;
+	}
+
+	static void SetChunkBounds(int width, float height_factor, glm::vec3 bot_left_coord, AABB& bounding_box) {
 		bounding_box.center = bot_left_coord + glm::vec3(width * 0.5f, 0, width * 0.5f);
 		bounding_box.extents = glm::vec3(width * 0.5f, height_factor, width * 0.5f);
+	}
 
-		VertexData3D& terrain_data = output_data;
-
-		static FastNoiseLite noise;
-		static FastNoiseLite noise2;
+	// One sample border around the chunk so central differences at its edges use real neighbours and match the adjacent chunks
+	// Laid out x-major like the output vertices, scaled by "height_factor"
+	static std::vector<float> SampleHeightGrid(unsigned seed, int grid_size, unsigned resolution, float height_factor, glm::vec3 bot_left_coord) {
+		ORNG_TRACY_PROFILEN("Terrain heightfield");
+		auto noise_layers = CreateNoiseLayers(seed);
+
+		std::vector<float> heights(grid_size * grid_size);
+		for (int gx = 0; gx < grid_size; gx++) {
+			const float x = bot_left_coord.x + (gx - 1) * static_cast<float>(resolution);
+			for (int gz = 0; gz < grid_size; gz++) {
+				const float z = bot_left_coord.z + (gz - 1) * static_cast<float>(resolution);
+				heights[gx * grid_size + gz] = SampleHeight(noise_layers, x, z);
+			}
+		}
 
+		for (auto& height : heights) {
+			height *= height_factor;
+		}
 
-		noise2.SetSeed(seed);
-		noise2.SetNoiseType(FastNoiseLite::NoiseType_Cellular);
-		noise2.SetCellularReturnType(FastNoiseLite::CellularReturnType_Distance2Div);
-		noise2.SetFractalType(FastNoiseLite::FractalType_FBm);
-		noise2.SetFrequency(0.00125f);
+		return heights;
+	}
 
-		noise.SetSeed(seed);
-		noise.SetNoiseType(FastNoiseLite::NoiseType_Cellular);
-		noise.SetFrequency(0.001f);
-		noise.SetCellularReturnType(FastNoiseLite::CellularReturnType_Distance2);
-		noise.SetFractalType(FastNoiseLite::FractalType_FBm);
-		noise.SetFractalOctaves(5.0);
+	void TerrainGenerator::GenNoiseChunk(unsigned int seed, int width, unsigned int resolution,
+		float height_scale, glm::vec3 bot_left_coord, VertexData3D& output_data, AABB& bounding_box)
+	{
+		ORNG_TRACY_PROFILE;
+		const float height_factor = glm::pow(height_scale, HEIGHT_EXPONENT);
+		SetChunkBounds(width, height_factor, bot_left_coord, bounding_box);
 
+		VertexData3D& terrain_data = output_data;
 
+		auto noise_layers = CreateNoiseLayers(seed);
 
 		terrain_data.positions.reserve(terrain_data.positions.size() + ((width)) * ((width) / resolution) * 4);
 		terrain_data.normals.reserve(terrain_data.normals.size() + ((width) / resolution) * ((width) / resolution) * 4);
@@ -43,10 +94,7 @@ namespace ORNG {
 
 		for (float x = bot_left_coord.x; x < bot_left_coord.x + width; x += resolution) {
 			for (float z = bot_left_coord.z; z < bot_left_coord.z + width; z += resolution) {
-				const float noise1 = noise2.GetNoise(x, z) * 0.15f
-					+ 3.5f * noise.GetNoise(x, z);
-
-				glm::vec3 vert = { x, noise1 * height_factor, z };
+				glm::vec3 vert = { x, SampleHeight(noise_layers, x, z) * height_factor, z };
 				VEC_PUSH_VEC3(terrain_data.positions, vert);
 			}
 		}
@@ -117,6 +165,197 @@ namespace ORNG {
 	}
 
 
+
+	void TerrainGenerator::GenNoiseChunkBatched(unsigned int seed, int width, unsigned int resolution,
+		float height_scale, glm::vec3 bot_left_coord, VertexData3D& output_data, AABB& bounding_box)
+	{
+		ORNG_TRACY_PROFILE;
+		ASSERT(width % resolution == 0);
+
+		const float height_factor = glm::pow(height_scale, HEIGHT_EXPONENT);
+		SetChunkBounds(width, height_factor, bot_left_coord, bounding_box);
+
+		const int side_length_steps = width / resolution;
+		const int grid_size = side_length_steps + 2;
+		const int num_samples = grid_size * grid_size;
+
+		std::vector<float> heights = SampleHeightGrid(seed, grid_size, resolution, height_factor, bot_left_coord);
+
+		// Gradients over the whole grid in one branch-free pass over contiguous memory so it vectorizes
+		// The first/last sample of each row wraps into the neighbouring row, these are border samples which are never output
+		const float inv_double_step = 1.f / (2.f * resolution);
+		std::vector<float> gradient_x(num_samples, 0.f);
+		std::vector<float> gradient_z(num_samples, 0.f);
+
+		for (int i = grid_size; i < num_samples - grid_size; i++) {
+			gradient_x[i] = (heights[i + grid_size] - heights[i - grid_size]) * inv_double_step;
+			gradient_z[i] = (heights[i + 1] - heights[i - 1]) * inv_double_step;
+		}
+
+		VertexData3D& terrain_data = output_data;
+		const unsigned base_index = terrain_data.positions.size() / 3;
+		const unsigned num_vertices = side_length_steps * side_length_steps;
+
+		terrain_data.positions.resize(terrain_data.positions.size() + num_vertices * 3);
+		terrain_data.normals.resize(terrain_data.normals.size() + num_vertices * 3);
+		terrain_data.tangents.resize(terrain_data.tangents.size() + num_vertices * 3);
+		terrain_data.tex_coords.resize(terrain_data.tex_coords.size() + num_vertices * 2);
+
+		float* p_positions = &terrain_data.positions[base_index * 3];
+		float* p_normals = &terrain_data.normals[base_index * 3];
+		float* p_tangents = &terrain_data.tangents[base_index * 3];
+		float* p_tex_coords = &terrain_data.tex_coords[base_index * 2];
+
+		const float inv_steps = 1.f / side_length_steps;
+		for (int lx = 0; lx < side_length_steps; lx++) {
+			const int row_start = (lx + 1) * grid_size + 1;
+			const float x = bot_left_coord.x + lx * static_cast<float>(resolution);
+
+			for (int lz = 0; lz < side_length_steps; lz++) {
+				const int sample = row_start + lz;
+				const int v = lx * side_length_steps + lz;
+				const float dx = gradient_x[sample];
+				const float dz = gradient_z[sample];
+
+				p_positions[v * 3] = x;
+				p_positions[v * 3 + 1] = heights[sample];
+				p_positions[v * 3 + 2] = bot_left_coord.z + lz * static_cast<float>(resolution);
+
+				// Normal of the surface y = h(x, z) is (-dh/dx, 1, -dh/dz), the tangent follows the u (x) texture axis
+				const float inv_normal_length = 1.f / std::sqrt(dx * dx + 1.f + dz * dz);
+				p_normals[v * 3] = -dx * inv_normal_length;
+				p_normals[v * 3 + 1] = inv_normal_length;
+				p_normals[v * 3 + 2] = -dz * inv_normal_length;
+
+				const float inv_tangent_length = 1.f / std::sqrt(1.f + dx * dx);
+				p_tangents[v * 3] = inv_tangent_length;
+				p_tangents[v * 3 + 1] = dx * inv_tangent_length;
+				p_tangents[v * 3 + 2] = 0.f;
+
+				p_tex_coords[v * 2] = lx * inv_steps;
+				p_tex_coords[v * 2 + 1] = lz * inv_steps;
+			}
+		}
+
+		terrain_data.indices.reserve(terrain_data.indices.size() + (side_length_steps - 1) * (side_length_steps - 1) * 6);
+		for (int lx = 0; lx < side_length_steps - 1; lx++) {
+			for (int lz = 0; lz < side_length_steps - 1; lz++) {
+				const unsigned bl_index = base_index + lx * side_length_steps + lz;
+				// Same winding as GenNoiseChunk
+				terrain_data.indices.push_back(bl_index);
+				terrain_data.indices.push_back(bl_index + 1);
+				terrain_data.indices.push_back(bl_index + side_length_steps + 1);
+
+				terrain_data.indices.push_back(bl_index + side_length_steps);
+				terrain_data.indices.push_back(bl_index);
+				terrain_data.indices.push_back(bl_index + side_length_steps + 1);
+			}
+		}
+	}
+
+
+	float TerrainGenerator::GetHeight(unsigned int seed, float height_scale, float x, float z) {
+		auto noise_layers = CreateNoiseLayers(seed);
+		return SampleHeight(noise_layers, x, z) * glm::pow(height_scale, HEIGHT_EXPONENT);
+	}
+
+	float TerrainGenerator::Heightfield::GetHeight(unsigned lx, unsigned lz) const {
+		const unsigned grid_size = GetGridSize();
+		return min_height + samples[(lx + 1) * grid_size + lz + 1] * (height_range / std::numeric_limits<uint16_t>::max());
+	}
+
+	void TerrainGenerator::GenHeightfieldChunk(unsigned int seed, int width, unsigned int resolution,
+		float height_scale, glm::vec3 bot_left_coord, Heightfield& output, AABB& bounding_box)
+	{
+		ORNG_TRACY_PROFILE;
+		ASSERT(width % resolution == 0);
+
+		const float height_factor = glm::pow(height_scale, HEIGHT_EXPONENT);
+		SetChunkBounds(width, height_factor, bot_left_coord, bounding_box);
+
+		const int side_length_steps = width / resolution;
+		const int grid_size = side_length_steps + 2;
+
+		std::vector<float> heights = SampleHeightGrid(seed, grid_size, resolution, height_factor, bot_left_coord);
+		auto [p_min, p_max] = std::ranges::minmax_element(heights);
+
+		output.side_length_steps = side_length_steps;
+		output.min_height = *p_min;
+		output.height_range = *p_max - *p_min;
+		output.samples.resize(heights.size());
+
+		const float max_sample = std::numeric_limits<uint16_t>::max();
+		const float to_normalized = output.height_range > 0.f ? max_sample / output.height_range : 0.f;
+		for (size_t i = 0; i < heights.size(); i++) {
+			output.samples[i] = static_cast<uint16_t>((heights[i] - output.min_height) * to_normalized + 0.5f);
+		}
+
+		// A coarser neighbour interpolates linearly between every other edge vertex, so it can't deviate from this chunk's edge by more than the largest step between neighbouring edge vertices
+		const int last = grid_size - 2;
+		float max_edge_step = 0.f;
+		for (int i = 1; i < last; i++) {
+			max_edge_step = glm::max(max_edge_step, glm::abs(heights[1 * grid_size + i + 1] - heights[1 * grid_size + i]));
+			max_edge_step = glm::max(max_edge_step, glm::abs(heights[last * grid_size + i + 1] - heights[last * grid_size + i]));
+			max_edge_step = glm::max(max_edge_step, glm::abs(heights[(i + 1) * grid_size + 1] - heights[i * grid_size + 1]));
+			max_edge_step = glm::max(max_edge_step, glm::abs(heights[(i + 1) * grid_size + last] - heights[i * grid_size + last]));
+		}
+
+		output.skirt_depth = max_edge_step + static_cast<float>(resolution) * 0.5f;
+	}
+
+	void TerrainGenerator::GenHeightfieldIndices(unsigned side_length_steps, bool with_skirts, std::vector<unsigned>& output) {
+		const unsigned steps = side_length_steps;
+		output.clear();
+		output.reserve((steps - 1) * (steps - 1) * 6 + (with_skirts ? 4 * (steps - 1) * 6 : 0));
+
+		// Same winding as GenNoiseChunk
+		for (unsigned lx = 0; lx < steps - 1; lx++) {
+			for (unsigned lz = 0; lz < steps - 1; lz++) {
+				const unsigned bl_index = lx * steps + lz;
+				output.push_back(bl_index);
+				output.push_back(bl_index + 1);
+				output.push_back(bl_index + steps + 1);
+
+				output.push_back(bl_index + steps);
+				output.push_back(bl_index);
+				output.push_back(bl_index + steps + 1);
+			}
+		}
+
+		if (!with_skirts)
+			return;
+
+		// Skirt vertex ids start after the grid, one row of "steps" vertices per edge in the order -x, +x, -z, +z
+		// Every skirt quad faces outwards from the chunk
+		const unsigned last = steps - 1;
+		auto edge_vertex = [steps, last](unsigned edge, unsigned i) {
+			switch (edge) {
+			case 0: return i;
+			case 1: return last * steps + i;
+			case 2: return i * steps;
+			default: return i * steps + last;
+			}
+		};
+
+		for (unsigned edge = 0; edge < 4; edge++) {
+			const bool flip = edge == 1 || edge == 2;
+			for (unsigned i = 0; i < last; i++) {
+				const unsigned t0 = edge_vertex(edge, i);
+				const unsigned t1 = edge_vertex(edge, i + 1);
+				const unsigned s0 = steps * steps + edge * steps + i;
+				const unsigned s1 = s0 + 1;
+
+				if (flip) {
+					output.insert(output.end(), { t0, t1, s0, t1, s1, s0 });
+				}
+				else {
+					output.insert(output.end(), { t0, s0, t1, t1, s0, s1 });
+				}
+			}
+		}
+	}
+
+
 	TerrainGenerator::QuadVertices TerrainGenerator::GenQuad(float size, glm::vec3 bot_left_vert_pos) {
 		TerrainGenerator::QuadVertices verts;
 
@@ -2,164 +2,259 @@
 
 #include "terrain/TerrainQuadtree.h"
 #include "util/Log.h"
+#include "util/util.h"
 #include "terrain/TerrainChunk.h"
 #include "terrain/ChunkLoader.h"
-#include <glm/glm/gtc/round.hpp>
 
 namespace ORNG {
-	void TerrainQuadtree::Subdivide() {
-		if (m_subdivision_layer == m_max_subdivision_layer || m_is_subdivided) {
-			ORNG_CORE_ERROR("Max terrain quadtree subdivisions hit");
-			return;
+	TerrainQuadtree::TerrainQuadtree(unsigned int width, float height_scale, unsigned int seed, glm::vec3 center_pos) :
+		m_base_height(center_pos.y), m_seed(seed), m_height_scale(height_scale)
+	{
+		// Root is MIN_NODE_WIDTH * 2^max_depth so every node width, and with it every vertex spacing, is a power of two
+		unsigned root_width = MIN_NODE_WIDTH;
+		while (root_width < width) {
+			root_width *= 2;
+			m_max_depth++;
 		}
-		m_child_nodes.reserve(4);
 
-		m_child_nodes.emplace_back(glm::vec3(m_center_pos.x + m_width * 0.25f, m_center_pos.y, m_center_pos.z - m_width * 0.25f), this); //TR
-		m_child_nodes.emplace_back(glm::vec3(m_center_pos.x - m_width * 0.25f, m_center_pos.y, m_center_pos.z - m_width * 0.25f), this); //TL
-		m_child_nodes.emplace_back(glm::vec3(m_center_pos.x + m_width * 0.25f, m_center_pos.y, m_center_pos.z + m_width * 0.25f), this); //BR
-		m_child_nodes.emplace_back(glm::vec3(m_center_pos.x - m_width * 0.25f, m_center_pos.y, m_center_pos.z + m_width * 0.25f), this); //BL
+		// Covers a camera near the ground at the default LOD distances, the pools grow if more is needed
+		const size_t expected_nodes = 1 + 16 * 4 * (m_max_depth + 1);
+		m_nodes.reserve(expected_nodes);
+		m_free_child_blocks.reserve(expected_nodes / 4);
+		m_chunk_storage.reserve(expected_nodes);
+		m_free_chunks.reserve(expected_nodes);
+		m_eval_stack.reserve(expected_nodes);
+		m_draw_chunks.reserve(expected_nodes);
 
-		m_is_subdivided = true;
+		Node& root = m_nodes.emplace_back();
+		root.min = glm::vec2(center_pos.x, center_pos.z) - glm::vec2(root_width * 0.5f);
+		root.width = static_cast<float>(root_width);
+		// Nothing is drawn in place of the root chunk, so treat the error as the whole chunk
+		root.p_chunk = AcquireChunk(root, root.width);
+		m_num_active_nodes = 1;
 	}
 
 	TerrainQuadtree::~TerrainQuadtree() {
-		ChunkLoader::CancelChunkLoad(m_chunk->m_chunk_key);
-		delete m_chunk;
+		for (auto& p_chunk : m_chunk_storage) {
+			ChunkLoader::CancelChunkLoad(p_chunk->m_chunk_key);
+		}
 	}
 
+	void TerrainQuadtree::SetLODDistances(float lod_distance_factor, float merge_hysteresis) {
+		m_lod_distance_factor = lod_distance_factor;
+		m_merge_hysteresis = merge_hysteresis;
+		m_decision_slack = -1.f;
+	}
 
+	float TerrainQuadtree::FootprintDistance(const Node& node, glm::vec2 camera_pos) {
+		glm::vec2 closest = glm::clamp(camera_pos, node.min, node.min + glm::vec2(node.width));
+		return glm::length(closest - camera_pos);
+	}
 
-	TerrainQuadtree::TerrainQuadtree(unsigned int width, float height_scale, unsigned int seed, glm::vec3 center_pos, unsigned int resolution) :
-		m_center_pos(center_pos), m_width(width), m_seed(seed), m_height_scale(height_scale), m_resolution(resolution), m_master_width(width),
-		m_is_root_node(true)
-	{
-		//no. subdivisions before min grid width is hit
-		m_max_subdivision_layer = static_cast<int>(glm::log2(static_cast<float>(m_master_width) / static_cast<float>(m_min_grid_width)));
+	bool TerrainQuadtree::Update(glm::vec3 camera_pos) {
+		ORNG_TRACY_PROFILE;
+		m_last_update_stats = UpdateStats{};
+		const glm::vec2 camera_xz{ camera_pos.x, camera_pos.z };
 
-		glm::vec3 bot_left_coord = glm::vec3(center_pos.x - m_width * 0.5f, center_pos.y, center_pos.z - m_width * 0.5f);
-		m_chunk = new TerrainChunk(bot_left_coord, m_resolution, m_width, m_seed, m_height_scale);
-		ChunkLoader::RequestChunkLoad(*m_chunk);
-	};
+		// The footprint distance can't change by more than the camera has moved, so nothing can cross a split/merge threshold yet
+		if (m_decision_slack >= 0.f && glm::length(camera_xz - m_last_eval_pos) < m_decision_slack) {
+			m_last_update_stats.skipped = true;
+			return false;
+		}
 
+		float slack = std::numeric_limits<float>::max();
+		m_eval_stack.clear();
+		m_eval_stack.push_back(ROOT_NODE);
 
+		while (!m_eval_stack.empty()) {
+			const uint32_t node_index = m_eval_stack.back();
+			m_eval_stack.pop_back();
+			m_last_update_stats.nodes_evaluated++;
 
-	TerrainQuadtree::TerrainQuadtree(glm::vec3 center_pos, TerrainQuadtree* parent)
-	{
-		m_parent = parent;
-		m_subdivision_layer = parent->m_subdivision_layer + 1;
-		m_max_subdivision_layer = parent->m_max_subdivision_layer;
-		m_seed = parent->m_seed;
-		m_width = parent->m_width / 2;
-		m_min_grid_width = parent->m_min_grid_width;
+			// Copied as splitting can grow m_nodes
+			const Node node = m_nodes[node_index];
+			const float distance = FootprintDistance(node, camera_xz);
+			const float split_distance = GetSplitDistance(node);
+			const float merge_distance = split_distance * (1.f + m_merge_hysteresis);
 
-		m_height_scale = parent->m_height_scale;
+			if (node.first_child == INVALID_NODE) {
+				if (node.depth == m_max_depth)
+					continue;
 
-		m_center_pos = center_pos;
-		m_master_width = parent->m_master_width;
+				if (distance >= split_distance) {
+					slack = glm::min(slack, distance - split_distance);
+					continue;
+				}
 
-		m_resolution = pow(m_max_subdivision_layer + 1 - m_subdivision_layer, 2);
-		m_resolution = glm::roundPowerOfTwo(m_resolution);
+				Split(node_index);
+			}
+			else if (distance > merge_distance) {
+				Merge(node_index);
+				slack = glm::min(slack, distance - split_distance);
+				continue;
+			}
 
-		glm::vec3 bot_left_coord = glm::vec3(center_pos.x - m_width / 2, center_pos.y, center_pos.z - m_width / 2);
-		m_chunk = new TerrainChunk(bot_left_coord, m_resolution, m_width + m_resolution, m_seed, m_height_scale);
-		ChunkLoader::RequestChunkLoad(*m_chunk);
-	};
+			slack = glm::min(slack, merge_distance - distance);
+			const uint32_t first_child = m_nodes[node_index].first_child;
+			for (uint32_t i = 0; i < 4; i++) {
+				m_eval_stack.push_back(first_child + i);
+			}
+		}
 
+		m_last_eval_pos = camera_xz;
+		m_decision_slack = slack;
 
+		const bool changed = m_last_update_stats.splits > 0 || m_last_update_stats.merges > 0;
+		if (changed)
+			m_draw_list_dirty = true;
 
-	void TerrainQuadtree::QueryTree(std::vector<TerrainQuadtree*>& node_array, glm::vec3 t_center_pos, int t_boundary) {
-		if (glm::length(glm::vec2(m_center_pos.x, m_center_pos.z) - glm::vec2(t_center_pos.x, t_center_pos.z)) < t_boundary + glm::sqrt(2 * m_width * m_width)) {
-			if (m_is_subdivided) {
-				for (auto& node : m_child_nodes) {
-					node.QueryTree(node_array, t_center_pos, t_boundary);
-				}
-			}
-			else {
-				node_array.push_back(this);
-				return;
-			}
+		return changed;
+	}
+
+	uint32_t TerrainQuadtree::AllocateChildBlock() {
+		if (!m_free_child_blocks.empty()) {
+			uint32_t block = m_free_child_blocks.back();
+			m_free_child_blocks.pop_back();
+			return block;
 		}
-		return;
-	};
-
-	void TerrainQuadtree::QueryChunks(std::vector<TerrainQuadtree*>& node_array, glm::vec3 t_center_pos, int t_boundary) {
-		if (glm::length(glm::vec2(m_center_pos.x, m_center_pos.z) - glm::vec2(t_center_pos.x, t_center_pos.z)) < t_boundary + glm::sqrt(2 * m_width * m_width)) {
-			if (m_is_subdivided) {
-				for (auto& node : m_child_nodes) {
-					node.QueryChunks(node_array, t_center_pos, t_boundary);
-				}
-			}
-			else if (m_chunk->m_is_initialized) {
-				node_array.push_back(this);
-			}
-			else {
-				/* This prevents gaps appearing in terrain when leaf node chunks aren't ready to render yet */
-				TerrainQuadtree* found_chunk = FindParentWithChunk();
-				if (found_chunk) node_array.push_back(found_chunk);
-			}
-			return;
+
+		if (m_nodes.size() + 4 > m_nodes.capacity()) {
+			m_last_update_stats.pool_allocations++;
+			m_nodes.reserve(m_nodes.capacity() * 2);
+			m_free_child_blocks.reserve(m_nodes.capacity() / 4);
+			m_eval_stack.reserve(m_nodes.capacity());
+			m_draw_chunks.reserve(m_nodes.capacity());
 		}
-		return;
-	};
 
-	TerrainQuadtree* TerrainQuadtree::FindParentWithChunk() {
-		if (!this->m_is_root_node) {
-			if (this->GetParent().m_chunk->m_is_initialized) {
-				return &this->GetParent();
-			}
-			else {
-				return this->GetParent().FindParentWithChunk();
-			}
+		uint32_t block = static_cast<uint32_t>(m_nodes.size());
+		m_nodes.resize(m_nodes.size() + 4);
+		return block;
+	}
+
+	TerrainChunk* TerrainQuadtree::AcquireChunk(const Node& node, float geometric_error) {
+		const unsigned resolution = GetResolution(node);
+		const glm::vec3 bot_left_coord{ node.min.x, m_base_height, node.min.y };
+		// One extra vertex step so the chunk reaches its neighbours' edges
+		const unsigned chunk_width = static_cast<unsigned>(node.width) + resolution;
+
+		TerrainChunk* p_chunk = nullptr;
+		if (!m_free_chunks.empty()) {
+			p_chunk = m_free_chunks.back();
+			m_free_chunks.pop_back();
+			p_chunk->Reset(bot_left_coord, resolution, chunk_width);
 		}
 		else {
-			return nullptr;
+			m_last_update_stats.pool_allocations++;
+			p_chunk = m_chunk_storage.emplace_back(std::make_unique<TerrainChunk>(bot_left_coord, resolution, chunk_width, m_seed, m_height_scale)).get();
+			m_free_chunks.reserve(m_chunk_storage.capacity());
 		}
+
+		ChunkLoader::RequestChunkLoad(*p_chunk, geometric_error);
+		return p_chunk;
 	}
 
-	void TerrainQuadtree::Update(glm::vec3 pos) {
-		float distance = glm::max(glm::length(glm::vec2(m_center_pos.x, m_center_pos.z) - glm::vec2(pos.x, pos.z)) - glm::sqrt(2 * m_width * m_width), 0.0);
-		// Calculate number of minimum grid widths that fit inside the chunk node path, this can then be used to calculate a subdivision count
-		int num_fitting_min_grid_widths = (int)(glm::pow(2, m_max_subdivision_layer - m_subdivision_layer));
+	void TerrainQuadtree::ReleaseChunk(TerrainChunk* p_chunk) {
+		ChunkLoader::CancelChunkLoad(p_chunk->m_chunk_key);
+		m_free_chunks.push_back(p_chunk);
+	}
 
-		int subdivision_count = (int)((float)(m_max_subdivision_layer)-distance / (float)(num_fitting_min_grid_widths * m_min_grid_width));
+	void TerrainQuadtree::Split(uint32_t node_index) {
+		const uint32_t first_child = AllocateChildBlock();
+		Node& node = m_nodes[node_index];
+		const float half_width = node.width * 0.5f;
 
-		if (subdivision_count <= m_subdivision_layer) {
-			Unsubdivide();
-		}
-		else if (subdivision_count > m_subdivision_layer) {
-			if (m_is_subdivided) {
-				for (auto& node : m_child_nodes) {
-					node.Update(pos);
-				}
-			}
-			else if (m_subdivision_layer != m_max_subdivision_layer) {
-				Subdivide();
-			}
+		for (uint32_t i = 0; i < 4; i++) {
+			Node& child = m_nodes[first_child + i];
+			child = Node{};
+			child.min = node.min + glm::vec2((i & 1) * half_width, (i >> 1) * half_width);
+			child.width = half_width;
+			child.depth = node.depth + 1;
+			// The parent's chunk is drawn in place of this one until it's loaded (see GetDrawChunks)
+			child.p_chunk = AcquireChunk(child, static_cast<float>(GetResolution(node)));
 		}
+
+		node.first_child = first_child;
+		m_num_active_nodes += 4;
+		m_last_update_stats.splits++;
 	}
 
-	void TerrainQuadtree::Unsubdivide() {
-		for (auto& node : m_child_nodes) {
-			node.Unsubdivide();
-			ChunkLoader::CancelChunkLoad(node.m_chunk->m_chunk_key);
+	void TerrainQuadtree::Merge(uint32_t node_index) {
+		const uint32_t first_child = m_nodes[node_index].first_child;
+
+		for (uint32_t i = 0; i < 4; i++) {
+			if (m_nodes[first_child + i].first_child != INVALID_NODE)
+				Merge(first_child + i);
+
+			ReleaseChunk(m_nodes[first_child + i].p_chunk);
+			m_nodes[first_child + i].p_chunk = nullptr;
 		}
-		m_child_nodes.clear();
 
-		m_is_subdivided = false;
+		m_free_child_blocks.push_back(first_child);
+		m_nodes[node_index].first_child = INVALID_NODE;
+		m_num_active_nodes -= 4;
+		m_last_update_stats.merges++;
 	}
 
-	bool TerrainQuadtree::CheckIntersection(glm::vec3 position) const {
-		if (position.x > m_center_pos.x + static_cast<float>(m_width) ||
-			position.x < m_center_pos.x - static_cast<float>(m_width) ||
-			position.z > m_center_pos.z - static_cast<float>(m_width) ||
-			position.z < m_center_pos.z + static_cast<float>(m_width)
-			) {
+	bool TerrainQuadtree::IsReady(uint32_t node_index) const {
+		const Node& node = m_nodes[node_index];
+		if (node.p_chunk->IsReadyToDraw())
+			return true;
+
+		if (node.first_child == INVALID_NODE)
 			return false;
+
+		for (uint32_t i = 0; i < 4; i++) {
+			if (!IsReady(node.first_child + i))
+				return false;
 		}
-		else {
-			return true;
+
+		return true;
+	}
+
+	void TerrainQuadtree::CollectDrawChunks(uint32_t node_index) {
+		const Node& node = m_nodes[node_index];
+
+		if (node.first_child != INVALID_NODE) {
+			bool children_ready = true;
+			for (uint32_t i = 0; i < 4 && children_ready; i++) {
+				children_ready = IsReady(node.first_child + i);
+			}
+
+			if (children_ready) {
+				for (uint32_t i = 0; i < 4; i++) {
+					CollectDrawChunks(node.first_child + i);
+				}
+				return;
+			}
+
+			// This node stands in for its children until they've all loaded
+			m_draw_list_dirty = true;
 		}
+
+		if (node.p_chunk->IsReadyToDraw())
+			m_draw_chunks.push_back(node.p_chunk);
+		else
+			m_draw_list_dirty = true;
 	}
 
+	const std::vector<const TerrainChunk*>& TerrainQuadtree::GetDrawChunks() {
+		if (m_draw_list_dirty) {
+			ORNG_TRACY_PROFILE;
+			m_draw_list_dirty = false;
+			m_draw_chunks.clear();
+			CollectDrawChunks(ROOT_NODE);
+		}
+
+		return m_draw_chunks;
+	}
 
-}
\ No newline at end of file
+	void TerrainQuadtree::AccumulateMemoryStats(unsigned& num_chunks, size_t& cpu_bytes, size_t& gpu_bytes) const {
+		for (auto& p_chunk : m_chunk_storage) {
+			if (p_chunk->m_data_is_loaded)
+				num_chunks++;
+
+			cpu_bytes += p_chunk->GetCPUSizeBytes();
+			gpu_bytes += p_chunk->GetGPUSizeBytes();
+		}
+	}
+}
@@ -46,6 +46,13 @@ namespace ORNG {
 
 		points.push_back({ glm::clamp(x, x_min_max.x, x_min_max.y), glm::clamp(v, glm::vec3(yzw_min_max.x), glm::vec3(yzw_min_max.y)) });
 		SortPoints();
+		BakeLUT();
+	}
+
+	void InterpolatorV3::BakeLUT() {
+		for (unsigned i = 0; i < LUT_SIZE; i++) {
+			m_lut[i] = GetValue(glm::mix(x_min_max.x, x_min_max.y, static_cast<float>(i) / (LUT_SIZE - 1)));
+		}
 	}
 
 	void InterpolatorV3::RemovePoint(unsigned index) {
@@ -53,6 +60,7 @@ namespace ORNG {
 			return;
 
 		points.erase(points.begin() + index);
+		BakeLUT();
 	}
 
 	void InterpolatorV3::SetPoint(unsigned index, const glm::vec4& v) {
@@ -68,7 +76,13 @@ namespace ORNG {
 			}
 		}
 
-		points[index] = { glm::clamp(v.x, x_min_max.x, x_min_max.y), glm::clamp({v.y, v.z, v.w}, glm::vec3(yzw_min_max.x), glm::vec3(yzw_min_max.y)) };
+		glm::vec4 point = { glm::clamp(v.x, x_min_max.x, x_min_max.y), glm::clamp({v.y, v.z, v.w}, glm::vec3(yzw_min_max.x), glm::vec3(yzw_min_max.y)) };
+		// The editor sets every point every frame
+		if (points[index] == point)
+			return;
+
+		points[index] = point;
+		BakeLUT();
 	}
 
 	void InterpolatorV1::SetPoint(unsigned index, glm::vec2 v) {
@@ -82,7 +96,13 @@ namespace ORNG {
 			ORNG_CORE_ERROR("InterpolatorV1 error setting point, value out of range, using bound value instead");
 		}
 
-		points[index] = { glm::clamp(v.x, x_min_max.x, x_min_max.y), glm::clamp(v.y, y_min_max.x, y_min_max.y) };
+		glm::vec2 point = { glm::clamp(v.x, x_min_max.x, x_min_max.y), glm::clamp(v.y, y_min_max.x, y_min_max.y) };
+		// The editor sets every point every frame
+		if (points[index] == point)
+			return;
+
+		points[index] = point;
+		BakeLUT();
 	}
 
 
@@ -160,6 +180,13 @@ namespace ORNG {
 
 		points.push_back({ glm::clamp(x, x_min_max.x, x_min_max.y), glm::clamp(v, y_min_max.x, y_min_max.y) });
 		SortPoints();
+		BakeLUT();
+	}
+
+	void InterpolatorV1::BakeLUT() {
+		for (unsigned i = 0; i < LUT_SIZE; i++) {
+			m_lut[i] = GetValue(glm::mix(x_min_max.x, x_min_max.y, static_cast<float>(i) / (LUT_SIZE - 1)));
+		}
 	}
 
 	glm::vec2 InterpolatorV1::GetPoint(unsigned index) {
@@ -173,5 +200,6 @@ namespace ORNG {
 			return;
 
 		points.erase(points.begin() + index);
+		BakeLUT();
 	}
 }
\ No newline at end of file
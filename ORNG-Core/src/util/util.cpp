@@ -198,6 +198,18 @@ namespace ORNG {
 		return stream.str();
 	}
 
+	uint64_t HashBytes(const void* p_data, size_t size, uint64_t seed) {
+		uint64_t hash = seed;
+		auto* p_bytes = static_cast<const uint8_t*>(p_data);
+
+		for (size_t i = 0; i < size; i++) {
+			hash ^= p_bytes[i];
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
 	bool ReadBinaryFile(const std::string& filepath, std::vector<std::byte>& output) {
 
 		std::ifstream file{ filepath, std::ios::binary | std::ios::ate };
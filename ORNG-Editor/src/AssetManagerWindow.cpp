@@ -1,6 +1,7 @@
 #include "pch/pch.h"
 #include <shellapi.h>
 #include <imgui.h>
+#include <fmod.hpp>
 #include "AssetManagerWindow.h"
 #include "assets/AssetManager.h"
 #include "core/Window.h"
@@ -124,8 +125,10 @@ namespace ORNG {
 		m_asset_deletion_queue.clear();
 		RenderMainAssetWindow();
 
-		if (mp_selected_material && mp_selected_material->uuid() != ORNG_BASE_MATERIAL_ID &&  RenderMaterialEditorSection())
+		if (mp_selected_material && mp_selected_material->uuid() != ORNG_BASE_MATERIAL_ID &&  RenderMaterialEditorSection()) {
 			m_materials_to_gen_previews.push_back(mp_selected_material);
+			AssetManager::RefreshMaterialDependencies(mp_selected_material);
+		}
 
 		if (mp_selected_texture)
 			RenderTextureEditorSection();
@@ -431,7 +434,7 @@ namespace ORNG {
 						Texture2D* p_new_tex = new Texture2D(filepath);
 						p_new_tex->SetSpec(m_current_2d_tex_spec);
 						AssetManager::LoadTexture2D(AssetManager::AddAsset(p_new_tex));
-						p_new_tex->filepath = new_filepath;
+						AssetManager::SetAssetFilepath(*p_new_tex, new_filepath);
 
 						// Set filepath to the new path from the serialized texture
 						AssetManager::SerializeAssets();
@@ -629,6 +632,25 @@ namespace ORNG {
 			ImGui::EndDragDropSource();
 			};
 
+		// The mode is saved with the asset, it's applied straight away if the source file is still on disk
+		auto add_load_mode_option = [&spec, p_asset](const char* name, const char* current_name, SoundAsset::LoadMode mode) {
+			spec.popup_spec.options.push_back(std::make_pair(p_asset->load_mode == mode ? current_name : name,
+				[p_asset, mode]() {
+					p_asset->load_mode = mode;
+					if (!FileExists(p_asset->source_filepath))
+						return;
+
+					p_asset->p_sound->release();
+					p_asset->p_sound = nullptr;
+					p_asset->stream_source = SoundAsset::StreamSource{};
+					p_asset->CreateSoundFromFile();
+				}));
+			};
+
+		add_load_mode_option("Load: auto", "Load: auto (current)", SoundAsset::LoadMode::AUTO);
+		add_load_mode_option("Load: decode", "Load: decode (current)", SoundAsset::LoadMode::DECODE);
+		add_load_mode_option("Load: stream", "Load: stream (current)", SoundAsset::LoadMode::STREAM);
+
 		spec.p_tex = AssetManager::GetAsset<Texture2D>(ORNG_BASE_TEX_ID);
 
 		RenderBaseAsset(p_asset, spec);
@@ -730,7 +752,7 @@ namespace ORNG {
 			}
 
 			// Update the mesh filepath from the source file initially loaded to the generated binary file
-			p_mesh->filepath = filepath;
+			AssetManager::SetAssetFilepath(*p_mesh, filepath);
 
 			break;
 		}
@@ -759,6 +781,12 @@ namespace ORNG {
 
 			break;
 		}
+		case Events::AssetEventType::SCRIPT_MODIFIED:
+		{
+			auto* p_script = reinterpret_cast<ScriptAsset*>(t_event.data_payload);
+			ReloadScript(p_script->filepath, false);
+			break;
+		}
 		case Events::AssetEventType::SCRIPT_DELETED:
 			auto* p_symbols = &reinterpret_cast<ScriptAsset*>(t_event.data_payload)->symbols;
 			for (auto [entity, script] : (*mp_scene_context)->m_registry.view<ScriptComponent>().each()) {
@@ -18,6 +18,7 @@
 #include "tracy/public/tracy/Tracy.hpp"
 #include "imgui/imgui_internal.h"
 #include "components/ComponentSystems.h"
+#include "physics/PhysicsLayers.h"
 
 constexpr unsigned LEFT_WINDOW_WIDTH = 75;
 constexpr unsigned RIGHT_WINDOW_WIDTH = 650;
@@ -354,7 +355,8 @@ namespace ORNG {
 			SCENE->GetSystem<MeshInstancingSystem>().OnUpdate(); // This still needs to update so meshes are rendered correctly in the editor
 			SCENE->GetSystem<ParticleSystem>().OnUpdate(); // Continue simulating particles for visual feedback
 			SCENE->GetSystem<AudioSystem>().OnUpdate(); // For accurate audio playback
-			//SCENE->terrain.UpdateTerrainQuadtree(SCENE->m_camera_system.GetActiveCamera()->GetEntity()->GetComponent<TransformComponent>()->GetPosition()); // Needed for terrain LOD updates
+			if (auto* p_cam = SCENE->terrain.IsActive() ? SCENE->GetActiveCamera() : nullptr)
+				SCENE->terrain.UpdateTerrainQuadtree(p_cam->GetEntity()->GetComponent<TransformComponent>()->GetAbsPosition()); // Needed for terrain LOD updates
 		}
 	}
 
@@ -1056,6 +1058,8 @@ namespace ORNG {
 
 			AssetManager::ClearAll();
 			AssetManager::LoadAssetsFromProjectPath(m_state.current_project_directory, false);
+			AssetManager::EnableHotReload(m_state.current_project_directory);
+			PhysicsLayers::Load(ORNG_PHYSICS_LAYERS_FILEPATH);
 			SCENE->LoadScene();
 			SceneSerializer::DeserializeScene(*SCENE, m_state.current_project_directory + "\\scene.yml", true);
 
@@ -1111,10 +1115,14 @@ namespace ORNG {
 			entity->AddComponent<CameraComponent>();
 			break;
 		case 4:
-			entity->AddComponent<PhysicsComponent>();
+			// Contact reports are opt-in, scripted entities get them so OnCollision/OnTrigger work without having to find the checkbox
+			if (auto* p_physics = entity->AddComponent<PhysicsComponent>(); entity->HasComponent<ScriptComponent>())
+				p_physics->SetContactReportsEnabled(true);
 			break;
 		case 5:
 			entity->AddComponent<ScriptComponent>();
+			if (auto* p_physics = entity->GetComponent<PhysicsComponent>())
+				p_physics->SetContactReportsEnabled(true);
 			break;
 		case 6:
 			entity->AddComponent<AudioComponent>();
@@ -1434,7 +1442,50 @@ namespace ORNG {
 		m_lua_cli.GetLua().set_function("moveto", p_move_to_func);
 		m_lua_cli.GetLua().set_function("move_me", p_cam_move_to_func);
 		m_lua_cli.GetLua().set_function("match", p_match_func);
-		
+
+		// Audio
+		m_lua_cli.GetLua().set_function("audio_voices", [this] {
+			auto& audio = SCENE->GetSystem<AudioSystem>();
+			auto stats = audio.GetVoiceStats();
+			m_lua_cli.GetLua()["print"](std::format("Audio: {} real voices, {} virtual voices (budget {}), last update virtualized {} and realized {}",
+				stats.real_voices, stats.virtual_voices, audio.GetMaxRealVoices(), stats.virtualized, stats.realized));
+			});
+
+		m_lua_cli.GetLua().set_function("audio_set_max_voices", [this](unsigned max_real_voices) {
+			SCENE->GetSystem<AudioSystem>().SetMaxRealVoices(max_real_voices);
+			});
+
+		// Derived data cache
+		m_lua_cli.GetLua().set_function("ddc_stats", [this] {
+			auto stats = DerivedDataCache::GetStats();
+			uint64_t lookups = stats.hits + stats.misses;
+			m_lua_cli.GetLua()["print"](std::format("DDC: {} entries, {}MB, {} hits, {} misses ({:.1f}% hit rate), {} writes, {} evictions",
+				stats.num_entries, stats.total_bytes / 1'000'000, stats.hits, stats.misses, lookups == 0 ? 0.0 : 100.0 * stats.hits / lookups, stats.writes, stats.evictions));
+			});
+
+		m_lua_cli.GetLua().set_function("ddc_warm", [this](const std::string& path) {
+			unsigned num_warmed = AssetManager::WarmDerivedDataCache(path);
+			m_lua_cli.GetLua()["print"](std::format("DDC: warmed {} files", num_warmed));
+			});
+
+		m_lua_cli.GetLua().set_function("ddc_warm_project", [this] {
+			unsigned num_warmed = AssetManager::WarmDerivedDataCache("");
+			m_lua_cli.GetLua()["print"](std::format("DDC: warmed {} files", num_warmed));
+			});
+
+		m_lua_cli.GetLua().set_function("ddc_prune", [this](double max_size_mb) {
+			auto evictions_before = DerivedDataCache::GetStats().evictions;
+			DerivedDataCache::Prune(static_cast<uint64_t>(max_size_mb * 1'000'000));
+			m_lua_cli.GetLua()["print"](std::format("DDC: evicted {} entries", DerivedDataCache::GetStats().evictions - evictions_before));
+			});
+
+		m_lua_cli.GetLua().set_function("ddc_set_max_size", [](double max_size_mb) {
+			DerivedDataCache::SetMaxSize(static_cast<uint64_t>(max_size_mb * 1'000'000));
+			});
+
+		m_lua_cli.GetLua().set_function("ddc_clear", [] {
+			DerivedDataCache::Clear();
+			});
 	}
 
 	
@@ -1561,7 +1612,8 @@ namespace ORNG {
 				auto [t, s, r] = transform.GetAbsoluteTransforms();
 				auto sf = ((PxSphereGeometry*)&phys.p_shape->getGeometry())->radius;
 				glm::mat4 m;
-				glm::mat4x4 rot_mat = ExtraMath::Init3DRotateTransform(transform.m_orientation.x, transform.m_orientation.y, transform.m_orientation.z);
+				glm::vec3 orientation = transform.GetOrientation();
+				glm::mat4x4 rot_mat = ExtraMath::Init3DRotateTransform(orientation.x, orientation.y, orientation.z);
 
 				if (transform.m_is_absolute || !transform.GetParent()) {
 					glm::mat4x4 scale_mat = ExtraMath::Init3DScaleTransform(sf, sf, sf);
@@ -2365,6 +2417,12 @@ namespace ORNG {
 
 		ImGui::SeparatorText("Parameters");
 
+		bool cpu_simulated = p_comp->m_simulation_backend == ParticleEmitterComponent::SimulationBackend::CPU;
+		ImGui::Text("CPU simulated"); ImGui::SameLine();
+		if (ImGui::Checkbox("##cpu", &cpu_simulated)) {
+			p_comp->SetSimulationBackend(cpu_simulated ? ParticleEmitterComponent::SimulationBackend::CPU : ParticleEmitterComponent::SimulationBackend::GPU);
+		}
+
 		ImGui::Text("Spread"); ImGui::SameLine();
 		if (ImGui::DragFloat("##spread", &p_comp->m_spread, 1.f, 0.f, 1.f, "%.3f", ImGuiSliderFlags_AlwaysClamp)) {
 			p_comp->SetSpread(p_comp->m_spread);
@@ -2436,8 +2494,18 @@ namespace ORNG {
 		if (ImGui::InputFloat("##max_range", &max_range)) {
 			p_audio->SetMinMaxRange(min_range, max_range);
 		}
+
+		float priority = p_audio->GetPriority();
+		ImGui::Text("Priority");
+		ImGui::SameLine(ImGui::GetWindowContentRegionMax().x - 300.f);
+		if (ImGui::InputFloat("##priority", &priority)) {
+			p_audio->SetPriority(glm::max(priority, 0.f));
+		}
 		ImGui::PopItemWidth();
 
+		if (p_audio->IsVirtual())
+			ImGui::TextDisabled("Virtual (inaudible or over the voice budget)");
+
 		ImGui::Separator();
 
 		auto* p_sound = AssetManager::GetAsset<SoundAsset>(p_audio->m_sound_asset_uuid);
@@ -2447,8 +2515,7 @@ namespace ORNG {
 		ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 10);
 		ExtraUI::ColoredButton("##playback bg", ImVec4{ 0.25, 0.25, 0.25, 1 }, ImVec2(playback_widget_width, playback_widget_height));
 
-		unsigned int position;
-		p_audio->mp_channel->getPosition(&position, FMOD_TIMEUNIT_MS);
+		unsigned int position = p_audio->GetPlaybackPosition();
 		unsigned int total_length;
 		p_sound->p_sound->getLength(&total_length, FMOD_TIMEUNIT_MS);
 		total_length /= 1000.0;
@@ -2482,7 +2549,7 @@ namespace ORNG {
 				ImVec2 mouse_pos = ImGui::GetMousePos();
 				ImVec2 local_mouse{ mouse_pos.x - (wp.x + prev_curs_pos.x), mouse_pos.y - (wp.y + prev_curs_pos.y) };
 
-				p_audio->mp_channel->setPosition((unsigned)((local_mouse.x / playback_widget_width) * (float)total_length) * 1000.0, FMOD_TIMEUNIT_MS);
+				p_audio->SetPlaybackPosition((unsigned)((local_mouse.x / playback_widget_width) * (float)total_length) * 1000.0);
 			}
 		}
 		if (first_mouse_down && ImGui::IsMouseReleased(0)) {
@@ -2538,6 +2605,10 @@ namespace ORNG {
 			if (ImGui::RadioButton("Sphere", p_comp->m_geometry_type == PhysicsComponent::SPHERE)) {
 				p_comp->UpdateGeometry(PhysicsComponent::SPHERE);
 			}
+			ImGui::SameLine();
+			if (ImGui::RadioButton("Convex mesh", p_comp->m_geometry_type == PhysicsComponent::CONVEX_MESH)) {
+				p_comp->UpdateGeometry(PhysicsComponent::CONVEX_MESH);
+			}
 
 			/*ImGui::SameLine(); // TODO Add back when shape assets added
 			if (ImGui::RadioButton("Mesh", p_comp->m_geometry_type == PhysicsComponent::TRIANGLE_MESH)) {
@@ -2552,6 +2623,10 @@ namespace ORNG {
 			if (ImGui::RadioButton("Static", p_comp->m_body_type == PhysicsComponent::STATIC)) {
 				p_comp->SetBodyType(PhysicsComponent::STATIC);
 			}
+			ImGui::SameLine();
+			if (ImGui::RadioButton("Kinematic", p_comp->m_body_type == PhysicsComponent::KINEMATIC)) {
+				p_comp->SetBodyType(PhysicsComponent::KINEMATIC);
+			}
 
 			ImGui::Spacing();
 
@@ -2561,6 +2636,29 @@ namespace ORNG {
 				p_comp->SetTrigger(is_trigger);
 			}
 
+			bool contact_reports = p_comp->GetContactReportsEnabled();
+			if (ImGui::Checkbox("Contact reports", &contact_reports)) {
+				p_comp->SetContactReportsEnabled(contact_reports);
+			}
+
+			int layer = p_comp->GetLayer();
+			if (ImGui::SliderInt("Layer", &layer, 0, PhysicsComponent::MAX_LAYERS - 1)) {
+				p_comp->SetLayer(static_cast<uint8_t>(layer));
+			}
+
+			// Row of the project-wide interaction matrix for this component's layer
+			if (ImGui::TreeNode("Layer interactions")) {
+				for (uint8_t i = 0; i < PhysicsLayers::MAX_LAYERS; i++) {
+					bool interacts = PhysicsLayers::DoLayersInteract(p_comp->GetLayer(), i);
+					if (ImGui::Checkbox(std::format("{}##{}", PhysicsLayers::GetLayerName(i), i).c_str(), &interacts)) {
+						PhysicsLayers::SetLayersInteract(p_comp->GetLayer(), i, interacts);
+						PhysicsLayers::Save(ORNG_PHYSICS_LAYERS_FILEPATH);
+					}
+				}
+
+				ImGui::TreePop();
+			}
+
 
 			ImGui::TableNextColumn();
 			ImGui::SeparatorText("Material");
@@ -2592,7 +2690,7 @@ namespace ORNG {
 		}
 
 		glm::vec3 matrix_translation = transforms[0]->m_pos;
-		glm::vec3 matrix_rotation = transforms[0]->m_orientation;
+		glm::vec3 matrix_rotation = transforms[0]->GetOrientation();
 		glm::vec3 matrix_scale = transforms[0]->m_scale;
 
 		// UI section
@@ -2672,11 +2770,11 @@ namespace ORNG {
 
 						glm::mat3 to_parent_space = p_parent_transform->GetMatrix() * rot;
 						glm::vec3 local_rot = glm::inverse(to_parent_space) * glm::vec4(delta_rotation, 0.0);
-						glm::vec3 total = glm::eulerAngles(glm::quat(glm::radians(local_rot)) * glm::quat(glm::radians(p_transform->m_orientation)));
+						glm::vec3 total = glm::eulerAngles(glm::quat(glm::radians(local_rot)) * glm::quat(glm::radians(p_transform->GetOrientation())));
 						p_transform->SetOrientation(glm::degrees(total));
 					}
 					else {
-						auto orientation = glm::degrees(glm::eulerAngles(glm::quat(glm::radians(delta_rotation)) * glm::quat(glm::radians(p_transform->m_orientation))));
+						auto orientation = glm::degrees(glm::eulerAngles(glm::quat(glm::radians(delta_rotation)) * glm::quat(glm::radians(p_transform->GetOrientation()))));
 						p_transform->SetOrientation(orientation.x, orientation.y, orientation.z);
 					}
 
@@ -0,0 +1,118 @@
+#pragma once
+#include "../../ORNG-Core/headers/EngineAPI.h"
+#include "components/ComponentSystems.h"
+
+namespace ORNG {
+	/*
+		Checks and times the CPU particle backend, writes the results to a JSON file, then closes the application.
+		First times CPUParticleSimulator on its own at each size in PARTICLE_COUNTS, on one thread and on all of them, next to ParticleSystem's compute shader update of the same number of particles.
+		Then validates CPUParticleSimulator against the compute shaders: every frame the GPU's particles are read back, stepped once on the CPU with the frame's timestep and compared with what the GPU produced.
+		Then runs an emitter on the CPU backend through ParticleSystem, checking that what ends up in the particle SSBO is the simulator's output untouched by ParticleCS.
+		Finally checks the interpolators' baked LUTs against GetValue on a few multi-keyframe curves and times sampling one against evaluating the keyframes.
+		The layer does no rendering.
+	*/
+	class ParticleBenchLayer : public Layer {
+	public:
+		ParticleBenchLayer(const std::string& output_path, unsigned num_frames, unsigned num_validation_frames) :
+			m_output_path(output_path), m_num_frames(num_frames), m_num_validation_frames(num_validation_frames) {};
+
+		void OnInit() override;
+		void Update() override;
+		void OnRender() override {};
+		void OnShutdown() override {};
+		void OnImGuiRender() override {};
+
+		// False until every check has run and passed, the timings aren't checked
+		bool Passed() const {
+			return m_validation_result.passed && m_backend_result.passed && m_lut_result.passed;
+		}
+
+		static constexpr std::array<unsigned, 3> PARTICLE_COUNTS = { 10'000, 100'000, 1'000'000 };
+
+		// A mismatched particle is further than this from the GPU's after one step, positions stay within a few tens of units of the emitter
+		static constexpr float MAX_POSITION_ERROR = 0.01f;
+		static constexpr float MAX_LIFE_ERROR_MS = 0.01f;
+		// Respawns are seeded by hashing floats, a seed the GPU rounds differently (fused multiply-adds, sin/cos precision) gives a completely different particle
+		static constexpr float MAX_MISMATCHED_FRACTION = 0.01f;
+
+		// Evenly spaced over each curve, so every LUT interval gets plenty
+		static constexpr unsigned NUM_LUT_CHECK_SAMPLES = 100'001;
+		// LUT errors may exceed the analytic bound by this much from float rounding
+		static constexpr float LUT_ERROR_TOLERANCE = 1e-5f;
+		static constexpr unsigned NUM_LUT_TIMING_SAMPLES = 1'000'000;
+
+	private:
+		struct TimingResult {
+			unsigned num_particles = 0;
+			float cpu_single_thread_ms = 0.f;
+			float cpu_threaded_ms = 0.f;
+			// ParticleSystem::OnUpdate with every particle on the GPU backend, emitters hold up to 100,000 particles so larger counts are split over several
+			float gpu_ms = 0.f;
+		};
+
+		struct ValidationResult {
+			unsigned num_particles = 0;
+			unsigned num_frames = 0;
+			// Particles the GPU respawned over the run, all of them go through the CPU's respawn too
+			unsigned num_respawned = 0;
+			unsigned num_mismatched = 0;
+			float mismatched_fraction = 0.f;
+			// Largest errors of the particles that matched
+			float max_position_error = 0.f;
+			float max_life_error_ms = 0.f;
+			bool passed = false;
+		};
+
+		struct BackendResult {
+			unsigned num_particles = 0;
+			// ParticleSystem::OnUpdate including the upload, until the GPU has finished with it
+			float mean_update_ms = 0.f;
+			// Particles in the SSBO that differ from a simulator stepped alongside it
+			unsigned num_mismatched = 0;
+			bool passed = false;
+		};
+
+		struct LUTCurveResult {
+			std::string name;
+			unsigned num_points = 0;
+			// SampleLUT against GetValue
+			float max_error = 0.f;
+			float mean_error = 0.f;
+			// Largest error linearly interpolating the LUT can have on this curve
+			float error_bound = 0.f;
+			bool passed = false;
+		};
+
+		struct LUTResult {
+			std::vector<LUTCurveResult> curves;
+			// Mean time per evaluation at random points on 8 keyframe curves
+			float v3_get_value_ns = 0.f;
+			float v3_sample_lut_ns = 0.f;
+			float v1_get_value_ns = 0.f;
+			float v1_sample_lut_ns = 0.f;
+			bool passed = false;
+		};
+
+		std::vector<TimingResult> RunTimings();
+
+		// Passes if no more than MAX_MISMATCHED_FRACTION of the particles stepped over the run mismatched
+		ValidationResult RunValidation();
+
+		// Passes if every particle matches exactly
+		BackendResult RunCPUBackendCheck();
+
+		// Passes if every curve's max error is within its bound
+		LUTResult RunLUTCheck();
+
+		void WriteResults();
+
+		std::string m_output_path;
+		unsigned m_num_frames;
+		unsigned m_num_validation_frames;
+
+		std::vector<TimingResult> m_timing_results;
+		ValidationResult m_validation_result;
+		BackendResult m_backend_result;
+		LUTResult m_lut_result;
+	};
+}
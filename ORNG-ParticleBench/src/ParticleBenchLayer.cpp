@@ -0,0 +1,482 @@
+#include "ParticleBenchLayer.h"
+#include <glfw/glfw3.h>
+#include <thread>
+#include <random>
+#include "util/ExtraMath.h"
+
+namespace ORNG {
+	static constexpr unsigned MAX_EMITTER_PARTICLES = 100'000;
+	static constexpr unsigned NUM_WARMUP_FRAMES = 10;
+	// Timestep for the standalone CPU timings, the scene runs use the wall clock like the engine does
+	static constexpr float FIXED_DT_MS = 1000.f / 60.f;
+
+	// Particles are continuously respawning, each lives half a second and the spawn delay is spread over the lifespan
+	static constexpr float EMITTER_LIFESPAN_MS = 500.f;
+	static constexpr glm::vec3 EMITTER_POS{ 5.f, 10.f, -3.f };
+	// Degrees, so velocities and spawn offsets go through a non-trivial rotation
+	static constexpr glm::vec3 EMITTER_ORIENTATION{ 30.f, 0.f, 45.f };
+	static constexpr glm::vec3 EMITTER_SPAWN_EXTENTS{ 10.f, 0.f, 10.f };
+	static constexpr glm::vec2 EMITTER_VELOCITY_RANGE{ 1.f, 20.f };
+	static constexpr glm::vec3 EMITTER_ACCELERATION{ 0.f, -9.81f, 0.f };
+	static constexpr float EMITTER_SPREAD = 0.25f;
+
+	// Same as a new emitter's
+	static InterpolatorV3 CreateDefaultInterpolatorV3() {
+		return InterpolatorV3{ {0, 1}, {0, 1}, {1, 1, 1}, {1, 1, 1} };
+	}
+
+	static InterpolatorV1 CreateDefaultInterpolatorV1() {
+		return InterpolatorV1{ {0, 1}, {0, 1}, 1, 1 };
+	}
+
+	// Keyframes at least one LUT spacing apart, so no LUT interval holds more than one
+	static InterpolatorV3 CreateColourCurve() {
+		InterpolatorV3 interpolator{ {0, 1}, {0, 1}, {1.f, 0.9f, 0.2f}, {0.f, 0.f, 0.f} };
+		interpolator.AddPoint(0.1f, { 1.f, 0.5f, 0.f });
+		interpolator.AddPoint(0.25f, { 0.8f, 0.2f, 0.1f });
+		interpolator.AddPoint(0.4f, { 0.3f, 0.3f, 0.9f });
+		interpolator.AddPoint(0.55f, { 0.1f, 0.6f, 0.7f });
+		interpolator.AddPoint(0.7f, { 0.5f, 0.5f, 0.5f });
+		interpolator.AddPoint(0.85f, { 0.2f, 0.1f, 0.05f });
+		return interpolator;
+	}
+
+	// Pops in, holds, shrinks out
+	static InterpolatorV3 CreateScaleCurve() {
+		InterpolatorV3 interpolator{ {0, 1}, {0, 1}, {0.f, 0.f, 0.f}, {0.2f, 0.2f, 0.2f} };
+		interpolator.AddPoint(0.1f, { 1.f, 1.f, 1.f });
+		interpolator.AddPoint(0.8f, { 1.f, 1.f, 1.f });
+		return interpolator;
+	}
+
+	// Flickers
+	static InterpolatorV1 CreateAlphaCurve() {
+		InterpolatorV1 interpolator{ {0, 1}, {0, 1}, 0.f, 0.f };
+		interpolator.AddPoint(0.05f, 1.f);
+		interpolator.AddPoint(0.2f, 0.4f);
+		interpolator.AddPoint(0.33f, 0.9f);
+		interpolator.AddPoint(0.5f, 0.3f);
+		interpolator.AddPoint(0.62f, 0.8f);
+		interpolator.AddPoint(0.8f, 0.6f);
+		return interpolator;
+	}
+
+	// A keyframe between two LUT samples is cut off by at most (change in slope) * (sample spacing) / 4, as long as each LUT interval holds at most one keyframe
+	static float GetLUTErrorBound(InterpolatorV3& interpolator) {
+		float max_slope_change = 0.f;
+		for (unsigned i = 1; i + 1 < interpolator.GetNbPoints(); i++) {
+			glm::vec4 p0 = interpolator.GetPoint(i - 1);
+			glm::vec4 p1 = interpolator.GetPoint(i);
+			glm::vec4 p2 = interpolator.GetPoint(i + 1);
+			glm::vec3 slope_change = glm::abs((glm::vec3{ p2.y, p2.z, p2.w } - glm::vec3{ p1.y, p1.z, p1.w }) / (p2.x - p1.x) - (glm::vec3{ p1.y, p1.z, p1.w } - glm::vec3{ p0.y, p0.z, p0.w }) / (p1.x - p0.x));
+			max_slope_change = glm::max(max_slope_change, glm::max(glm::max(slope_change.x, slope_change.y), slope_change.z));
+		}
+
+		return max_slope_change / (InterpolatorV3::LUT_SIZE - 1) / 4.f;
+	}
+
+	static float GetLUTErrorBound(InterpolatorV1& interpolator) {
+		float max_slope_change = 0.f;
+		for (unsigned i = 1; i + 1 < interpolator.GetNbPoints(); i++) {
+			glm::vec2 p0 = interpolator.GetPoint(i - 1);
+			glm::vec2 p1 = interpolator.GetPoint(i);
+			glm::vec2 p2 = interpolator.GetPoint(i + 1);
+			max_slope_change = glm::max(max_slope_change, glm::abs((p2.y - p1.y) / (p2.x - p1.x) - (p1.y - p0.y) / (p1.x - p0.x)));
+		}
+
+		return max_slope_change / (InterpolatorV1::LUT_SIZE - 1) / 4.f;
+	}
+
+	// "get_error" returns the LUT's error at x, sampled at "num_samples" evenly spaced points over [0, 1]
+	template<typename T>
+	static void MeasureLUTError(T&& get_error, unsigned num_samples, float& max_error, float& mean_error) {
+		double total_error = 0.0;
+		for (unsigned i = 0; i < num_samples; i++) {
+			const float error = get_error(static_cast<float>(i) / (num_samples - 1));
+			max_error = glm::max(max_error, error);
+			total_error += error;
+		}
+		mean_error = static_cast<float>(total_error / num_samples);
+	}
+
+	// Returns the mean nanoseconds per call of "evaluate"
+	template<typename T>
+	static float TimeEvaluations(const std::vector<float>& samples, T&& evaluate) {
+		float sum = 0.f;
+		auto start = std::chrono::steady_clock::now();
+		for (float x : samples) {
+			sum += evaluate(x);
+		}
+		float ns = std::chrono::duration<float, std::nano>(std::chrono::steady_clock::now() - start).count() / samples.size();
+
+		// Keeps the evaluations from being optimized away
+		volatile float sink = sum;
+		(void)sink;
+		return ns;
+	}
+
+	static std::unique_ptr<Scene> CreateParticleScene() {
+		auto p_scene = std::make_unique<Scene>();
+		p_scene->AddSystem(new ParticleSystem{ &*p_scene });
+		p_scene->AddSystem(new TransformHierarchySystem{ &*p_scene });
+		p_scene->LoadScene();
+		return p_scene;
+	}
+
+	static ParticleEmitterComponent* AddBenchEmitter(Scene& scene, unsigned num_particles, ParticleEmitterComponent::SimulationBackend backend) {
+		auto& ent = scene.CreateEntity("Emitter");
+		auto* p_transform = ent.GetComponent<TransformComponent>();
+		p_transform->SetAbsolutePosition(EMITTER_POS);
+		p_transform->SetAbsoluteOrientation(EMITTER_ORIENTATION);
+
+		auto* p_emitter = ent.AddComponent<ParticleEmitterComponent>();
+		p_emitter->SetSimulationBackend(backend);
+		p_emitter->SetNbParticles(num_particles);
+		p_emitter->SetParticleLifespan(EMITTER_LIFESPAN_MS);
+		p_emitter->SetParticleSpawnDelay(EMITTER_LIFESPAN_MS / num_particles);
+		p_emitter->SetSpawnExtents(EMITTER_SPAWN_EXTENTS);
+		p_emitter->SetVelocityScale(EMITTER_VELOCITY_RANGE);
+		p_emitter->SetAcceleration(EMITTER_ACCELERATION);
+		p_emitter->SetSpread(EMITTER_SPREAD);
+		return p_emitter;
+	}
+
+	// The same values AddBenchEmitter gives a scene emitter, for simulators run without one
+	static CPUParticleSimulator::EmitterParams GetBenchEmitterParams(unsigned num_particles) {
+		CPUParticleSimulator::EmitterParams params;
+		params.pos = EMITTER_POS;
+		params.rotation = ExtraMath::Init3DRotateTransform(EMITTER_ORIENTATION.x, EMITTER_ORIENTATION.y, EMITTER_ORIENTATION.z);
+		params.spawn_extents = EMITTER_SPAWN_EXTENTS;
+		params.acceleration = EMITTER_ACCELERATION;
+		params.vel_scale_min = EMITTER_VELOCITY_RANGE.x;
+		params.vel_scale_max = EMITTER_VELOCITY_RANGE.y;
+		params.spread = EMITTER_SPREAD * 2.0f * glm::pi<float>();
+		params.lifespan_ms = EMITTER_LIFESPAN_MS;
+		params.spawn_delay_ms = EMITTER_LIFESPAN_MS / num_particles;
+		return params;
+	}
+
+	// Timesteps reach the compute shaders through the common UBO, which SceneRenderer would normally set
+	// Returns the new timestep
+	static float AdvanceFrame(bool paced) {
+		if (paced)
+			std::this_thread::sleep_for(std::chrono::milliseconds(16));
+
+		FrameTiming::Update();
+		Renderer::GetShaderLibrary().SetCommonUBO(glm::vec3{ 0.f }, glm::vec3{ 0.f, 0.f, -1.f }, glm::vec3{ 1.f, 0.f, 0.f }, glm::vec3{ 0.f, 1.f, 0.f }, 1, 1, 1000.f, 0.1f,
+			glm::vec3{ 0.f }, glm::vec3{ 0.f }, FrameTiming::GetTotalElapsedTime());
+
+		return FrameTiming::GetTimeStep();
+	}
+
+	void ParticleBenchLayer::OnInit() {
+		ORNG_CORE_INFO("Particle bench: {0} timed frames, {1} validation frames", m_num_frames, m_num_validation_frames);
+	}
+
+	void ParticleBenchLayer::Update() {
+		m_timing_results = RunTimings();
+		m_validation_result = RunValidation();
+		m_backend_result = RunCPUBackendCheck();
+		m_lut_result = RunLUTCheck();
+		WriteResults();
+		glfwSetWindowShouldClose(Window::GetGLFWwindow(), true);
+	}
+
+
+
+	std::vector<ParticleBenchLayer::TimingResult> ParticleBenchLayer::RunTimings() {
+		std::vector<TimingResult> results;
+		auto colour = CreateDefaultInterpolatorV3();
+		auto scale = CreateDefaultInterpolatorV3();
+		auto alpha = CreateDefaultInterpolatorV1();
+
+		for (unsigned num_particles : PARTICLE_COUNTS) {
+			auto& result = results.emplace_back();
+			result.num_particles = num_particles;
+
+			const auto params = GetBenchEmitterParams(num_particles);
+			CPUParticleSimulator simulator;
+
+			for (unsigned max_workers : { 1u, 0u }) {
+				simulator.SetMaxWorkers(max_workers);
+				simulator.Init(params, num_particles, FIXED_DT_MS);
+
+				for (unsigned i = 0; i < NUM_WARMUP_FRAMES; i++) {
+					simulator.Update(params, FIXED_DT_MS, colour, scale, alpha);
+				}
+
+				auto start = std::chrono::steady_clock::now();
+				for (unsigned i = 0; i < m_num_frames; i++) {
+					simulator.Update(params, FIXED_DT_MS, colour, scale, alpha);
+				}
+				float mean_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() / m_num_frames;
+				(max_workers == 1 ? result.cpu_single_thread_ms : result.cpu_threaded_ms) = mean_ms;
+			}
+
+			auto p_scene = CreateParticleScene();
+			auto& particles = p_scene->GetSystem<ParticleSystem>();
+			for (unsigned added = 0; added < num_particles; added += MAX_EMITTER_PARTICLES) {
+				AddBenchEmitter(*p_scene, glm::min(num_particles - added, MAX_EMITTER_PARTICLES), ParticleEmitterComponent::SimulationBackend::GPU);
+			}
+
+			for (unsigned i = 0; i < NUM_WARMUP_FRAMES; i++) {
+				AdvanceFrame(false);
+				particles.OnUpdate();
+			}
+			glFinish();
+
+			float total_gpu_ms = 0.f;
+			for (unsigned i = 0; i < m_num_frames; i++) {
+				AdvanceFrame(false);
+				auto start = std::chrono::steady_clock::now();
+				particles.OnUpdate();
+				glFinish();
+				total_gpu_ms += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+			}
+			result.gpu_ms = total_gpu_ms / m_num_frames;
+
+			ORNG_CORE_INFO("Particle bench timings: {0} particles, CPU {1:.3f}ms single threaded, {2:.3f}ms threaded, GPU {3:.3f}ms",
+				num_particles, result.cpu_single_thread_ms, result.cpu_threaded_ms, result.gpu_ms);
+		}
+
+		return results;
+	}
+
+
+
+	ParticleBenchLayer::ValidationResult ParticleBenchLayer::RunValidation() {
+		ValidationResult result;
+		result.num_particles = MAX_EMITTER_PARTICLES;
+		result.num_frames = m_num_validation_frames;
+
+		auto p_scene = CreateParticleScene();
+		auto& particles = p_scene->GetSystem<ParticleSystem>();
+		auto* p_emitter = AddBenchEmitter(*p_scene, MAX_EMITTER_PARTICLES, ParticleEmitterComponent::SimulationBackend::GPU);
+		const auto params = CPUParticleSimulator::EmitterParams::FromEmitter(*p_emitter);
+
+		auto colour = CreateDefaultInterpolatorV3();
+		auto scale = CreateDefaultInterpolatorV3();
+		auto alpha = CreateDefaultInterpolatorV1();
+		CPUParticleSimulator simulator;
+
+		std::vector<CPUParticleSimulator::GPUParticle> before;
+		std::vector<CPUParticleSimulator::GPUParticle> after;
+
+		FrameTiming::Update();
+		for (unsigned frame = 0; frame < m_num_validation_frames; frame++) {
+			// Starting every step from the GPU's particles keeps one mismatched respawn from being counted again every frame after
+			particles.ReadEmitterParticles(p_emitter, before);
+			simulator.ReadGPUParticles(before);
+
+			const float dt = AdvanceFrame(true);
+			particles.OnUpdate();
+			particles.ReadEmitterParticles(p_emitter, after);
+			simulator.Update(params, dt, colour, scale, alpha);
+
+			const auto& simulated = simulator.GetParticles();
+			for (unsigned i = 0; i < MAX_EMITTER_PARTICLES; i++) {
+				if (after[i].velocity_life.w > before[i].velocity_life.w)
+					result.num_respawned++;
+
+				const float position_error = glm::length(glm::vec3{ after[i].pos } - glm::vec3{ simulated.pos_x[i], simulated.pos_y[i], simulated.pos_z[i] });
+				const float life_error = glm::abs(after[i].velocity_life.w - simulated.life[i]);
+
+				if (!(position_error <= MAX_POSITION_ERROR && life_error <= MAX_LIFE_ERROR_MS)) {
+					result.num_mismatched++;
+					continue;
+				}
+
+				result.max_position_error = glm::max(result.max_position_error, position_error);
+				result.max_life_error_ms = glm::max(result.max_life_error_ms, life_error);
+			}
+		}
+
+		const unsigned long long num_stepped = static_cast<unsigned long long>(MAX_EMITTER_PARTICLES) * m_num_validation_frames;
+		result.mismatched_fraction = num_stepped == 0 ? 1.f : static_cast<float>(static_cast<double>(result.num_mismatched) / num_stepped);
+		result.passed = result.num_respawned > 0 && result.mismatched_fraction <= MAX_MISMATCHED_FRACTION;
+
+		ORNG_CORE_INFO("Particle bench validation: {0} respawns, {1}/{2} particle steps mismatched, max position error {3}, max life error {4}ms",
+			result.num_respawned, result.num_mismatched, num_stepped, result.max_position_error, result.max_life_error_ms);
+
+		return result;
+	}
+
+
+
+	ParticleBenchLayer::BackendResult ParticleBenchLayer::RunCPUBackendCheck() {
+		BackendResult result;
+		result.num_particles = MAX_EMITTER_PARTICLES;
+
+		auto p_scene = CreateParticleScene();
+		auto& particles = p_scene->GetSystem<ParticleSystem>();
+		auto* p_emitter = AddBenchEmitter(*p_scene, MAX_EMITTER_PARTICLES, ParticleEmitterComponent::SimulationBackend::CPU);
+		const auto params = CPUParticleSimulator::EmitterParams::FromEmitter(*p_emitter);
+
+		auto colour = CreateDefaultInterpolatorV3();
+		auto scale = CreateDefaultInterpolatorV3();
+		auto alpha = CreateDefaultInterpolatorV1();
+		CPUParticleSimulator reference;
+
+		std::vector<CPUParticleSimulator::GPUParticle> before;
+		std::vector<CPUParticleSimulator::GPUParticle> after;
+		std::vector<CPUParticleSimulator::GPUParticle> expected(MAX_EMITTER_PARTICLES);
+
+		float total_update_ms = 0.f;
+		FrameTiming::Update();
+		for (unsigned frame = 0; frame < m_num_validation_frames; frame++) {
+			particles.ReadEmitterParticles(p_emitter, before);
+			reference.ReadGPUParticles(before);
+
+			const float dt = AdvanceFrame(true);
+			auto start = std::chrono::steady_clock::now();
+			particles.OnUpdate();
+			glFinish();
+			total_update_ms += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			particles.ReadEmitterParticles(p_emitter, after);
+			reference.Update(params, dt, colour, scale, alpha);
+			reference.WriteGPUParticles(expected, 0);
+
+			// If ParticleCS had also stepped these they would be a frame ahead
+			for (unsigned i = 0; i < MAX_EMITTER_PARTICLES; i++) {
+				if (glm::vec3{ after[i].pos } != glm::vec3{ expected[i].pos } || after[i].velocity_life != expected[i].velocity_life || after[i].scale != expected[i].scale)
+					result.num_mismatched++;
+			}
+		}
+
+		result.mean_update_ms = m_num_validation_frames == 0 ? 0.f : total_update_ms / m_num_validation_frames;
+		result.passed = m_num_validation_frames > 0 && result.num_mismatched == 0;
+
+		ORNG_CORE_INFO("Particle bench CPU backend: {0} particles, {1:.3f}ms mean update, {2} mismatched", result.num_particles, result.mean_update_ms, result.num_mismatched);
+
+		return result;
+	}
+
+
+
+	ParticleBenchLayer::LUTResult ParticleBenchLayer::RunLUTCheck() {
+		LUTResult result;
+		result.passed = true;
+
+		auto add_curve = [&](const std::string& name, auto interpolator) {
+			auto& curve = result.curves.emplace_back();
+			curve.name = name;
+			curve.num_points = interpolator.GetNbPoints();
+			curve.error_bound = GetLUTErrorBound(interpolator);
+
+			MeasureLUTError([&](float x) {
+				if constexpr (std::is_same_v<decltype(interpolator), InterpolatorV3>) {
+					// Per component like the bound
+					glm::vec3 error = glm::abs(interpolator.SampleLUT(x) - interpolator.GetValue(x));
+					return glm::max(glm::max(error.x, error.y), error.z);
+				}
+				else {
+					return glm::abs(interpolator.SampleLUT(x) - interpolator.GetValue(x));
+				}
+				}, NUM_LUT_CHECK_SAMPLES, curve.max_error, curve.mean_error);
+
+			curve.passed = curve.max_error <= curve.error_bound + LUT_ERROR_TOLERANCE;
+			result.passed &= curve.passed;
+
+			ORNG_CORE_INFO("Particle bench LUT: '{0}' ({1} points), max error {2}, mean error {3}, bound {4}", curve.name, curve.num_points, curve.max_error, curve.mean_error, curve.error_bound);
+			};
+
+		add_curve("default colour", CreateDefaultInterpolatorV3());
+		add_curve("colour", CreateColourCurve());
+		add_curve("scale", CreateScaleCurve());
+		add_curve("default alpha", CreateDefaultInterpolatorV1());
+		add_curve("alpha", CreateAlphaCurve());
+
+		// Particles are at every point in their lives, so the timing samples are spread randomly rather than swept
+		std::vector<float> samples(NUM_LUT_TIMING_SAMPLES);
+		std::mt19937 rng{ 0 };
+		std::uniform_real_distribution<float> dist{ 0.f, 1.f };
+		for (float& x : samples) {
+			x = dist(rng);
+		}
+
+		auto colour = CreateColourCurve();
+		auto alpha = CreateAlphaCurve();
+		ASSERT(colour.GetNbPoints() == InterpolatorV3::GPU_INTERPOLATOR_STRUCT_MAX_POINTS && alpha.GetNbPoints() == InterpolatorV1::GPU_INTERPOLATOR_STRUCT_MAX_POINTS);
+
+		result.v3_get_value_ns = TimeEvaluations(samples, [&](float x) { glm::vec3 v = colour.GetValue(x); return v.x + v.y + v.z; });
+		result.v3_sample_lut_ns = TimeEvaluations(samples, [&](float x) { glm::vec3 v = colour.SampleLUT(x); return v.x + v.y + v.z; });
+		result.v1_get_value_ns = TimeEvaluations(samples, [&](float x) { return alpha.GetValue(x); });
+		result.v1_sample_lut_ns = TimeEvaluations(samples, [&](float x) { return alpha.SampleLUT(x); });
+
+		ORNG_CORE_INFO("Particle bench LUT timings: InterpolatorV3 {0:.2f}ns GetValue, {1:.2f}ns SampleLUT, InterpolatorV1 {2:.2f}ns GetValue, {3:.2f}ns SampleLUT",
+			result.v3_get_value_ns, result.v3_sample_lut_ns, result.v1_get_value_ns, result.v1_sample_lut_ns);
+
+		return result;
+	}
+
+
+
+	void ParticleBenchLayer::WriteResults() {
+		std::ofstream s{ m_output_path };
+		if (!s.is_open()) {
+			ORNG_CORE_ERROR("Particle bench failed to open '{0}' for writing", m_output_path);
+			return;
+		}
+
+		s << "{\n";
+		s << std::format("\t\"frames\": {},\n", m_num_frames);
+		s << std::format("\t\"hardware_threads\": {},\n", std::thread::hardware_concurrency());
+
+		s << "\t\"timings\": [\n";
+		for (size_t i = 0; i < m_timing_results.size(); i++) {
+			const auto& result = m_timing_results[i];
+			s << "\t\t{\n";
+			s << std::format("\t\t\t\"particles\": {},\n", result.num_particles);
+			s << std::format("\t\t\t\"cpu_single_thread_ms\": {},\n", result.cpu_single_thread_ms);
+			s << std::format("\t\t\t\"cpu_threaded_ms\": {},\n", result.cpu_threaded_ms);
+			s << std::format("\t\t\t\"gpu_ms\": {}\n", result.gpu_ms);
+			s << (i + 1 == m_timing_results.size() ? "\t\t}\n" : "\t\t},\n");
+		}
+		s << "\t],\n";
+
+		const auto& validation = m_validation_result;
+		s << "\t\"validation\": {\n";
+		s << std::format("\t\t\"passed\": {},\n", validation.passed);
+		s << std::format("\t\t\"particles\": {},\n", validation.num_particles);
+		s << std::format("\t\t\"frames\": {},\n", validation.num_frames);
+		s << std::format("\t\t\"respawned\": {},\n", validation.num_respawned);
+		s << std::format("\t\t\"mismatched\": {},\n", validation.num_mismatched);
+		s << std::format("\t\t\"mismatched_fraction\": {},\n", validation.mismatched_fraction);
+		s << std::format("\t\t\"max_position_error\": {},\n", validation.max_position_error);
+		s << std::format("\t\t\"max_life_error_ms\": {}\n", validation.max_life_error_ms);
+		s << "\t},\n";
+
+		const auto& backend = m_backend_result;
+		s << "\t\"cpu_backend\": {\n";
+		s << std::format("\t\t\"passed\": {},\n", backend.passed);
+		s << std::format("\t\t\"particles\": {},\n", backend.num_particles);
+		s << std::format("\t\t\"mean_update_ms\": {},\n", backend.mean_update_ms);
+		s << std::format("\t\t\"mismatched\": {}\n", backend.num_mismatched);
+		s << "\t},\n";
+
+		const auto& lut = m_lut_result;
+		s << "\t\"interpolator_luts\": {\n";
+		s << std::format("\t\t\"passed\": {},\n", lut.passed);
+		s << std::format("\t\t\"lut_size\": {},\n", InterpolatorV3::LUT_SIZE);
+		s << std::format("\t\t\"v3_get_value_ns\": {},\n", lut.v3_get_value_ns);
+		s << std::format("\t\t\"v3_sample_lut_ns\": {},\n", lut.v3_sample_lut_ns);
+		s << std::format("\t\t\"v1_get_value_ns\": {},\n", lut.v1_get_value_ns);
+		s << std::format("\t\t\"v1_sample_lut_ns\": {},\n", lut.v1_sample_lut_ns);
+		s << "\t\t\"curves\": [\n";
+		for (size_t i = 0; i < lut.curves.size(); i++) {
+			const auto& curve = lut.curves[i];
+			s << "\t\t\t{\n";
+			s << std::format("\t\t\t\t\"name\": \"{}\",\n", curve.name);
+			s << std::format("\t\t\t\t\"points\": {},\n", curve.num_points);
+			s << std::format("\t\t\t\t\"passed\": {},\n", curve.passed);
+			s << std::format("\t\t\t\t\"max_error\": {},\n", curve.max_error);
+			s << std::format("\t\t\t\t\"mean_error\": {},\n", curve.mean_error);
+			s << std::format("\t\t\t\t\"error_bound\": {}\n", curve.error_bound);
+			s << (i + 1 == lut.curves.size() ? "\t\t\t}\n" : "\t\t\t},\n");
+		}
+		s << "\t\t]\n";
+		s << "\t}\n";
+		s << "}\n";
+	}
+}
@@ -0,0 +1,13 @@
+#include "ParticleBenchLayer.h"
+#include "BenchMain.h"
+
+// Usage: ORNG_PARTICLE_BENCH [output json path] [timed frames] [validation frames]
+int main(int argc, char** argv) {
+	std::string output_path = argc > 1 ? argv[1] : "particle-bench.json";
+	unsigned num_frames = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 120;
+	unsigned num_validation_frames = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 60;
+
+	ORNG::ParticleBenchLayer bench{ output_path, num_frames, num_validation_frames };
+
+	return ORNG::RunBench(bench, "ORNG Particle Bench", static_cast<ORNG::ApplicationModulesFlags>(ORNG::SCENE_RENDERER | ORNG::PHYSICS | ORNG::AUDIO | ORNG::INPUT | ORNG::ASSET_MANAGER));
+}
@@ -0,0 +1,252 @@
+#pragma once
+#include "../../ORNG-Core/headers/EngineAPI.h"
+#include "components/ComponentSystems.h"
+
+namespace ORNG {
+	/*
+		Builds a set of physics scenarios programmatically, steps each one a fixed number of times and writes the step timings to a JSON file, then closes the application.
+		Every scenario runs in its own scene so results don't affect each other, the layer does no rendering.
+		Afterwards checks terrain heightfield colliders against the analytic terrain height, see RunTerrainColliderCheck, convex hull cooking, see RunConvexHullCheck, whether stepping is independent of frame time, see RunDeterminismCheck, batched raycasts against serial ones, see RunRaycastBatchCheck, how animated scale reaches the colliders, see RunAnimatedScaleCheck, frame times with pipelined stepping against synchronous stepping, see RunPipelinedSteppingCheck, and the cost of writing poses back to transforms, see RunWriteBackCheck.
+	*/
+	class PhysicsBenchLayer : public Layer {
+	public:
+		PhysicsBenchLayer(const std::string& output_path, unsigned num_steps, unsigned num_traffic_vehicles) : m_output_path(output_path), m_num_steps(num_steps), m_num_traffic_vehicles(num_traffic_vehicles) {};
+
+		void OnInit() override;
+		void Update() override;
+		void OnRender() override {};
+		void OnShutdown() override {};
+		void OnImGuiRender() override {};
+
+		// False until every check has run and passed, the timings aren't checked
+		bool Passed() const {
+			return m_terrain_collider_result.passed && m_convex_hull_result.passed && m_determinism_result.passed && m_raycast_batch_result.passed && m_animated_scale_result.passed && m_pipelined_stepping_result.passed && m_write_back_result.passed;
+		}
+
+		// Steps taken before timing starts, so bodies have settled into contact and PhysX has allocated its buffers
+		static constexpr unsigned NUM_WARMUP_STEPS = 30;
+
+	private:
+		struct Scenario {
+			const char* name;
+			void (PhysicsBenchLayer::*build)(Scene& scene);
+			bool parallel_vehicle_stepping = true;
+		};
+
+		struct ScenarioResult {
+			std::string name;
+			unsigned num_bodies = 0;
+			unsigned num_joints = 0;
+			std::vector<float> step_times_ms;
+			PhysicsSystem::ContactStats contact_totals;
+			// From the last timed step, shows how much of the scene had gone to sleep
+			PhysicsSystem::ActorStats final_actor_stats;
+		};
+
+		ScenarioResult RunScenario(const Scenario& scenario);
+		void WriteResults();
+
+		struct TerrainColliderResult {
+			unsigned num_tiles = 0;
+			size_t cooked_bytes = 0;
+			// Generating and cooking one tile on a streamer worker
+			float mean_tile_ms = 0.f;
+			unsigned num_rays = 0;
+			unsigned num_hits = 0;
+			// Rays through sample positions, only quantization separates these from the analytic height
+			float max_sample_error = 0.f;
+			float mean_sample_error = 0.f;
+			// Rays between samples, also includes the error from the triangles interpolating between samples
+			float max_between_error = 0.f;
+			float mean_between_error = 0.f;
+			float raycast_ms = 0.f;
+			bool passed = false;
+		};
+
+		// Streams TerrainColliders in around the origin, raycasts straight down onto them and compares the hits with TerrainGenerator::GetHeight
+		// Passes if every ray hits and the hits through sample positions are within MAX_TERRAIN_SAMPLE_ERROR
+		TerrainColliderResult RunTerrainColliderCheck();
+
+		static constexpr float MAX_TERRAIN_SAMPLE_ERROR = 0.01f;
+
+		struct HullResult {
+			std::string name;
+			unsigned num_input_vertices = 0;
+			unsigned num_hull_vertices = 0;
+			unsigned num_polygons = 0;
+			float cook_ms = 0.f;
+			// Mass at unit density from PxConvexMesh::getMassInformation
+			float volume = 0.f;
+			float expected_volume = 0.f;
+			// Relative to expected_volume
+			float volume_error = 0.f;
+			// Furthest any hull vertex is in front of one of the hull's own planes, above zero the hull isn't convex
+			float max_convexity_error = 0.f;
+			// Furthest any input vertex is outside the hull, quantizing and the vertex limit both trim hulls a little so this is only reported
+			float max_outside_distance = 0.f;
+			bool passed = false;
+		};
+
+		struct ConvexHullResult {
+			std::vector<HullResult> hulls;
+			bool passed = false;
+		};
+
+		// Cooks hulls with PhysicsSystem::CookConvexHull around a finely tessellated sphere, cylinder and box, whose volumes are known
+		// Passes if every hull cooks within the vertex limit, has no vertex further than MAX_HULL_CONVEXITY_ERROR in front of its own planes and is within MAX_HULL_VOLUME_ERROR of the shape's volume
+		ConvexHullResult RunConvexHullCheck();
+
+		// Relative, a 255 vertex hull around a sphere loses about 3% of its volume even with evenly spread vertices
+		static constexpr float MAX_HULL_VOLUME_ERROR = 0.1f;
+		static constexpr float MAX_HULL_CONVEXITY_ERROR = 1e-3f;
+
+		struct DeterminismResult {
+			unsigned num_steps = 0;
+			unsigned num_bodies = 0;
+			// Frames each run took to get through the steps
+			std::array<unsigned, 2> num_frames{};
+			// Bodies whose final poses aren't bitwise identical between the runs
+			unsigned num_mismatched = 0;
+			float max_position_difference = 0.f;
+			bool passed = false;
+		};
+
+		// Builds the ragdoll pile twice and steps each through NUM_DETERMINISM_STEPS with PhysicsSystem::StepFrame, fed a different random sequence of frame times per run
+		// The substeps left over once a frame could overshoot are run with StepImmediate, passes if every body ends up with an identical pose in both runs
+		DeterminismResult RunDeterminismCheck();
+
+		static constexpr unsigned NUM_DETERMINISM_STEPS = 10'000;
+		// Under the substep limit (4 steps, ~67ms), so no frame time is dropped and both runs simulate the same steps
+		static constexpr float MIN_DETERMINISM_FRAME_MS = 2.f;
+		static constexpr float MAX_DETERMINISM_FRAME_MS = 50.f;
+
+		struct RaycastBatchResult {
+			unsigned num_rays = 0;
+			unsigned num_triangles = 0;
+			unsigned num_hits = 0;
+			float serial_ms = 0.f;
+			float batch_ms = 0.f;
+			// Rays whose RaycastBatch result differs from Raycast's
+			unsigned num_mismatched = 0;
+			bool passed = false;
+		};
+
+		// Casts NUM_BATCH_RAYS random rays at a static triangle mesh level (a bumpy LEVEL_GRID_SIZE^2 quad grid, added as a world actor), once with Raycast per ray and once with RaycastBatch
+		// Passes if every ray gets the same result both ways
+		RaycastBatchResult RunRaycastBatchCheck();
+
+		static constexpr unsigned NUM_BATCH_RAYS = 100'000;
+		static constexpr unsigned LEVEL_GRID_SIZE = 256;
+
+		struct AnimatedScaleResult {
+			unsigned num_entities = 0;
+			unsigned num_steps = 0;
+			// From PhysicsSystem::GetColliderScaleStats over the animated steps
+			unsigned shapes_rescaled = 0;
+			unsigned shapes_rebuilt = 0;
+			// Mean per step, setting every entity's scale (which is when the shapes are updated) then stepping
+			float scale_update_ms = 0.f;
+			float step_ms = 0.f;
+			// The same scene stepped beforehand without any scale changes
+			float baseline_step_ms = 0.f;
+			bool passed = false;
+		};
+
+		// Builds NUM_ANIMATED_SCALE_ENTITIES static, kinematic and dynamic boxes and spheres, then for m_num_steps steps gives every one a new scale before stepping
+		// Passes if every scale change was applied with setGeometry and no collider was rebuilt
+		AnimatedScaleResult RunAnimatedScaleCheck();
+
+		static constexpr unsigned NUM_ANIMATED_SCALE_ENTITIES = 1000;
+
+		struct PipelinedModeResult {
+			unsigned num_steps = 0;
+			// Whole frames, StepFrame followed by the render work
+			float mean_frame_ms = 0.f;
+			float p95_frame_ms = 0.f;
+			// StepFrame on its own, pipelined this only waits for the previous frame's step
+			float mean_step_frame_ms = 0.f;
+		};
+
+		struct PipelinedSteppingResult {
+			unsigned num_bodies = 0;
+			unsigned num_frames = 0;
+			float render_work_ms = 0.f;
+			PipelinedModeResult sync;
+			PipelinedModeResult pipelined;
+			// Bodies whose final poses aren't bitwise identical between the runs
+			unsigned num_mismatched = 0;
+			bool passed = false;
+		};
+
+		// Builds NUM_PIPELINED_BODIES dynamic boxes twice and runs m_num_steps frames of one step each, every frame a StepFrame followed by PIPELINED_RENDER_WORK_MS of busy work on this thread standing in for rendering
+		// The first run steps synchronously, the second with SetPipelinedStepping so the step runs alongside the render work
+		// Passes if both runs take the same steps and end with identical poses, the frame times aren't checked
+		PipelinedSteppingResult RunPipelinedSteppingCheck();
+
+		static constexpr unsigned NUM_PIPELINED_BODIES = 5000;
+		static constexpr float PIPELINED_RENDER_WORK_MS = 4.f;
+
+		struct WriteBackResult {
+			unsigned num_bodies = 0;
+			unsigned num_steps = 0;
+			// Mean per step, every body spins so all of them should be written every step
+			float mean_transforms_written = 0.f;
+			// Pose write-back including the PhysicsMovedEvent listeners, euler angles are only converted when read
+			float write_back_ms = 0.f;
+			// Write-back followed by reading every body's orientation, what every step cost when SetPhysicsPose converted the euler angles itself
+			float write_back_with_euler_ms = 0.f;
+			// Largest distance between an axis rotated by a body's actor pose and by the rotation its euler angles give once read
+			float max_orientation_error = 0.f;
+			bool passed = false;
+		};
+
+		// Spins NUM_WRITE_BACK_BODIES dynamic boxes in place without gravity so every pose is written back every step, for m_num_steps steps timing write-back alone, then m_num_steps more also reading every orientation
+		// Passes if every body was written every step and the orientations read back match the actors within MAX_WRITE_BACK_ORIENTATION_ERROR
+		WriteBackResult RunWriteBackCheck();
+
+		static constexpr unsigned NUM_WRITE_BACK_BODIES = 5000;
+		// glm::eulerAngles takes an asin of the pitch, which loses precision close to +-90 degrees
+		static constexpr float MAX_WRITE_BACK_ORIENTATION_ERROR = 1e-3f;
+
+		static SceneEntity& CreateBody(Scene& scene, glm::vec3 pos, glm::vec3 scale, PhysicsComponent::RigidBodyType type, PhysicsComponent::GeometryType geometry = PhysicsComponent::BOX, bool is_trigger = false);
+
+		// Connects "a0" to "a1" with a joint that can swing and twist freely, both need physics components
+		static void CreateJoint(SceneEntity& a0, SceneEntity& a1);
+
+		// Large static box every scenario is built on
+		static void CreateGround(Scene& scene);
+
+		void BuildStacking(Scene& scene);
+		void BuildRagdollPile(Scene& scene);
+		void BuildVehicles(Scene& scene);
+		void BuildTriggers(Scene& scene);
+		void BuildJointChains(Scene& scene);
+
+		// m_num_traffic_vehicles DirectDrive vehicles driving in circles, run with serial and parallel vehicle stepping for comparison
+		void BuildVehicleTraffic(Scene& scene);
+
+		static constexpr std::array<Scenario, 7> SCENARIOS = { {
+			{ "stacking", &PhysicsBenchLayer::BuildStacking },
+			{ "ragdoll_pile", &PhysicsBenchLayer::BuildRagdollPile },
+			{ "vehicles", &PhysicsBenchLayer::BuildVehicles },
+			{ "triggers", &PhysicsBenchLayer::BuildTriggers },
+			{ "joint_chains", &PhysicsBenchLayer::BuildJointChains },
+			{ "vehicle_traffic_serial", &PhysicsBenchLayer::BuildVehicleTraffic, false },
+			{ "vehicle_traffic_parallel", &PhysicsBenchLayer::BuildVehicleTraffic, true },
+		} };
+
+		std::string m_output_path;
+		unsigned m_num_steps;
+		unsigned m_num_traffic_vehicles;
+
+		unsigned m_next_scenario = 0;
+		std::vector<ScenarioResult> m_results;
+		TerrainColliderResult m_terrain_collider_result;
+		ConvexHullResult m_convex_hull_result;
+		DeterminismResult m_determinism_result;
+		RaycastBatchResult m_raycast_batch_result;
+		AnimatedScaleResult m_animated_scale_result;
+		PipelinedSteppingResult m_pipelined_stepping_result;
+		WriteBackResult m_write_back_result;
+	};
+}
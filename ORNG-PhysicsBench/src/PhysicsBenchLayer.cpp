@@ -0,0 +1,992 @@
+#include "PhysicsBenchLayer.h"
+#include <glfw/glfw3.h>
+#include <numeric>
+#include "assets/AssetManager.h"
+#include "assets/PhysXMaterialAsset.h"
+#include "terrain/TerrainColliders.h"
+
+namespace ORNG {
+	using namespace physx;
+
+	void PhysicsBenchLayer::OnInit() {
+		// The asset manager module is disabled, physics components fall back to the base material so it has to exist
+		auto* p_material = new PhysXMaterialAsset("BASE");
+		p_material->uuid = UUID<uint64_t>(ORNG_BASE_PHYSX_MATERIAL_ID);
+		p_material->p_material = Physics::GetPhysics()->createMaterial(0.75f, 0.75f, 0.6f);
+		AssetManager::AddAsset(p_material);
+
+		ORNG_CORE_INFO("Physics bench: {0} scenarios, {1} steps each", SCENARIOS.size(), m_num_steps);
+	}
+
+
+
+	void PhysicsBenchLayer::Update() {
+		if (m_next_scenario == SCENARIOS.size())
+			return;
+
+		// One scenario per frame so the window stays responsive between them
+		m_results.push_back(RunScenario(SCENARIOS[m_next_scenario++]));
+
+		if (m_next_scenario == SCENARIOS.size()) {
+			m_terrain_collider_result = RunTerrainColliderCheck();
+			m_convex_hull_result = RunConvexHullCheck();
+			m_determinism_result = RunDeterminismCheck();
+			m_raycast_batch_result = RunRaycastBatchCheck();
+			m_animated_scale_result = RunAnimatedScaleCheck();
+			m_pipelined_stepping_result = RunPipelinedSteppingCheck();
+			m_write_back_result = RunWriteBackCheck();
+			WriteResults();
+			glfwSetWindowShouldClose(Window::GetGLFWwindow(), true);
+		}
+	}
+
+
+
+	PhysicsBenchLayer::ScenarioResult PhysicsBenchLayer::RunScenario(const Scenario& scenario) {
+		ScenarioResult result;
+		result.name = scenario.name;
+
+		auto p_scene = std::make_unique<Scene>();
+		p_scene->AddSystem(new PhysicsSystem{ &*p_scene });
+		p_scene->AddSystem(new TransformHierarchySystem{ &*p_scene });
+		p_scene->LoadScene();
+
+		auto& physics = p_scene->GetSystem<PhysicsSystem>();
+		physics.SetParallelVehicleStepping(scenario.parallel_vehicle_stepping);
+
+		(this->*scenario.build)(*p_scene);
+
+		auto& reg = p_scene->GetRegistry();
+		for (auto [entity, comp] : reg.view<PhysicsComponent>().each()) {
+			result.num_bodies++;
+		}
+
+		for (auto [entity, comp] : reg.view<VehicleComponent>().each()) {
+			result.num_bodies++;
+		}
+
+		for (auto [entity, comp] : reg.view<JointComponent>().each()) {
+			for (auto& [p_joint, attachment] : comp.attachments) {
+				// Each joint is in the attachments of both entities, only count it from its owner
+				if (p_joint->GetA0() == comp.GetEntity())
+					result.num_joints++;
+			}
+		}
+
+		physics.StepImmediate(NUM_WARMUP_STEPS);
+
+		result.step_times_ms.reserve(m_num_steps);
+		for (unsigned i = 0; i < m_num_steps; i++) {
+			auto start = std::chrono::steady_clock::now();
+			physics.StepImmediate(1);
+			auto end = std::chrono::steady_clock::now();
+
+			result.step_times_ms.push_back(std::chrono::duration<float, std::milli>(end - start).count());
+
+			auto& stats = physics.GetContactStats();
+			result.contact_totals.pairs_filtered += stats.pairs_filtered;
+			result.contact_totals.contact_pairs += stats.contact_pairs;
+			result.contact_totals.touching_pairs += stats.touching_pairs;
+			result.contact_totals.reported_contacts += stats.reported_contacts;
+			result.contact_totals.reported_triggers += stats.reported_triggers;
+		}
+
+		result.final_actor_stats = physics.GetActorStats();
+
+		float total_ms = std::accumulate(result.step_times_ms.begin(), result.step_times_ms.end(), 0.f);
+		ORNG_CORE_INFO("Physics bench '{0}': {1} bodies, {2} joints, {3:.3f}ms mean step", result.name, result.num_bodies, result.num_joints, total_ms / glm::max(m_num_steps, 1u));
+
+		return result;
+	}
+
+
+
+	PhysicsBenchLayer::TerrainColliderResult PhysicsBenchLayer::RunTerrainColliderCheck() {
+		TerrainColliderResult result;
+		constexpr unsigned seed = 123;
+		// Terrain's defaults
+		constexpr float height_scale = 1.5f;
+
+		auto p_scene = std::make_unique<Scene>();
+		p_scene->AddSystem(new PhysicsSystem{ &*p_scene });
+		p_scene->LoadScene();
+		auto& physics = p_scene->GetSystem<PhysicsSystem>();
+
+		TerrainColliders::Settings settings;
+		TerrainColliders colliders{ seed, height_scale, settings };
+		colliders.Update(glm::vec3(0), physics);
+		colliders.WaitForTiles(physics);
+
+		auto stats = colliders.GetStats();
+		result.num_tiles = stats.loaded_tiles;
+		result.cooked_bytes = stats.cooked_bytes;
+		result.mean_tile_ms = stats.streaming.mean_generation_ms;
+
+		// Grid of rays inside the load radius, each on a sample position and offset to land between samples
+		constexpr int rays_per_side = 64;
+		constexpr float ray_height = 1000.f;
+		const float spacing = static_cast<float>(settings.sample_spacing);
+		const float grid_step = spacing * 3.f;
+		const float grid_start = -grid_step * rays_per_side * 0.5f;
+
+		std::vector<RaycastQuery> queries;
+		std::vector<bool> is_sample_position;
+		for (int x = 0; x < rays_per_side; x++) {
+			for (int z = 0; z < rays_per_side; z++) {
+				glm::vec2 pos{ grid_start + x * grid_step, grid_start + z * grid_step };
+				for (glm::vec2 offset : { glm::vec2(0.f), glm::vec2(0.37f, 0.71f) * spacing }) {
+					queries.push_back(RaycastQuery{ glm::vec3(pos.x + offset.x, ray_height, pos.y + offset.y), glm::vec3(0, -1, 0), ray_height * 2.f });
+					is_sample_position.push_back(offset == glm::vec2(0.f));
+				}
+			}
+		}
+
+		std::vector<RaycastResults> hits(queries.size());
+		auto start = std::chrono::steady_clock::now();
+		physics.RaycastBatch(queries, hits);
+		result.raycast_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		unsigned num_sample_hits = 0;
+		unsigned num_between_hits = 0;
+		for (size_t i = 0; i < queries.size(); i++) {
+			result.num_rays++;
+			if (!hits[i].hit)
+				continue;
+
+			result.num_hits++;
+			const glm::vec3 origin = queries[i].origin;
+			const float error = glm::abs(hits[i].hit_pos.y - TerrainGenerator::GetHeight(seed, height_scale, origin.x, origin.z));
+
+			if (is_sample_position[i]) {
+				result.max_sample_error = glm::max(result.max_sample_error, error);
+				result.mean_sample_error += error;
+				num_sample_hits++;
+			}
+			else {
+				result.max_between_error = glm::max(result.max_between_error, error);
+				result.mean_between_error += error;
+				num_between_hits++;
+			}
+		}
+
+		result.mean_sample_error /= glm::max(num_sample_hits, 1u);
+		result.mean_between_error /= glm::max(num_between_hits, 1u);
+		result.passed = result.num_hits == result.num_rays && result.max_sample_error <= MAX_TERRAIN_SAMPLE_ERROR;
+
+		// Tiles have to leave the physics scene before it's released
+		colliders.Clear();
+
+		if (result.passed)
+			ORNG_CORE_INFO("Terrain colliders: {0} tiles, {1}/{2} rays hit, max error {3} at samples and {4} between them", result.num_tiles, result.num_hits, result.num_rays, result.max_sample_error, result.max_between_error);
+		else
+			ORNG_CORE_ERROR("Terrain collider check failed: {0}/{1} rays hit, max error {2} at samples (limit {3})", result.num_hits, result.num_rays, result.max_sample_error, MAX_TERRAIN_SAMPLE_ERROR);
+
+		return result;
+	}
+
+
+
+	PhysicsBenchLayer::ConvexHullResult PhysicsBenchLayer::RunConvexHullCheck() {
+		ConvexHullResult result;
+
+		struct HullInput {
+			const char* name;
+			std::vector<float> positions;
+			float expected_volume;
+		};
+
+		auto push = [](std::vector<float>& positions, glm::vec3 p) { positions.insert(positions.end(), { p.x, p.y, p.z }); };
+		std::vector<HullInput> inputs;
+
+		// Unit sphere, over 2000 vertices so it's quantized and hits the vertex limit
+		{
+			auto& sphere = inputs.emplace_back(HullInput{ "sphere", {}, 4.f / 3.f * glm::pi<float>() });
+			constexpr int rings = 32;
+			constexpr int segments = 64;
+			for (int r = 0; r <= rings; r++) {
+				const float phi = glm::pi<float>() * r / rings;
+				// Poles are a single vertex
+				const int ring_segments = r == 0 || r == rings ? 1 : segments;
+				for (int s = 0; s < ring_segments; s++) {
+					const float theta = glm::two_pi<float>() * s / segments;
+					push(sphere.positions, { glm::sin(phi) * glm::cos(theta), glm::cos(phi), glm::sin(phi) * glm::sin(theta) });
+				}
+			}
+		}
+
+		// Radius 0.5, height 2, with rings along its side the hull should discard, a 64-sided prism is within 0.2% of the cylinder's volume
+		{
+			constexpr float radius = 0.5f;
+			constexpr float height = 2.f;
+			constexpr int segments = 64;
+			auto& cylinder = inputs.emplace_back(HullInput{ "cylinder", {}, segments * 0.5f * glm::sin(glm::two_pi<float>() / segments) * radius * radius * height });
+			for (int h = 0; h <= 4; h++) {
+				for (int s = 0; s < segments; s++) {
+					const float theta = glm::two_pi<float>() * s / segments;
+					push(cylinder.positions, { glm::cos(theta) * radius, height * (h / 4.f - 0.5f), glm::sin(theta) * radius });
+				}
+			}
+		}
+
+		// 2x1x0.5 box sampled over its whole volume, only the corners belong on the hull
+		{
+			auto& box = inputs.emplace_back(HullInput{ "box", {}, 2.f * 1.f * 0.5f });
+			for (int x = 0; x <= 8; x++) {
+				for (int y = 0; y <= 8; y++) {
+					for (int z = 0; z <= 8; z++) {
+						push(box.positions, glm::vec3(x, y, z) / 8.f * glm::vec3(2.f, 1.f, 0.5f) - glm::vec3(1.f, 0.5f, 0.25f));
+					}
+				}
+			}
+		}
+
+		result.passed = true;
+		for (auto& input : inputs) {
+			HullResult& hull = result.hulls.emplace_back();
+			hull.name = input.name;
+			hull.num_input_vertices = static_cast<unsigned>(input.positions.size() / 3);
+			hull.expected_volume = input.expected_volume;
+
+			auto start = std::chrono::steady_clock::now();
+			PxConvexMesh* p_mesh = PhysicsSystem::CookConvexHull(input.positions);
+			hull.cook_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			if (!p_mesh) {
+				ORNG_CORE_ERROR("Convex hull check: '{0}' failed to cook", hull.name);
+				result.passed = false;
+				continue;
+			}
+
+			hull.num_hull_vertices = p_mesh->getNbVertices();
+			hull.num_polygons = p_mesh->getNbPolygons();
+
+			PxReal mass;
+			PxMat33 local_inertia;
+			PxVec3 local_com;
+			p_mesh->getMassInformation(mass, local_inertia, local_com);
+			hull.volume = mass;
+			hull.volume_error = glm::abs(hull.volume - hull.expected_volume) / hull.expected_volume;
+
+			const PxVec3* p_vertices = p_mesh->getVertices();
+			for (PxU32 i = 0; i < hull.num_polygons; i++) {
+				PxHullPolygon polygon;
+				p_mesh->getPolygonData(i, polygon);
+				const PxVec3 normal{ polygon.mPlane[0], polygon.mPlane[1], polygon.mPlane[2] };
+
+				for (PxU32 v = 0; v < hull.num_hull_vertices; v++) {
+					hull.max_convexity_error = glm::max(hull.max_convexity_error, normal.dot(p_vertices[v]) + polygon.mPlane[3]);
+				}
+
+				for (size_t v = 0; v < input.positions.size(); v += 3) {
+					const PxVec3 p{ input.positions[v], input.positions[v + 1], input.positions[v + 2] };
+					hull.max_outside_distance = glm::max(hull.max_outside_distance, normal.dot(p) + polygon.mPlane[3]);
+				}
+			}
+
+			p_mesh->release();
+
+			// A closed hull needs at least a tetrahedron's worth of faces
+			hull.passed = hull.num_hull_vertices >= 4 && hull.num_hull_vertices <= 255 && hull.num_polygons >= 4 &&
+				hull.max_convexity_error <= MAX_HULL_CONVEXITY_ERROR && hull.volume_error <= MAX_HULL_VOLUME_ERROR;
+			result.passed &= hull.passed;
+
+			if (hull.passed)
+				ORNG_CORE_INFO("Convex hull '{0}': {1} -> {2} vertices, {3} polygons, volume error {4}", hull.name, hull.num_input_vertices, hull.num_hull_vertices, hull.num_polygons, hull.volume_error);
+			else
+				ORNG_CORE_ERROR("Convex hull check failed for '{0}': {1} vertices, {2} polygons, volume error {3} (limit {4}), convexity error {5} (limit {6})",
+					hull.name, hull.num_hull_vertices, hull.num_polygons, hull.volume_error, MAX_HULL_VOLUME_ERROR, hull.max_convexity_error, MAX_HULL_CONVEXITY_ERROR);
+		}
+
+		return result;
+	}
+
+
+
+	PhysicsBenchLayer::DeterminismResult PhysicsBenchLayer::RunDeterminismCheck() {
+		DeterminismResult result;
+		result.num_steps = NUM_DETERMINISM_STEPS;
+
+		std::array<std::vector<PxTransform>, 2> final_poses;
+
+		for (unsigned run = 0; run < 2; run++) {
+			auto p_scene = std::make_unique<Scene>();
+			p_scene->AddSystem(new PhysicsSystem{ &*p_scene });
+			p_scene->AddSystem(new TransformHierarchySystem{ &*p_scene });
+			p_scene->LoadScene();
+			auto& physics = p_scene->GetSystem<PhysicsSystem>();
+
+			BuildRagdollPile(*p_scene);
+
+			std::mt19937 rng{ run + 1 };
+			std::uniform_real_distribution<float> frame_time_dist{ MIN_DETERMINISM_FRAME_MS, MAX_DETERMINISM_FRAME_MS };
+
+			unsigned num_steps = 0;
+			while (num_steps + physics.GetMaxSubsteps() < NUM_DETERMINISM_STEPS) {
+				num_steps += physics.StepFrame(frame_time_dist(rng));
+				result.num_frames[run]++;
+			}
+
+			physics.StepImmediate(NUM_DETERMINISM_STEPS - num_steps);
+
+			// Both scenes were built the same way, so their views are in the same order
+			for (auto [entity, comp] : p_scene->GetRegistry().view<PhysicsComponent>().each()) {
+				final_poses[run].push_back(comp.p_rigid_actor->getGlobalPose());
+			}
+		}
+
+		result.num_bodies = static_cast<unsigned>(final_poses[0].size());
+		for (size_t i = 0; i < final_poses[0].size(); i++) {
+			const PxTransform& a = final_poses[0][i];
+			const PxTransform& b = final_poses[1][i];
+			if (std::memcmp(&a, &b, sizeof(PxTransform)) != 0)
+				result.num_mismatched++;
+
+			result.max_position_difference = glm::max(result.max_position_difference, (a.p - b.p).magnitude());
+		}
+
+		result.passed = final_poses[0].size() == final_poses[1].size() && result.num_mismatched == 0;
+
+		if (result.passed)
+			ORNG_CORE_INFO("Determinism check: {0} bodies identical after {1} steps over {2} and {3} frames", result.num_bodies, result.num_steps, result.num_frames[0], result.num_frames[1]);
+		else
+			ORNG_CORE_ERROR("Determinism check failed: {0}/{1} bodies differ after {2} steps, max position difference {3}", result.num_mismatched, result.num_bodies, result.num_steps, result.max_position_difference);
+
+		return result;
+	}
+
+
+
+	PhysicsBenchLayer::RaycastBatchResult PhysicsBenchLayer::RunRaycastBatchCheck() {
+		RaycastBatchResult result;
+		result.num_rays = NUM_BATCH_RAYS;
+
+		auto p_scene = std::make_unique<Scene>();
+		p_scene->AddSystem(new PhysicsSystem{ &*p_scene });
+		p_scene->LoadScene();
+		auto& physics = p_scene->GetSystem<PhysicsSystem>();
+
+		// Rolling hills centred on the origin, one unit per quad
+		constexpr unsigned verts_per_side = LEVEL_GRID_SIZE + 1;
+		constexpr float half_size = LEVEL_GRID_SIZE * 0.5f;
+		std::vector<PxVec3> vertices;
+		std::vector<PxU32> indices;
+		vertices.reserve(verts_per_side * verts_per_side);
+		indices.reserve(LEVEL_GRID_SIZE * LEVEL_GRID_SIZE * 6);
+
+		for (unsigned z = 0; z < verts_per_side; z++) {
+			for (unsigned x = 0; x < verts_per_side; x++) {
+				const float fx = x - half_size;
+				const float fz = z - half_size;
+				vertices.emplace_back(fx, 3.f * glm::sin(fx * 0.1f) * glm::cos(fz * 0.13f), fz);
+			}
+		}
+
+		for (unsigned z = 0; z < LEVEL_GRID_SIZE; z++) {
+			for (unsigned x = 0; x < LEVEL_GRID_SIZE; x++) {
+				const PxU32 i = z * verts_per_side + x;
+				indices.insert(indices.end(), { i, i + verts_per_side, i + 1, i + 1, i + verts_per_side, i + verts_per_side + 1 });
+			}
+		}
+
+		result.num_triangles = static_cast<unsigned>(indices.size() / 3);
+
+		PxTriangleMeshDesc desc;
+		desc.points.count = static_cast<PxU32>(vertices.size());
+		desc.points.stride = sizeof(PxVec3);
+		desc.points.data = vertices.data();
+		desc.triangles.count = result.num_triangles;
+		desc.triangles.stride = sizeof(PxU32) * 3;
+		desc.triangles.data = indices.data();
+
+		PxDefaultMemoryOutputStream stream;
+		if (!PxCookTriangleMesh(PxCookingParams(PxTolerancesScale(1.f)), desc, stream)) {
+			ORNG_CORE_ERROR("Raycast batch check failed: couldn't cook the level mesh");
+			return result;
+		}
+
+		PxDefaultMemoryInputData input{ stream.getData(), stream.getSize() };
+		PxTriangleMesh* p_mesh = Physics::GetPhysics()->createTriangleMesh(input);
+		PxShape* p_shape = Physics::GetPhysics()->createShape(PxTriangleMeshGeometry(p_mesh), *AssetManager::GetAsset<PhysXMaterialAsset>(ORNG_BASE_PHYSX_MATERIAL_ID)->p_material, true);
+		PxRigidStatic* p_level = PxCreateStatic(*Physics::GetPhysics(), PxTransform(PxIdentity), *p_shape);
+		physics.AddWorldActor(p_level);
+
+		// Rays start above the level and point down at random angles, some leave the level's bounds and miss
+		std::mt19937 rng{ 34 };
+		std::uniform_real_distribution<float> pos_dist{ -half_size, half_size };
+		std::uniform_real_distribution<float> dir_dist{ -1.f, 1.f };
+
+		std::vector<RaycastQuery> queries(NUM_BATCH_RAYS);
+		for (auto& query : queries) {
+			query.origin = { pos_dist(rng), 20.f, pos_dist(rng) };
+			query.unit_dir = glm::normalize(glm::vec3(dir_dist(rng), -1.f, dir_dist(rng)));
+			query.max_distance = 100.f;
+		}
+
+		std::vector<RaycastResults> serial_results(NUM_BATCH_RAYS);
+		std::vector<RaycastResults> batch_results(NUM_BATCH_RAYS);
+
+		auto start = std::chrono::steady_clock::now();
+		for (unsigned i = 0; i < NUM_BATCH_RAYS; i++) {
+			serial_results[i] = physics.Raycast(queries[i].origin, queries[i].unit_dir, queries[i].max_distance, queries[i].layer_mask);
+		}
+		result.serial_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		start = std::chrono::steady_clock::now();
+		physics.RaycastBatch(queries, batch_results);
+		result.batch_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		for (unsigned i = 0; i < NUM_BATCH_RAYS; i++) {
+			const auto& serial = serial_results[i];
+			const auto& batch = batch_results[i];
+			result.num_hits += serial.hit;
+
+			// Same PhysX query either way, so the results should match exactly
+			if (serial.hit != batch.hit || (serial.hit && (serial.hit_pos != batch.hit_pos || serial.hit_normal != batch.hit_normal || serial.hit_dist != batch.hit_dist)))
+				result.num_mismatched++;
+		}
+
+		result.passed = result.num_mismatched == 0;
+
+		physics.RemoveWorldActor(p_level);
+		p_level->release();
+		p_shape->release();
+		p_mesh->release();
+
+		if (result.passed)
+			ORNG_CORE_INFO("Raycast batch check: {0} rays ({1} hits) against {2} triangles, {3}ms serial, {4}ms batched", result.num_rays, result.num_hits, result.num_triangles, result.serial_ms, result.batch_ms);
+		else
+			ORNG_CORE_ERROR("Raycast batch check failed: {0}/{1} batched results differ from Raycast", result.num_mismatched, result.num_rays);
+
+		return result;
+	}
+
+
+
+	PhysicsBenchLayer::AnimatedScaleResult PhysicsBenchLayer::RunAnimatedScaleCheck() {
+		AnimatedScaleResult result;
+		result.num_entities = NUM_ANIMATED_SCALE_ENTITIES;
+		result.num_steps = m_num_steps;
+
+		auto p_scene = std::make_unique<Scene>();
+		p_scene->AddSystem(new PhysicsSystem{ &*p_scene });
+		p_scene->AddSystem(new TransformHierarchySystem{ &*p_scene });
+		p_scene->LoadScene();
+		auto& physics = p_scene->GetSystem<PhysicsSystem>();
+
+		CreateGround(*p_scene);
+
+		// Spread out on a grid so the dynamic ones mostly sit on the ground rather than piling up
+		constexpr unsigned grid_size = 32;
+		constexpr float spacing = 3.f;
+		std::vector<TransformComponent*> transforms;
+		transforms.reserve(NUM_ANIMATED_SCALE_ENTITIES);
+		for (unsigned i = 0; i < NUM_ANIMATED_SCALE_ENTITIES; i++) {
+			glm::vec3 pos{ (i % grid_size) * spacing - grid_size * spacing * 0.5f, 1.f, (i / grid_size) * spacing - grid_size * spacing * 0.5f };
+			auto type = static_cast<PhysicsComponent::RigidBodyType>(i % 3);
+			auto geometry = i % 2 == 0 ? PhysicsComponent::BOX : PhysicsComponent::SPHERE;
+			transforms.push_back(CreateBody(*p_scene, pos, glm::vec3(1.f), type, geometry).GetComponent<TransformComponent>());
+		}
+
+		physics.StepImmediate(NUM_WARMUP_STEPS);
+
+		auto start = std::chrono::steady_clock::now();
+		physics.StepImmediate(m_num_steps);
+		result.baseline_step_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() / glm::max(m_num_steps, 1u);
+
+		const auto stats_before = physics.GetColliderScaleStats();
+		float total_scale_update_ms = 0.f;
+		float total_step_ms = 0.f;
+
+		for (unsigned step = 0; step < m_num_steps; step++) {
+			start = std::chrono::steady_clock::now();
+			for (unsigned i = 0; i < NUM_ANIMATED_SCALE_ENTITIES; i++) {
+				// Every entity pulses out of phase with its neighbours, non-uniformly so boxes change shape as well as size
+				const float t = step * 0.1f + i * 0.37f;
+				transforms[i]->SetAbsoluteScale(glm::vec3(1.f + 0.25f * glm::sin(t), 1.f + 0.25f * glm::cos(t), 1.f + 0.25f * glm::sin(t * 0.5f)));
+			}
+			auto end = std::chrono::steady_clock::now();
+			total_scale_update_ms += std::chrono::duration<float, std::milli>(end - start).count();
+
+			physics.StepImmediate(1);
+			total_step_ms += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - end).count();
+		}
+
+		const auto& stats_after = physics.GetColliderScaleStats();
+		result.shapes_rescaled = stats_after.shapes_rescaled - stats_before.shapes_rescaled;
+		result.shapes_rebuilt = stats_after.shapes_rebuilt - stats_before.shapes_rebuilt;
+		result.scale_update_ms = total_scale_update_ms / glm::max(m_num_steps, 1u);
+		result.step_ms = total_step_ms / glm::max(m_num_steps, 1u);
+
+		result.passed = result.shapes_rebuilt == 0 && result.shapes_rescaled == NUM_ANIMATED_SCALE_ENTITIES * m_num_steps;
+
+		if (result.passed)
+			ORNG_CORE_INFO("Animated scale check: {0} shapes rescaled in place over {1} steps, {2:.3f}ms scale updates + {3:.3f}ms step (baseline {4:.3f}ms)",
+				result.shapes_rescaled, result.num_steps, result.scale_update_ms, result.step_ms, result.baseline_step_ms);
+		else
+			ORNG_CORE_ERROR("Animated scale check failed: {0} shapes rebuilt and {1} rescaled, expected {2} rescaled", result.shapes_rebuilt, result.shapes_rescaled, NUM_ANIMATED_SCALE_ENTITIES * m_num_steps);
+
+		return result;
+	}
+
+
+
+	PhysicsBenchLayer::PipelinedSteppingResult PhysicsBenchLayer::RunPipelinedSteppingCheck() {
+		PipelinedSteppingResult result;
+		result.num_frames = m_num_steps;
+		result.render_work_ms = PIPELINED_RENDER_WORK_MS;
+
+		// Exactly one step per frame, so the accumulator never drifts and both runs take the same steps
+		const float frame_time_ms = PhysicsSystem::GetStepSize() * 1000.f;
+		std::array<std::vector<PxTransform>, 2> final_poses;
+
+		for (unsigned run = 0; run < 2; run++) {
+			auto& mode = run == 0 ? result.sync : result.pipelined;
+
+			auto p_scene = std::make_unique<Scene>();
+			p_scene->AddSystem(new PhysicsSystem{ &*p_scene });
+			p_scene->AddSystem(new TransformHierarchySystem{ &*p_scene });
+			p_scene->LoadScene();
+			auto& physics = p_scene->GetSystem<PhysicsSystem>();
+
+			CreateGround(*p_scene);
+
+			// 625 towers of 8 unit cubes
+			const unsigned towers_per_side = 25;
+			const unsigned tower_height = NUM_PIPELINED_BODIES / (towers_per_side * towers_per_side);
+			for (unsigned i = 0; i < NUM_PIPELINED_BODIES; i++) {
+				const unsigned tower = i / tower_height;
+				CreateBody(*p_scene, { (tower % towers_per_side) * 2.f, 0.5f + (i % tower_height) * 1.01f, (tower / towers_per_side) * 2.f }, glm::vec3(1), PhysicsComponent::DYNAMIC);
+			}
+
+			physics.StepImmediate(NUM_WARMUP_STEPS);
+			physics.SetPipelinedStepping(run == 1);
+
+			std::vector<float> frame_times_ms;
+			frame_times_ms.reserve(m_num_steps);
+			float total_step_frame_ms = 0.f;
+
+			for (unsigned frame = 0; frame < m_num_steps; frame++) {
+				auto start = std::chrono::steady_clock::now();
+				mode.num_steps += physics.StepFrame(frame_time_ms);
+				auto step_end = std::chrono::steady_clock::now();
+
+				// Spins rather than sleeps, a render thread submitting draws keeps its core busy
+				const auto render_end = step_end + std::chrono::duration<float, std::milli>(PIPELINED_RENDER_WORK_MS);
+				while (std::chrono::steady_clock::now() < render_end) {}
+
+				total_step_frame_ms += std::chrono::duration<float, std::milli>(step_end - start).count();
+				frame_times_ms.push_back(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count());
+			}
+
+			// Fetches the step the last frame left in flight
+			physics.SetPipelinedStepping(false);
+
+			std::ranges::sort(frame_times_ms);
+			mode.mean_frame_ms = frame_times_ms.empty() ? 0.f : std::accumulate(frame_times_ms.begin(), frame_times_ms.end(), 0.f) / frame_times_ms.size();
+			mode.p95_frame_ms = frame_times_ms.empty() ? 0.f : frame_times_ms[static_cast<size_t>(0.95f * (frame_times_ms.size() - 1))];
+			mode.mean_step_frame_ms = total_step_frame_ms / glm::max(m_num_steps, 1u);
+
+			// Both scenes were built the same way, so their views are in the same order
+			for (auto [entity, comp] : p_scene->GetRegistry().view<PhysicsComponent>().each()) {
+				final_poses[run].push_back(comp.p_rigid_actor->getGlobalPose());
+			}
+		}
+
+		result.num_bodies = static_cast<unsigned>(final_poses[0].size());
+		for (size_t i = 0; i < glm::min(final_poses[0].size(), final_poses[1].size()); i++) {
+			if (std::memcmp(&final_poses[0][i], &final_poses[1][i], sizeof(PxTransform)) != 0)
+				result.num_mismatched++;
+		}
+
+		result.passed = result.sync.num_steps == result.pipelined.num_steps && final_poses[0].size() == final_poses[1].size() && result.num_mismatched == 0;
+
+		if (result.passed)
+			ORNG_CORE_INFO("Pipelined stepping check: {0} bodies, {1:.3f}ms mean frame synchronous, {2:.3f}ms pipelined with {3}ms of render work",
+				result.num_bodies, result.sync.mean_frame_ms, result.pipelined.mean_frame_ms, result.render_work_ms);
+		else
+			ORNG_CORE_ERROR("Pipelined stepping check failed: {0} and {1} steps, {2}/{3} bodies differ", result.sync.num_steps, result.pipelined.num_steps, result.num_mismatched, result.num_bodies);
+
+		return result;
+	}
+
+
+
+	PhysicsBenchLayer::WriteBackResult PhysicsBenchLayer::RunWriteBackCheck() {
+		WriteBackResult result;
+		result.num_steps = m_num_steps;
+
+		auto p_scene = std::make_unique<Scene>();
+		p_scene->AddSystem(new PhysicsSystem{ &*p_scene });
+		p_scene->AddSystem(new TransformHierarchySystem{ &*p_scene });
+		p_scene->LoadScene();
+		auto& physics = p_scene->GetSystem<PhysicsSystem>();
+
+		// Far enough apart that no boxes touch, every step's cost is integration and write-back
+		const unsigned grid_size = static_cast<unsigned>(glm::ceil(glm::sqrt(static_cast<float>(NUM_WRITE_BACK_BODIES))));
+		const float spacing = 3.f;
+		std::mt19937 rng{ 5 };
+		std::uniform_real_distribution<float> spin_dist{ -5.f, 5.f };
+
+		std::vector<TransformComponent*> transforms;
+		transforms.reserve(NUM_WRITE_BACK_BODIES);
+		for (unsigned i = 0; i < NUM_WRITE_BACK_BODIES; i++) {
+			auto& ent = CreateBody(*p_scene, { (i % grid_size) * spacing, 10.f, (i / grid_size) * spacing }, glm::vec3(1), PhysicsComponent::DYNAMIC);
+			auto* p_dynamic = ent.GetComponent<PhysicsComponent>()->p_rigid_actor->is<PxRigidDynamic>();
+			p_dynamic->setActorFlag(PxActorFlag::eDISABLE_GRAVITY, true);
+			p_dynamic->setAngularDamping(0.f);
+			p_dynamic->setSleepThreshold(0.f);
+			p_dynamic->setAngularVelocity({ spin_dist(rng), spin_dist(rng), spin_dist(rng) });
+			transforms.push_back(ent.GetComponent<TransformComponent>());
+		}
+
+		result.num_bodies = NUM_WRITE_BACK_BODIES;
+		physics.StepImmediate(NUM_WARMUP_STEPS);
+
+		unsigned total_written = 0;
+		float total_write_back_ms = 0.f;
+		for (unsigned step = 0; step < m_num_steps; step++) {
+			physics.StepImmediate(1);
+			total_write_back_ms += physics.GetWriteBackStats().write_back_ms;
+			total_written += physics.GetWriteBackStats().transforms_written;
+		}
+
+		float total_with_euler_ms = 0.f;
+		for (unsigned step = 0; step < m_num_steps; step++) {
+			physics.StepImmediate(1);
+
+			// Reading the orientation converts it, as SetPhysicsPose used to for every body
+			auto start = std::chrono::steady_clock::now();
+			glm::vec3 orientation_sum{ 0.f };
+			for (auto* p_transform : transforms) {
+				orientation_sum += p_transform->GetOrientation();
+			}
+
+			total_with_euler_ms += physics.GetWriteBackStats().write_back_ms + std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+			total_written += physics.GetWriteBackStats().transforms_written;
+
+			// Keeps the reads from being optimized out
+			if (glm::any(glm::isnan(orientation_sum)))
+				ORNG_CORE_ERROR("Write-back check: NaN orientation");
+		}
+
+		// StepImmediate writes the final poses, so every transform should hold its actor's current rotation
+		physics.StepImmediate(1);
+		for (auto* p_transform : transforms) {
+			PxQuat q = p_transform->GetEntity()->GetComponent<PhysicsComponent>()->p_rigid_actor->getGlobalPose().q;
+			glm::mat3 actor_rot = glm::mat3_cast(glm::quat{ q.w, q.x, q.y, q.z });
+			glm::mat3 euler_rot = glm::mat3_cast(glm::quat{ glm::radians(p_transform->GetOrientation()) });
+
+			for (int axis = 0; axis < 3; axis++) {
+				result.max_orientation_error = glm::max(result.max_orientation_error, glm::length(actor_rot[axis] - euler_rot[axis]));
+			}
+		}
+
+		result.mean_transforms_written = total_written / glm::max(m_num_steps * 2.f, 1.f);
+		result.write_back_ms = total_write_back_ms / glm::max(m_num_steps, 1u);
+		result.write_back_with_euler_ms = total_with_euler_ms / glm::max(m_num_steps, 1u);
+		result.passed = total_written == NUM_WRITE_BACK_BODIES * m_num_steps * 2 && result.max_orientation_error <= MAX_WRITE_BACK_ORIENTATION_ERROR;
+
+		if (result.passed)
+			ORNG_CORE_INFO("Write-back check: {0} bodies, {1:.3f}ms write-back, {2:.3f}ms reading every orientation", result.num_bodies, result.write_back_ms, result.write_back_with_euler_ms);
+		else
+			ORNG_CORE_ERROR("Write-back check failed: {0} transforms written per step of {1}, max orientation error {2}", result.mean_transforms_written, result.num_bodies, result.max_orientation_error);
+
+		return result;
+	}
+
+
+
+	void PhysicsBenchLayer::WriteResults() {
+		std::ofstream s{ m_output_path };
+		if (!s.is_open()) {
+			ORNG_CORE_ERROR("Physics bench failed to open '{0}' for writing", m_output_path);
+			return;
+		}
+
+		s << "{\n";
+		s << std::format("\t\"steps\": {},\n", m_num_steps);
+		s << std::format("\t\"warmup_steps\": {},\n", NUM_WARMUP_STEPS);
+		s << std::format("\t\"step_size_ms\": {},\n", PhysicsSystem::GetStepSize() * 1000.f);
+		s << std::format("\t\"worker_threads\": {},\n", Physics::GetCPUDispatcher()->getWorkerCount());
+		s << std::format("\t\"traffic_vehicles\": {},\n", m_num_traffic_vehicles);
+		s << "\t\"scenarios\": [\n";
+
+		for (size_t i = 0; i < m_results.size(); i++) {
+			auto& result = m_results[i];
+
+			std::vector<float> sorted = result.step_times_ms;
+			std::ranges::sort(sorted);
+
+			auto percentile = [&](float p) { return sorted.empty() ? 0.f : sorted[static_cast<size_t>(p * (sorted.size() - 1))]; };
+			float total_ms = std::accumulate(sorted.begin(), sorted.end(), 0.f);
+
+			s << "\t\t{\n";
+			s << std::format("\t\t\t\"name\": \"{}\",\n", result.name);
+			s << std::format("\t\t\t\"bodies\": {},\n", result.num_bodies);
+			s << std::format("\t\t\t\"joints\": {},\n", result.num_joints);
+			s << std::format("\t\t\t\"mean_ms\": {},\n", sorted.empty() ? 0.f : total_ms / sorted.size());
+			s << std::format("\t\t\t\"median_ms\": {},\n", percentile(0.5f));
+			s << std::format("\t\t\t\"p95_ms\": {},\n", percentile(0.95f));
+			s << std::format("\t\t\t\"min_ms\": {},\n", sorted.empty() ? 0.f : sorted.front());
+			s << std::format("\t\t\t\"max_ms\": {},\n", sorted.empty() ? 0.f : sorted.back());
+			s << std::format("\t\t\t\"pairs_filtered\": {},\n", result.contact_totals.pairs_filtered);
+			s << std::format("\t\t\t\"contact_pairs\": {},\n", result.contact_totals.contact_pairs);
+			s << std::format("\t\t\t\"touching_pairs\": {},\n", result.contact_totals.touching_pairs);
+			s << std::format("\t\t\t\"reported_contacts\": {},\n", result.contact_totals.reported_contacts);
+			s << std::format("\t\t\t\"reported_triggers\": {},\n", result.contact_totals.reported_triggers);
+			s << std::format("\t\t\t\"active_actors\": {},\n", result.final_actor_stats.active);
+			s << std::format("\t\t\t\"sleeping_actors\": {},\n", result.final_actor_stats.sleeping);
+			s << "\t\t\t\"step_times_ms\": [";
+
+			for (size_t j = 0; j < result.step_times_ms.size(); j++) {
+				s << std::format("{}{}", j == 0 ? "" : ", ", result.step_times_ms[j]);
+			}
+
+			s << "]\n";
+			s << (i + 1 == m_results.size() ? "\t\t}\n" : "\t\t},\n");
+		}
+
+		s << "\t],\n";
+
+		const auto& terrain = m_terrain_collider_result;
+		s << "\t\"terrain_colliders\": {\n";
+		s << std::format("\t\t\"passed\": {},\n", terrain.passed);
+		s << std::format("\t\t\"tiles\": {},\n", terrain.num_tiles);
+		s << std::format("\t\t\"cooked_bytes\": {},\n", terrain.cooked_bytes);
+		s << std::format("\t\t\"mean_tile_ms\": {},\n", terrain.mean_tile_ms);
+		s << std::format("\t\t\"rays\": {},\n", terrain.num_rays);
+		s << std::format("\t\t\"hits\": {},\n", terrain.num_hits);
+		s << std::format("\t\t\"raycast_ms\": {},\n", terrain.raycast_ms);
+		s << std::format("\t\t\"max_sample_error\": {},\n", terrain.max_sample_error);
+		s << std::format("\t\t\"mean_sample_error\": {},\n", terrain.mean_sample_error);
+		s << std::format("\t\t\"max_between_error\": {},\n", terrain.max_between_error);
+		s << std::format("\t\t\"mean_between_error\": {}\n", terrain.mean_between_error);
+		s << "\t},\n";
+
+		const auto& hulls = m_convex_hull_result;
+		s << "\t\"convex_hulls\": {\n";
+		s << std::format("\t\t\"passed\": {},\n", hulls.passed);
+		s << "\t\t\"hulls\": [\n";
+
+		for (size_t i = 0; i < hulls.hulls.size(); i++) {
+			auto& hull = hulls.hulls[i];
+			s << "\t\t\t{\n";
+			s << std::format("\t\t\t\t\"name\": \"{}\",\n", hull.name);
+			s << std::format("\t\t\t\t\"passed\": {},\n", hull.passed);
+			s << std::format("\t\t\t\t\"input_vertices\": {},\n", hull.num_input_vertices);
+			s << std::format("\t\t\t\t\"hull_vertices\": {},\n", hull.num_hull_vertices);
+			s << std::format("\t\t\t\t\"polygons\": {},\n", hull.num_polygons);
+			s << std::format("\t\t\t\t\"cook_ms\": {},\n", hull.cook_ms);
+			s << std::format("\t\t\t\t\"volume\": {},\n", hull.volume);
+			s << std::format("\t\t\t\t\"expected_volume\": {},\n", hull.expected_volume);
+			s << std::format("\t\t\t\t\"volume_error\": {},\n", hull.volume_error);
+			s << std::format("\t\t\t\t\"max_convexity_error\": {},\n", hull.max_convexity_error);
+			s << std::format("\t\t\t\t\"max_outside_distance\": {}\n", hull.max_outside_distance);
+			s << (i + 1 == hulls.hulls.size() ? "\t\t\t}\n" : "\t\t\t},\n");
+		}
+
+		s << "\t\t]\n";
+		s << "\t},\n";
+
+		const auto& determinism = m_determinism_result;
+		s << "\t\"determinism\": {\n";
+		s << std::format("\t\t\"passed\": {},\n", determinism.passed);
+		s << std::format("\t\t\"steps\": {},\n", determinism.num_steps);
+		s << std::format("\t\t\"bodies\": {},\n", determinism.num_bodies);
+		s << std::format("\t\t\"frames\": [{}, {}],\n", determinism.num_frames[0], determinism.num_frames[1]);
+		s << std::format("\t\t\"mismatched_bodies\": {},\n", determinism.num_mismatched);
+		s << std::format("\t\t\"max_position_difference\": {}\n", determinism.max_position_difference);
+		s << "\t},\n";
+
+		const auto& raycasts = m_raycast_batch_result;
+		s << "\t\"raycast_batch\": {\n";
+		s << std::format("\t\t\"passed\": {},\n", raycasts.passed);
+		s << std::format("\t\t\"rays\": {},\n", raycasts.num_rays);
+		s << std::format("\t\t\"level_triangles\": {},\n", raycasts.num_triangles);
+		s << std::format("\t\t\"hits\": {},\n", raycasts.num_hits);
+		s << std::format("\t\t\"serial_ms\": {},\n", raycasts.serial_ms);
+		s << std::format("\t\t\"batch_ms\": {},\n", raycasts.batch_ms);
+		s << std::format("\t\t\"speedup\": {},\n", raycasts.batch_ms > 0.f ? raycasts.serial_ms / raycasts.batch_ms : 0.f);
+		s << std::format("\t\t\"mismatched\": {}\n", raycasts.num_mismatched);
+		s << "\t},\n";
+
+		const auto& scale = m_animated_scale_result;
+		s << "\t\"animated_scale\": {\n";
+		s << std::format("\t\t\"passed\": {},\n", scale.passed);
+		s << std::format("\t\t\"entities\": {},\n", scale.num_entities);
+		s << std::format("\t\t\"steps\": {},\n", scale.num_steps);
+		s << std::format("\t\t\"shapes_rescaled\": {},\n", scale.shapes_rescaled);
+		s << std::format("\t\t\"shapes_rebuilt\": {},\n", scale.shapes_rebuilt);
+		s << std::format("\t\t\"scale_update_ms\": {},\n", scale.scale_update_ms);
+		s << std::format("\t\t\"step_ms\": {},\n", scale.step_ms);
+		s << std::format("\t\t\"baseline_step_ms\": {}\n", scale.baseline_step_ms);
+		s << "\t},\n";
+
+		const auto& pipelined = m_pipelined_stepping_result;
+		s << "\t\"pipelined_stepping\": {\n";
+		s << std::format("\t\t\"passed\": {},\n", pipelined.passed);
+		s << std::format("\t\t\"bodies\": {},\n", pipelined.num_bodies);
+		s << std::format("\t\t\"frames\": {},\n", pipelined.num_frames);
+		s << std::format("\t\t\"render_work_ms\": {},\n", pipelined.render_work_ms);
+		s << std::format("\t\t\"mismatched_bodies\": {},\n", pipelined.num_mismatched);
+
+		for (auto [name, mode] : { std::pair{ "sync", &pipelined.sync }, std::pair{ "pipelined", &pipelined.pipelined } }) {
+			s << std::format("\t\t\"{}\": {{\n", name);
+			s << std::format("\t\t\t\"steps\": {},\n", mode->num_steps);
+			s << std::format("\t\t\t\"mean_frame_ms\": {},\n", mode->mean_frame_ms);
+			s << std::format("\t\t\t\"p95_frame_ms\": {},\n", mode->p95_frame_ms);
+			s << std::format("\t\t\t\"mean_step_frame_ms\": {}\n", mode->mean_step_frame_ms);
+			s << (mode == &pipelined.pipelined ? "\t\t}\n" : "\t\t},\n");
+		}
+
+		s << "\t},\n";
+
+		const auto& write_back = m_write_back_result;
+		s << "\t\"write_back\": {\n";
+		s << std::format("\t\t\"passed\": {},\n", write_back.passed);
+		s << std::format("\t\t\"bodies\": {},\n", write_back.num_bodies);
+		s << std::format("\t\t\"steps\": {},\n", write_back.num_steps);
+		s << std::format("\t\t\"mean_transforms_written\": {},\n", write_back.mean_transforms_written);
+		s << std::format("\t\t\"write_back_ms\": {},\n", write_back.write_back_ms);
+		s << std::format("\t\t\"write_back_with_euler_ms\": {},\n", write_back.write_back_with_euler_ms);
+		s << std::format("\t\t\"max_orientation_error\": {}\n", write_back.max_orientation_error);
+		s << "\t}\n";
+		s << "}\n";
+
+		ORNG_CORE_INFO("Physics bench results written to '{0}'", m_output_path);
+	}
+
+
+
+	SceneEntity& PhysicsBenchLayer::CreateBody(Scene& scene, glm::vec3 pos, glm::vec3 scale, PhysicsComponent::RigidBodyType type, PhysicsComponent::GeometryType geometry, bool is_trigger) {
+		auto& ent = scene.CreateEntity("Body");
+		auto* p_transform = ent.GetComponent<TransformComponent>();
+		p_transform->SetAbsolutePosition(pos);
+		p_transform->SetAbsoluteScale(scale);
+
+		// Shapes are built from the transform when the component is added
+		// Contact reports are left off as nothing listens for collision events in the bench, triggers opt in below
+		ent.AddComponent<PhysicsComponent>(is_trigger, geometry, type, AssetManager::GetAsset<PhysXMaterialAsset>(ORNG_BASE_PHYSX_MATERIAL_ID));
+
+		return ent;
+	}
+
+
+
+	void PhysicsBenchLayer::CreateJoint(SceneEntity& a0, SceneEntity& a1) {
+		auto* p_joint_comp = a0.AddComponent<JointComponent>();
+		auto* p_target = a1.AddComponent<JointComponent>();
+
+		auto* p_joint = p_joint_comp->CreateJoint().p_joint;
+		p_joint->SetMotion(PxD6Axis::eTWIST, PxD6Motion::eFREE);
+		p_joint->SetMotion(PxD6Axis::eSWING1, PxD6Motion::eFREE);
+		p_joint->SetMotion(PxD6Axis::eSWING2, PxD6Motion::eFREE);
+		p_joint->Connect(p_target);
+	}
+
+
+
+	void PhysicsBenchLayer::CreateGround(Scene& scene) {
+		CreateBody(scene, { 0, -0.5f, 0 }, { 1000, 1, 1000 }, PhysicsComponent::STATIC);
+	}
+
+
+
+	void PhysicsBenchLayer::BuildStacking(Scene& scene) {
+		CreateGround(scene);
+
+		// 100 towers of 20 unit cubes, small gaps so they settle onto each other during warmup
+		for (int x = 0; x < 10; x++) {
+			for (int z = 0; z < 10; z++) {
+				for (int y = 0; y < 20; y++) {
+					CreateBody(scene, { x * 3.f, 0.5f + y * 1.01f, z * 3.f }, glm::vec3(1), PhysicsComponent::DYNAMIC);
+				}
+			}
+		}
+	}
+
+
+
+	void PhysicsBenchLayer::BuildRagdollPile(Scene& scene) {
+		CreateGround(scene);
+
+		// Box ragdolls (torso, head, arms, legs) dropped in columns so they land on each other
+		for (int i = 0; i < 200; i++) {
+			glm::vec3 base{ (i % 5) * 1.5f, 2.f + (i / 25) * 3.f, ((i / 5) % 5) * 1.5f };
+
+			auto& torso = CreateBody(scene, base, { 0.5f, 0.7f, 0.3f }, PhysicsComponent::DYNAMIC);
+			CreateJoint(CreateBody(scene, base + glm::vec3(0, 0.55f, 0), glm::vec3(0.3f), PhysicsComponent::DYNAMIC), torso);
+			CreateJoint(CreateBody(scene, base + glm::vec3(-0.45f, 0.1f, 0), { 0.3f, 0.6f, 0.2f }, PhysicsComponent::DYNAMIC), torso);
+			CreateJoint(CreateBody(scene, base + glm::vec3(0.45f, 0.1f, 0), { 0.3f, 0.6f, 0.2f }, PhysicsComponent::DYNAMIC), torso);
+			CreateJoint(CreateBody(scene, base + glm::vec3(-0.15f, -0.75f, 0), { 0.2f, 0.7f, 0.2f }, PhysicsComponent::DYNAMIC), torso);
+			CreateJoint(CreateBody(scene, base + glm::vec3(0.15f, -0.75f, 0), { 0.2f, 0.7f, 0.2f }, PhysicsComponent::DYNAMIC), torso);
+		}
+	}
+
+
+
+	void PhysicsBenchLayer::BuildVehicles(Scene& scene) {
+		CreateGround(scene);
+
+		for (int i = 0; i < 100; i++) {
+			auto& ent = scene.CreateEntity("Vehicle");
+			ent.GetComponent<TransformComponent>()->SetAbsolutePosition({ (i % 10) * 6.f, 1.f, (i / 10) * 8.f });
+
+			auto* p_vehicle = ent.AddComponent<VehicleComponent>();
+			p_vehicle->SetThrottle(1.f);
+			p_vehicle->SetSteer(i % 2 == 0 ? 0.5f : -0.5f);
+		}
+	}
+
+
+
+	void PhysicsBenchLayer::BuildVehicleTraffic(Scene& scene) {
+		CreateGround(scene);
+
+		const unsigned vehicles_per_row = 20;
+		for (unsigned i = 0; i < m_num_traffic_vehicles; i++) {
+			auto& ent = scene.CreateEntity("Vehicle");
+			ent.GetComponent<TransformComponent>()->SetAbsolutePosition({ (i % vehicles_per_row) * 8.f, 1.f, (i / vehicles_per_row) * 12.f });
+
+			// Steering all the same way keeps them circling in their own space rather than piling into each other
+			auto* p_vehicle = ent.AddComponent<VehicleComponent>();
+			p_vehicle->SetThrottle(0.5f);
+			p_vehicle->SetSteer(0.3f);
+		}
+	}
+
+
+
+	void PhysicsBenchLayer::BuildTriggers(Scene& scene) {
+		CreateGround(scene);
+
+		// Spheres rain through a layer of trigger volumes, only the triggers want reports
+		for (int x = 0; x < 5; x++) {
+			for (int z = 0; z < 5; z++) {
+				auto& trigger = CreateBody(scene, { x * 10.f, 5.f, z * 10.f }, { 8, 2, 8 }, PhysicsComponent::STATIC, PhysicsComponent::BOX, true);
+				trigger.GetComponent<PhysicsComponent>()->SetContactReportsEnabled(true);
+			}
+		}
+
+		for (int i = 0; i < 2000; i++) {
+			CreateBody(scene, { (i % 40) * 1.1f, 10.f + (i / 1600) * 1.1f, ((i / 40) % 40) * 1.1f }, glm::vec3(1), PhysicsComponent::DYNAMIC, PhysicsComponent::SPHERE);
+		}
+	}
+
+
+
+	void PhysicsBenchLayer::BuildJointChains(Scene& scene) {
+		// Chains of 50 links hanging from static anchors, no ground so they swing freely
+		for (int c = 0; c < 40; c++) {
+			glm::vec3 anchor_pos{ c * 2.f, 60.f, 0 };
+			SceneEntity* p_prev = &CreateBody(scene, anchor_pos, glm::vec3(0.5f), PhysicsComponent::STATIC);
+
+			for (int i = 1; i <= 50; i++) {
+				// Offset sideways so the chains start swinging
+				auto& link = CreateBody(scene, anchor_pos + glm::vec3(i * 0.6f, 0, 0), glm::vec3(0.5f), PhysicsComponent::DYNAMIC);
+				CreateJoint(link, *p_prev);
+				p_prev = &link;
+			}
+		}
+	}
+}
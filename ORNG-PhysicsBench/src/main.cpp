@@ -0,0 +1,13 @@
+#include "PhysicsBenchLayer.h"
+#include "BenchMain.h"
+
+// Usage: ORNG_PHYSICS_BENCH [output json path] [steps per scenario] [vehicles in the traffic scenarios]
+int main(int argc, char** argv) {
+	std::string output_path = argc > 1 ? argv[1] : "physics-bench.json";
+	unsigned num_steps = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 600;
+	unsigned num_traffic_vehicles = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 250;
+
+	ORNG::PhysicsBenchLayer bench{ output_path, num_steps, num_traffic_vehicles };
+
+	return ORNG::RunBench(bench, "ORNG Physics Bench", static_cast<ORNG::ApplicationModulesFlags>(ORNG::SCENE_RENDERER | ORNG::AUDIO | ORNG::INPUT | ORNG::ASSET_MANAGER));
+}
@@ -2,6 +2,7 @@
 #include <GL/glew.h>
 #include "assets/AssetManager.h"
 #include "scene/SceneSerializer.h"
+#include "physics/PhysicsLayers.h"
 
 namespace ORNG {
 	void RuntimeLayer::OnInit() {
@@ -33,9 +34,11 @@ namespace ORNG {
 
 		mp_scene = std::make_unique<Scene>();
 		Events::EventManager::RegisterListener(m_window_event_listener);
-		AssetManager::LoadAssetsFromProjectPath("./", true);
+		AssetManager::LoadSceneAssetsFromProjectPath("./", ".\\scene.yml", true);
+		PhysicsLayers::Load(ORNG_PHYSICS_LAYERS_FILEPATH);
 		mp_scene->LoadScene();
 		SceneSerializer::DeserializeScene(*mp_scene, ".\\scene.yml", true);
+		AssetManager::PrioritiseStreaming(*mp_scene);
 		mp_scene->OnStart();
 	}
 
@@ -0,0 +1,413 @@
+#include "terrain/TerrainGenerator.h"
+#include "terrain/ChunkLoader.h"
+#include "terrain/TerrainQuadtree.h"
+#include <iostream>
+#include <unordered_set>
+
+/*
+	Times TerrainGenerator's scalar, batched and heightfield chunk generation at several resolutions and measures the memory each chunk format takes, checking the batched heights match the scalar ones.
+	Then streams a grid of chunks around a camera through ChunkStreamer in request order and in priority order.
+	Finally flies a camera over a TerrainQuadtree with and without merge hysteresis, recording the LOD update cost and main thread allocations every frame.
+	Writes the results to a JSON file. Pure CPU work, no window or GL context is created.
+*/
+
+// Counts allocations made by the thread calling new, streaming workers allocate chunk data and aren't counted
+static thread_local unsigned long long s_num_allocations = 0;
+
+void* operator new(std::size_t size) {
+	s_num_allocations++;
+	if (void* p = std::malloc(size ? size : 1))
+		return p;
+
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+namespace ORNG {
+	struct ResolutionResult {
+		unsigned resolution = 0;
+		unsigned num_vertices = 0;
+		float scalar_median_ms = 0.f;
+		float batched_median_ms = 0.f;
+		float heightfield_median_ms = 0.f;
+		// Largest difference between GenNoiseChunk's and GenNoiseChunkBatched's vertex heights
+		float max_batched_height_error = 0.f;
+		// Both output the same vertices (by x/z) in the same order, the heights aren't comparable otherwise
+		bool batched_layout_matches = true;
+
+		// Full vertex format, MeshVAO keeps its vertex data after uploading so it's held on both the CPU and GPU
+		size_t vertex_format_bytes = 0;
+		// Held on both the CPU and GPU (as an R16 texture)
+		size_t heightfield_bytes = 0;
+		// Shared by every chunk with this resolution, including skirts
+		size_t shared_index_bytes = 0;
+	};
+
+	static constexpr int CHUNK_WIDTH = 1024;
+	static constexpr unsigned SEED = 123;
+	// Terrain's default
+	static constexpr float HEIGHT_SCALE = 1.5f;
+	// Both sample the same noise at the same coordinates, so this only allows for the compiler contracting the height scaling differently
+	static constexpr float MAX_BATCHED_HEIGHT_ERROR = 1e-4f;
+
+	static size_t GetSizeBytes(const VertexData3D& data) {
+		return (data.positions.size() + data.normals.size() + data.tangents.size() + data.tex_coords.size()) * sizeof(float) + data.indices.size() * sizeof(unsigned);
+	}
+
+	static size_t GetSizeBytes(const TerrainGenerator::Heightfield& data) {
+		return data.GetSizeBytes();
+	}
+
+	// Chunks are spread out so every run samples new noise rather than hitting the same cells
+	static glm::vec3 ChunkBotLeft(unsigned i) {
+		return { static_cast<float>(i * CHUNK_WIDTH), 0.f, static_cast<float>((i % 4) * CHUNK_WIDTH) };
+	}
+
+	// "output_bytes" is set to the size of the last chunk generated
+	template<typename OutputT, typename GenFunc>
+	static float MedianChunkTime(GenFunc gen, unsigned resolution, unsigned num_chunks, size_t* output_bytes = nullptr) {
+		std::vector<float> times_ms;
+
+		for (unsigned i = 0; i < num_chunks; i++) {
+			OutputT data;
+			AABB aabb;
+			glm::vec3 bot_left = ChunkBotLeft(i);
+
+			auto start = std::chrono::steady_clock::now();
+			gen(SEED, CHUNK_WIDTH, resolution, HEIGHT_SCALE, bot_left, data, aabb);
+			auto end = std::chrono::steady_clock::now();
+
+			times_ms.push_back(std::chrono::duration<float, std::milli>(end - start).count());
+			if (output_bytes)
+				*output_bytes = GetSizeBytes(data);
+		}
+
+		std::ranges::sort(times_ms);
+		return times_ms[times_ms.size() / 2];
+	}
+
+	// Over the same chunks MedianChunkTime times, "layout_matches" is cleared if the two don't output the same vertices in the same order
+	static float MaxBatchedHeightError(unsigned resolution, unsigned num_chunks, bool& layout_matches) {
+		float max_error = 0.f;
+
+		for (unsigned i = 0; i < num_chunks; i++) {
+			VertexData3D scalar_data;
+			VertexData3D batched_data;
+			AABB aabb;
+			TerrainGenerator::GenNoiseChunk(SEED, CHUNK_WIDTH, resolution, HEIGHT_SCALE, ChunkBotLeft(i), scalar_data, aabb);
+			TerrainGenerator::GenNoiseChunkBatched(SEED, CHUNK_WIDTH, resolution, HEIGHT_SCALE, ChunkBotLeft(i), batched_data, aabb);
+
+			if (scalar_data.positions.size() != batched_data.positions.size()) {
+				layout_matches = false;
+				return max_error;
+			}
+
+			for (size_t v = 0; v < scalar_data.positions.size(); v += 3) {
+				if (scalar_data.positions[v] != batched_data.positions[v] || scalar_data.positions[v + 2] != batched_data.positions[v + 2]) {
+					layout_matches = false;
+					return max_error;
+				}
+
+				max_error = glm::max(max_error, glm::abs(scalar_data.positions[v + 1] - batched_data.positions[v + 1]));
+			}
+		}
+
+		return max_error;
+	}
+
+	struct StreamingResult {
+		const char* name = "";
+		unsigned num_chunks = 0;
+		// Time until every chunk within NEAR_RING_DISTANCE of the camera has been generated, these are the ones that leave visible holes
+		float near_ring_ms = 0.f;
+		float all_chunks_ms = 0.f;
+		ChunkStreamer::Metrics metrics;
+	};
+
+	static constexpr int STREAMING_GRID_SIDE = 16;
+	static constexpr int STREAMING_CHUNK_WIDTH = 256;
+	static constexpr unsigned STREAMING_RESOLUTION = 4;
+	static constexpr float NEAR_RING_DISTANCE = STREAMING_CHUNK_WIDTH * 1.5f;
+
+	// Chunks are requested row by row from one corner of the grid with the camera in its center, like a quadtree walk would
+	static StreamingResult RunStreaming(const char* name, bool prioritized, unsigned num_workers) {
+		StreamingResult result;
+		result.name = name;
+
+		const glm::vec3 camera_pos{ 0.f, 0.f, 0.f };
+		const float grid_offset = -STREAMING_GRID_SIDE * STREAMING_CHUNK_WIDTH * 0.5f;
+
+		ChunkStreamer streamer{ num_workers };
+		std::unordered_set<uint64_t> near_keys;
+		auto start = std::chrono::steady_clock::now();
+
+		for (int x = 0; x < STREAMING_GRID_SIDE; x++) {
+			for (int z = 0; z < STREAMING_GRID_SIDE; z++) {
+				ChunkStreamer::ChunkParams params{ SEED, STREAMING_CHUNK_WIDTH, STREAMING_RESOLUTION, HEIGHT_SCALE,
+					glm::vec3{ grid_offset + x * STREAMING_CHUNK_WIDTH, 0.f, grid_offset + z * STREAMING_CHUNK_WIDTH } };
+
+				const float geometric_error = static_cast<float>(STREAMING_RESOLUTION * 2);
+				float priority = ChunkLoader::CalculatePriority(params.bot_left_coord, STREAMING_CHUNK_WIDTH, geometric_error, camera_pos);
+				bool is_near = priority >= geometric_error / NEAR_RING_DISTANCE;
+
+				uint64_t key = streamer.Request(params, prioritized ? priority : -static_cast<float>(result.num_chunks));
+				if (is_near)
+					near_keys.insert(key);
+
+				result.num_chunks++;
+			}
+		}
+
+		unsigned num_received = 0;
+		while (num_received < result.num_chunks) {
+			auto completed = streamer.ConsumeCompleted();
+			auto now = std::chrono::steady_clock::now();
+
+			for (auto& chunk : completed) {
+				if (near_keys.erase(chunk.key) && near_keys.empty())
+					result.near_ring_ms = std::chrono::duration<float, std::milli>(now - start).count();
+			}
+
+			num_received += static_cast<unsigned>(completed.size());
+			if (completed.empty())
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		result.all_chunks_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		result.metrics = streamer.GetMetrics();
+		return result;
+	}
+
+	struct FlythroughResult {
+		const char* name = "";
+		float merge_hysteresis = 0.f;
+		unsigned num_frames = 0;
+		unsigned skipped_frames = 0;
+		unsigned total_splits = 0;
+		unsigned total_merges = 0;
+		float mean_nodes_evaluated = 0.f;
+		float mean_update_ms = 0.f;
+		float p99_update_ms = 0.f;
+		float max_update_ms = 0.f;
+		unsigned max_active_nodes = 0;
+		// Main thread allocations, split by whether the tree had reached its peak size yet
+		// Quadtree covers Update and GetDrawChunks, the chunk loader's request queues still grow whenever more chunks are in flight than ever before
+		unsigned long long quadtree_allocations_warmup = 0;
+		unsigned long long quadtree_allocations_steady = 0;
+		unsigned long long loader_allocations_warmup = 0;
+		unsigned long long loader_allocations_steady = 0;
+	};
+
+	static constexpr unsigned FLYTHROUGH_TERRAIN_WIDTH = 8192;
+	static constexpr unsigned FLYTHROUGH_LEG_FRAMES = 600;
+	// The first round trip, after it the tree has been through every LOD configuration on the path
+	static constexpr unsigned FLYTHROUGH_WARMUP_FRAMES = FLYTHROUGH_LEG_FRAMES * 2;
+	static constexpr unsigned FLYTHROUGH_FRAMES = 6000;
+
+	// Camera crosses the terrain at walking speed, wobbling back and forth along its path like a player strafing, so it repeatedly crosses the same LOD boundaries
+	// The path is flown there and back repeatedly
+	static glm::vec3 GetFlythroughCameraPos(unsigned frame) {
+		constexpr float speed = 1.f;
+		constexpr float wobble_amplitude = 6.f;
+		constexpr float wobble_period_frames = 30.f;
+		constexpr float path_length = FLYTHROUGH_LEG_FRAMES * speed;
+
+		float t = static_cast<float>(frame % (FLYTHROUGH_LEG_FRAMES * 2));
+		float along = t < FLYTHROUGH_LEG_FRAMES ? t * speed : path_length - (t - FLYTHROUGH_LEG_FRAMES) * speed;
+		along += wobble_amplitude * std::sin(static_cast<float>(frame) * 2.f * glm::pi<float>() / wobble_period_frames);
+
+		return glm::vec3{ along - path_length * 0.5f, 20.f, along * 0.5f };
+	}
+
+	static FlythroughResult RunFlythrough(const char* name, float merge_hysteresis) {
+		FlythroughResult result;
+		result.name = name;
+		result.merge_hysteresis = merge_hysteresis;
+
+		TerrainQuadtree tree{ FLYTHROUGH_TERRAIN_WIDTH, HEIGHT_SCALE, SEED, glm::vec3{ 0.f } };
+		tree.SetLODDistances(TerrainQuadtree::DEFAULT_LOD_DISTANCE_FACTOR, merge_hysteresis);
+
+		std::vector<float> update_times_ms;
+		update_times_ms.reserve(FLYTHROUGH_FRAMES);
+		unsigned long long total_nodes_evaluated = 0;
+
+		for (unsigned frame = 0; frame < FLYTHROUGH_FRAMES; frame++) {
+			glm::vec3 camera_pos = GetFlythroughCameraPos(frame);
+
+			unsigned long long allocations_before = s_num_allocations;
+			auto start = std::chrono::steady_clock::now();
+			tree.Update(camera_pos);
+			auto end = std::chrono::steady_clock::now();
+			tree.GetDrawChunks();
+			const unsigned long long quadtree_allocations = s_num_allocations - allocations_before;
+
+			allocations_before = s_num_allocations;
+			ChunkLoader::ProcessChunkLoads(camera_pos);
+			const unsigned long long loader_allocations = s_num_allocations - allocations_before;
+
+			const bool warmup = frame < FLYTHROUGH_WARMUP_FRAMES;
+			(warmup ? result.quadtree_allocations_warmup : result.quadtree_allocations_steady) += quadtree_allocations;
+			(warmup ? result.loader_allocations_warmup : result.loader_allocations_steady) += loader_allocations;
+
+			const auto& stats = tree.GetLastUpdateStats();
+			update_times_ms.push_back(std::chrono::duration<float, std::milli>(end - start).count());
+			total_nodes_evaluated += stats.nodes_evaluated;
+			result.skipped_frames += stats.skipped;
+			result.total_splits += stats.splits;
+			result.total_merges += stats.merges;
+			result.max_active_nodes = glm::max(result.max_active_nodes, tree.GetNumActiveNodes());
+		}
+
+		result.num_frames = FLYTHROUGH_FRAMES;
+		result.mean_nodes_evaluated = static_cast<float>(total_nodes_evaluated) / FLYTHROUGH_FRAMES;
+
+		float total_ms = 0.f;
+		for (float ms : update_times_ms) {
+			total_ms += ms;
+		}
+		result.mean_update_ms = total_ms / FLYTHROUGH_FRAMES;
+
+		std::ranges::sort(update_times_ms);
+		result.p99_update_ms = update_times_ms[update_times_ms.size() * 99 / 100];
+		result.max_update_ms = update_times_ms.back();
+
+		return result;
+	}
+}
+
+// Usage: ORNG_TERRAIN_BENCH [output json path] [chunks per resolution] [streaming workers, 0 for the default]
+// Exits with 1 if the batched heights check fails, the timings aren't checked
+int main(int argc, char** argv) {
+	using namespace ORNG;
+	std::string output_path = argc > 1 ? argv[1] : "terrain-bench.json";
+	unsigned num_chunks = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 16;
+	unsigned num_streaming_workers = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 0;
+
+	std::vector<ResolutionResult> results;
+	for (unsigned resolution : { 32u, 16u, 8u, 4u, 2u }) {
+		auto& result = results.emplace_back();
+		result.resolution = resolution;
+		result.num_vertices = (CHUNK_WIDTH / resolution) * (CHUNK_WIDTH / resolution);
+		result.scalar_median_ms = MedianChunkTime<VertexData3D>(&TerrainGenerator::GenNoiseChunk, resolution, num_chunks);
+		result.batched_median_ms = MedianChunkTime<VertexData3D>(&TerrainGenerator::GenNoiseChunkBatched, resolution, num_chunks, &result.vertex_format_bytes);
+		result.heightfield_median_ms = MedianChunkTime<TerrainGenerator::Heightfield>(&TerrainGenerator::GenHeightfieldChunk, resolution, num_chunks, &result.heightfield_bytes);
+		result.max_batched_height_error = MaxBatchedHeightError(resolution, num_chunks, result.batched_layout_matches);
+
+		std::vector<unsigned> shared_indices;
+		TerrainGenerator::GenHeightfieldIndices(CHUNK_WIDTH / resolution, true, shared_indices);
+		result.shared_index_bytes = shared_indices.size() * sizeof(unsigned);
+
+		std::cout << std::format("Resolution {}: {} vertices, scalar {}ms, batched {}ms (max height error {}), heightfield {}ms, vertex format {}KB, heightfield {}KB (+{}KB shared indices)\n", resolution, result.num_vertices,
+			result.scalar_median_ms, result.batched_median_ms, result.max_batched_height_error, result.heightfield_median_ms, result.vertex_format_bytes / 1000, result.heightfield_bytes / 1000, result.shared_index_bytes / 1000);
+	}
+
+	float max_batched_height_error = 0.f;
+	bool batched_layouts_match = true;
+	for (const auto& result : results) {
+		max_batched_height_error = glm::max(max_batched_height_error, result.max_batched_height_error);
+		batched_layouts_match &= result.batched_layout_matches;
+	}
+
+	const bool batched_heights_passed = batched_layouts_match && max_batched_height_error <= MAX_BATCHED_HEIGHT_ERROR;
+	if (!batched_heights_passed)
+		std::cout << std::format("Batched heights check failed: max error {} (limit {}), layouts {}\n", max_batched_height_error, MAX_BATCHED_HEIGHT_ERROR, batched_layouts_match ? "match" : "differ");
+
+	std::vector<StreamingResult> streaming_results;
+	streaming_results.push_back(RunStreaming("request_order", false, num_streaming_workers));
+	streaming_results.push_back(RunStreaming("prioritized", true, num_streaming_workers));
+	for (const auto& result : streaming_results) {
+		std::cout << std::format("Streaming {}: near ring {}ms, all {} chunks {}ms, mean queue latency {}ms\n", result.name, result.near_ring_ms, result.num_chunks, result.all_chunks_ms, result.metrics.mean_queue_latency_ms);
+	}
+
+	// No GL context, chunks are marked ready to draw as soon as they're generated
+	ChunkLoader::SetGPUUploadsEnabled(false);
+	std::vector<FlythroughResult> flythrough_results;
+	flythrough_results.push_back(RunFlythrough("no_hysteresis", 0.f));
+	flythrough_results.push_back(RunFlythrough("default_hysteresis", TerrainQuadtree::DEFAULT_MERGE_HYSTERESIS));
+	for (const auto& result : flythrough_results) {
+		std::cout << std::format("Flythrough {}: {} splits, {} merges, {}/{} frames skipped, mean {} nodes evaluated, update mean {}ms p99 {}ms max {}ms, quadtree allocations warmup {} steady {}, chunk loader allocations warmup {} steady {}\n",
+			result.name, result.total_splits, result.total_merges, result.skipped_frames, result.num_frames, result.mean_nodes_evaluated, result.mean_update_ms, result.p99_update_ms, result.max_update_ms,
+			result.quadtree_allocations_warmup, result.quadtree_allocations_steady, result.loader_allocations_warmup, result.loader_allocations_steady);
+	}
+
+	std::ofstream s{ output_path };
+	if (!s.is_open()) {
+		std::cout << std::format("Failed to write terrain bench results, cannot open '{}'\n", output_path);
+		return 1;
+	}
+
+	s << "{\n";
+	s << std::format("\t\"chunk_width\": {},\n", CHUNK_WIDTH);
+	s << std::format("\t\"chunks_per_resolution\": {},\n", num_chunks);
+	s << "\t\"batched_heights\": {\n";
+	s << std::format("\t\t\"passed\": {},\n", batched_heights_passed);
+	s << std::format("\t\t\"layouts_match\": {},\n", batched_layouts_match);
+	s << std::format("\t\t\"max_error\": {}\n", max_batched_height_error);
+	s << "\t},\n";
+	s << "\t\"resolutions\": [\n";
+	for (size_t i = 0; i < results.size(); i++) {
+		const auto& result = results[i];
+		s << "\t\t{\n";
+		s << std::format("\t\t\t\"resolution\": {},\n", result.resolution);
+		s << std::format("\t\t\t\"vertices\": {},\n", result.num_vertices);
+		s << std::format("\t\t\t\"scalar_median_ms\": {},\n", result.scalar_median_ms);
+		s << std::format("\t\t\t\"batched_median_ms\": {},\n", result.batched_median_ms);
+		s << std::format("\t\t\t\"max_batched_height_error\": {},\n", result.max_batched_height_error);
+		s << std::format("\t\t\t\"batched_layout_matches\": {},\n", result.batched_layout_matches);
+		s << std::format("\t\t\t\"heightfield_median_ms\": {},\n", result.heightfield_median_ms);
+		s << std::format("\t\t\t\"vertex_format_bytes\": {},\n", result.vertex_format_bytes);
+		s << std::format("\t\t\t\"heightfield_bytes\": {},\n", result.heightfield_bytes);
+		s << std::format("\t\t\t\"shared_index_bytes\": {}\n", result.shared_index_bytes);
+		s << (i + 1 == results.size() ? "\t\t}\n" : "\t\t},\n");
+	}
+	s << "\t],\n";
+
+	s << "\t\"streaming\": [\n";
+	for (size_t i = 0; i < streaming_results.size(); i++) {
+		const auto& result = streaming_results[i];
+		s << "\t\t{\n";
+		s << std::format("\t\t\t\"name\": \"{}\",\n", result.name);
+		s << std::format("\t\t\t\"chunks\": {},\n", result.num_chunks);
+		s << std::format("\t\t\t\"near_ring_ms\": {},\n", result.near_ring_ms);
+		s << std::format("\t\t\t\"all_chunks_ms\": {},\n", result.all_chunks_ms);
+		s << std::format("\t\t\t\"mean_queue_latency_ms\": {},\n", result.metrics.mean_queue_latency_ms);
+		s << std::format("\t\t\t\"max_queue_latency_ms\": {},\n", result.metrics.max_queue_latency_ms);
+		s << std::format("\t\t\t\"mean_generation_ms\": {},\n", result.metrics.mean_generation_ms);
+		s << std::format("\t\t\t\"max_total_latency_ms\": {}\n", result.metrics.max_total_latency_ms);
+		s << (i + 1 == streaming_results.size() ? "\t\t}\n" : "\t\t},\n");
+	}
+	s << "\t],\n";
+
+	s << std::format("\t\"flythrough_terrain_width\": {},\n", FLYTHROUGH_TERRAIN_WIDTH);
+	s << "\t\"flythrough\": [\n";
+	for (size_t i = 0; i < flythrough_results.size(); i++) {
+		const auto& result = flythrough_results[i];
+		s << "\t\t{\n";
+		s << std::format("\t\t\t\"name\": \"{}\",\n", result.name);
+		s << std::format("\t\t\t\"merge_hysteresis\": {},\n", result.merge_hysteresis);
+		s << std::format("\t\t\t\"frames\": {},\n", result.num_frames);
+		s << std::format("\t\t\t\"skipped_frames\": {},\n", result.skipped_frames);
+		s << std::format("\t\t\t\"splits\": {},\n", result.total_splits);
+		s << std::format("\t\t\t\"merges\": {},\n", result.total_merges);
+		s << std::format("\t\t\t\"max_active_nodes\": {},\n", result.max_active_nodes);
+		s << std::format("\t\t\t\"mean_nodes_evaluated\": {},\n", result.mean_nodes_evaluated);
+		s << std::format("\t\t\t\"mean_update_ms\": {},\n", result.mean_update_ms);
+		s << std::format("\t\t\t\"p99_update_ms\": {},\n", result.p99_update_ms);
+		s << std::format("\t\t\t\"max_update_ms\": {},\n", result.max_update_ms);
+		s << std::format("\t\t\t\"quadtree_allocations_warmup\": {},\n", result.quadtree_allocations_warmup);
+		s << std::format("\t\t\t\"quadtree_allocations_steady\": {},\n", result.quadtree_allocations_steady);
+		s << std::format("\t\t\t\"loader_allocations_warmup\": {},\n", result.loader_allocations_warmup);
+		s << std::format("\t\t\t\"loader_allocations_steady\": {}\n", result.loader_allocations_steady);
+		s << (i + 1 == flythrough_results.size() ? "\t\t}\n" : "\t\t},\n");
+	}
+	s << "\t]\n}\n";
+
+	return batched_heights_passed ? 0 : 1;
+}